@@ -5,7 +5,32 @@
       "sources": [
         "src/sysmon.cpp",
         "src/network.cpp",
-        "src/connections.cpp"
+        "src/connections.cpp",
+        "src/anomaly.cpp",
+        "src/alerts.cpp",
+        "src/snapshot.cpp",
+        "src/arena.cpp",
+        "src/selfstats.cpp",
+        "src/scheduler.cpp",
+        "src/sensors.cpp",
+        "src/pressure.cpp",
+        "src/ntinfo.cpp",
+        "src/threads.cpp",
+        "src/handles.cpp",
+        "src/disks.cpp",
+        "src/scanner.cpp",
+        "src/tcpstats.cpp",
+        "src/replay.cpp",
+        "src/wire.cpp",
+        "src/stream.cpp",
+        "src/aggregator.cpp",
+        "src/history.cpp",
+        "src/shared.cpp",
+        "src/inventory.cpp",
+        "src/energy.cpp",
+        "src/procdetails.cpp",
+        "src/topology.cpp",
+        "src/container.cpp"
       ],
       "defines": ["NAPI_VERSION=8"],
       "conditions": [
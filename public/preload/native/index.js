@@ -16,6 +16,115 @@ function formatUptime(seconds) {
   return `${d}天 ${h}小时 ${m}分钟`
 }
 
+function formatSystemInfo(s) {
+  return { 
+    hostname: s.hostname, platform: s.platform, arch: s.arch, build: s.build,
+    manufacturer: s.manufacturer || '未知', model: s.model || '未知'
+  }
+}
+
+function formatCpuInfo(c, u) {
+  return {
+    brand: (c.brand || 'Unknown').trim(),
+    manufacturer: (c.brand || '').includes('Intel') ? 'Intel' : (c.brand || '').includes('AMD') ? 'AMD' : 'Unknown',
+    cores: c.cores,
+    physicalCores: c.physicalCores || Math.floor(c.cores / 2),
+    sockets: c.sockets || 1,
+    numaNodes: c.numaNodes || 1,
+    speed: c.speed ? c.speed.toFixed(2) + ' GHz' : 'Unknown',
+    currentSpeed: c.currentSpeed ? c.currentSpeed.toFixed(2) + ' GHz' : (c.speed ? c.speed.toFixed(2) + ' GHz' : 'Unknown'),
+    virtualization: c.virtualization === 'Supported' ? '支持' : '未知',
+    load: u.load.toFixed(1) + '%'
+  }
+}
+
+function formatGpuInfo(g) {
+  return { 
+    controllers: (g.controllers || []).map(gpu => ({
+      model: gpu.model || 'Unknown',
+      vendor: gpu.vendor || (gpu.model?.includes('NVIDIA') ? 'NVIDIA' : gpu.model?.includes('AMD') ? 'AMD' : 
+        gpu.model?.includes('Intel') ? 'Intel' : 'Unknown'),
+      vram: gpu.vram ? formatBytes(gpu.vram) : '共享内存',
+      bus: gpu.bus || 'PCI'
+    })), 
+    displays: (g.displays || []).map(d => ({
+      model: d.model || '显示器',
+      main: d.main || false,
+      resolutionX: d.resolutionX || 0,
+      resolutionY: d.resolutionY || 0,
+      currentResX: d.currentResX || d.resolutionX || 0,
+      currentResY: d.currentResY || d.resolutionY || 0,
+      refreshRate: d.refreshRate ? d.refreshRate + ' Hz' : '未知',
+      pixelDepth: d.pixelDepth ? d.pixelDepth + ' bit' : '未知'
+    }))
+  }
+}
+
+function formatMemoryHardware(hw) {
+  const modules = (hw.modules || []).map(m => ({
+    bank: m.bank || '',
+    capacity: formatBytes(m.capacity || 0),
+    capacityRaw: m.capacity || 0,
+    speed: m.speed || 0,
+    type: m.type || 'Unknown',
+    formFactor: m.formFactor || 'Unknown',
+    manufacturer: m.manufacturer || '',
+    partNumber: m.partNumber || ''
+  }))
+  
+  return {
+    modules,
+    usedSlots: hw.usedSlots || modules.length,
+    totalSlots: hw.totalSlots || modules.length,
+    totalCapacity: formatBytes(modules.reduce((sum, m) => sum + m.capacityRaw, 0)),
+    speed: modules[0]?.speed || 0,
+    type: modules[0]?.type || 'Unknown'
+  }
+}
+
+// Inventory exports refreshed in the background, by native export name
+const inventoryFormats = {
+  getSystemInfo: formatSystemInfo,
+  getCpuInfo: c => formatCpuInfo(c, native.getCpuUsage()),
+  getGpuInfo: formatGpuInfo,
+  getMemoryHardware: formatMemoryHardware
+}
+
+// Shared snapshot reader: while another live instance publishes, CPU load and
+// the process list come from the segment instead of running the collectors here
+const SHARED_MAX_AGE = 3000
+let sharedReads = false
+// Anomaly detection only sees processes the local collector samples, so
+// once anomaly events are asked for the process list is collected here
+let anomalyReads = false
+
+function sharedFresh(section, procs) {
+  if (!sharedReads) return null
+  const s = native.getSharedSnapshot({ procs })
+  if (!s.found || s.role !== 'reader' || !s.ownerAlive) return null
+  const age = s.ages[section]
+  return age !== undefined && age < SHARED_MAX_AGE ? s : null
+}
+
+function processRows(processes, totalMem) {
+  return processes.map(proc => ({
+    pid: proc.pid,
+    name: proc.name,
+    memory: formatBytes(proc.memory),
+    memoryRaw: proc.memory,
+    memPercent: ((proc.memory / totalMem) * 100).toFixed(1) + '%',
+    memPercentRaw: (proc.memory / totalMem) * 100,
+    threads: proc.threads || 0,
+    handles: proc.handles || 0,
+    cpu: (proc.cpu || 0).toFixed(1) + '%',
+    cpuRaw: proc.cpu || 0,
+    path: proc.details ? proc.details.path : null,
+    cmdline: proc.details ? proc.details.cmdline : null,
+    user: proc.details ? proc.details.user : null,
+    startTime: proc.details ? proc.details.startTime : null
+  }))
+}
+
 module.exports = {
   isLoaded: () => native !== null,
   getError: () => loadError,
@@ -39,40 +148,31 @@ module.exports = {
       committedRaw: m.committed || 0,
       cachedRaw: m.cached || 0,
       pagedPoolRaw: m.pagedPool || 0,
-      nonPagedPoolRaw: m.nonPagedPool || 0
+      nonPagedPoolRaw: m.nonPagedPool || 0,
+      sampleInterval: m.sampleInterval, sampleAge: m.sampleAge,
+      // Under a job memory limit the totals above are relative to it
+      container: !!m.container,
+      host: m.host ? { total: formatBytes(m.host.total), used: formatBytes(m.host.used), usedPercent: m.host.usedPercent.toFixed(1) + '%', totalRaw: m.host.total, usedRaw: m.host.used } : null
     }
   },
 
   // Memory hardware info (via C++ WMI)
   getMemoryHardware() {
     if (!native) return { modules: [], usedSlots: 0, totalSlots: 0, totalCapacity: '0 B', speed: 0, type: 'Unknown' }
-    
-    const hw = native.getMemoryHardware()
-    const modules = (hw.modules || []).map(m => ({
-      bank: m.bank || '',
-      capacity: formatBytes(m.capacity || 0),
-      capacityRaw: m.capacity || 0,
-      speed: m.speed || 0,
-      type: m.type || 'Unknown',
-      formFactor: m.formFactor || 'Unknown',
-      manufacturer: m.manufacturer || '',
-      partNumber: m.partNumber || ''
-    }))
-    
-    return {
-      modules,
-      usedSlots: hw.usedSlots || modules.length,
-      totalSlots: hw.totalSlots || modules.length,
-      totalCapacity: formatBytes(modules.reduce((sum, m) => sum + m.capacityRaw, 0)),
-      speed: modules[0]?.speed || 0,
-      type: modules[0]?.type || 'Unknown'
-    }
+    return formatMemoryHardware(native.getMemoryHardware())
   },
 
   getCpuUsage() {
     if (!native) return null
+    const s = sharedFresh('cpu', false)
+    if (s) return { load: s.cpu.total.toFixed(1) + '%', loadRaw: s.cpu.total, container: false, cpuLimit: null, host: null, hostRaw: null, shared: true }
     const c = native.getCpuUsage()
-    return { load: c.load.toFixed(1) + '%', loadRaw: c.load }
+    return {
+      load: c.load.toFixed(1) + '%', loadRaw: c.load,
+      // Under a job CPU cap load is a share of the cap; host is the machine-wide value
+      container: !!c.container, cpuLimit: c.cpuLimit || null,
+      host: c.container ? c.host.toFixed(1) + '%' : null, hostRaw: c.container ? c.host : null
+    }
   },
 
   getPerCoreUsage() {
@@ -85,6 +185,22 @@ module.exports = {
     }))
   },
 
+  // Sockets / NUMA nodes / L3 domains / cores with aggregated load and per-node memory
+  getCpuTopology() {
+    if (!native) return null
+    const t = native.getCpuTopology()
+    const fmt = g => ({ ...g, loadFmt: g.load.toFixed(1) + '%' })
+    return { ...t, sockets: t.sockets.map(fmt), nodes: t.nodes.map(fmt), caches: t.caches.map(fmt), cores: t.cores.map(fmt) }
+  },
+
+  // Job object (container) limits, usage against them, throttling and limit hits
+  getContainerInfo() {
+    if (!native) return null
+    const c = native.getContainerInfo()
+    if (c.memory) Object.assign(c.memory, { limitFmt: formatBytes(c.memory.limit), usedFmt: formatBytes(c.memory.used), peakFmt: formatBytes(c.memory.peak) })
+    return c
+  },
+
   getUptime() {
     if (!native) return null
     return formatUptime(native.getUptime().seconds)
@@ -96,74 +212,71 @@ module.exports = {
     return {
       processCount: s.processCount,
       threadCount: s.threadCount,
-      handleCount: s.handleCount
+      handleCount: s.handleCount,
+      sampleInterval: s.sampleInterval, sampleAge: s.sampleAge
     }
   },
 
   getSystemInfo() {
     if (!native) return null
-    const s = native.getSystemInfo()
-    return { 
-      hostname: s.hostname, platform: s.platform, arch: s.arch, build: s.build,
-      manufacturer: s.manufacturer || '未知', model: s.model || '未知'
-    }
+    return formatSystemInfo(native.getSystemInfo())
   },
 
   getCpuInfo() {
     if (!native) return null
-    const c = native.getCpuInfo(), u = native.getCpuUsage()
+    return formatCpuInfo(native.getCpuInfo(), native.getCpuUsage())
+  },
+
+  // Effective CPU frequency, throttling and thermal zones (PDH)
+  getSensors() {
+    if (!native) return null
+    const s = native.getSensors()
     return {
-      brand: (c.brand || 'Unknown').trim(),
-      manufacturer: (c.brand || '').includes('Intel') ? 'Intel' : (c.brand || '').includes('AMD') ? 'AMD' : 'Unknown',
-      cores: c.cores,
-      physicalCores: c.physicalCores || Math.floor(c.cores / 2),
-      speed: c.speed ? c.speed.toFixed(2) + ' GHz' : 'Unknown',
-      currentSpeed: c.currentSpeed ? c.currentSpeed.toFixed(2) + ' GHz' : (c.speed ? c.speed.toFixed(2) + ' GHz' : 'Unknown'),
-      virtualization: c.virtualization === 'Supported' ? '支持' : '未知',
-      load: u.load.toFixed(1) + '%'
+      ...s,
+      frequencyFmt: s.cpu.frequency ? (s.cpu.frequency / 1000).toFixed(2) + ' GHz' : 'Unknown',
+      temperatureFmt: s.cpuTemperature != null ? s.cpuTemperature.toFixed(1) + ' °C' : 'N/A'
     }
   },
 
+  // Paging / run queue / disk queue rates since the previous call
+  getPressure() {
+    if (!native) return null
+    return native.getPressure()
+  },
+
   getGpuInfo() {
     if (!native) return null
-    const g = native.getGpuInfo()
-    return { 
-      controllers: (g.controllers || []).map(gpu => ({
-        model: gpu.model || 'Unknown',
-        vendor: gpu.vendor || (gpu.model?.includes('NVIDIA') ? 'NVIDIA' : gpu.model?.includes('AMD') ? 'AMD' : 
-          gpu.model?.includes('Intel') ? 'Intel' : 'Unknown'),
-        vram: gpu.vram ? formatBytes(gpu.vram) : '共享内存',
-        bus: gpu.bus || 'PCI'
-      })), 
-      displays: (g.displays || []).map(d => ({
-        model: d.model || '显示器',
-        main: d.main || false,
-        resolutionX: d.resolutionX || 0,
-        resolutionY: d.resolutionY || 0,
-        currentResX: d.currentResX || d.resolutionX || 0,
-        currentResY: d.currentResY || d.resolutionY || 0,
-        refreshRate: d.refreshRate ? d.refreshRate + ' Hz' : '未知',
-        pixelDepth: d.pixelDepth ? d.pixelDepth + ' bit' : '未知'
-      }))
-    }
+    return formatGpuInfo(native.getGpuInfo())
   },
 
   getBatteryInfo() {
     if (!native) return null
     const b = native.getBatteryInfo()
     if (!b.hasBattery) return { hasBattery: false }
-    return { hasBattery: true, percent: b.percent + '%', isCharging: b.isCharging, timeRemaining: 'Unknown' }
+    const remaining = b.isCharging ? b.timeToFull : b.timeToEmpty
+    return { hasBattery: true, percent: b.percent + '%', isCharging: b.isCharging,
+      timeRemaining: remaining != null ? formatUptime(remaining) : 'Unknown',
+      dischargeRate: b.dischargeRate != null ? b.dischargeRate.toFixed(1) + ' W' : null }
   },
 
   getDiskInfo() {
     if (!native) return null
     const d = native.getDiskInfo()
+    // Totals count each local volume once (it may be mounted at a letter and
+    // several folders) and leave network drives out
     let totalSize = 0, totalUsed = 0
+    const counted = new Set()
     const partitions = (d.partitions || []).map(p => {
-      totalSize += p.size; totalUsed += p.used
-      return { fs: p.fs, mount: p.mount, type: p.type || 'NTFS',
+      if (p.kind !== 'remote' && !(p.volume && counted.has(p.volume))) {
+        if (p.volume) counted.add(p.volume)
+        totalSize += p.size; totalUsed += p.used
+      }
+      return { fs: p.fs, mount: p.mount, type: p.type || 'NTFS', label: p.label || '', kind: p.kind || 'fixed',
         size: formatBytes(p.size), used: formatBytes(p.used), available: formatBytes(p.free),
-        usedPercent: p.usedPercent.toFixed(1) + '%', sizeBytes: p.size, usedBytes: p.used }
+        usedPercent: p.usedPercent.toFixed(1) + '%', sizeBytes: p.size, usedBytes: p.used,
+        // Forecast from the last hour of usage; null while the volume is not filling
+        growthRate: p.growthRate || 0, timeToFull: p.timeToFull == null ? null : p.timeToFull,
+        timeToFullText: p.timeToFull == null ? '' : formatUptime(p.timeToFull) }
     })
     const physical = (d.physical || []).map(p => ({
       name: p.name || 'Unknown', vendor: p.vendor || '',
@@ -171,7 +284,8 @@ module.exports = {
     }))
     return { partitions, physical, totalSize: formatBytes(totalSize), totalUsed: formatBytes(totalUsed),
       totalAvailable: formatBytes(totalSize - totalUsed),
-      totalPercent: totalSize > 0 ? ((totalUsed / totalSize) * 100).toFixed(1) + '%' : '0%' }
+      totalPercent: totalSize > 0 ? ((totalUsed / totalSize) * 100).toFixed(1) + '%' : '0%',
+      sampleInterval: d.sampleInterval, sampleAge: d.sampleAge }
   },
 
   getDiskIO() {
@@ -198,7 +312,8 @@ module.exports = {
       readsPerSec: io.readsPerSec || 0,
       readsPerSecFmt: (io.readsPerSec || 0).toFixed(1),
       writesPerSec: io.writesPerSec || 0,
-      writesPerSecFmt: (io.writesPerSec || 0).toFixed(1)
+      writesPerSecFmt: (io.writesPerSec || 0).toFixed(1),
+      sampleInterval: io.sampleInterval, sampleAge: io.sampleAge
     }
   },
 
@@ -226,75 +341,301 @@ module.exports = {
       rxSec: formatBytes(i.rxSec || 0) + '/s',
       txSec: formatBytes(i.txSec || 0) + '/s',
       rxSecBytes: i.rxSec || 0,
-      txSecBytes: i.txSec || 0
+      txSecBytes: i.txSec || 0,
+      virtual: i.virtual || false,
+      ifType: i.ifType || 0,
+      rxPacketsSec: i.rxPacketsSec || 0,
+      txPacketsSec: i.txPacketsSec || 0,
+      rxNonUnicastPackets: i.rxNonUnicastPackets || 0,
+      txNonUnicastPackets: i.txNonUnicastPackets || 0,
+      rxMulticastBytes: formatBytes(i.rxMulticastBytes || 0),
+      txMulticastBytes: formatBytes(i.txMulticastBytes || 0),
+      rxErrors: i.rxErrors || 0,
+      txErrors: i.txErrors || 0,
+      rxDrops: i.rxDrops || 0,
+      txDrops: i.txDrops || 0,
+      rxErrorsSec: i.rxErrorsSec || 0,
+      txErrorsSec: i.txErrorsSec || 0,
+      rxDropsSec: i.rxDropsSec || 0,
+      txDropsSec: i.txDropsSec || 0,
+      rxLossPercent: i.rxLossPercent || 0,
+      txLossPercent: i.txLossPercent || 0,
+      lossFmt: Math.max(i.rxLossPercent || 0, i.txLossPercent || 0).toFixed(2) + '%'
     }))
   },
 
   getProcessList() {
     if (!native) return null
-    const p = native.getProcessList(), totalMem = native.getMemoryInfo().total
-    const list = (p.processes || []).map(proc => ({
-      pid: proc.pid,
-      name: proc.name,
-      memory: formatBytes(proc.memory),
-      memoryRaw: proc.memory,
-      memPercent: ((proc.memory / totalMem) * 100).toFixed(1) + '%',
-      memPercentRaw: (proc.memory / totalMem) * 100,
-      threads: proc.threads || 0,
-      handles: proc.handles || 0,
-      cpu: (proc.cpu || 0).toFixed(1) + '%',
-      cpuRaw: proc.cpu || 0
-    }))
+    let s = anomalyReads ? null : sharedFresh('proc', true)
+    // A list the publisher had to truncate is collected locally
+    if (s && s.procs.length !== s.procTotal) s = null
+    const p = s ? { count: s.procs.length, processes: s.procs, sampleAge: s.ages.proc }
+      : native.getProcessList()
+    const totalMem = s ? s.mem.total : native.getMemoryInfo().total
+    const list = processRows(p.processes || [], totalMem)
     
     // Sort by memory for topMem
     const topMem = [...list].sort((a, b) => b.memoryRaw - a.memoryRaw).slice(0, 15)
     // Sort by CPU for topCpu
     const topCpu = [...list].sort((a, b) => b.cpuRaw - a.cpuRaw).slice(0, 15)
     
-    return { count: p.count, list, topMem, topCpu }
+    return { count: p.count, list, topMem, topCpu, sampleInterval: p.sampleInterval, sampleAge: p.sampleAge, shared: !!s }
+  },
+
+  // Per-thread CPU of one process; the first call for a pid only sets the baseline
+  getProcessThreads(pid) {
+    if (!native) return { pid, found: false, threads: [] }
+    const r = native.getProcessThreads(pid)
+    return {
+      ...r,
+      threads: r.threads.map(t => ({ ...t, cpuFmt: t.cpu.toFixed(1) + '%' }))
+    }
+  },
+
+  // Open handles of one process grouped by type/target, with changes since the previous call
+  getProcessHandles(pid, opts = {}) {
+    if (!native) return { pid, found: false, byType: [], groups: [], changes: [] }
+    return native.getProcessHandles(pid, opts)
+  },
+
+  // Largest directories/files under root, walked on native worker threads.
+  // Returns { id, result: Promise, cancel() }; a cancelled scan resolves with partial totals.
+  scanDirectory(root, opts = {}) {
+    if (!native) return { id: 0, result: Promise.resolve({ root, found: false, topDirs: [], topFiles: [] }), cancel() {} }
+    const { id, result } = native.scanDirectory(root, opts)
+    return {
+      id,
+      cancel: () => native.cancelScan(id),
+      result: result.then(r => ({
+        ...r,
+        bytesFmt: formatBytes(r.bytes),
+        topDirs: r.topDirs.map(d => ({ ...d, sizeFmt: formatBytes(d.size) })),
+        topFiles: r.topFiles.map(f => ({ ...f, sizeFmt: formatBytes(f.size) }))
+      }))
+    }
+  },
+
+  // Path, command line, user and start time of one process (cached per process lifetime)
+  getProcessDetails(pid) {
+    if (!native) return null
+    return native.getProcessDetails(pid)
+  },
+
+  // Leak / anomaly events raised while getProcessList samples processes
+  getAnomalyEvents() {
+    if (!native) return { events: [], tracked: 0, dropped: 0 }
+    anomalyReads = true
+    const r = native.getAnomalyEvents()
+    return {
+      events: r.events.map(e => ({
+        ...e,
+        valueFmt: e.type === 'memoryGrowth' ? e.value.toFixed(1) + ' MB/h' :
+          e.type === 'cpuSpike' ? e.value.toFixed(1) + '%' : '+' + e.value.toFixed(0)
+      })),
+      tracked: r.tracked,
+      dropped: r.dropped
+    }
+  },
+
+  setAnomalyOptions(opts) {
+    if (!native) return null
+    return native.setAnomalyOptions(opts || {})
+  },
+
+  // Alert rules, e.g. "cpu.total > 90 for 30s", "disk['C:'].usedPercent > 95"
+  addAlertRule(id, expr) {
+    if (!native) return { ok: false, error: 'native module not loaded' }
+    return native.addAlertRule(id, expr)
+  },
+
+  removeAlertRule(id) {
+    if (!native) return false
+    return native.removeAlertRule(id)
+  },
+
+  getAlertRules() {
+    if (!native) return []
+    return native.getAlertRules()
+  },
+
+  // callback({ id, expr, state: 'fired' | 'resolved', value, time }), null to detach
+  setAlertCallback(callback) {
+    if (!native) return false
+    return native.setAlertCallback(callback || null)
+  },
+
+  setAlertLog(path) {
+    if (!native) return false
+    return native.setAlertLog(path || null)
+  },
+
+  getAllocatorStats() {
+    if (!native) return null
+    return native.getAllocatorStats()
+  },
+
+  getSelfStats(reset = false) {
+    if (!native) return null
+    return native.getSelfStats(!!reset)
+  },
+
+  // Adaptive sampling: collectors return their previous result until their interval is due
+  getSchedule() {
+    if (!native) return null
+    return native.getSchedule()
+  },
+
+  setSchedule(opts) {
+    if (!native) return null
+    return native.setSchedule(opts || {})
+  },
+
+  // Record raw OS tables to an archive, or serve collectors from one:
+  // { mode: 'record' | 'play' | 'off', path, loop }
+  setReplay(opts) {
+    if (!native) return null
+    return native.setReplay(opts)
+  },
+
+  // Stream this machine's metrics to an aggregator: { target: 'host:port' | 'unix:path', host, interval }
+  setStream(opts) {
+    if (!native) return null
+    return native.setStream(opts)
+  },
+
+  // Receive agent streams: { listen: 'addr:port' | 'unix:path' | null }
+  setAggregator(opts) {
+    if (!native) return null
+    return native.setAggregator(opts)
+  },
+
+  getAggregatedHosts(opts = {}) {
+    if (!native) return []
+    return native.getAggregatedHosts(opts).map(h => ({
+      ...h,
+      memUsedFmt: formatBytes(h.memUsed),
+      bytesPerSecFmt: formatBytes(h.bytesPerSec) + '/s'
+    }))
+  },
+
+  // Loopback load test for the aggregator: { target, agents, seconds, interval, procs }
+  simulateAgents(opts) {
+    if (!native) return Promise.resolve(null)
+    return native.simulateAgents(opts)
+  },
+
+  // Percentiles / min / max / mean of a metric over any window, from native sketches:
+  // queryMetric('cpu.total', { window: 3600000, percentiles: [50, 99] })
+  queryMetric(metric, opts = {}) {
+    if (!native) return null
+    return native.queryMetric(metric, opts)
+  },
+
+  // Chart points for any window sized to the chart width: { times, values } as Float64Arrays
+  downsample(metric, from, to, width, opts = {}) {
+    if (!native) return { metric, found: false, from, to, times: new Float64Array(0), values: new Float64Array(0) }
+    return native.downsample(metric, from, to, width, opts)
+  },
+
+  getMetricNames() {
+    if (!native) return []
+    return native.getMetricNames()
+  },
+
+  // Share one sampler between instances via a named segment:
+  // { mode: 'auto' | 'publish' | 'attach' | 'off', name }
+  // Unless the mode is 'off', getCpuUsage / getProcessList of a reader serve the segment
+  setSharedSnapshot(opts) {
+    if (!native) return null
+    const status = native.setSharedSnapshot(opts)
+    sharedReads = status.mode !== 'off'
+    return status
+  },
+
+  // Latest published snapshot (+ last n host samples) without collecting: { history: n, procs }
+  getSharedSnapshot(opts = {}) {
+    if (!native) return { found: false, role: 'off' }
+    const r = native.getSharedSnapshot(opts)
+    if (!r.found) return r
+    return {
+      ...r,
+      mem: { ...r.mem, usedFmt: formatBytes(r.mem.used), totalFmt: formatBytes(r.mem.total) }
+    }
+  },
+
+  // Static inventory served from disk at startup: { enabled, path, refreshDelay, clear }
+  getInventoryCache() {
+    if (!native) return null
+    return native.getInventoryCache()
+  },
+
+  // onRefresh({ getSystemInfo, getCpuInfo, getGpuInfo, getMemoryHardware }) receives the
+  // formatted fresh values of the exports first answered from the file
+  setInventoryCache(opts) {
+    if (!native) return null
+    if (opts && typeof opts.onRefresh === 'function') {
+      const onRefresh = opts.onRefresh
+      opts = { ...opts, onRefresh: raw => {
+        const fresh = {}
+        for (const name of Object.keys(raw)) if (inventoryFormats[name]) fresh[name] = inventoryFormats[name](raw[name])
+        onRefresh(fresh)
+      } }
+    }
+    return native.setInventoryCache(opts)
+  },
+
+  // Energy meters (RAPL via EMI), battery rate and per-process energy: { procs }
+  getPowerInfo(opts) {
+    if (!native) return { available: false, meters: [], package: null, core: null, dram: null, gpu: null, battery: null, processes: [], interval: 0, error: null }
+    return native.getPowerInfo(opts || {})
+  },
+
+  // TCP health per remote host for the given pid(s); needs admin for RTT/retransmits
+  getConnectionQuality(pids) {
+    if (!native) return { watched: [], enabled: false, window: 0, connections: 0, untracked: 0, hosts: [] }
+    const r = native.getConnectionQuality(pids)
+    return {
+      ...r,
+      hosts: r.hosts.map(h => ({
+        ...h,
+        rttFmt: h.rtt == null ? '-' : h.rtt.toFixed(0) + ' ms',
+        bytesInSecFmt: formatBytes(h.bytesInSec) + '/s',
+        bytesOutSecFmt: formatBytes(h.bytesOutSec) + '/s'
+      }))
+    }
+  },
+
+  // Listening socket index: O(1) by port / pid, plus a change feed
+  findPortOwner(port, protocol) {
+    if (!native) return { port, inUse: false, owners: [], indexAge: 0 }
+    return native.findPortOwner(port, protocol)
+  },
+
+  getListeningPorts(pid) {
+    if (!native) return []
+    return pid == null ? native.getListeningPorts() : native.getListeningPorts(pid)
+  },
+
+  getListeningChanges(since = 0) {
+    if (!native) return { seq: 0, truncated: false, changes: [] }
+    return native.getListeningChanges(since)
   },
 
   getNetworkConnections() {
     if (!native) return { tcp: [], udp: [], byProcess: [] }
     const data = native.getNetworkConnections()
     
-    // Group by process for summary
-    const byProcess = {}
-    const allConns = [...data.tcp, ...data.udp]
-    
-    allConns.forEach(conn => {
-      const key = conn.pid
-      if (!byProcess[key]) {
-        byProcess[key] = {
-          pid: conn.pid,
-          process: conn.process || 'Unknown',
-          tcp: 0,
-          udp: 0,
-          established: 0,
-          listening: 0
-        }
-      }
-      
-      if (conn.protocol === 'TCP') {
-        byProcess[key].tcp++
-        if (conn.state === 'ESTABLISHED') byProcess[key].established++
-        if (conn.state === 'LISTENING') byProcess[key].listening++
-      } else {
-        byProcess[key].udp++
-      }
-    })
-    
-    const byProcessArray = Object.values(byProcess)
-      .sort((a, b) => (b.tcp + b.udp) - (a.tcp + a.udp))
-    
+    // Per-process summary and totals are tallied natively in the same pass
     return {
       tcp: data.tcp,
       udp: data.udp,
-      byProcess: byProcessArray,
-      totalTcp: data.tcp.length,
-      totalUdp: data.udp.length,
-      totalEstablished: data.tcp.filter(c => c.state === 'ESTABLISHED').length,
-      totalListening: data.tcp.filter(c => c.state === 'LISTENING').length
+      byProcess: data.byProcess.map(p => ({ ...p, process: p.process || 'Unknown' })),
+      totalTcp: data.totalTcp,
+      totalUdp: data.totalUdp,
+      totalEstablished: data.totalEstablished,
+      totalListening: data.totalListening,
+      sampleInterval: data.sampleInterval,
+      sampleAge: data.sampleAge
     }
   }
 }
@@ -0,0 +1,477 @@
+#include "aggregator.h"
+#include "wire.h"
+#include <ws2tcpip.h>
+#include <afunix.h>
+#include <windows.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+static const uint32_t MAX_CONNS = 16384;
+static const size_t MAX_HOSTS = 16384;
+static const uint64_t HOST_EXPIRE_MS = 3600 * 1000;
+static const size_t RECV_CHUNK = 4096;
+static const ULONG_PTR KEY_IO = 1;
+static const ULONG COMPLETION_BATCH = 64;
+
+struct AggHost;
+
+struct AggConn {
+    OVERLAPPED ov;          // first member: completions map back to the connection
+    SOCKET sock = INVALID_SOCKET;
+    std::vector<uint8_t> buf;
+    size_t used = 0;
+    bool reading = false;
+    AggHost* host = nullptr;
+};
+
+struct AggHost {
+    WireDecoder dec;
+    AggConn* conn = nullptr;        // null while disconnected
+    uint64_t lastSeen = 0, connectedAt = 0;
+    uint64_t bytes = 0, connBytes = 0;
+};
+
+// Host table, shared between the I/O thread and JS
+static std::mutex aggLock;
+static std::unordered_map<std::string, AggHost*> hosts;
+static uint64_t totalFrames = 0, totalBytes = 0, protocolErrors = 0;
+
+// Owned by the I/O thread
+static std::unordered_set<AggConn*> conns;
+
+static SOCKET listener = INVALID_SOCKET;
+static HANDLE iocp = nullptr;
+static std::thread ioThread, acceptThread;
+static std::atomic<bool> stopping{false};
+static std::atomic<uint32_t> connCount{0};
+static std::string listenTarget, lastError;
+static uint32_t listenPort = 0;
+static bool cleanupHooked = false;
+
+static void CloseConn(AggConn* c) {
+    {
+        std::lock_guard<std::mutex> guard(aggLock);
+        if (c->host && c->host->conn == c) c->host->conn = nullptr;
+    }
+    if (c->sock != INVALID_SOCKET) closesocket(c->sock);
+    conns.erase(c);
+    connCount = (uint32_t)conns.size();
+    delete c;
+}
+
+static void PostRecv(AggConn* c) {
+    if (c->buf.size() - c->used < RECV_CHUNK) {
+        size_t size = c->buf.empty() ? RECV_CHUNK * 2 : c->buf.size() * 2;
+        if (size > WIRE_MAX_MESSAGE + 16) size = WIRE_MAX_MESSAGE + 16;
+        if (size <= c->used) {
+            CloseConn(c);
+            return;
+        }
+        c->buf.resize(size);
+    }
+    WSABUF wb = { (ULONG)(c->buf.size() - c->used), (char*)c->buf.data() + c->used };
+    DWORD flags = 0;
+    memset(&c->ov, 0, sizeof(c->ov));
+    c->reading = true;
+    if (WSARecv(c->sock, &wb, 1, nullptr, &flags, &c->ov, nullptr) == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING) {
+        c->reading = false;
+        CloseConn(c);
+    }
+}
+
+// HELLO binds the connection to its host entry; a host that reconnects
+// takes its entry over from the stale connection
+static bool Attach(AggConn* c, const uint8_t* msg, uint32_t len, uint64_t now) {
+    WireDecoder hello;
+    if (msg[0] != WIRE_HELLO || !hello.Decode(msg, len)) return false;
+    auto it = hosts.find(hello.host);
+    AggHost* h;
+    if (it != hosts.end()) {
+        h = it->second;
+    } else {
+        if (hosts.size() >= MAX_HOSTS) return false;
+        h = new AggHost();
+        hosts.emplace(hello.host, h);
+    }
+    if (h->conn && h->conn != c) {
+        AggConn* old = h->conn;
+        old->host = nullptr;
+        closesocket(old->sock);         // its pending read fails and frees it
+        old->sock = INVALID_SOCKET;
+    }
+    h->dec.Decode(msg, len);
+    h->conn = c;
+    h->connectedAt = now;
+    h->connBytes = 0;
+    c->host = h;
+    return true;
+}
+
+// Decodes every complete message in the buffer
+static bool Consume(AggConn* c, DWORD received) {
+    uint64_t now = GetTickCount64();
+    size_t off = 0;
+    std::lock_guard<std::mutex> guard(aggLock);
+    totalBytes += received;
+    if (c->host) {
+        c->host->bytes += received;
+        c->host->connBytes += received;
+    }
+    for (;;) {
+        uint32_t len;
+        size_t header;
+        int r = WirePeek(c->buf.data() + off, c->used - off, len, header);
+        if (r < 0) return false;
+        if (r == 0 || c->used - off < header + len) break;
+        const uint8_t* msg = c->buf.data() + off + header;
+        if (!c->host) {
+            if (!Attach(c, msg, len, now)) return false;
+        } else if (!c->host->dec.Decode(msg, len)) {
+            return false;
+        }
+        c->host->lastSeen = now;
+        totalFrames++;
+        off += header + len;
+    }
+    if (off) {
+        memmove(c->buf.data(), c->buf.data() + off, c->used - off);
+        c->used -= off;
+    }
+    return true;
+}
+
+static void IoLoop() {
+    OVERLAPPED_ENTRY entries[COMPLETION_BATCH];
+    bool quit = false;
+    while (!quit) {
+        ULONG count = 0;
+        if (!GetQueuedCompletionStatusEx(iocp, entries, COMPLETION_BATCH, &count, INFINITE, FALSE)) break;
+        for (ULONG i = 0; i < count; i++) {
+            OVERLAPPED_ENTRY& e = entries[i];
+            if (!e.lpOverlapped) {
+                if (e.lpCompletionKey == 0) {
+                    quit = true;
+                } else {
+                    // New socket from the accept thread
+                    AggConn* c = (AggConn*)e.lpCompletionKey;
+                    conns.insert(c);
+                    connCount = (uint32_t)conns.size();
+                    PostRecv(c);
+                }
+                continue;
+            }
+            AggConn* c = (AggConn*)e.lpOverlapped;
+            c->reading = false;
+            DWORD n = e.dwNumberOfBytesTransferred;
+            // Internal holds the NTSTATUS of the read; 0 bytes is an orderly close
+            if (e.lpOverlapped->Internal != 0 || n == 0 || c->sock == INVALID_SOCKET) {
+                CloseConn(c);
+                continue;
+            }
+            c->used += n;
+            if (Consume(c, n)) {
+                PostRecv(c);
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> guard(aggLock);
+                protocolErrors++;
+            }
+            CloseConn(c);
+        }
+    }
+
+    // Close everything, then wait for the cancelled reads before freeing
+    for (auto* c : conns) {
+        if (c->sock != INVALID_SOCKET) closesocket(c->sock);
+        c->sock = INVALID_SOCKET;
+    }
+    size_t reading = 0;
+    for (auto* c : conns) reading += c->reading;
+    while (reading) {
+        ULONG count = 0;
+        if (!GetQueuedCompletionStatusEx(iocp, entries, COMPLETION_BATCH, &count, 1000, FALSE)) break;
+        for (ULONG i = 0; i < count; i++) {
+            if (entries[i].lpOverlapped && reading) {
+                ((AggConn*)entries[i].lpOverlapped)->reading = false;
+                reading--;
+            }
+        }
+    }
+    std::vector<AggConn*> all(conns.begin(), conns.end());
+    for (auto* c : all) CloseConn(c);
+}
+
+static void AcceptLoop() {
+    while (!stopping) {
+        SOCKET s = accept(listener, nullptr, nullptr);
+        if (s == INVALID_SOCKET) {
+            if (!stopping) Sleep(10);       // out of sockets or similar: back off
+            continue;
+        }
+        if (connCount >= MAX_CONNS || !CreateIoCompletionPort((HANDLE)s, iocp, KEY_IO, 0)) {
+            closesocket(s);
+            continue;
+        }
+        AggConn* c = new AggConn();
+        c->sock = s;
+        if (!PostQueuedCompletionStatus(iocp, 0, (ULONG_PTR)c, nullptr)) {
+            closesocket(s);
+            delete c;
+        }
+    }
+}
+
+static void Stop() {
+    if (!iocp) return;
+    stopping = true;
+    if (listener != INVALID_SOCKET) closesocket(listener);
+    listener = INVALID_SOCKET;
+    if (acceptThread.joinable()) acceptThread.join();
+    PostQueuedCompletionStatus(iocp, 0, 0, nullptr);
+    if (ioThread.joinable()) ioThread.join();
+    CloseHandle(iocp);
+    iocp = nullptr;
+
+    std::lock_guard<std::mutex> guard(aggLock);
+    for (auto& h : hosts) delete h.second;
+    hosts.clear();
+    totalFrames = totalBytes = protocolErrors = 0;
+    listenPort = 0;
+}
+
+static bool Start(const std::string& target) {
+    sockaddr_storage addr;
+    int addrLen = 0;
+    if (!WireStartup() || !WireResolve(target, addr, addrLen)) {
+        lastError = "cannot resolve listen address";
+        return false;
+    }
+    if (addr.ss_family == AF_UNIX) DeleteFileA(((SOCKADDR_UN*)&addr)->sun_path);    // stale socket file
+    listener = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (listener == INVALID_SOCKET || bind(listener, (const sockaddr*)&addr, addrLen) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        lastError = "cannot listen";
+        if (listener != INVALID_SOCKET) closesocket(listener);
+        listener = INVALID_SOCKET;
+        return false;
+    }
+    if (addr.ss_family != AF_UNIX) {
+        sockaddr_storage bound;
+        int boundLen = sizeof(bound);
+        if (getsockname(listener, (sockaddr*)&bound, &boundLen) == 0) {
+            listenPort = ntohs(bound.ss_family == AF_INET6 ? ((sockaddr_in6*)&bound)->sin6_port
+                                                           : ((sockaddr_in*)&bound)->sin_port);
+        }
+    }
+    iocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!iocp) {
+        lastError = "cannot create completion port";
+        closesocket(listener);
+        listener = INVALID_SOCKET;
+        return false;
+    }
+    stopping = false;
+    ioThread = std::thread(IoLoop);
+    acceptThread = std::thread(AcceptLoop);
+    return true;
+}
+
+static void CleanupAggregator(void*) {
+    Stop();
+}
+
+static uint64_t ThreadCpuMs(std::thread& t) {
+    FILETIME created, exited, kernel, user;
+    if (!t.joinable() || !GetThreadTimes((HANDLE)t.native_handle(), &created, &exited, &kernel, &user)) return 0;
+    uint64_t k = ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+    uint64_t u = ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+    return (k + u) / 10000;
+}
+
+static napi_value Status(napi_env env) {
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_get_boolean(env, iocp != nullptr, &v); napi_set_named_property(env, result, "listening", v);
+    if (listenTarget.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, listenTarget.c_str(), listenTarget.size(), &v);
+    napi_set_named_property(env, result, "listen", v);
+    napi_create_uint32(env, listenPort, &v); napi_set_named_property(env, result, "port", v);
+    napi_create_uint32(env, connCount.load(), &v); napi_set_named_property(env, result, "connections", v);
+    {
+        std::lock_guard<std::mutex> guard(aggLock);
+        napi_create_uint32(env, (uint32_t)hosts.size(), &v); napi_set_named_property(env, result, "hosts", v);
+        napi_create_double(env, (double)totalFrames, &v); napi_set_named_property(env, result, "frames", v);
+        napi_create_double(env, (double)totalBytes, &v); napi_set_named_property(env, result, "bytes", v);
+        napi_create_double(env, (double)protocolErrors, &v); napi_set_named_property(env, result, "errors", v);
+    }
+    napi_create_double(env, (double)ThreadCpuMs(ioThread), &v); napi_set_named_property(env, result, "cpuMs", v);
+    if (lastError.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, lastError.c_str(), lastError.size(), &v);
+    napi_set_named_property(env, result, "error", v);
+    return result;
+}
+
+napi_value SetAggregator(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type != napi_object) return Status(env);
+
+    std::string target;
+    bool has = false;
+    napi_value v;
+    size_t len = 0;
+    if (napi_has_named_property(env, argv[0], "listen", &has) == napi_ok && has) {
+        napi_get_named_property(env, argv[0], "listen", &v);
+        if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) == napi_ok) {
+            target.resize(len);
+            napi_get_value_string_utf8(env, v, &target[0], len + 1, &len);
+        }
+    }
+
+    Stop();
+    lastError.clear();
+    listenTarget = target;
+    if (!target.empty() && !Start(target)) listenTarget.clear();
+    if (iocp && !cleanupHooked) {
+        napi_add_env_cleanup_hook(env, CleanupAggregator, nullptr);
+        cleanupHooked = true;
+    }
+    return Status(env);
+}
+
+static void SetValue(napi_env env, napi_value obj, const WireField& field, int64_t q) {
+    napi_value v;
+    double value = WireValue(q, field.scale);
+    if (isnan(value)) napi_get_null(env, &v);
+    else napi_create_double(env, value, &v);
+    napi_set_named_property(env, obj, field.name, v);
+}
+
+static const char* DictName(const WireDecoder& dec, int64_t id) {
+    return id >= 0 && (uint64_t)id < dec.dict.size() ? dec.dict[(size_t)id].c_str() : "";
+}
+
+// Disk and net rows: keyed by their name id
+static napi_value NamedRows(napi_env env, const WireDecoder& dec, int list, const char* keyName) {
+    napi_value arr, item, v;
+    napi_create_array(env, &arr);
+    std::vector<std::pair<const char*, const WireRow*>> rows;
+    for (auto& r : dec.rows[list]) rows.push_back({ DictName(dec, (int64_t)r.first), &r.second });
+    std::sort(rows.begin(), rows.end(), [](const std::pair<const char*, const WireRow*>& a,
+                                           const std::pair<const char*, const WireRow*>& b) {
+        return strcmp(a.first, b.first) < 0;
+    });
+    uint32_t idx = 0;
+    for (auto& r : rows) {
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, r.first, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, keyName, v);
+        for (int f = 0; f < wireListFieldCount[list]; f++) SetValue(env, item, wireListFields[list][f], r.second->f[f]);
+        napi_set_element(env, arr, idx++, item);
+    }
+    return arr;
+}
+
+static napi_value HostObject(napi_env env, const std::string& name, const AggHost* h, uint32_t topProcs, uint64_t now) {
+    const WireDecoder& dec = h->dec;
+    napi_value obj, v;
+    napi_create_object(env, &obj);
+    napi_create_string_utf8(env, name.c_str(), name.size(), &v); napi_set_named_property(env, obj, "host", v);
+    napi_get_boolean(env, h->conn != nullptr, &v); napi_set_named_property(env, obj, "connected", v);
+    napi_create_double(env, (double)(now - h->lastSeen), &v); napi_set_named_property(env, obj, "lastSeen", v);
+    napi_create_uint32(env, dec.intervalMs, &v); napi_set_named_property(env, obj, "interval", v);
+    napi_create_double(env, (double)dec.frames, &v); napi_set_named_property(env, obj, "frames", v);
+    napi_create_double(env, (double)dec.keyframes, &v); napi_set_named_property(env, obj, "keyframes", v);
+    napi_create_double(env, (double)h->bytes, &v); napi_set_named_property(env, obj, "bytes", v);
+    double rate = h->conn && now > h->connectedAt ? h->connBytes * 1000.0 / (now - h->connectedAt) : 0;
+    napi_create_double(env, rate, &v); napi_set_named_property(env, obj, "bytesPerSec", v);
+    for (int i = 0; i < WIRE_HOST_FIELDS; i++) SetValue(env, obj, wireHostFields[i], dec.hostFields[i]);
+
+    napi_set_named_property(env, obj, "disks", NamedRows(env, dec, WIRE_DISK, "fs"));
+    napi_set_named_property(env, obj, "net", NamedRows(env, dec, WIRE_NET, "name"));
+
+    const auto& procRows = dec.rows[WIRE_PROC];
+    napi_create_uint32(env, (uint32_t)procRows.size(), &v); napi_set_named_property(env, obj, "procCount", v);
+    std::vector<std::pair<uint64_t, const WireRow*>> procs;
+    if (topProcs) for (auto& r : procRows) procs.push_back({ r.first, &r.second });
+    size_t n = std::min<size_t>(topProcs, procs.size());
+    // Field 1 is cpu
+    std::partial_sort(procs.begin(), procs.begin() + n, procs.end(),
+                      [](const std::pair<uint64_t, const WireRow*>& a, const std::pair<uint64_t, const WireRow*>& b) {
+                          return a.second->f[1] > b.second->f[1];
+                      });
+    napi_value arr, item;
+    napi_create_array(env, &arr);
+    const WireField* fields = wireListFields[WIRE_PROC];
+    for (size_t i = 0; i < n; i++) {
+        napi_create_object(env, &item);
+        napi_create_double(env, (double)procs[i].first, &v); napi_set_named_property(env, item, "pid", v);
+        napi_create_string_utf8(env, DictName(dec, procs[i].second->f[0]), NAPI_AUTO_LENGTH, &v);
+        napi_set_named_property(env, item, "name", v);
+        for (int f = 1; f < wireListFieldCount[WIRE_PROC]; f++) SetValue(env, item, fields[f], procs[i].second->f[f]);
+        napi_set_element(env, arr, (uint32_t)i, item);
+    }
+    napi_set_named_property(env, obj, "procs", arr);
+    return obj;
+}
+
+napi_value GetAggregatedHosts(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    std::string only;
+    uint32_t topProcs = 0;
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) {
+        bool has = false;
+        napi_value v;
+        size_t len = 0;
+        if (napi_has_named_property(env, argv[0], "host", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "host", &v);
+            if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) == napi_ok) {
+                only.resize(len);
+                napi_get_value_string_utf8(env, v, &only[0], len + 1, &len);
+            }
+        }
+        if (napi_has_named_property(env, argv[0], "procs", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "procs", &v);
+            napi_get_value_uint32(env, v, &topProcs);
+        }
+    }
+
+    uint64_t now = GetTickCount64();
+    napi_value result;
+    napi_create_array(env, &result);
+    std::lock_guard<std::mutex> guard(aggLock);
+    std::vector<const std::string*> names;
+    for (auto it = hosts.begin(); it != hosts.end();) {
+        AggHost* h = it->second;
+        if (!h->conn && now - h->lastSeen >= HOST_EXPIRE_MS) {
+            delete h;
+            it = hosts.erase(it);
+            continue;
+        }
+        if (only.empty() || it->first == only) names.push_back(&it->first);
+        ++it;
+    }
+    std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+    uint32_t idx = 0;
+    for (auto* name : names) {
+        napi_set_element(env, result, idx++, HostObject(env, *name, hosts[*name], topProcs, now));
+    }
+    return result;
+}
@@ -0,0 +1,25 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include <node_api.h>
+
+// Central side of the metrics stream (protocol in wire.h): accepts agent
+// connections and keeps the latest decoded state of every host in memory.
+// All sockets are serviced by one I/O completion port thread; an accept
+// thread only hands new sockets to it, so thousands of mostly idle agent
+// streams cost one completion per frame and no per-connection thread.
+//
+// setAggregator({ listen: 'addr:port' | 'unix:path' | null }) -> status
+//   { listening, listen, port, connections, hosts, frames, bytes, errors,
+//     cpuMs, error }; port 0 picks a free port. setAggregator() only
+//   returns the status.
+napi_value SetAggregator(napi_env env, napi_callback_info info);
+
+// getAggregatedHosts({ host, procs }) -> [{ host, connected, lastSeen,
+//   interval, frames, keyframes, bytes, bytesPerSec, cpu, mem..., disks[],
+//   net[], procCount, procs[] }]
+// lastSeen is ms since the last frame. procs lists the N busiest processes
+// (default 0). Hosts gone for HOST_EXPIRE_MS are dropped.
+napi_value GetAggregatedHosts(napi_env env, napi_callback_info info);
+
+#endif // AGGREGATOR_H
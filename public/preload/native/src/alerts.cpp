@@ -0,0 +1,658 @@
+#include "alerts.h"
+#include "snapshot.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+// ---- Compiled rule representation ----
+
+enum MetricField { F_TOTAL, F_USED, F_FREE, F_USED_PERCENT, F_COMMITTED, F_SWAP_USED, F_SIZE,
+                   F_RX_SEC, F_TX_SEC, F_UTILIZATION, F_CPU, F_MEMORY, F_HANDLES, F_THREADS, F_COUNT,
+                   F_CPU_TEMP, F_CPU_FREQ, F_CPU_PERF, F_PERF_LIMIT,
+                   F_PAGE_FAULTS, F_HARD_FAULTS, F_PAGES, F_RUN_QUEUE, F_DISK_QUEUE, F_TIME_TO_FULL };
+
+struct FieldDef { uint32_t section; const char* name; MetricField field; };
+static const FieldDef fieldDefs[] = {
+    { SNAP_CPU, "total", F_TOTAL },
+    { SNAP_MEM, "total", F_TOTAL },
+    { SNAP_MEM, "used", F_USED },
+    { SNAP_MEM, "free", F_FREE },
+    { SNAP_MEM, "usedPercent", F_USED_PERCENT },
+    { SNAP_MEM, "committed", F_COMMITTED },
+    { SNAP_MEM, "swapUsed", F_SWAP_USED },
+    { SNAP_DISK, "size", F_SIZE },
+    { SNAP_DISK, "used", F_USED },
+    { SNAP_DISK, "free", F_FREE },
+    { SNAP_DISK, "usedPercent", F_USED_PERCENT },
+    { SNAP_DISK, "timeToFull", F_TIME_TO_FULL },
+    { SNAP_NET, "rxSec", F_RX_SEC },
+    { SNAP_NET, "txSec", F_TX_SEC },
+    { SNAP_NET, "utilization", F_UTILIZATION },
+    { SNAP_PROC, "cpu", F_CPU },
+    { SNAP_PROC, "memory", F_MEMORY },
+    { SNAP_PROC, "handles", F_HANDLES },
+    { SNAP_PROC, "threads", F_THREADS },
+    { SNAP_PROC, "count", F_COUNT },
+    { SNAP_SENSOR, "cpuTemp", F_CPU_TEMP },
+    { SNAP_SENSOR, "cpuFreq", F_CPU_FREQ },
+    { SNAP_SENSOR, "cpuPerf", F_CPU_PERF },
+    { SNAP_SENSOR, "perfLimit", F_PERF_LIMIT },
+    { SNAP_PRESSURE, "pageFaultsSec", F_PAGE_FAULTS },
+    { SNAP_PRESSURE, "hardFaultsSec", F_HARD_FAULTS },
+    { SNAP_PRESSURE, "pagesSec", F_PAGES },
+    { SNAP_PRESSURE, "runQueue", F_RUN_QUEUE },
+    { SNAP_PRESSURE, "diskQueue", F_DISK_QUEUE },
+};
+
+struct SectionDef { const char* name; uint32_t section; };
+static const SectionDef sectionDefs[] = {
+    { "cpu", SNAP_CPU }, { "mem", SNAP_MEM }, { "disk", SNAP_DISK }, { "net", SNAP_NET }, { "proc", SNAP_PROC },
+    { "sensor", SNAP_SENSOR }, { "pressure", SNAP_PRESSURE },
+};
+
+enum SelectorKind { SEL_ALL, SEL_KEY, SEL_NAME, SEL_PID, SEL_USER, SEL_PATH, SEL_CMDLINE };
+
+struct MetricRef {
+    uint32_t section;
+    MetricField field;
+    SelectorKind sel;
+    std::string key;        // disk / net key
+    std::string glob;       // proc name / user / path / cmdline pattern
+    uint32_t pid;
+};
+
+enum OpCode : uint8_t { OP_CMP, OP_AND, OP_OR };
+enum CmpKind : uint8_t { CMP_GT, CMP_GE, CMP_LT, CMP_LE, CMP_EQ, CMP_NE };
+
+// Comparisons are fused with their metric load, so a rule is a flat postfix program
+struct AlertOp {
+    OpCode op;
+    CmpKind cmp;
+    uint16_t metric;
+    double threshold;
+};
+
+struct AlertRule {
+    std::string id, expr;
+    std::vector<MetricRef> metrics;
+    std::vector<AlertOp> code;
+    uint32_t deps = 0;
+    double forMs = 0, resolveMs = 0, hysteresis = 0;
+    // Runtime state
+    bool active = false;
+    uint64_t pendingSince = 0, clearSince = 0;
+    double lastValue = NAN;
+    uint32_t fireCount = 0;
+};
+
+static const size_t MAX_OPS = 64;
+static const int MAX_DEPTH = 16;
+
+static std::vector<AlertRule> rules;
+static uint32_t neededSections = 0;
+
+// ---- Parser ----
+
+struct RuleParser {
+    const char* s;
+    size_t pos = 0;
+    int depth = 0;
+    std::string error;
+    AlertRule& rule;
+
+    RuleParser(const char* src, AlertRule& r) : s(src), rule(r) {}
+
+    bool Fail(const char* msg) {
+        if (error.empty()) error = msg;
+        return false;
+    }
+    void SkipWs() { while (s[pos] == ' ' || s[pos] == '\t') pos++; }
+    bool Accept(const char* lit) {
+        SkipWs();
+        size_t n = strlen(lit);
+        if (strncmp(s + pos, lit, n) != 0) return false;
+        pos += n;
+        return true;
+    }
+    // Keyword match that doesn't eat the prefix of a longer identifier
+    bool AcceptWord(const char* word) {
+        SkipWs();
+        size_t n = strlen(word);
+        if (strncmp(s + pos, word, n) != 0 || isalnum((unsigned char)s[pos + n]) || s[pos + n] == '_') return false;
+        pos += n;
+        return true;
+    }
+    bool Ident(std::string& out) {
+        SkipWs();
+        size_t start = pos;
+        if (!isalpha((unsigned char)s[pos]) && s[pos] != '_') return false;
+        while (isalnum((unsigned char)s[pos]) || s[pos] == '_') pos++;
+        out.assign(s + start, pos - start);
+        return true;
+    }
+    bool Number(double& out) {
+        SkipWs();
+        char* end = nullptr;
+        out = strtod(s + pos, &end);
+        if (end == s + pos) return false;
+        pos = end - s;
+        return true;
+    }
+    bool Duration(double& ms) {
+        if (!Number(ms)) return Fail("expected duration");
+        if (Accept("ms")) return true;
+        if (s[pos] == 'h') { pos++; ms *= 3600000; }
+        else if (s[pos] == 'm') { pos++; ms *= 60000; }
+        else { if (s[pos] == 's') pos++; ms *= 1000; }
+        return true;
+    }
+    // Selector value: quoted string or raw text up to ']'
+    bool SelectorValue(std::string& out) {
+        SkipWs();
+        char q = s[pos];
+        if (q == '\'' || q == '"') {
+            size_t start = ++pos;
+            while (s[pos] && s[pos] != q) pos++;
+            if (!s[pos]) return Fail("unterminated string");
+            out.assign(s + start, pos - start);
+            pos++;
+            return true;
+        }
+        size_t start = pos;
+        while (s[pos] && s[pos] != ']') pos++;
+        size_t end = pos;
+        while (end > start && (s[end - 1] == ' ' || s[end - 1] == '\t')) end--;
+        out.assign(s + start, end - start);
+        return !out.empty() || Fail("empty selector");
+    }
+
+    bool Metric(uint16_t& index) {
+        std::string name;
+        if (!Ident(name)) return Fail("expected metric");
+        MetricRef m = { 0, F_TOTAL, SEL_ALL, "", "", 0 };
+        for (auto& d : sectionDefs) if (name == d.name) m.section = d.section;
+        if (!m.section) return Fail("unknown metric group");
+
+        if (Accept("[")) {
+            if (m.section == SNAP_CPU || m.section == SNAP_MEM || m.section == SNAP_SENSOR ||
+                m.section == SNAP_PRESSURE) return Fail("selector not allowed here");
+            size_t save = pos;
+            std::string key, value;
+            if (Ident(key) && Accept("=")) {
+                if (!SelectorValue(value)) return false;
+                if (m.section == SNAP_PROC && key == "name") {
+                    m.sel = SEL_NAME;
+                    m.glob = value;
+                } else if (m.section == SNAP_PROC && key == "pid") {
+                    m.sel = SEL_PID;
+                    m.pid = (uint32_t)strtoul(value.c_str(), nullptr, 10);
+                } else if (m.section == SNAP_PROC && (key == "user" || key == "path" || key == "cmdline")) {
+                    m.sel = key == "user" ? SEL_USER : key == "path" ? SEL_PATH : SEL_CMDLINE;
+                    m.glob = value;
+                } else {
+                    return Fail("unknown selector key");
+                }
+            } else {
+                pos = save;
+                if (m.section == SNAP_PROC) return Fail("proc selector needs name=, pid=, user=, path= or cmdline=");
+                if (!SelectorValue(value)) return false;
+                m.sel = SEL_KEY;
+                m.key = value;
+            }
+            if (!Accept("]")) return Fail("expected ']'");
+        }
+
+        if (!Accept(".")) return Fail("expected '.'");
+        std::string field;
+        if (!Ident(field)) return Fail("expected field");
+        bool found = false;
+        for (auto& f : fieldDefs) {
+            if (f.section == m.section && field == f.name) { m.field = f.field; found = true; break; }
+        }
+        if (!found) return Fail("unknown field");
+
+        rule.deps |= m.section;
+        rule.metrics.push_back(m);
+        index = (uint16_t)(rule.metrics.size() - 1);
+        return true;
+    }
+
+    bool Emit(const AlertOp& op) {
+        if (rule.code.size() >= MAX_OPS) return Fail("rule too long");
+        rule.code.push_back(op);
+        return true;
+    }
+
+    bool Compare() {
+        if (Accept("(")) {
+            if (++depth > MAX_DEPTH) return Fail("nesting too deep");
+            if (!Or()) return false;
+            depth--;
+            return Accept(")") || Fail("expected ')'");
+        }
+        AlertOp op = { OP_CMP, CMP_GT, 0, 0 };
+        if (!Metric(op.metric)) return false;
+        if (Accept(">=")) op.cmp = CMP_GE;
+        else if (Accept("<=")) op.cmp = CMP_LE;
+        else if (Accept("==")) op.cmp = CMP_EQ;
+        else if (Accept("!=")) op.cmp = CMP_NE;
+        else if (Accept(">")) op.cmp = CMP_GT;
+        else if (Accept("<")) op.cmp = CMP_LT;
+        else return Fail("expected comparison operator");
+        if (!Number(op.threshold)) return Fail("expected number");
+        return Emit(op);
+    }
+
+    bool And() {
+        if (!Compare()) return false;
+        while (AcceptWord("and") || Accept("&&")) {
+            if (!Compare()) return false;
+            if (!Emit({ OP_AND, CMP_GT, 0, 0 })) return false;
+        }
+        return true;
+    }
+
+    bool Or() {
+        if (!And()) return false;
+        while (AcceptWord("or") || Accept("||")) {
+            if (!And()) return false;
+            if (!Emit({ OP_OR, CMP_GT, 0, 0 })) return false;
+        }
+        return true;
+    }
+
+    bool Rule() {
+        if (!Or()) return false;
+        // Trailing clauses: for <dur>, resolve <dur>, hysteresis <num>
+        for (;;) {
+            if (AcceptWord("for")) { if (!Duration(rule.forMs)) return false; }
+            else if (AcceptWord("resolve")) { if (!Duration(rule.resolveMs)) return false; }
+            else if (AcceptWord("hysteresis")) { if (!Number(rule.hysteresis)) return Fail("expected number"); }
+            else break;
+        }
+        SkipWs();
+        return !s[pos] || Fail("unexpected input");
+    }
+};
+
+// ---- Evaluation ----
+
+// Case-insensitive (ASCII) glob with * and ?
+static bool GlobMatch(const char* pat, const char* str) {
+    const char* star = nullptr;
+    const char* mark = nullptr;
+    while (*str) {
+        if (*pat == '?' || tolower((unsigned char)*pat) == tolower((unsigned char)*str)) { pat++; str++; }
+        else if (*pat == '*') { star = pat++; mark = str; }
+        else if (star) { pat = star + 1; str = ++mark; }
+        else return false;
+    }
+    while (*pat == '*') pat++;
+    return !*pat;
+}
+
+// "C:", "C:\" and "c" all name drive C; mounted folders match by path
+static bool DriveMatch(const char* fs, const std::string& key) {
+    if (fs[0] && fs[1] == ':' && fs[2] == 0) {
+        return !key.empty() && toupper((unsigned char)key[0]) == toupper((unsigned char)fs[0]) &&
+               (key.size() == 1 || key[1] == ':');
+    }
+    size_t len = key.size();
+    if (len > 1 && key[len - 1] == '\\') len--;
+    return strlen(fs) == len && _strnicmp(fs, key.c_str(), len) == 0;
+}
+
+static bool KeyMatch(const char* name, const std::string& key) {
+    return _stricmp(name, key.c_str()) == 0;
+}
+
+static inline void TakeMax(double& best, double v) { if (isnan(best) || v > best) best = v; }
+static inline void TakeMin(double& best, double v) { if (!isnan(v) && (isnan(best) || v < best)) best = v; }
+
+static double ReadMetric(const MetricRef& m) {
+    double best = NAN;
+    switch (m.section) {
+    case SNAP_CPU:
+        return snapshot.cpuTotal;
+    case SNAP_MEM:
+        switch (m.field) {
+        case F_TOTAL: return snapshot.memTotal;
+        case F_USED: return snapshot.memUsed;
+        case F_FREE: return snapshot.memFree;
+        case F_USED_PERCENT: return snapshot.memUsedPercent;
+        case F_COMMITTED: return snapshot.memCommitted;
+        case F_SWAP_USED: return snapshot.swapUsed;
+        default: return NAN;
+        }
+    case SNAP_SENSOR:
+        switch (m.field) {
+        case F_CPU_TEMP: return snapshot.cpuTemp;
+        case F_CPU_FREQ: return snapshot.cpuFreq;
+        case F_CPU_PERF: return snapshot.cpuPerf;
+        case F_PERF_LIMIT: return snapshot.cpuPerfLimit;
+        default: return NAN;
+        }
+    case SNAP_PRESSURE:
+        switch (m.field) {
+        case F_PAGE_FAULTS: return snapshot.pageFaultsSec;
+        case F_HARD_FAULTS: return snapshot.hardFaultsSec;
+        case F_PAGES: return snapshot.pagesSec;
+        case F_RUN_QUEUE: return snapshot.runQueue;
+        case F_DISK_QUEUE: return snapshot.diskQueue;
+        default: return NAN;
+        }
+    case SNAP_DISK:
+        for (auto& d : snapshot.disks) {
+            if (m.sel == SEL_KEY && !DriveMatch(d.fs, m.key)) continue;
+            // The volume closest to full is the one that matters
+            if (m.field == F_TIME_TO_FULL) { TakeMin(best, d.timeToFull); continue; }
+            TakeMax(best, m.field == F_SIZE ? d.size : m.field == F_USED ? d.used :
+                          m.field == F_FREE ? d.free : d.usedPercent);
+        }
+        return best;
+    case SNAP_NET:
+        for (auto& n : snapshot.net) {
+            if (m.sel == SEL_KEY && !KeyMatch(n.name, m.key)) continue;
+            TakeMax(best, m.field == F_RX_SEC ? n.rxSec : m.field == F_TX_SEC ? n.txSec : n.utilization);
+        }
+        return best;
+    case SNAP_PROC: {
+        uint32_t count = 0;
+        for (auto& p : snapshot.procs) {
+            if (m.sel == SEL_PID && p.pid != m.pid) continue;
+            if (m.sel == SEL_NAME && !GlobMatch(m.glob.c_str(), p.name)) continue;
+            if (m.sel >= SEL_USER) {
+                const char* text = m.sel == SEL_USER ? p.user : m.sel == SEL_PATH ? p.path : p.cmdline;
+                if (!GlobMatch(m.glob.c_str(), text ? text : "")) continue;
+            }
+            count++;
+            switch (m.field) {
+            case F_CPU: TakeMax(best, p.cpu); break;
+            case F_MEMORY: TakeMax(best, p.memory); break;
+            case F_HANDLES: TakeMax(best, p.handles); break;
+            case F_THREADS: TakeMax(best, p.threads); break;
+            default: break;
+            }
+        }
+        return m.field == F_COUNT ? (double)count : best;
+    }
+    }
+    return NAN;
+}
+
+static bool RunRule(AlertRule& r, double& firstValue) {
+    bool stack[MAX_OPS];
+    int sp = 0;
+    firstValue = NAN;
+    for (auto& op : r.code) {
+        if (op.op != OP_CMP) {
+            bool b = stack[--sp], a = stack[--sp];
+            stack[sp++] = op.op == OP_AND ? (a && b) : (a || b);
+            continue;
+        }
+        double v = ReadMetric(r.metrics[op.metric]);
+        if (isnan(firstValue)) firstValue = v;
+        // Hysteresis: once firing, the value must cross back past threshold -/+ margin
+        double t = op.threshold;
+        if (r.active) {
+            if (op.cmp == CMP_GT || op.cmp == CMP_GE) t -= r.hysteresis;
+            else if (op.cmp == CMP_LT || op.cmp == CMP_LE) t += r.hysteresis;
+        }
+        bool b = false;
+        if (!isnan(v)) {
+            switch (op.cmp) {
+            case CMP_GT: b = v > t; break;
+            case CMP_GE: b = v >= t; break;
+            case CMP_LT: b = v < t; break;
+            case CMP_LE: b = v <= t; break;
+            case CMP_EQ: b = v == t; break;
+            case CMP_NE: b = v != t; break;
+            }
+        }
+        stack[sp++] = b;
+    }
+    return sp > 0 && stack[sp - 1];
+}
+
+// ---- Event delivery (callback and/or log file) ----
+
+struct AlertEventData {
+    std::string id, expr;
+    const char* state;
+    double value;
+    uint64_t time;
+};
+
+static napi_threadsafe_function alertTsfn = nullptr;
+static uintptr_t alertTsfnId = 0;   // tells a replaced callback's finalizer from the current one
+static FILE* alertLog = nullptr;
+
+static uint64_t UnixTimeMs() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    ULONGLONG t = ((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000ULL) / 10000;
+}
+
+static void CallAlertJs(napi_env env, napi_value jsCb, void* context, void* data) {
+    AlertEventData* e = (AlertEventData*)data;
+    if (env && jsCb) {
+        napi_value ev, v, undefined;
+        napi_create_object(env, &ev);
+        napi_create_string_utf8(env, e->id.c_str(), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, ev, "id", v);
+        napi_create_string_utf8(env, e->expr.c_str(), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, ev, "expr", v);
+        napi_create_string_utf8(env, e->state, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, ev, "state", v);
+        napi_create_double(env, e->value, &v); napi_set_named_property(env, ev, "value", v);
+        napi_create_double(env, (double)e->time, &v); napi_set_named_property(env, ev, "time", v);
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, jsCb, 1, &ev, nullptr);
+    }
+    delete e;
+}
+
+// The pump thread may be evaluating rules while the env tears the function down
+static void AlertTsfnFinalized(napi_env, void* data, void*) {
+    std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+    if ((uintptr_t)data == alertTsfnId) alertTsfn = nullptr;
+}
+
+static void EmitEvent(const AlertRule& r, const char* state, double value) {
+    uint64_t now = UnixTimeMs();
+    if (alertLog) {
+        SYSTEMTIME st; GetLocalTime(&st);
+        fprintf(alertLog, "%04d-%02d-%02d %02d:%02d:%02d\t%s\t%s\t%.3f\t%s\n",
+            st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond,
+            state, r.id.c_str(), value, r.expr.c_str());
+        fflush(alertLog);
+    }
+    if (alertTsfn) {
+        AlertEventData* e = new AlertEventData{ r.id, r.expr, state, value, now };
+        if (napi_call_threadsafe_function(alertTsfn, e, napi_tsfn_nonblocking) != napi_ok) delete e;
+    }
+}
+
+void AlertsEvaluate(uint32_t section, uint64_t nowMs) {
+    for (auto& r : rules) {
+        if (!(r.deps & section)) continue;
+        double value;
+        bool cond = RunRule(r, value);
+        r.lastValue = value;
+        if (!r.active) {
+            if (!cond) { r.pendingSince = 0; continue; }
+            // Debounce: condition must hold for `forMs` before firing
+            if (!r.pendingSince) r.pendingSince = nowMs;
+            if (nowMs - r.pendingSince >= r.forMs) {
+                r.active = true;
+                r.clearSince = 0;
+                r.fireCount++;
+                EmitEvent(r, "fired", value);
+            }
+        } else {
+            if (cond) { r.clearSince = 0; continue; }
+            if (!r.clearSince) r.clearSince = nowMs;
+            if (nowMs - r.clearSince >= r.resolveMs) {
+                r.active = false;
+                r.pendingSince = 0;
+                EmitEvent(r, "resolved", value);
+            }
+        }
+    }
+}
+
+bool AlertsNeed(uint32_t section) {
+    return (neededSections & section) != 0;
+}
+
+static void UpdateNeededSections() {
+    neededSections = 0;
+    for (auto& r : rules) neededSections |= r.deps;
+}
+
+// ---- N-API exports ----
+
+static std::string GetStringArg(napi_env env, napi_value value) {
+    size_t len = 0;
+    if (napi_get_value_string_utf8(env, value, nullptr, 0, &len) != napi_ok) return "";
+    std::string s(len, 0);
+    napi_get_value_string_utf8(env, value, &s[0], len + 1, &len);
+    return s;
+}
+
+// addAlertRule(id, expr) -> { ok, error?, position? }; replaces a rule with the same id
+napi_value AddAlertRule(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_value result, v;
+    napi_create_object(env, &result);
+    if (argc < 2) {
+        napi_get_boolean(env, false, &v); napi_set_named_property(env, result, "ok", v);
+        napi_create_string_utf8(env, "expected (id, expr)", NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "error", v);
+        return result;
+    }
+
+    AlertRule rule;
+    rule.id = GetStringArg(env, argv[0]);
+    rule.expr = GetStringArg(env, argv[1]);
+    RuleParser parser(rule.expr.c_str(), rule);
+    bool ok = !rule.id.empty() && parser.Rule();
+
+    napi_get_boolean(env, ok, &v); napi_set_named_property(env, result, "ok", v);
+    if (!ok) {
+        const char* err = rule.id.empty() ? "empty rule id" : parser.error.c_str();
+        napi_create_string_utf8(env, err, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "error", v);
+        napi_create_uint32(env, (uint32_t)parser.pos, &v); napi_set_named_property(env, result, "position", v);
+        return result;
+    }
+
+    bool replaced = false;
+    for (auto& r : rules) {
+        if (r.id == rule.id) { r = rule; replaced = true; break; }
+    }
+    if (!replaced) rules.push_back(rule);
+    UpdateNeededSections();
+    return result;
+}
+
+// removeAlertRule(id) -> bool
+napi_value RemoveAlertRule(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    bool removed = false;
+    if (argc > 0) {
+        std::string id = GetStringArg(env, argv[0]);
+        for (auto it = rules.begin(); it != rules.end(); ++it) {
+            if (it->id == id) { rules.erase(it); removed = true; break; }
+        }
+        UpdateNeededSections();
+    }
+    napi_value result;
+    napi_get_boolean(env, removed, &result);
+    return result;
+}
+
+// getAlertRules() -> [{ id, expr, active, value, fireCount }]
+napi_value GetAlertRules(napi_env env, napi_callback_info info) {
+    napi_value result;
+    napi_create_array(env, &result);
+    uint32_t idx = 0;
+    for (auto& r : rules) {
+        napi_value rule, v;
+        napi_create_object(env, &rule);
+        napi_create_string_utf8(env, r.id.c_str(), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, rule, "id", v);
+        napi_create_string_utf8(env, r.expr.c_str(), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, rule, "expr", v);
+        napi_get_boolean(env, r.active, &v); napi_set_named_property(env, rule, "active", v);
+        if (isnan(r.lastValue)) napi_get_null(env, &v);
+        else napi_create_double(env, r.lastValue, &v);
+        napi_set_named_property(env, rule, "value", v);
+        napi_create_uint32(env, r.fireCount, &v); napi_set_named_property(env, rule, "fireCount", v);
+        napi_create_uint32(env, (uint32_t)r.code.size(), &v); napi_set_named_property(env, rule, "ops", v);
+        napi_set_element(env, result, idx++, rule);
+    }
+    return result;
+}
+
+// setAlertCallback(fn | null) - fn({ id, expr, state: 'fired'|'resolved', value, time })
+napi_value SetAlertCallback(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    if (alertTsfn) {
+        napi_release_threadsafe_function(alertTsfn, napi_tsfn_release);
+        alertTsfn = nullptr;
+    }
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_function) {
+        napi_value name;
+        napi_create_string_utf8(env, "sysmonAlert", NAPI_AUTO_LENGTH, &name);
+        alertTsfnId++;
+        if (napi_create_threadsafe_function(env, argv[0], nullptr, name, 0, 1, (void*)alertTsfnId, AlertTsfnFinalized,
+                                            nullptr, CallAlertJs, &alertTsfn) == napi_ok) {
+            // Don't keep the event loop alive just for alerts
+            napi_unref_threadsafe_function(env, alertTsfn);
+        } else {
+            alertTsfn = nullptr;
+        }
+    }
+
+    napi_value result;
+    napi_get_boolean(env, alertTsfn != nullptr, &result);
+    return result;
+}
+
+// setAlertLog(path | null) - appends tab-separated fired/resolved lines
+napi_value SetAlertLog(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    if (alertLog) {
+        fclose(alertLog);
+        alertLog = nullptr;
+    }
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_string) {
+        std::string path = GetStringArg(env, argv[0]);
+        int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+        if (len > 0) {
+            std::wstring wpath(len - 1, 0);
+            MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], len);
+            alertLog = _wfopen(wpath.c_str(), L"a");
+        }
+    }
+
+    napi_value result;
+    napi_get_boolean(env, alertLog != nullptr, &result);
+    return result;
+}
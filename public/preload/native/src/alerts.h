@@ -0,0 +1,29 @@
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Threshold alert rules, e.g.
+//   cpu.total > 90 for 30s
+//   disk['C:'].usedPercent > 95 hysteresis 2
+//   proc[name=*.exe].handles > 10000 and mem.usedPercent > 80
+//   proc[cmdline=*--inspect*].cpu > 50 or proc[user=*\svc-*].count > 40
+//   sensor.cpuTemp > 90 or sensor.perfLimit < 50
+//   pressure.hardFaultsSec > 500 for 1m
+//   disk['D:\Data'].timeToFull < 86400
+// Rules are compiled once into flat bytecode and evaluated natively each
+// time a collector publishes a snapshot section they depend on.
+
+// Snapshot subscriber (see SnapshotPublish): runs the rules depending on `section`
+void AlertsEvaluate(uint32_t section, uint64_t nowMs);
+// Whether any rule reads the given section
+bool AlertsNeed(uint32_t section);
+
+napi_value AddAlertRule(napi_env env, napi_callback_info info);
+napi_value RemoveAlertRule(napi_env env, napi_callback_info info);
+napi_value GetAlertRules(napi_env env, napi_callback_info info);
+napi_value SetAlertCallback(napi_env env, napi_callback_info info);
+napi_value SetAlertLog(napi_env env, napi_callback_info info);
+
+#endif // ALERTS_H
@@ -0,0 +1,256 @@
+#include "anomaly.h"
+#include <windows.h>
+#include <math.h>
+#include <string.h>
+#include <unordered_map>
+
+// Detection thresholds (adjustable from JS via setAnomalyOptions)
+struct AnomalyOptions {
+    bool enabled = true;
+    double memGrowthMBPerHour = 50;   // working set trend that counts as growth
+    double memGrowthMinutes = 30;     // growth must hold this long (also the trend window)
+    double handleGrowthMin = 500;     // net increase of a monotonic handle run
+    double handleGrowthMinutes = 10;  // minimum duration of that run
+    double cpuSigma = 3;              // z-score of a CPU spike
+    double cpuMinDelta = 10;          // spike must also be this many % above the mean
+    double warmupSamples = 30;        // samples before z-scores are trusted
+    double maxTracked = 16384;        // upper bound on per-process state
+};
+static AnomalyOptions opts;
+
+// Fixed-size per-process state, updated in O(1) per sample
+struct ProcState {
+    uint64_t createTime;
+    uint64_t firstMs, lastMs, tick;
+    uint32_t samples;
+    // Working set trend: exponentially weighted least squares, t in hours, x in MB
+    double sw, st, sx, stt, stx;
+    uint64_t growSinceMs;   // 0 while the slope is below the threshold
+    bool memFired;
+    // Handle count: current non-decreasing run
+    uint32_t lastHandles, runBase;
+    uint64_t runStartMs;
+    bool handleFired;
+    // CPU: EWMA mean and variance
+    double cpuMean, cpuVar;
+    uint32_t cpuSamples;
+    bool cpuFired;
+};
+static std::unordered_map<uint32_t, ProcState> procStates;
+static uint64_t currentTick = 0;
+
+// Pending events (bounded ring, drained by getAnomalyEvents)
+struct AnomalyEvent {
+    const char* type;
+    uint32_t pid;
+    char name[64];
+    double value, threshold;
+    uint64_t time;
+};
+static const size_t MAX_EVENTS = 256;
+static AnomalyEvent events[MAX_EVENTS];
+static size_t eventHead = 0, eventCount = 0;
+static uint32_t droppedEvents = 0;
+
+static uint64_t UnixTimeMs() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    ULONGLONG t = ((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000ULL) / 10000;
+}
+
+static void PushEvent(const char* type, uint32_t pid, const char* name, double value, double threshold) {
+    if (eventCount == MAX_EVENTS) {
+        // Oldest event is overwritten
+        eventHead = (eventHead + 1) % MAX_EVENTS;
+        eventCount--;
+        droppedEvents++;
+    }
+    AnomalyEvent& e = events[(eventHead + eventCount) % MAX_EVENTS];
+    e.type = type;
+    e.pid = pid;
+    strncpy(e.name, name ? name : "", sizeof(e.name) - 1);
+    e.name[sizeof(e.name) - 1] = 0;
+    e.value = value;
+    e.threshold = threshold;
+    e.time = UnixTimeMs();
+    eventCount++;
+}
+
+static void ResetState(ProcState& s, uint64_t createTime, uint64_t nowMs) {
+    memset(&s, 0, sizeof(s));
+    s.createTime = createTime;
+    s.firstMs = nowMs;
+}
+
+void AnomalyObserve(uint32_t pid, uint64_t createTime, const char* name,
+                    double workingSet, uint32_t handles, double cpu, bool hasCpu, uint64_t nowMs) {
+    if (!opts.enabled) return;
+
+    auto it = procStates.find(pid);
+    if (it == procStates.end()) {
+        if (procStates.size() >= (size_t)opts.maxTracked) return;
+        it = procStates.emplace(pid, ProcState()).first;
+        ResetState(it->second, createTime, nowMs);
+    } else if (it->second.createTime != createTime) {
+        // PID was reused by a new process
+        ResetState(it->second, createTime, nowMs);
+    }
+    ProcState& s = it->second;
+    s.tick = currentTick;
+
+    // Working set growth
+    double t = (nowMs - s.firstMs) / 3600000.0;
+    double x = workingSet / (1024.0 * 1024.0);
+    double tau = opts.memGrowthMinutes / 60.0;
+    double decay = (s.samples > 0 && tau > 0) ? exp(-((nowMs - s.lastMs) / 3600000.0) / tau) : 1.0;
+    s.sw = s.sw * decay + 1;
+    s.st = s.st * decay + t;
+    s.sx = s.sx * decay + x;
+    s.stt = s.stt * decay + t * t;
+    s.stx = s.stx * decay + t * x;
+    double denom = s.sw * s.stt - s.st * s.st;
+    double slope = denom > 1e-12 ? (s.sw * s.stx - s.st * s.sx) / denom : 0; // MB/h
+
+    if (slope > opts.memGrowthMBPerHour) {
+        if (!s.growSinceMs) s.growSinceMs = nowMs;
+        if (!s.memFired && nowMs - s.growSinceMs >= opts.memGrowthMinutes * 60000.0) {
+            PushEvent("memoryGrowth", pid, name, slope, opts.memGrowthMBPerHour);
+            s.memFired = true;
+        }
+    } else if (slope < opts.memGrowthMBPerHour * 0.5) {
+        // Hysteresis: re-arm only once the trend has clearly flattened
+        s.growSinceMs = 0;
+        s.memFired = false;
+    }
+
+    // Handle count monotonic increase
+    if (s.samples == 0 || handles < s.lastHandles) {
+        s.runBase = handles;
+        s.runStartMs = nowMs;
+        s.handleFired = false;
+    } else if (!s.handleFired &&
+               handles - s.runBase >= opts.handleGrowthMin &&
+               nowMs - s.runStartMs >= opts.handleGrowthMinutes * 60000.0) {
+        PushEvent("handleLeak", pid, name, (double)(handles - s.runBase), opts.handleGrowthMin);
+        s.handleFired = true;
+    }
+    s.lastHandles = handles;
+
+    // CPU spike (z-score against EWMA), evaluated before the sample is folded in
+    if (hasCpu) {
+        if (s.cpuSamples >= (uint32_t)opts.warmupSamples) {
+            double sd = sqrt(s.cpuVar);
+            double limit = s.cpuMean + opts.cpuSigma * sd;
+            bool spike = cpu > limit && cpu - s.cpuMean >= opts.cpuMinDelta;
+            if (spike && !s.cpuFired) {
+                PushEvent("cpuSpike", pid, name, cpu, limit);
+                s.cpuFired = true;
+            } else if (!spike && cpu < s.cpuMean + sd) {
+                s.cpuFired = false;
+            }
+        }
+        double alpha = 2.0 / (opts.warmupSamples * 2 + 1);
+        if (s.cpuSamples == 0) {
+            s.cpuMean = cpu;
+            s.cpuVar = 0;
+        } else {
+            double diff = cpu - s.cpuMean;
+            double incr = alpha * diff;
+            s.cpuMean += incr;
+            s.cpuVar = (1 - alpha) * (s.cpuVar + diff * incr);
+        }
+        s.cpuSamples++;
+    }
+
+    s.samples++;
+    s.lastMs = nowMs;
+}
+
+void AnomalyEndTick(uint64_t nowMs) {
+    for (auto it = procStates.begin(); it != procStates.end(); ) {
+        if (it->second.tick != currentTick) it = procStates.erase(it);
+        else ++it;
+    }
+    currentTick++;
+}
+
+// getAnomalyEvents() - drains pending events
+napi_value GetAnomalyEvents(napi_env env, napi_callback_info info) {
+    napi_value result, list;
+    napi_create_object(env, &result);
+    napi_create_array(env, &list);
+
+    for (size_t i = 0; i < eventCount; i++) {
+        const AnomalyEvent& e = events[(eventHead + i) % MAX_EVENTS];
+        napi_value ev, v;
+        napi_create_object(env, &ev);
+        napi_create_string_utf8(env, e.type, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, ev, "type", v);
+        napi_create_uint32(env, e.pid, &v); napi_set_named_property(env, ev, "pid", v);
+        napi_create_string_utf8(env, e.name, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, ev, "name", v);
+        napi_create_double(env, e.value, &v); napi_set_named_property(env, ev, "value", v);
+        napi_create_double(env, e.threshold, &v); napi_set_named_property(env, ev, "threshold", v);
+        napi_create_double(env, (double)e.time, &v); napi_set_named_property(env, ev, "time", v);
+        napi_set_element(env, list, (uint32_t)i, ev);
+    }
+    eventHead = 0;
+    eventCount = 0;
+
+    napi_value v;
+    napi_set_named_property(env, result, "events", list);
+    napi_create_uint32(env, (uint32_t)procStates.size(), &v); napi_set_named_property(env, result, "tracked", v);
+    napi_create_uint32(env, droppedEvents, &v); napi_set_named_property(env, result, "dropped", v);
+    droppedEvents = 0;
+    return result;
+}
+
+// Values below `min` (and NaN) are ignored, keeping the previous setting
+static void ReadOption(napi_env env, napi_value obj, const char* key, double& out, double min = 0) {
+    bool has = false;
+    if (napi_has_named_property(env, obj, key, &has) != napi_ok || !has) return;
+    napi_value v; double d;
+    napi_get_named_property(env, obj, key, &v);
+    if (napi_get_value_double(env, v, &d) == napi_ok && d >= min) out = d;
+}
+
+// setAnomalyOptions(opts) - updates thresholds, returns the effective options
+napi_value SetAnomalyOptions(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) {
+        bool has = false;
+        if (napi_has_named_property(env, argv[0], "enabled", &has) == napi_ok && has) {
+            napi_value v; bool b;
+            napi_get_named_property(env, argv[0], "enabled", &v);
+            if (napi_get_value_bool(env, v, &b) == napi_ok) {
+                opts.enabled = b;
+                if (!b) procStates.clear();
+            }
+        }
+        ReadOption(env, argv[0], "memGrowthMBPerHour", opts.memGrowthMBPerHour);
+        ReadOption(env, argv[0], "memGrowthMinutes", opts.memGrowthMinutes);
+        ReadOption(env, argv[0], "handleGrowthMin", opts.handleGrowthMin);
+        ReadOption(env, argv[0], "handleGrowthMinutes", opts.handleGrowthMinutes);
+        ReadOption(env, argv[0], "cpuSigma", opts.cpuSigma);
+        ReadOption(env, argv[0], "cpuMinDelta", opts.cpuMinDelta);
+        // The EWMA weight is 2 / (2n + 1); n < 1 would push it past 1 and diverge
+        ReadOption(env, argv[0], "warmupSamples", opts.warmupSamples, 1);
+        ReadOption(env, argv[0], "maxTracked", opts.maxTracked);
+    }
+
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_get_boolean(env, opts.enabled, &v); napi_set_named_property(env, result, "enabled", v);
+    napi_create_double(env, opts.memGrowthMBPerHour, &v); napi_set_named_property(env, result, "memGrowthMBPerHour", v);
+    napi_create_double(env, opts.memGrowthMinutes, &v); napi_set_named_property(env, result, "memGrowthMinutes", v);
+    napi_create_double(env, opts.handleGrowthMin, &v); napi_set_named_property(env, result, "handleGrowthMin", v);
+    napi_create_double(env, opts.handleGrowthMinutes, &v); napi_set_named_property(env, result, "handleGrowthMinutes", v);
+    napi_create_double(env, opts.cpuSigma, &v); napi_set_named_property(env, result, "cpuSigma", v);
+    napi_create_double(env, opts.cpuMinDelta, &v); napi_set_named_property(env, result, "cpuMinDelta", v);
+    napi_create_double(env, opts.warmupSamples, &v); napi_set_named_property(env, result, "warmupSamples", v);
+    napi_create_double(env, opts.maxTracked, &v); napi_set_named_property(env, result, "maxTracked", v);
+    return result;
+}
@@ -0,0 +1,18 @@
+#ifndef ANOMALY_H
+#define ANOMALY_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Streaming anomaly / leak detection over per-process samples.
+// GetProcessList feeds one observation per process per refresh; every
+// observation is O(1) and each tracked process costs a fixed-size state.
+void AnomalyObserve(uint32_t pid, uint64_t createTime, const char* name,
+                    double workingSet, uint32_t handles, double cpu, bool hasCpu, uint64_t nowMs);
+// Drops state of processes that were not observed in the current tick
+void AnomalyEndTick(uint64_t nowMs);
+
+napi_value GetAnomalyEvents(napi_env env, napi_callback_info info);
+napi_value SetAnomalyOptions(napi_env env, napi_callback_info info);
+
+#endif // ANOMALY_H
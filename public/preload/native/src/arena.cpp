@@ -0,0 +1,182 @@
+#include "arena.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+
+// ---- Counting global allocator ----
+// Replaces operator new/delete for this module only, so the counters see
+// exactly the heap traffic of native collector code (not V8's).
+static std::atomic<uint64_t> heapAllocs(0), heapFrees(0), heapBytes(0);
+
+void* operator new(size_t size) {
+    heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    heapFrees.fetch_add(1, std::memory_order_relaxed);
+    free(p);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// ---- Registry for getAllocatorStats ----
+static const int MAX_REGISTERED = 16;
+static ScratchArena* arenas[MAX_REGISTERED];
+static int arenaCount = 0;
+static ReusableBuffer* buffers[MAX_REGISTERED];
+static int bufferCount = 0;
+
+// ---- ScratchArena ----
+
+static const size_t ARENA_MIN_SPILL = 64 * 1024;
+
+ScratchArena::ScratchArena(const char* n) : name(n) {
+    if (arenaCount < MAX_REGISTERED) arenas[arenaCount++] = this;
+}
+
+ScratchArena::~ScratchArena() {
+    for (char* c : overflow) free(c);
+    for (char* c : oversized) free(c);
+    free(block);
+}
+
+void ScratchArena::Reset() {
+    if (!overflow.empty() || !oversized.empty()) {
+        // Consolidate into a single block sized to the high-water mark (+25%)
+        for (char* c : overflow) free(c);
+        for (char* c : oversized) free(c);
+        overflow.clear();
+        oversized.clear();
+        free(block);
+        size_t want = highWater + highWater / 4;
+        want = (want + 4095) & ~(size_t)4095;
+        block = (char*)malloc(want);
+        capacity = block ? want : 0;
+        growths++;
+    }
+    used = 0;
+    overflowBytes = 0;
+    resets++;
+}
+
+void* ScratchArena::Alloc(size_t bytes, size_t align) {
+    size_t offset = (used + align - 1) & ~(align - 1);
+    if (overflow.empty() && oversized.empty() && offset + bytes <= capacity) {
+        used = offset + bytes;
+        if (used > highWater) highWater = used;
+        return block + offset;
+    }
+
+    // Spill: bump inside the newest overflow chunk, starting a new one when it is full.
+    // `used` keeps counting as if the arena were contiguous so highWater is right.
+    used = offset + bytes;
+    if (used > highWater) highWater = used;
+    size_t chunkSize = ARENA_MIN_SPILL;
+    if (!overflow.empty()) {
+        size_t spillOffset = (overflowBytes + align - 1) & ~(align - 1);
+        if (spillOffset + bytes <= chunkSize) {
+            overflowBytes = spillOffset + bytes;
+            return overflow.back() + spillOffset;
+        }
+    }
+    if (bytes > chunkSize) {
+        // Oversized request gets its own allocation, kept apart from the spill chunks
+        char* big = (char*)malloc(bytes);
+        if (big) oversized.push_back(big);
+        return big;
+    }
+    char* chunk = (char*)malloc(chunkSize);
+    if (!chunk) return nullptr;
+    overflow.push_back(chunk);
+    overflowBytes = bytes;
+    return chunk;
+}
+
+const char* ScratchArena::Utf8(const wchar_t* wstr) {
+    if (!wstr) return "";
+    int len = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return "";
+    char* out = (char*)Alloc(len, 1);
+    if (!out) return "";
+    WideCharToMultiByte(CP_UTF8, 0, wstr, -1, out, len, nullptr, nullptr);
+    return out;
+}
+
+const char* ScratchArena::Copy(const char* str) {
+    if (!str) return "";
+    size_t len = strlen(str) + 1;
+    char* out = (char*)Alloc(len, 1);
+    if (!out) return "";
+    memcpy(out, str, len);
+    return out;
+}
+
+// ---- ReusableBuffer ----
+
+ReusableBuffer::ReusableBuffer(const char* n) : name(n) {
+    if (bufferCount < MAX_REGISTERED) buffers[bufferCount++] = this;
+}
+
+ReusableBuffer::~ReusableBuffer() {
+    free(data);
+}
+
+bool ReusableBuffer::Reserve(size_t bytes) {
+    if (bytes <= size) return true;
+    size_t want = bytes + bytes / 4;
+    uint8_t* p = (uint8_t*)malloc(want);
+    if (!p) return false;
+    free(data);
+    data = p;
+    size = want;
+    growths++;
+    return true;
+}
+
+// getAllocatorStats() - heap counters of this module plus arena / buffer sizes
+napi_value GetAllocatorStats(napi_env env, napi_callback_info info) {
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+
+    napi_create_double(env, (double)heapAllocs.load(), &v); napi_set_named_property(env, result, "heapAllocs", v);
+    napi_create_double(env, (double)heapFrees.load(), &v); napi_set_named_property(env, result, "heapFrees", v);
+    napi_create_double(env, (double)heapBytes.load(), &v); napi_set_named_property(env, result, "heapBytes", v);
+
+    napi_create_array(env, &list);
+    for (int i = 0; i < arenaCount; i++) {
+        ScratchArena* a = arenas[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, a->name, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "name", v);
+        napi_create_double(env, (double)a->capacity, &v); napi_set_named_property(env, item, "capacity", v);
+        napi_create_double(env, (double)a->used, &v); napi_set_named_property(env, item, "used", v);
+        napi_create_double(env, (double)a->highWater, &v); napi_set_named_property(env, item, "highWater", v);
+        napi_create_uint32(env, a->growths, &v); napi_set_named_property(env, item, "growths", v);
+        napi_create_uint32(env, a->resets, &v); napi_set_named_property(env, item, "resets", v);
+        napi_set_element(env, list, i, item);
+    }
+    napi_set_named_property(env, result, "arenas", list);
+
+    napi_create_array(env, &list);
+    for (int i = 0; i < bufferCount; i++) {
+        ReusableBuffer* b = buffers[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, b->name, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "name", v);
+        napi_create_double(env, (double)b->Size(), &v); napi_set_named_property(env, item, "capacity", v);
+        napi_create_uint32(env, b->growths, &v); napi_set_named_property(env, item, "growths", v);
+        napi_set_element(env, list, i, item);
+    }
+    napi_set_named_property(env, result, "buffers", list);
+    return result;
+}
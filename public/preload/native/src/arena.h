@@ -0,0 +1,61 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <node_api.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Per-collector scratch memory. Allocation is a pointer bump and the whole
+// arena is reset at the start of each tick. If a tick needs more than the
+// current block, overflow chunks are used and the next Reset() replaces
+// everything with one block sized to the high-water mark, so steady-state
+// ticks never touch the heap.
+class ScratchArena {
+public:
+    explicit ScratchArena(const char* name);
+    ~ScratchArena();
+
+    void Reset();
+    void* Alloc(size_t bytes, size_t align = 8);
+    template <typename T> T* AllocArray(size_t n) { return (T*)Alloc(n * sizeof(T), alignof(T)); }
+    // UTF-16 -> UTF-8 copy living until the next Reset() (never null)
+    const char* Utf8(const wchar_t* wstr);
+    // UTF-8 copy living until the next Reset() (never null)
+    const char* Copy(const char* str);
+
+    const char* name;
+    size_t capacity = 0, used = 0, highWater = 0;
+    uint32_t growths = 0, resets = 0;
+
+private:
+    char* block = nullptr;
+    size_t overflowBytes = 0;           // bumped in overflow.back()
+    std::vector<char*> overflow;        // spill chunks of ARENA_MIN_SPILL bytes
+    std::vector<char*> oversized;       // one allocation each, never bumped into
+};
+
+// Grow-only buffer for OS enumeration calls (TCP tables, adapter lists, ...).
+// It keeps the largest size a call has needed so the usual
+// "ask for size, allocate, call again" dance happens only on growth.
+class ReusableBuffer {
+public:
+    explicit ReusableBuffer(const char* name);
+    ~ReusableBuffer();
+
+    uint8_t* Data() { return data; }
+    size_t Size() const { return size; }
+    // Ensures at least `bytes` (plus headroom); false on allocation failure
+    bool Reserve(size_t bytes);
+
+    const char* name;
+    uint32_t growths = 0;
+
+private:
+    uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+napi_value GetAllocatorStats(napi_env env, napi_callback_info info);
+
+#endif // ARENA_H
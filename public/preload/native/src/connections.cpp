@@ -1,12 +1,18 @@
 #include "connections.h"
+#include "arena.h"
+#include "selfstats.h"
+#include "scheduler.h"
+#include "replay.h"
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
 #include <iphlpapi.h>
 #include <psapi.h>
+#include <stddef.h>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <algorithm>
 
 #pragma comment(lib, "iphlpapi.lib")
 #pragma comment(lib, "ws2_32.lib")
@@ -47,6 +53,123 @@ std::string GetProcessNameFromPID(DWORD pid) {
 // Cache for process names
 static std::unordered_map<DWORD, std::string> processNameCache;
 
+static const char* CachedProcessName(DWORD pid) {
+    auto it = processNameCache.find(pid);
+    if (it == processNameCache.end()) {
+        it = processNameCache.emplace(pid, GetProcessNameFromPID(pid)).first;
+    }
+    return it->second.c_str();
+}
+
+// Table buffers are reused across calls and only grow
+static ReusableBuffer tcpBuffer("tcpTable");
+static ReusableBuffer udpBuffer("udpTable");
+
+// Calls GetExtendedTcpTable/GetExtendedUdpTable-style functions into `buf`, growing it if needed
+template <typename Table, typename Fn>
+static bool FillTable(ReusableBuffer& buf, Fn query) {
+    ReplayResult replay = ReplayFillTable(buf, offsetof(Table, table), sizeof(Table::table[0]));
+    if (replay != REPLAY_LIVE) return replay == REPLAY_SERVED;
+    SelfStatsQueryBegin();
+    ULONG size = (ULONG)buf.Size();
+    DWORD rc = query(buf.Data(), &size);
+    // The table can grow between calls; retry a few times
+    for (int i = 0; i < 3 && rc == ERROR_INSUFFICIENT_BUFFER; i++) {
+        if (!buf.Reserve(size)) return false;
+        size = (ULONG)buf.Size();
+        rc = query(buf.Data(), &size);
+    }
+    SelfStatsQueryEnd(rc == NO_ERROR ? size : 0);
+    if (rc == NO_ERROR) ReplayCapture(buf, size);
+    return rc == NO_ERROR;
+}
+
+
+// ---- Listening socket index ----
+// Kept incrementally from every connection pass (and from a listener-only
+// query when the collector has not run recently), so port/PID lookups and
+// conflict checks never walk the socket table themselves.
+struct ListenKey {
+    DWORD addr, pid;
+    uint16_t port;
+    uint8_t udp;
+    bool operator==(const ListenKey& o) const {
+        return addr == o.addr && pid == o.pid && port == o.port && udp == o.udp;
+    }
+};
+struct ListenKeyHash {
+    size_t operator()(const ListenKey& k) const {
+        return ((size_t)k.port << 1 | k.udp) ^ ((size_t)k.addr * 0x9E3779B1u) ^ ((size_t)k.pid << 17);
+    }
+};
+struct ListenChange { uint64_t seq; bool added; ListenKey key; };
+
+static std::unordered_map<ListenKey, uint32_t, ListenKeyHash> listeners;   // -> generation last seen
+static std::unordered_map<uint16_t, std::vector<ListenKey>> listenByPort;
+static std::unordered_map<DWORD, std::vector<ListenKey>> listenByPid;
+static uint32_t listenGeneration = 0;
+static ULONGLONG listenTime = 0;
+// Last LISTEN_CHANGES changes; older ones are only reported as truncated
+static const size_t LISTEN_CHANGES = 256;
+static std::vector<ListenChange> listenChanges;
+static uint64_t listenSeq = 0;
+// Lookups older than this refresh the index first
+static const ULONGLONG LISTEN_STALE_MS = 2000;
+static ReusableBuffer listenBuffer("tcpListenTable");
+
+static void RecordListenChange(bool added, const ListenKey& key) {
+    ListenChange c = { ++listenSeq, added, key };
+    if (listenChanges.size() < LISTEN_CHANGES) listenChanges.push_back(c);
+    else listenChanges[(listenSeq - 1) % LISTEN_CHANGES] = c;
+}
+
+static void EraseKey(std::vector<ListenKey>& list, const ListenKey& key) {
+    list.erase(std::remove(list.begin(), list.end(), key), list.end());
+}
+
+static void ListenSeen(bool udp, DWORD addr, DWORD port, DWORD pid) {
+    ListenKey key = { addr, pid, ntohs((u_short)port), (uint8_t)udp };
+    auto it = listeners.find(key);
+    if (it != listeners.end()) {
+        it->second = listenGeneration;
+        return;
+    }
+    listeners.emplace(key, listenGeneration);
+    listenByPort[key.port].push_back(key);
+    listenByPid[pid].push_back(key);
+    RecordListenChange(true, key);
+}
+
+// Drops listeners not seen in the current generation (one full pass)
+static void ListenSweep(ULONGLONG now) {
+    for (auto it = listeners.begin(); it != listeners.end(); ) {
+        if (it->second == listenGeneration) { ++it; continue; }
+        const ListenKey& key = it->first;
+        auto port = listenByPort.find(key.port);
+        EraseKey(port->second, key);
+        if (port->second.empty()) listenByPort.erase(port);
+        auto pid = listenByPid.find(key.pid);
+        EraseKey(pid->second, key);
+        if (pid->second.empty()) listenByPid.erase(pid);
+        RecordListenChange(false, key);
+        it = listeners.erase(it);
+    }
+    listenTime = now;
+}
+
+// Per-process connection counts, rebuilt on every pass
+struct ProcConnCount { DWORD pid; uint32_t tcp, udp, established, listening; };
+static std::vector<ProcConnCount> procCounts;
+static std::unordered_map<DWORD, uint32_t> procCountIndex;
+
+static ProcConnCount& ProcCount(DWORD pid) {
+    auto it = procCountIndex.find(pid);
+    if (it != procCountIndex.end()) return procCounts[it->second];
+    procCountIndex.emplace(pid, (uint32_t)procCounts.size());
+    procCounts.push_back({ pid, 0, 0, 0, 0 });
+    return procCounts.back();
+}
+
 napi_value GetNetworkConnections(napi_env env, napi_callback_info info) {
     napi_value result, tcpConns, udpConns;
     napi_create_object(env, &result);
@@ -55,16 +178,21 @@ napi_value GetNetworkConnections(napi_env env, napi_callback_info info) {
     
     // Clear old cache entries (keep it small)
     if (processNameCache.size() > 500) processNameCache.clear();
+    procCounts.clear();
+    procCountIndex.clear();
+    listenGeneration++;
+    uint32_t established = 0, listening = 0;
     
     // Get TCP connections
-    ULONG tcpSize = 0;
-    GetExtendedTcpTable(nullptr, &tcpSize, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0);
+    bool tcpOk = FillTable<MIB_TCPTABLE_OWNER_PID>(tcpBuffer, [](void* data, ULONG* size) {
+        return GetExtendedTcpTable(data, size, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0);
+    });
     
-    if (tcpSize > 0) {
-        std::vector<BYTE> tcpBuffer(tcpSize);
-        auto tcpTable = (PMIB_TCPTABLE_OWNER_PID)tcpBuffer.data();
+    {
+        auto tcpTable = (PMIB_TCPTABLE_OWNER_PID)tcpBuffer.Data();
+        SchedulerSignal(tcpOk ? tcpTable->dwNumEntries : 0, 0.5);
         
-        if (GetExtendedTcpTable(tcpTable, &tcpSize, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0) == NO_ERROR) {
+        if (tcpOk) {
             uint32_t tcpIdx = 0;
             
             for (DWORD i = 0; i < tcpTable->dwNumEntries; i++) {
@@ -133,31 +261,33 @@ napi_value GetNetworkConnections(napi_env env, napi_callback_info info) {
                 napi_set_named_property(env, conn, "pid", v);
                 
                 // Process name (cached)
-                std::string processName;
-                auto it = processNameCache.find(row.dwOwningPid);
-                if (it != processNameCache.end()) {
-                    processName = it->second;
-                } else {
-                    processName = GetProcessNameFromPID(row.dwOwningPid);
-                    processNameCache[row.dwOwningPid] = processName;
-                }
-                napi_create_string_utf8(env, processName.c_str(), NAPI_AUTO_LENGTH, &v);
+                napi_create_string_utf8(env, CachedProcessName(row.dwOwningPid), NAPI_AUTO_LENGTH, &v);
                 napi_set_named_property(env, conn, "process", v);
                 
                 napi_set_element(env, tcpConns, tcpIdx++, conn);
+                
+                ProcConnCount& pc = ProcCount(row.dwOwningPid);
+                pc.tcp++;
+                if (row.dwState == MIB_TCP_STATE_ESTAB) { pc.established++; established++; }
+                if (row.dwState == MIB_TCP_STATE_LISTEN) {
+                    pc.listening++;
+                    listening++;
+                    ListenSeen(false, row.dwLocalAddr, row.dwLocalPort, row.dwOwningPid);
+                }
             }
         }
     }
     
     // Get UDP connections
-    ULONG udpSize = 0;
-    GetExtendedUdpTable(nullptr, &udpSize, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0);
+    bool udpOk = FillTable<MIB_UDPTABLE_OWNER_PID>(udpBuffer, [](void* data, ULONG* size) {
+        return GetExtendedUdpTable(data, size, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0);
+    });
     
-    if (udpSize > 0) {
-        std::vector<BYTE> udpBuffer(udpSize);
-        auto udpTable = (PMIB_UDPTABLE_OWNER_PID)udpBuffer.data();
+    {
+        auto udpTable = (PMIB_UDPTABLE_OWNER_PID)udpBuffer.Data();
+        SchedulerSignal(udpOk ? udpTable->dwNumEntries : 0, 0.5);
         
-        if (GetExtendedUdpTable(udpTable, &udpSize, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0) == NO_ERROR) {
+        if (udpOk) {
             uint32_t udpIdx = 0;
             
             for (DWORD i = 0; i < udpTable->dwNumEntries; i++) {
@@ -200,24 +330,178 @@ napi_value GetNetworkConnections(napi_env env, napi_callback_info info) {
                 napi_set_named_property(env, conn, "pid", v);
                 
                 // Process name (cached)
-                std::string processName;
-                auto it = processNameCache.find(row.dwOwningPid);
-                if (it != processNameCache.end()) {
-                    processName = it->second;
-                } else {
-                    processName = GetProcessNameFromPID(row.dwOwningPid);
-                    processNameCache[row.dwOwningPid] = processName;
-                }
-                napi_create_string_utf8(env, processName.c_str(), NAPI_AUTO_LENGTH, &v);
+                napi_create_string_utf8(env, CachedProcessName(row.dwOwningPid), NAPI_AUTO_LENGTH, &v);
                 napi_set_named_property(env, conn, "process", v);
                 
                 napi_set_element(env, udpConns, udpIdx++, conn);
+                
+                ProcCount(row.dwOwningPid).udp++;
+                ListenSeen(true, row.dwLocalAddr, row.dwLocalPort, row.dwOwningPid);
             }
         }
     }
     
     napi_set_named_property(env, result, "tcp", tcpConns);
     napi_set_named_property(env, result, "udp", udpConns);
+    // A failed table would look like every listener closed
+    if (tcpOk && udpOk) ListenSweep(GetTickCount64());
+    
+    // Summary by process
+    std::sort(procCounts.begin(), procCounts.end(), [](const ProcConnCount& a, const ProcConnCount& b) {
+        return a.tcp + a.udp > b.tcp + b.udp;
+    });
+    napi_value byProcess, v;
+    napi_create_array(env, &byProcess);
+    uint32_t idx = 0, totalTcp = 0, totalUdp = 0;
+    for (auto& pc : procCounts) {
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_uint32(env, pc.pid, &v); napi_set_named_property(env, item, "pid", v);
+        napi_create_string_utf8(env, CachedProcessName(pc.pid), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "process", v);
+        napi_create_uint32(env, pc.tcp, &v); napi_set_named_property(env, item, "tcp", v);
+        napi_create_uint32(env, pc.udp, &v); napi_set_named_property(env, item, "udp", v);
+        napi_create_uint32(env, pc.established, &v); napi_set_named_property(env, item, "established", v);
+        napi_create_uint32(env, pc.listening, &v); napi_set_named_property(env, item, "listening", v);
+        napi_set_element(env, byProcess, idx++, item);
+        totalTcp += pc.tcp;
+        totalUdp += pc.udp;
+    }
+    napi_set_named_property(env, result, "byProcess", byProcess);
+    napi_create_uint32(env, totalTcp, &v); napi_set_named_property(env, result, "totalTcp", v);
+    napi_create_uint32(env, totalUdp, &v); napi_set_named_property(env, result, "totalUdp", v);
+    napi_create_uint32(env, established, &v); napi_set_named_property(env, result, "totalEstablished", v);
+    napi_create_uint32(env, listening, &v); napi_set_named_property(env, result, "totalListening", v);
     
     return result;
 }
+
+// Listener-only pass for lookups made while the collector is idle
+static void RefreshListeners() {
+    listenGeneration++;
+    bool tcpOk = FillTable<MIB_TCPTABLE_OWNER_PID>(listenBuffer, [](void* data, ULONG* size) {
+        return GetExtendedTcpTable(data, size, FALSE, AF_INET, TCP_TABLE_OWNER_PID_LISTENER, 0);
+    });
+    if (tcpOk) {
+        auto table = (PMIB_TCPTABLE_OWNER_PID)listenBuffer.Data();
+        for (DWORD i = 0; i < table->dwNumEntries; i++) {
+            auto& row = table->table[i];
+            ListenSeen(false, row.dwLocalAddr, row.dwLocalPort, row.dwOwningPid);
+        }
+    }
+    bool udpOk = FillTable<MIB_UDPTABLE_OWNER_PID>(udpBuffer, [](void* data, ULONG* size) {
+        return GetExtendedUdpTable(data, size, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0);
+    });
+    if (udpOk) {
+        auto table = (PMIB_UDPTABLE_OWNER_PID)udpBuffer.Data();
+        for (DWORD i = 0; i < table->dwNumEntries; i++) {
+            auto& row = table->table[i];
+            ListenSeen(true, row.dwLocalAddr, row.dwLocalPort, row.dwOwningPid);
+        }
+    }
+    if (tcpOk && udpOk) ListenSweep(GetTickCount64());
+}
+
+static void RefreshListenersIfStale() {
+    if (listenTime == 0 || GetTickCount64() - listenTime > LISTEN_STALE_MS) RefreshListeners();
+}
+
+static napi_value ListenObject(napi_env env, const ListenKey& key) {
+    napi_value item, v;
+    napi_create_object(env, &item);
+    char addr[16];
+    sprintf(addr, "%d.%d.%d.%d", key.addr & 0xFF, (key.addr >> 8) & 0xFF, (key.addr >> 16) & 0xFF, (key.addr >> 24) & 0xFF);
+    napi_create_string_utf8(env, key.udp ? "UDP" : "TCP", NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "protocol", v);
+    napi_create_string_utf8(env, addr, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "address", v);
+    napi_create_uint32(env, key.port, &v); napi_set_named_property(env, item, "port", v);
+    napi_create_uint32(env, key.pid, &v); napi_set_named_property(env, item, "pid", v);
+    napi_create_string_utf8(env, CachedProcessName(key.pid), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "process", v);
+    return item;
+}
+
+napi_value FindPortOwner(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t port = 0;
+    if (argc > 0) napi_get_value_uint32(env, argv[0], &port);
+    // Optional 'tcp' / 'udp' filter
+    int udp = -1;
+    if (argc > 1) {
+        char proto[8] = {0};
+        size_t len = 0;
+        if (napi_get_value_string_utf8(env, argv[1], proto, sizeof(proto), &len) == napi_ok) {
+            udp = _stricmp(proto, "udp") == 0 ? 1 : _stricmp(proto, "tcp") == 0 ? 0 : -1;
+        }
+    }
+    RefreshListenersIfStale();
+
+    napi_value result, owners, v;
+    napi_create_object(env, &result);
+    napi_create_array(env, &owners);
+    uint32_t idx = 0;
+    auto it = listenByPort.find((uint16_t)port);
+    if (it != listenByPort.end()) {
+        for (auto& key : it->second) {
+            if (udp >= 0 && key.udp != udp) continue;
+            napi_set_element(env, owners, idx++, ListenObject(env, key));
+        }
+    }
+    napi_create_uint32(env, port, &v); napi_set_named_property(env, result, "port", v);
+    napi_get_boolean(env, idx > 0, &v); napi_set_named_property(env, result, "inUse", v);
+    napi_set_named_property(env, result, "owners", owners);
+    napi_create_double(env, (double)(GetTickCount64() - listenTime), &v); napi_set_named_property(env, result, "indexAge", v);
+    return result;
+}
+
+napi_value GetListeningPorts(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t pid = 0;
+    bool byPid = argc > 0 && napi_get_value_uint32(env, argv[0], &pid) == napi_ok;
+    RefreshListenersIfStale();
+
+    napi_value result;
+    napi_create_array(env, &result);
+    uint32_t idx = 0;
+    if (byPid) {
+        auto it = listenByPid.find(pid);
+        if (it != listenByPid.end()) {
+            for (auto& key : it->second) napi_set_element(env, result, idx++, ListenObject(env, key));
+        }
+    } else {
+        for (auto& entry : listeners) napi_set_element(env, result, idx++, ListenObject(env, entry.first));
+    }
+    return result;
+}
+
+napi_value GetListeningChanges(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    double since = 0;
+    if (argc > 0) napi_get_value_double(env, argv[0], &since);
+    RefreshListenersIfStale();
+
+    // Change `seq` lives at (seq - 1) % LISTEN_CHANGES
+    uint64_t oldest = listenSeq >= listenChanges.size() ? listenSeq - listenChanges.size() + 1 : 1;
+    uint64_t from = (uint64_t)since + 1;
+    bool truncated = from < oldest && listenSeq > 0;
+    if (from < oldest) from = oldest;
+
+    napi_value result, changes, v;
+    napi_create_object(env, &result);
+    napi_create_array(env, &changes);
+    uint32_t idx = 0;
+    for (uint64_t seq = from; seq <= listenSeq; seq++) {
+        const ListenChange& c = listenChanges[(seq - 1) % LISTEN_CHANGES];
+        napi_value item = ListenObject(env, c.key);
+        napi_create_double(env, (double)c.seq, &v); napi_set_named_property(env, item, "seq", v);
+        napi_create_string_utf8(env, c.added ? "added" : "removed", NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "change", v);
+        napi_set_element(env, changes, idx++, item);
+    }
+    napi_create_double(env, (double)listenSeq, &v); napi_set_named_property(env, result, "seq", v);
+    napi_get_boolean(env, truncated, &v); napi_set_named_property(env, result, "truncated", v);
+    napi_set_named_property(env, result, "changes", changes);
+    return result;
+}
@@ -6,4 +6,15 @@
 // Get network connections (TCP/UDP)
 napi_value GetNetworkConnections(napi_env env, napi_callback_info info);
 
+// Listening socket index (TCP LISTEN + bound UDP), maintained from every
+// getNetworkConnections pass; lookups refresh it from a listener-only
+// query when it is older than LISTEN_STALE_MS.
+// findPortOwner(port, 'tcp' | 'udp') - owners of one port, O(1)
+napi_value FindPortOwner(napi_env env, napi_callback_info info);
+// getListeningPorts(pid) - listeners of one process (all without pid)
+napi_value GetListeningPorts(napi_env env, napi_callback_info info);
+// getListeningChanges(sinceSeq) - listeners added/removed after sinceSeq;
+// truncated: true when older changes were already dropped
+napi_value GetListeningChanges(napi_env env, napi_callback_info info);
+
 #endif
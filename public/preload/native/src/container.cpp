@@ -0,0 +1,170 @@
+#include "container.h"
+#include "selfstats.h"
+#include <windows.h>
+
+static const ULONGLONG MIN_SAMPLE_MS = 250;
+static const double THROTTLE_RATIO = 0.97;
+static const ULONGLONG THROTTLE_WINDOW_MS = 10000;
+static const int THROTTLE_POINTS = 64;     // > window / MIN_SAMPLE_MS
+
+static ContainerState state;
+static bool probed = false;
+static ULONGLONG lastSample = 0;
+static uint64_t lastCpuTime = 0;        // 100 ns
+static DWORD lastTerminated = 0;
+static bool lastMemViolation = false;
+
+// Recent (tick, throttledTime) samples, for the throttled rate over the window
+struct ThrottlePoint { ULONGLONG t; double throttled; };
+static ThrottlePoint throttlePoints[THROTTLE_POINTS];
+static int throttleHead = 0, throttleCount = 0;
+
+static double ThrottleRate(ULONGLONG now, double throttled) {
+    throttlePoints[throttleHead] = { now, throttled };
+    throttleHead = (throttleHead + 1) % THROTTLE_POINTS;
+    if (throttleCount < THROTTLE_POINTS) throttleCount++;
+    // Oldest point still inside the window (the newest one is `now` itself)
+    const ThrottlePoint* oldest = nullptr;
+    for (int i = 1; i < throttleCount; i++) {
+        const ThrottlePoint& p = throttlePoints[(throttleHead + THROTTLE_POINTS - 1 - i) % THROTTLE_POINTS];
+        if (now - p.t > THROTTLE_WINDOW_MS) break;
+        oldest = &p;
+    }
+    if (!oldest || now == oldest->t) return 0;
+    return (throttled - oldest->throttled) / ((now - oldest->t) / 1000.0);
+}
+
+static uint32_t CountBits(ULONG_PTR mask) {
+    uint32_t n = 0;
+    for (; mask; mask &= mask - 1) n++;
+    return n;
+}
+
+// Limits can be changed on a running container, so they are re-read per sample
+static void ReadLimits(double logical) {
+    double cpus = 0;
+    JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate = {};
+    if (QueryInformationJobObject(NULL, JobObjectCpuRateControlInformation, &rate, sizeof(rate), NULL) &&
+        (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_ENABLE)) {
+        // Rates are in 1/100 of a percent of the whole machine; weights don't cap
+        if (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP) cpus = rate.CpuRate / 10000.0 * logical;
+        else if (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_MIN_MAX_RATE) cpus = rate.MaxRate / 10000.0 * logical;
+    }
+
+    state.memLimited = false;
+    state.memLimit = 0;
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION ext = {};
+    if (QueryInformationJobObject(NULL, JobObjectExtendedLimitInformation, &ext, sizeof(ext), NULL)) {
+        DWORD flags = ext.BasicLimitInformation.LimitFlags;
+        if (flags & JOB_OBJECT_LIMIT_AFFINITY) {
+            double affinity = CountBits(ext.BasicLimitInformation.Affinity);
+            if (affinity > 0 && (cpus == 0 || affinity < cpus)) cpus = affinity;
+        }
+        if (flags & JOB_OBJECT_LIMIT_JOB_MEMORY) {
+            state.memLimited = true;
+            state.memLimit = (double)ext.JobMemoryLimit;
+        }
+        state.memPeak = (double)ext.PeakJobMemoryUsed;
+    }
+    state.cpuLimited = cpus > 0 && cpus < logical;
+    state.cpus = state.cpuLimited ? cpus : logical;
+}
+
+const ContainerState& ContainerSample() {
+    if (!probed) {
+        BOOL inJob = FALSE;
+        state.inJob = IsProcessInJob(GetCurrentProcess(), NULL, &inJob) && inJob;
+        probed = true;
+    }
+    ULONGLONG now = GetTickCount64();
+    if (!state.inJob || (lastSample && now - lastSample < MIN_SAMPLE_MS)) return state;
+
+    double logical = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    JOBOBJECT_BASIC_ACCOUNTING_INFORMATION acct = {};
+    JOBOBJECT_LIMIT_VIOLATION_INFORMATION violation = {};
+    SelfStatsQueryBegin();
+    ReadLimits(logical);
+    bool acctOk = QueryInformationJobObject(NULL, JobObjectBasicAccountingInformation, &acct, sizeof(acct), NULL) != 0;
+    bool violationOk = QueryInformationJobObject(NULL, JobObjectLimitViolationInformation, &violation, sizeof(violation), NULL) != 0;
+    SelfStatsQueryEnd(sizeof(acct) + sizeof(violation));
+
+    double dt = lastSample ? (now - lastSample) / 1000.0 : 0;
+    bool cpuViolation = violationOk && (violation.ViolationLimitFlags & JOB_OBJECT_LIMIT_CPU_RATE_CONTROL);
+    bool memViolation = violationOk && (violation.ViolationLimitFlags & JOB_OBJECT_LIMIT_JOB_MEMORY);
+    if (violationOk) state.memUsed = (double)violation.JobMemory;
+
+    if (acctOk) {
+        uint64_t cpuTime = (uint64_t)acct.TotalUserTime.QuadPart + (uint64_t)acct.TotalKernelTime.QuadPart;
+        state.processes = acct.ActiveProcesses;
+        if (dt > 0) {
+            double busy = (cpuTime - lastCpuTime) * 1e-7;      // CPU seconds
+            double percent = busy / (dt * state.cpus) * 100;
+            state.cpuPercent = percent < 0 ? 0 : percent > 100 ? 100 : percent;
+            bool atCap = state.cpuLimited && (busy >= dt * state.cpus * THROTTLE_RATIO || cpuViolation);
+            if (atCap) {
+                state.throttledPeriods++;
+                state.throttledTime += dt;
+            }
+            state.throttledSec = ThrottleRate(now, state.throttledTime);
+            DWORD terminated = acct.TotalTerminatedProcesses - lastTerminated;
+            state.terminated += terminated;
+            state.terminatedSec = terminated / dt;
+        }
+        lastCpuTime = cpuTime;
+        lastTerminated = acct.TotalTerminatedProcesses;
+    }
+
+    bool hit = memViolation && !lastMemViolation;
+    if (hit) state.memLimitHits++;
+    state.memLimitHitsSec = dt > 0 && hit ? 1 / dt : 0;
+    lastMemViolation = memViolation;
+
+    state.interval = dt;
+    lastSample = now;
+    return state;
+}
+
+static void SetDouble(napi_env env, napi_value obj, const char* name, double value) {
+    napi_value v;
+    napi_create_double(env, value, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+napi_value GetContainerInfo(napi_env env, napi_callback_info info) {
+    const ContainerState& s = ContainerSample();
+    napi_value result, cpu, mem, v;
+    napi_create_object(env, &result);
+    napi_get_boolean(env, s.inJob, &v); napi_set_named_property(env, result, "inJob", v);
+    napi_get_boolean(env, s.cpuLimited || s.memLimited, &v); napi_set_named_property(env, result, "limited", v);
+
+    if (s.cpuLimited) {
+        napi_create_object(env, &cpu);
+        SetDouble(env, cpu, "limit", s.cpus);
+        SetDouble(env, cpu, "usedPercent", s.cpuPercent);
+        SetDouble(env, cpu, "throttledPeriods", (double)s.throttledPeriods);
+        SetDouble(env, cpu, "throttledTime", s.throttledTime);
+        SetDouble(env, cpu, "throttledSec", s.throttledSec);
+    } else {
+        napi_get_null(env, &cpu);
+    }
+    napi_set_named_property(env, result, "cpu", cpu);
+
+    if (s.memLimited) {
+        napi_create_object(env, &mem);
+        SetDouble(env, mem, "limit", s.memLimit);
+        SetDouble(env, mem, "used", s.memUsed);
+        SetDouble(env, mem, "peak", s.memPeak);
+        SetDouble(env, mem, "usedPercent", s.memLimit > 0 ? s.memUsed / s.memLimit * 100 : 0);
+        SetDouble(env, mem, "limitHits", (double)s.memLimitHits);
+        SetDouble(env, mem, "limitHitsSec", s.memLimitHitsSec);
+    } else {
+        napi_get_null(env, &mem);
+    }
+    napi_set_named_property(env, result, "memory", mem);
+
+    napi_create_uint32(env, s.processes, &v); napi_set_named_property(env, result, "processes", v);
+    SetDouble(env, result, "terminated", (double)s.terminated);
+    SetDouble(env, result, "terminatedSec", s.terminatedSec);
+    SetDouble(env, result, "interval", s.interval);
+    return result;
+}
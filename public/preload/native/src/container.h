@@ -0,0 +1,41 @@
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Container (job object) awareness.
+// Windows containers and sandboxes cap a process tree through the job
+// object it runs in: a CPU rate hard cap, an affinity mask and a job
+// commit limit. When this process sits in a job with such limits,
+// getCpuUsage / getMemoryInfo switch to values relative to them (the host
+// values move under `host`), and getContainerInfo() has the details.
+// A job without limits (terminals and browsers create those) changes nothing.
+struct ContainerState {
+    bool inJob = false;
+    bool cpuLimited = false, memLimited = false;
+    double cpus = 0;                // CPU limit in logical processors
+    double cpuPercent = 0;          // job CPU time over the last interval, % of the limit
+    double memLimit = 0, memUsed = 0, memPeak = 0;   // bytes of commit
+    uint32_t processes = 0;
+    // No scheduler throttle counters exist; an interval at >= 97% of the
+    // cap counts as throttled, for its whole length
+    uint64_t throttledPeriods = 0;
+    double throttledTime = 0;       // s
+    double throttledSec = 0;        // throttled s per s over the last 10 s
+    // Rising edges of the job memory limit violation, and processes the job terminated
+    uint64_t memLimitHits = 0, terminated = 0;
+    double memLimitHitsSec = 0, terminatedSec = 0;
+    double interval = 0;            // s
+};
+
+// Samples the job (at most every 250 ms) and returns the current state
+const ContainerState& ContainerSample();
+
+// getContainerInfo() -> { inJob, limited, cpu: { limit, usedPercent,
+//   throttledPeriods, throttledTime, throttledSec } | null, memory: { limit,
+//   used, peak, usedPercent, limitHits, limitHitsSec } | null, processes,
+//   terminated, terminatedSec, interval }
+napi_value GetContainerInfo(napi_env env, napi_callback_info info);
+
+#endif // CONTAINER_H
@@ -0,0 +1,439 @@
+#include "disks.h"
+#include "snapshot.h"
+#include "selfstats.h"
+#include "scheduler.h"
+#include "inventory.h"
+#include <windows.h>
+#include <winioctl.h>
+#include <cfgmgr32.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#pragma comment(lib, "cfgmgr32.lib")
+
+static std::string WideToUtf8Disk(const wchar_t* wstr) {
+    if (!wstr) return "";
+    int len = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return "";
+    std::string result(len - 1, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wstr, -1, &result[0], len, nullptr, nullptr);
+    return result;
+}
+
+// Used bytes over time; one point per HISTORY_STEP_MS, about an hour kept
+struct UsagePoint { ULONGLONG t; double used; };
+static const size_t HISTORY_POINTS = 120;
+static const ULONGLONG HISTORY_STEP_MS = 30000;
+// No forecast until the history spans this long
+static const ULONGLONG FIT_MIN_SPAN_MS = 120000;
+// Network drives are queried in the background at most this often, and
+// hidden once their last answer is older than REMOTE_MAX_AGE_MS
+static const ULONGLONG REMOTE_REFRESH_MS = 10000;
+static const ULONGLONG REMOTE_MAX_AGE_MS = 60000;
+
+// Last answer for a mapped network drive. Queries on an offline share can
+// block for tens of seconds, so they run on a detached thread that shares
+// this record; one that never returns only keeps its own drive stale.
+struct RemoteVolume {
+    std::mutex lock;
+    bool busy = false, ok = false;
+    ULONGLONG done = 0;         // tick of the last completed query
+    double size = 0, free = 0;
+    std::string type, label;
+};
+
+struct VolumeInfo {
+    std::string id;             // volume GUID path; empty for network drives
+    std::string key;            // volume GUID path + mount path, keeps history across rebuilds
+    std::wstring root;          // path passed to GetDiskFreeSpaceExW
+    std::string mount, fs, type, label;
+    const char* kind;
+    double size, free, used, usedPercent;
+    double growth, timeToFull;  // bytes/s, seconds (NAN when not filling)
+    bool ok;
+    std::vector<UsagePoint> history;
+    size_t head;
+    std::shared_ptr<RemoteVolume> remote;   // network drives only
+};
+
+struct PhysicalDriveInfo {
+    std::string name, vendor;
+    const char* interfaceType;
+    double size;
+};
+
+static std::vector<VolumeInfo> volumes;
+static std::vector<PhysicalDriveInfo> physicalDrives;
+static bool drivesProbed = false;
+static std::vector<wchar_t> pathNames(1024);
+
+// Topology is rebuilt on volume arrival/removal and when the drive mask moves.
+// Mounted folders and share remaps raise neither; the safety refresh covers them.
+static volatile LONG volumesDirty = 1;
+static HCMNOTIFICATION volumeNotify = NULL;
+static bool notifyInit = false;
+static DWORD driveMask = 0;
+static ULONGLONG volumesTime = 0;
+static const ULONGLONG VOLUME_REFRESH_MS = 300000;
+
+// GUID_DEVINTERFACE_VOLUME
+static const GUID VolumeInterfaceGuid = { 0x53f5630d, 0xb6bf, 0x11d0, { 0x94, 0xf2, 0x00, 0xa0, 0xc9, 0x1e, 0xfb, 0x8b } };
+
+static DWORD CALLBACK OnVolumeChange(HCMNOTIFICATION notify, PVOID context, CM_NOTIFY_ACTION action,
+                                     PCM_NOTIFY_EVENT_DATA data, DWORD size) {
+    InterlockedExchange(&volumesDirty, 1);
+    return ERROR_SUCCESS;
+}
+
+static void CancelVolumeNotify(void* arg) {
+    if (volumeNotify) { CM_Unregister_Notification(volumeNotify); volumeNotify = NULL; }
+}
+
+// Trims leading/trailing spaces of a NUL-terminated string in place
+static const char* TrimSpaces(char* s) {
+    while (*s == ' ') s++;
+    char* end = s + strlen(s);
+    while (end > s && end[-1] == ' ') *--end = 0;
+    return s;
+}
+
+static void AddVolume(std::vector<VolumeInfo>& next, const wchar_t* id, const wchar_t* path) {
+    const char* kind;
+    bool remote = false;
+    switch (GetDriveTypeW(path)) {
+        case DRIVE_FIXED: kind = "fixed"; break;
+        case DRIVE_REMOVABLE: kind = "removable"; break;
+        case DRIVE_REMOTE: kind = "remote"; remote = true; break;
+        case DRIVE_RAMDISK: kind = "ramdisk"; break;
+        default: return;    // optical drives, unmounted
+    }
+    wchar_t label[MAX_PATH + 1] = {0}, fsType[MAX_PATH + 1] = {0};
+    // Fails for empty card readers and the like; network drives are asked
+    // in the background with their free space
+    if (!remote && !GetVolumeInformationW(path, label, MAX_PATH + 1, nullptr, nullptr, nullptr, fsType, MAX_PATH + 1)) return;
+
+    VolumeInfo v = {};
+    v.root = path;
+    v.mount = WideToUtf8Disk(path);
+    v.id = WideToUtf8Disk(id);
+    v.key = v.id + v.mount;
+    // "C:\" -> "C:", "D:\Data\" -> "D:\Data"
+    v.fs = v.mount;
+    if (v.fs.size() > 1 && v.fs.back() == '\\') v.fs.pop_back();
+    v.type = fsType[0] ? WideToUtf8Disk(fsType) : "NTFS";
+    v.label = WideToUtf8Disk(label);
+    v.kind = kind;
+    v.timeToFull = NAN;
+    // Keep the usage history of volumes that were already known
+    for (auto& old : volumes) {
+        if (old.key == v.key) {
+            v.history.swap(old.history);
+            v.head = old.head;
+            v.remote = old.remote;
+            break;
+        }
+    }
+    if (remote && !v.remote) v.remote = std::make_shared<RemoteVolume>();
+    next.push_back(std::move(v));
+}
+
+// Free space of a network drive from the background query; starts a new
+// one when the last answer is old and none is running
+static bool SampleRemote(VolumeInfo& vol, ULONGLONG now) {
+    std::shared_ptr<RemoteVolume> r = vol.remote;
+    std::lock_guard<std::mutex> guard(r->lock);
+    if (!r->busy && (!r->done || now - r->done >= REMOTE_REFRESH_MS)) {
+        r->busy = true;
+        std::wstring root = vol.root;
+        std::thread([r, root] {
+            ULARGE_INTEGER freeAvail, total, totalFree;
+            wchar_t label[MAX_PATH + 1] = {0}, fsType[MAX_PATH + 1] = {0};
+            bool ok = GetDiskFreeSpaceExW(root.c_str(), &freeAvail, &total, &totalFree) != 0;
+            if (ok) GetVolumeInformationW(root.c_str(), label, MAX_PATH + 1, nullptr, nullptr, nullptr, fsType, MAX_PATH + 1);
+            std::lock_guard<std::mutex> guard(r->lock);
+            r->busy = false;
+            r->done = GetTickCount64();
+            r->ok = ok;
+            if (!ok) return;
+            r->size = (double)total.QuadPart;
+            r->free = (double)totalFree.QuadPart;
+            r->type = fsType[0] ? WideToUtf8Disk(fsType) : "";
+            r->label = WideToUtf8Disk(label);
+        }).detach();
+    }
+    if (!r->ok || !r->done || now - r->done >= REMOTE_MAX_AGE_MS) return false;
+    vol.size = r->size;
+    vol.free = r->free;
+    if (!r->type.empty()) vol.type = r->type;
+    vol.label = r->label;
+    return true;
+}
+
+// Any thread: only touches the returned list
+static std::vector<PhysicalDriveInfo> QueryPhysicalDrives() {
+    std::vector<PhysicalDriveInfo> drives;
+    for (int i = 0; i < 16; i++) {
+        char path[32]; sprintf(path, "\\\\.\\PhysicalDrive%d", i);
+        HANDLE hDisk = CreateFileA(path, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (hDisk == INVALID_HANDLE_VALUE) continue;
+
+        STORAGE_PROPERTY_QUERY query = {StorageDeviceProperty, PropertyStandardQuery};
+        char buffer[1024] = {0};
+        DWORD bytesReturned = 0;
+        if (DeviceIoControl(hDisk, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), buffer, sizeof(buffer), &bytesReturned, nullptr)) {
+            STORAGE_DEVICE_DESCRIPTOR* desc = (STORAGE_DEVICE_DESCRIPTOR*)buffer;
+            PhysicalDriveInfo d = {};
+            // 型号 / 厂商 (去除首尾空格, 原地处理)
+            if (desc->ProductIdOffset) d.name = TrimSpaces(buffer + desc->ProductIdOffset);
+            if (desc->VendorIdOffset) d.vendor = TrimSpaces(buffer + desc->VendorIdOffset);
+            // 类型 (SSD/HDD)
+            d.interfaceType = desc->BusType == BusTypeSata ? "SATA" :
+                              desc->BusType == BusTypeNvme ? "NVMe" : "Unknown";
+            DISK_GEOMETRY_EX geo;
+            if (DeviceIoControl(hDisk, IOCTL_DISK_GET_DRIVE_GEOMETRY_EX, nullptr, 0, &geo, sizeof(geo), &bytesReturned, nullptr)) {
+                d.size = (double)geo.DiskSize.QuadPart;
+            }
+            drives.push_back(d);
+        }
+        CloseHandle(hDisk);
+    }
+    return drives;
+}
+
+// The 16 drive probes are the slow part of the first call; the inventory
+// cache answers it until the deferred refresh probes again
+static void SavePhysicalDrives() {
+    InventoryWriter w;
+    w.U(physicalDrives.size());
+    for (const auto& d : physicalDrives) {
+        w.S(d.name);
+        w.S(d.vendor);
+        w.S(d.interfaceType);
+        w.D(d.size);
+    }
+    InventoryStore("physicalDrives", w.out);
+}
+
+static void ProbePhysicalDrives() {
+    physicalDrives = QueryPhysicalDrives();
+    SavePhysicalDrives();
+}
+
+// Deferred refresh: probes on the inventory worker, stores on the JS thread
+static void* CollectPhysicalDrives() {
+    return new std::vector<PhysicalDriveInfo>(QueryPhysicalDrives());
+}
+
+static void StorePhysicalDrives(void* state) {
+    std::vector<PhysicalDriveInfo>* drives = (std::vector<PhysicalDriveInfo>*)state;
+    physicalDrives.swap(*drives);
+    delete drives;
+    SavePhysicalDrives();
+}
+
+static bool LoadPhysicalDrives() {
+    std::string blob;
+    if (!InventoryLoad("physicalDrives", blob, CollectPhysicalDrives, StorePhysicalDrives)) return false;
+    InventoryReader r(blob);
+    std::vector<PhysicalDriveInfo> cached(r.ok ? (size_t)r.U() : 0);
+    if (cached.size() > 16) return false;
+    for (auto& d : cached) {
+        d.name = r.S();
+        d.vendor = r.S();
+        std::string type = r.S();
+        d.interfaceType = type == "SATA" ? "SATA" : type == "NVMe" ? "NVMe" : "Unknown";
+        d.size = r.D();
+    }
+    if (!r.ok) return false;
+    physicalDrives.swap(cached);
+    return true;
+}
+
+static void RefreshVolumes() {
+    std::vector<VolumeInfo> next;
+    wchar_t volumeName[MAX_PATH];
+    HANDLE find = FindFirstVolumeW(volumeName, MAX_PATH);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            DWORD len = 0;
+            BOOL ok = GetVolumePathNamesForVolumeNameW(volumeName, pathNames.data(), (DWORD)pathNames.size(), &len);
+            if (!ok && GetLastError() == ERROR_MORE_DATA) {
+                pathNames.resize(len);
+                ok = GetVolumePathNamesForVolumeNameW(volumeName, pathNames.data(), (DWORD)pathNames.size(), &len);
+            }
+            if (!ok) continue;
+            // Multi-string: a volume can be mounted at a letter and any number of folders
+            for (const wchar_t* p = pathNames.data(); *p; p += wcslen(p) + 1) AddVolume(next, volumeName, p);
+        } while (FindNextVolumeW(find, volumeName, MAX_PATH));
+        FindVolumeClose(find);
+    }
+    // Mapped network drives are not local volumes
+    for (char letter = 'A'; letter <= 'Z'; letter++) {
+        if (!(driveMask & (1 << (letter - 'A')))) continue;
+        wchar_t root[4] = { (wchar_t)letter, L':', L'\\', 0 };
+        if (GetDriveTypeW(root) == DRIVE_REMOTE) AddVolume(next, L"", root);
+    }
+    volumes.swap(next);
+    bool cached = !drivesProbed && LoadPhysicalDrives();
+    drivesProbed = true;
+    if (!cached) ProbePhysicalDrives();
+}
+
+// Least-squares slope of used bytes over the history; sets growth/timeToFull
+static void Forecast(VolumeInfo& v, ULONGLONG now) {
+    size_t n = v.history.size();
+    size_t newest = n < HISTORY_POINTS ? n - 1 : (v.head + HISTORY_POINTS - 1) % HISTORY_POINTS;
+    if (n == 0 || now - v.history[newest].t >= HISTORY_STEP_MS) {
+        UsagePoint p = { now, v.used };
+        if (n < HISTORY_POINTS) {
+            v.history.push_back(p);
+            n++;
+        } else {
+            v.history[v.head] = p;
+            v.head = (v.head + 1) % HISTORY_POINTS;
+        }
+    }
+    v.growth = 0;
+    v.timeToFull = NAN;
+    size_t oldest = n < HISTORY_POINTS ? 0 : v.head;
+    if (n < 4 || now - v.history[oldest].t < FIT_MIN_SPAN_MS) return;
+
+    double meanT = 0, meanU = 0;
+    for (auto& p : v.history) {
+        meanT += (double)(now - p.t) / 1000.0;
+        meanU += p.used;
+    }
+    meanT /= n;
+    meanU /= n;
+    double sxy = 0, sxx = 0;
+    for (auto& p : v.history) {
+        // Time runs forward: older points have smaller t
+        double dt = -((double)(now - p.t) / 1000.0 - meanT);
+        sxy += dt * (p.used - meanU);
+        sxx += dt * dt;
+    }
+    if (sxx <= 0) return;
+    v.growth = sxy / sxx;
+    if (v.growth > 0) v.timeToFull = v.free / v.growth;
+}
+
+bool DisksSample() {
+    ULONGLONG now = GetTickCount64();
+    if (!notifyInit) {
+        // Without notifications topology is re-read every call
+        CM_NOTIFY_FILTER filter = {};
+        filter.cbSize = sizeof(filter);
+        filter.FilterType = CM_NOTIFY_FILTER_TYPE_DEVICEINTERFACE;
+        filter.u.DeviceInterface.ClassGuid = VolumeInterfaceGuid;
+        if (CM_Register_Notification(&filter, nullptr, OnVolumeChange, &volumeNotify) != CR_SUCCESS) {
+            volumeNotify = NULL;
+        }
+        notifyInit = true;
+    }
+
+    DWORD mask = GetLogicalDrives();
+    bool stale = !volumeNotify || now - volumesTime >= VOLUME_REFRESH_MS || mask != driveMask;
+    if (InterlockedExchange(&volumesDirty, 0) || stale) {
+        driveMask = mask;
+        SelfStatsQueryBegin();
+        RefreshVolumes();
+        SelfStatsQueryEnd(volumes.size() * sizeof(VolumeInfo) + physicalDrives.size() * sizeof(PhysicalDriveInfo));
+        volumesTime = now;
+    }
+
+    // 分区信息: per tick only free space is sampled
+    uint32_t count = 0;
+    double totalUsed = 0;
+    bool publish = SnapshotNeeded(SNAP_DISK);
+    if (publish) {
+        snapshot.disks.clear();
+        SnapshotStrings(SNAP_DISK).Reset();
+    }
+    for (auto& vol : volumes) {
+        if (vol.remote) {
+            vol.ok = SampleRemote(vol, now);
+        } else {
+            ULARGE_INTEGER freeAvail, total, totalFree;
+            SelfStatsQueryBegin();
+            vol.ok = GetDiskFreeSpaceExW(vol.root.c_str(), &freeAvail, &total, &totalFree) != 0;
+            SelfStatsQueryEnd(3 * sizeof(ULARGE_INTEGER));
+            if (vol.ok) {
+                vol.size = (double)total.QuadPart;
+                vol.free = (double)totalFree.QuadPart;
+            }
+        }
+        if (!vol.ok) continue;
+        vol.used = vol.size - vol.free;
+        vol.usedPercent = vol.size > 0 ? vol.used / vol.size * 100.0 : 0;
+        Forecast(vol, now);
+        count++;
+        totalUsed += vol.used;
+
+        if (publish) {
+            snapshot.disks.push_back({ SnapshotStrings(SNAP_DISK).Copy(vol.fs.c_str()), vol.size, vol.used, vol.free, vol.usedPercent, vol.timeToFull });
+        }
+    }
+    if (publish) SnapshotPublish(SNAP_DISK, now);
+    SchedulerSignal(count, 0.5);
+    SchedulerSignal(totalUsed, 64.0 * 1024 * 1024);
+    return true;
+}
+
+napi_value GetDiskInfo(napi_env env, napi_callback_info info) {
+    napi_value result, partitions, physical;
+    napi_create_object(env, &result);
+    napi_create_array(env, &partitions);
+    napi_create_array(env, &physical);
+    DisksSample();
+
+    uint32_t idx = 0;
+    for (auto& vol : volumes) {
+        if (!vol.ok) continue;
+        napi_value disk; napi_create_object(env, &disk);
+        napi_value v;
+        napi_create_string_utf8(env, vol.mount.c_str(), vol.mount.size(), &v); napi_set_named_property(env, disk, "mount", v);
+        napi_create_string_utf8(env, vol.fs.c_str(), vol.fs.size(), &v); napi_set_named_property(env, disk, "fs", v);
+        napi_create_string_utf8(env, vol.id.c_str(), vol.id.size(), &v); napi_set_named_property(env, disk, "volume", v);
+        napi_create_double(env, vol.size, &v); napi_set_named_property(env, disk, "size", v);
+        napi_create_double(env, vol.free, &v); napi_set_named_property(env, disk, "free", v);
+        napi_create_double(env, vol.used, &v); napi_set_named_property(env, disk, "used", v);
+        napi_create_double(env, vol.usedPercent, &v); napi_set_named_property(env, disk, "usedPercent", v);
+        // 文件系统类型
+        napi_create_string_utf8(env, vol.type.c_str(), vol.type.size(), &v); napi_set_named_property(env, disk, "type", v);
+        napi_create_string_utf8(env, vol.label.c_str(), vol.label.size(), &v); napi_set_named_property(env, disk, "label", v);
+        napi_create_string_utf8(env, vol.kind, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, disk, "kind", v);
+        // 增长速率 / 预计写满时间 (秒, 不增长时为 null)
+        napi_create_double(env, vol.growth, &v); napi_set_named_property(env, disk, "growthRate", v);
+        if (isnan(vol.timeToFull)) napi_get_null(env, &v);
+        else napi_create_double(env, vol.timeToFull, &v);
+        napi_set_named_property(env, disk, "timeToFull", v);
+
+        napi_set_element(env, partitions, idx++, disk);
+    }
+    napi_set_named_property(env, result, "partitions", partitions);
+
+    // 物理磁盘信息 (cached with the topology)
+    uint32_t pIdx = 0;
+    for (auto& d : physicalDrives) {
+        napi_value disk; napi_create_object(env, &disk);
+        napi_value v;
+        napi_create_string_utf8(env, d.name.c_str(), d.name.size(), &v); napi_set_named_property(env, disk, "name", v);
+        napi_create_string_utf8(env, d.vendor.c_str(), d.vendor.size(), &v); napi_set_named_property(env, disk, "vendor", v);
+        napi_create_string_utf8(env, d.interfaceType, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, disk, "interfaceType", v);
+        napi_create_double(env, d.size, &v); napi_set_named_property(env, disk, "size", v);
+        napi_set_element(env, physical, pIdx++, disk);
+    }
+    napi_set_named_property(env, result, "physical", physical);
+
+    return result;
+}
+
+void DisksAttach(napi_env env) {
+    napi_add_env_cleanup_hook(env, CancelVolumeNotify, nullptr);
+}
@@ -0,0 +1,24 @@
+#ifndef DISKS_H
+#define DISKS_H
+
+#include <node_api.h>
+
+// getDiskInfo() - mounted volumes (drive letters, mounted folders, mapped
+// network shares) and physical drives.
+// The volume list and drive descriptors are cached and only rebuilt when a
+// volume arrives or leaves, the logical drive mask changes, or a slow
+// safety refresh runs; a tick is one GetDiskFreeSpaceExW per local volume.
+// Network drives are queried on a background thread every 10 s and served
+// from that answer, so an offline share never blocks a tick.
+// Each partition carries `volume`, its volume GUID path (empty for network
+// drives), so that a volume mounted at several paths can be counted once.
+// Used space is kept for about an hour per volume and fitted linearly to
+// forecast the time until the volume is full.
+napi_value GetDiskInfo(napi_env env, napi_callback_info info);
+
+// Takes a sample and publishes the SNAP_DISK snapshot section
+bool DisksSample();
+// Cancels the volume change notification at unload (before SnapshotPumpAttach)
+void DisksAttach(napi_env env);
+
+#endif // DISKS_H
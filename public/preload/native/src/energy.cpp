@@ -0,0 +1,488 @@
+#include "energy.h"
+#include "snapshot.h"
+#include "arena.h"
+#include "replay.h"
+#include "selfstats.h"
+#include <windows.h>
+#include <initguid.h>
+#include <emi.h>
+#include <cfgmgr32.h>
+#include <powrprof.h>
+#include <math.h>
+#include <string.h>
+#include <wchar.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#pragma comment(lib, "cfgmgr32.lib")
+#pragma comment(lib, "powrprof.lib")
+
+static const double JOULES_PER_PWH = 3.6e-9;
+static const double RATE_TAU = 60;                  // s, battery rate smoothing
+static const uint64_t SLOPE_WINDOW_MS = 300000;     // capacity slope fallback
+static const uint64_t SLOPE_STEP_MS = 5000;
+static const size_t SLOPE_POINTS = 64;
+static const uint64_t BATTERY_REUSE_MS = 500;       // one battery read per snapshot tick
+static const uint64_t TRACK_PROCS_MS = 60000;       // keep publishing processes after the last getPowerInfo
+
+// Raw layouts shared by the live readers and replay fixtures
+#pragma pack(push, 1)
+struct EnergyRecord {
+    char name[40];          // channel name, UTF-8
+    uint64_t energy;        // absolute, pWh
+    uint64_t time;          // absolute, 100 ns
+    uint64_t range;         // the counter wraps after this value; 0 = never
+};
+struct BatteryRecord {
+    uint64_t timeMs;
+    SYSTEM_BATTERY_STATE state;
+};
+#pragma pack(pop)
+
+static ReusableBuffer meterBuffer("energyMeters");
+static ReusableBuffer batteryBuffer("batteryState");
+
+static uint64_t NowEpochMs() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000ULL) / 10000;
+}
+
+// ---- EMI devices ----
+struct MeterDevice {
+    HANDLE handle;
+    bool v2;
+    std::vector<std::string> channels;
+};
+
+static std::vector<MeterDevice> devices;
+static bool devicesOpened = false;
+static std::string meterError;
+static std::vector<EMI_CHANNEL_MEASUREMENT_DATA> measurements;
+
+static std::string Narrow(const WCHAR* w, size_t bytes) {
+    int n = (int)(bytes / sizeof(WCHAR));
+    while (n > 0 && w[n - 1] == 0) n--;
+    if (n == 0) return std::string();
+    int len = WideCharToMultiByte(CP_UTF8, 0, w, n, nullptr, 0, nullptr, nullptr);
+    std::string s(len, 0);
+    WideCharToMultiByte(CP_UTF8, 0, w, n, &s[0], len, nullptr, nullptr);
+    return s;
+}
+
+static bool ReadMetadata(MeterDevice& d) {
+    DWORD ret = 0;
+    EMI_VERSION version = {};
+    EMI_METADATA_SIZE size = {};
+    if (!DeviceIoControl(d.handle, IOCTL_EMI_GET_VERSION, nullptr, 0, &version, sizeof(version), &ret, nullptr) ||
+        !DeviceIoControl(d.handle, IOCTL_EMI_GET_METADATA_SIZE, nullptr, 0, &size, sizeof(size), &ret, nullptr) ||
+        size.MetadataSize < sizeof(EMI_METADATA_V1)) return false;
+    std::vector<uint8_t> meta(size.MetadataSize);
+    if (!DeviceIoControl(d.handle, IOCTL_EMI_GET_METADATA, nullptr, 0, meta.data(), (DWORD)meta.size(), &ret, nullptr)) return false;
+    const uint8_t* end = meta.data() + ret;
+
+    d.v2 = version.EmiVersion >= EMI_VERSION_V2;
+    if (!d.v2) {
+        const EMI_METADATA_V1* md = (const EMI_METADATA_V1*)meta.data();
+        size_t bytes = std::min<size_t>(md->MeteredHardwareNameSize, end - (const uint8_t*)md->MeteredHardwareName);
+        d.channels.push_back(Narrow(md->MeteredHardwareName, bytes));
+        return true;
+    }
+    const EMI_METADATA_V2* md = (const EMI_METADATA_V2*)meta.data();
+    const EMI_CHANNEL_V2* c = md->Channels;
+    for (USHORT i = 0; i < md->ChannelCount; i++) {
+        if ((const uint8_t*)c->ChannelName + c->ChannelNameSize > end) return false;
+        d.channels.push_back(Narrow(c->ChannelName, c->ChannelNameSize));
+        c = EMI_CHANNEL_V2_NEXT_CHANNEL(c);
+    }
+    return !d.channels.empty();
+}
+
+static void OpenMeters() {
+    devicesOpened = true;
+    meterError = "no energy meters";
+    ULONG len = 0;
+    if (CM_Get_Device_Interface_List_SizeW(&len, (LPGUID)&GUID_DEVICE_ENERGY_METER, nullptr,
+            CM_GET_DEVICE_INTERFACE_LIST_PRESENT) != CR_SUCCESS || len <= 1) return;
+    std::vector<wchar_t> list(len);
+    if (CM_Get_Device_Interface_ListW((LPGUID)&GUID_DEVICE_ENERGY_METER, nullptr, list.data(), len,
+            CM_GET_DEVICE_INTERFACE_LIST_PRESENT) != CR_SUCCESS) return;
+
+    for (const wchar_t* p = list.data(); *p; p += wcslen(p) + 1) {
+        HANDLE h = CreateFileW(p, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            meterError = "cannot open energy meters (needs admin)";
+            continue;
+        }
+        MeterDevice d = { h, false, {} };
+        if (ReadMetadata(d)) devices.push_back(std::move(d));
+        else CloseHandle(h);
+    }
+    if (!devices.empty()) meterError.clear();
+}
+
+// Fills meterBuffer with one EnergyRecord per channel; returns the count
+static size_t ReadMeters() {
+    size_t recorded = 0;
+    ReplayResult replay = ReplayFill(meterBuffer, recorded);
+    if (replay != REPLAY_LIVE) return replay == REPLAY_SERVED ? recorded / sizeof(EnergyRecord) : 0;
+
+    if (!devicesOpened) OpenMeters();
+    size_t channels = 0;
+    for (auto& d : devices) channels += d.channels.size();
+    if (channels == 0 || !meterBuffer.Reserve(channels * sizeof(EnergyRecord))) return 0;
+
+    EnergyRecord* out = (EnergyRecord*)meterBuffer.Data();
+    size_t n = 0;
+    auto put = [&](const std::string& name, uint64_t energy, uint64_t time) {
+        EnergyRecord& r = out[n++];
+        memset(r.name, 0, sizeof(r.name));
+        memcpy(r.name, name.data(), std::min(name.size(), sizeof(r.name) - 1));
+        r.energy = energy;
+        r.time = time;
+        r.range = 0;    // EMI counters are 64-bit pWh and do not wrap in practice
+    };
+
+    SelfStatsQueryBegin();
+    for (auto& d : devices) {
+        DWORD ret = 0;
+        if (d.v2) {
+            // EMI_MEASUREMENT_DATA_V2 is an array of per-channel measurements
+            measurements.resize(d.channels.size());
+            if (!DeviceIoControl(d.handle, IOCTL_EMI_GET_MEASUREMENT, nullptr, 0, measurements.data(),
+                                 (DWORD)(measurements.size() * sizeof(measurements[0])), &ret, nullptr)) continue;
+            for (size_t i = 0; i < d.channels.size(); i++)
+                put(d.channels[i], measurements[i].AbsoluteEnergy, measurements[i].AbsoluteTime);
+        } else {
+            EMI_MEASUREMENT_DATA_V1 m;
+            if (!DeviceIoControl(d.handle, IOCTL_EMI_GET_MEASUREMENT, nullptr, 0, &m, sizeof(m), &ret, nullptr)) continue;
+            put(d.channels[0], m.AbsoluteEnergy, m.AbsoluteTime);
+        }
+    }
+    SelfStatsQueryEnd(n * sizeof(EnergyRecord));
+    ReplayCapture(meterBuffer, n * sizeof(EnergyRecord));
+    return n;
+}
+
+// ---- Channel deltas ----
+enum EnergyKind { EK_PACKAGE, EK_CORE, EK_DRAM, EK_GPU, EK_OTHER, EK_COUNT };
+static const char* kindNames[EK_COUNT] = { "package", "core", "dram", "gpu", "other" };
+
+struct Channel {
+    std::string name;
+    EnergyKind kind;
+    uint64_t energy = 0, time = 0;
+    double watts = NAN;
+    double joules = 0;          // since the first sample
+    double lastJoules = 0;      // in the last interval
+    bool seen = false;
+    bool present = false;       // in the current sample
+};
+
+static std::vector<Channel> channelState;
+
+static bool EndsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && _stricmp(s.c_str() + s.size() - n, suffix) == 0;
+}
+
+static EnergyKind ChannelKind(const std::string& name) {
+    if (EndsWith(name, "_PKG")) return EK_PACKAGE;
+    if (EndsWith(name, "_PP0")) return EK_CORE;
+    if (EndsWith(name, "_PP1")) return EK_GPU;
+    if (EndsWith(name, "_DRAM")) return EK_DRAM;
+    return EK_OTHER;
+}
+
+static void UpdateChannels(const EnergyRecord* recs, size_t n) {
+    for (auto& c : channelState) {
+        c.lastJoules = 0;
+        c.present = false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        const EnergyRecord& r = recs[i];
+        std::string name(r.name, strnlen(r.name, sizeof(r.name)));
+        Channel* c = nullptr;
+        for (auto& x : channelState) if (x.name == name) { c = &x; break; }
+        if (!c) {
+            channelState.push_back(Channel());
+            c = &channelState.back();
+            c->name = name;
+            c->kind = ChannelKind(name);
+        }
+        c->present = true;
+        if (c->seen && r.time == c->time) continue;
+        c->watts = NAN;
+        if (c->seen && r.time > c->time) {
+            bool valid = true;
+            uint64_t delta = 0;
+            if (r.energy >= c->energy) delta = r.energy - c->energy;
+            else if (r.range && c->energy <= r.range) delta = r.range - c->energy + r.energy + 1;
+            else valid = false;     // reset without a known range
+            if (valid) {
+                c->lastJoules = delta * JOULES_PER_PWH;
+                c->joules += c->lastJoules;
+                c->watts = c->lastJoules / ((r.time - c->time) * 1e-7);
+            }
+        }
+        // A clock going backwards (meter re-enumerated) just starts a new baseline
+        c->energy = r.energy;
+        c->time = r.time;
+        c->seen = true;
+    }
+    channelState.erase(std::remove_if(channelState.begin(), channelState.end(),
+                                      [](const Channel& c) { return !c.present; }), channelState.end());
+}
+
+// ---- Battery ----
+struct CapacityPoint { uint64_t t; double mWh; };
+static CapacityPoint slopePoints[SLOPE_POINTS];
+static size_t slopeHead = 0, slopeCount = 0;
+static double smoothedRate = NAN;
+static uint64_t lastBatteryMs = 0;
+static int lastDirection = 0;
+// Tick of the last live read and whether it succeeded
+static uint64_t batteryReadTick = 0;
+static bool batteryReadOk = false;
+
+static bool ReadBattery(BatteryRecord& rec) {
+    size_t recorded = 0;
+    ReplayResult replay = ReplayFill(batteryBuffer, recorded);
+    if (replay == REPLAY_EMPTY) return false;
+    if (replay == REPLAY_LIVE) {
+        uint64_t tick = GetTickCount64();
+        if (batteryReadTick && tick - batteryReadTick < BATTERY_REUSE_MS) {
+            // getBatteryInfo and getPowerInfo in the same snapshot: the buffer still
+            // holds this tick's record, and the smoother ignores a repeated timestamp
+            if (!batteryReadOk) return false;
+        } else {
+            if (!batteryBuffer.Reserve(sizeof(BatteryRecord))) return false;
+            BatteryRecord* r = (BatteryRecord*)batteryBuffer.Data();
+            r->timeMs = NowEpochMs();
+            SelfStatsQueryBegin();
+            LONG status = CallNtPowerInformation(SystemBatteryState, nullptr, 0, &r->state, sizeof(r->state));
+            SelfStatsQueryEnd(sizeof(r->state));
+            batteryReadTick = tick;
+            batteryReadOk = status == 0;
+            if (!batteryReadOk) return false;
+            ReplayCapture(batteryBuffer, sizeof(BatteryRecord));
+        }
+        recorded = sizeof(BatteryRecord);
+    } else {
+        batteryReadTick = 0;    // the buffer now holds a replayed record
+    }
+    if (recorded < sizeof(BatteryRecord)) return false;
+    memcpy(&rec, batteryBuffer.Data(), sizeof(rec));
+    return true;
+}
+
+// Least-squares slope of remaining capacity over the window, in W
+static double CapacitySlope() {
+    if (slopeCount < 3) return NAN;
+    const CapacityPoint& newest = slopePoints[(slopeHead + SLOPE_POINTS - 1) % SLOPE_POINTS];
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    uint64_t oldest = newest.t;
+    for (size_t i = 0; i < slopeCount; i++) {
+        const CapacityPoint& p = slopePoints[(slopeHead + SLOPE_POINTS - 1 - i) % SLOPE_POINTS];
+        if (newest.t - p.t > SLOPE_WINDOW_MS) break;
+        double x = (double)(newest.t - p.t) / -1000.0;    // s, relative to the newest point
+        n++; sx += x; sy += p.mWh; sxx += x * x; sxy += x * p.mWh;
+        oldest = p.t;
+    }
+    double denom = n * sxx - sx * sx;
+    if (n < 3 || newest.t - oldest < 30000 || denom <= 0) return NAN;
+    return (n * sxy - sx * sy) / denom * 3.6;              // mWh/s -> W
+}
+
+bool EnergyBattery(BatteryEstimate& e) {
+    e = BatteryEstimate();
+    BatteryRecord rec;
+    if (!ReadBattery(rec) || !rec.state.BatteryPresent) return false;
+    const SYSTEM_BATTERY_STATE& s = rec.state;
+    e.present = true;
+    e.charging = s.Charging != 0;
+    e.discharging = s.Discharging != 0;
+    e.remaining = s.RemainingCapacity;
+    e.capacity = s.MaxCapacity;
+
+    // A charge / discharge flip makes the old samples meaningless
+    int direction = e.charging ? 1 : e.discharging ? -1 : 0;
+    if (direction != lastDirection) {
+        slopeCount = 0;
+        smoothedRate = NAN;
+        lastDirection = direction;
+    }
+    const CapacityPoint* newest = slopeCount ? &slopePoints[(slopeHead + SLOPE_POINTS - 1) % SLOPE_POINTS] : nullptr;
+    if (!newest || rec.timeMs >= newest->t + SLOPE_STEP_MS) {
+        slopePoints[slopeHead] = { rec.timeMs, (double)s.RemainingCapacity };
+        slopeHead = (slopeHead + 1) % SLOPE_POINTS;
+        if (slopeCount < SLOPE_POINTS) slopeCount++;
+    }
+
+    e.rate = NAN;
+    if (s.Rate != BATTERY_UNKNOWN_RATE && s.Rate != 0 && direction != 0) {
+        double watts = (int32_t)s.Rate / 1000.0;
+        if (isnan(smoothedRate)) smoothedRate = watts;
+        else if (rec.timeMs > lastBatteryMs) {
+            double dt = (rec.timeMs - lastBatteryMs) / 1000.0;
+            smoothedRate += (1 - exp(-dt / RATE_TAU)) * (watts - smoothedRate);
+        }
+        e.rate = smoothedRate;
+        e.source = "battery";
+    } else if (direction != 0) {
+        e.rate = CapacitySlope();
+        if (!isnan(e.rate)) e.source = "capacity";
+    }
+    lastBatteryMs = rec.timeMs;
+
+    e.timeToEmpty = direction < 0 && e.rate < 0 ? e.remaining / (-e.rate * 1000) * 3600 : NAN;
+    e.timeToFull = direction > 0 && e.rate > 0 && e.capacity > e.remaining
+        ? (e.capacity - e.remaining) / (e.rate * 1000) * 3600 : NAN;
+    return true;
+}
+
+// ---- Per-process attribution ----
+struct ProcEnergy {
+    std::string name;
+    double cpu = 0, watts = 0, joules = 0;
+    bool seen = false;
+};
+
+static std::unordered_map<uint32_t, ProcEnergy> procEnergy;
+static ULONGLONG trackUntil = 0;
+
+bool EnergyNeed(uint32_t section) {
+    return (section & SNAP_PROC) != 0 && GetTickCount64() < trackUntil;
+}
+
+static void Attribute(double watts, double joules) {
+    double total = 0;
+    for (auto& p : snapshot.procs) total += p.cpu;
+    for (auto& kv : procEnergy) kv.second.seen = false;
+    for (auto& p : snapshot.procs) {
+        ProcEnergy& e = procEnergy[p.pid];
+        if (e.name.empty() && p.name) e.name = p.name;
+        double share = total > 0 ? p.cpu / total : 0;
+        e.cpu = p.cpu;
+        e.watts = isnan(watts) ? 0 : watts * share;
+        if (!isnan(joules)) e.joules += joules * share;
+        e.seen = true;
+    }
+    for (auto it = procEnergy.begin(); it != procEnergy.end();) {
+        if (!it->second.seen) it = procEnergy.erase(it);
+        else ++it;
+    }
+}
+
+// ---- Export ----
+static uint64_t lastSampleTime = 0;    // 100 ns, meter clock
+
+static void SetNumber(napi_env env, napi_value obj, const char* name, double value) {
+    napi_value v;
+    if (isnan(value)) napi_get_null(env, &v);
+    else napi_create_double(env, value, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+static bool GetUint32Option(napi_env env, napi_value opts, const char* name, uint32_t& out) {
+    bool has = false;
+    if (napi_has_named_property(env, opts, name, &has) != napi_ok || !has) return false;
+    napi_value v;
+    napi_get_named_property(env, opts, name, &v);
+    return napi_get_value_uint32(env, v, &out) == napi_ok;
+}
+
+napi_value GetPowerInfo(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t procLimit = 10;
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) GetUint32Option(env, argv[0], "procs", procLimit);
+    if (procLimit > 0) trackUntil = GetTickCount64() + TRACK_PROCS_MS;
+
+    size_t n = ReadMeters();
+    const EnergyRecord* recs = (const EnergyRecord*)meterBuffer.Data();
+    UpdateChannels(recs, n);
+    uint64_t sampleTime = 0;
+    for (size_t i = 0; i < n; i++) sampleTime = std::max<uint64_t>(sampleTime, recs[i].time);
+    double interval = lastSampleTime && sampleTime > lastSampleTime ? (sampleTime - lastSampleTime) * 1e-7 : 0;
+    if (sampleTime) lastSampleTime = sampleTime;
+
+    double kindWatts[EK_COUNT], kindJoules[EK_COUNT];
+    bool kindSeen[EK_COUNT] = {};
+    for (int k = 0; k < EK_COUNT; k++) kindWatts[k] = kindJoules[k] = 0;
+    napi_value result, meters, v;
+    napi_create_object(env, &result);
+    napi_create_array(env, &meters);
+    uint32_t idx = 0;
+    for (auto& c : channelState) {
+        napi_value m;
+        napi_create_object(env, &m);
+        napi_create_string_utf8(env, c.name.c_str(), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, m, "name", v);
+        napi_create_string_utf8(env, kindNames[c.kind], NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, m, "kind", v);
+        SetNumber(env, m, "watts", c.watts);
+        SetNumber(env, m, "joules", c.joules);
+        napi_set_element(env, meters, idx++, m);
+        if (!isnan(c.watts)) {
+            kindWatts[c.kind] += c.watts;
+            kindJoules[c.kind] += c.lastJoules;
+            kindSeen[c.kind] = true;
+        }
+    }
+    napi_get_boolean(env, n > 0, &v); napi_set_named_property(env, result, "available", v);
+    napi_set_named_property(env, result, "meters", meters);
+    for (int k = EK_PACKAGE; k <= EK_GPU; k++) SetNumber(env, result, kindNames[k], kindSeen[k] ? kindWatts[k] : NAN);
+
+    BatteryEstimate b;
+    napi_value battery;
+    if (EnergyBattery(b)) {
+        napi_create_object(env, &battery);
+        napi_get_boolean(env, b.charging, &v); napi_set_named_property(env, battery, "charging", v);
+        napi_get_boolean(env, b.discharging, &v); napi_set_named_property(env, battery, "discharging", v);
+        SetNumber(env, battery, "remaining", b.remaining);
+        SetNumber(env, battery, "capacity", b.capacity);
+        SetNumber(env, battery, "rate", b.rate);
+        SetNumber(env, battery, "timeToEmpty", b.timeToEmpty);
+        SetNumber(env, battery, "timeToFull", b.timeToFull);
+        napi_create_string_utf8(env, b.source, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, battery, "source", v);
+    } else {
+        napi_get_null(env, &battery);
+    }
+    napi_set_named_property(env, result, "battery", battery);
+
+    // Core power is the part processes drive; fall back to the whole package
+    int source = kindSeen[EK_CORE] ? EK_CORE : EK_PACKAGE;
+    napi_value processes;
+    napi_create_array(env, &processes);
+    if (procLimit > 0 && kindSeen[source]) {
+        Attribute(kindWatts[source], interval > 0 ? kindJoules[source] : NAN);
+        std::vector<std::pair<uint32_t, const ProcEnergy*>> top;
+        for (auto& kv : procEnergy) top.push_back({ kv.first, &kv.second });
+        size_t count = std::min<size_t>(procLimit, top.size());
+        std::partial_sort(top.begin(), top.begin() + count, top.end(), [](const auto& a, const auto& b) {
+            return a.second->watts != b.second->watts ? a.second->watts > b.second->watts : a.second->joules > b.second->joules;
+        });
+        for (size_t i = 0; i < count; i++) {
+            napi_value p;
+            napi_create_object(env, &p);
+            napi_create_uint32(env, top[i].first, &v); napi_set_named_property(env, p, "pid", v);
+            napi_create_string_utf8(env, top[i].second->name.c_str(), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, p, "name", v);
+            SetNumber(env, p, "cpu", top[i].second->cpu);
+            SetNumber(env, p, "watts", top[i].second->watts);
+            SetNumber(env, p, "joules", top[i].second->joules);
+            napi_set_element(env, processes, (uint32_t)i, p);
+        }
+    }
+    napi_set_named_property(env, result, "processes", processes);
+    SetNumber(env, result, "interval", interval);
+
+    if (n > 0 || meterError.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, meterError.c_str(), NAPI_AUTO_LENGTH, &v);
+    napi_set_named_property(env, result, "error", v);
+    return result;
+}
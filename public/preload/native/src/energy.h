@@ -0,0 +1,44 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Power telemetry: energy meters, battery discharge and per-process energy.
+// Meters are the Energy Metering Interface (EMI) devices Windows exposes
+// for RAPL (channels RAPL_Package0_PKG / _PP0 / _PP1 / _DRAM) and for
+// board power monitors. Each sample reads every channel's absolute energy
+// (pWh) and timestamp; watts come from the delta to the previous sample.
+// A counter that runs backwards wraps at the channel's range, or when it
+// has none (meter reset) the interval is skipped.
+// Battery rate is the rate the battery reports, smoothed over ~1 min, or
+// the slope of remaining capacity over the last 5 min when it reports none.
+// Both raw inputs go through ReusableBuffers ("energyMeters",
+// "batteryState") so fixtures can be replayed (see test-energy.js).
+
+struct BatteryEstimate {
+    bool present = false;
+    bool charging = false;
+    bool discharging = false;
+    double remaining = 0;           // mWh
+    double capacity = 0;            // mWh, full charge
+    double rate = 0;                // W, negative while discharging (NAN if unknown)
+    double timeToEmpty = 0;         // s (NAN unless discharging at a known rate)
+    double timeToFull = 0;          // s (NAN unless charging at a known rate)
+    const char* source = "none";    // "battery" (reported rate) or "capacity" (slope)
+};
+
+// Samples the battery and updates the smoothed rate (also used by getBatteryInfo);
+// calls within 500 ms share one read, so both exports see the same sample
+bool EnergyBattery(BatteryEstimate& out);
+// Whether per-process attribution wants the given snapshot section
+bool EnergyNeed(uint32_t section);
+
+// getPowerInfo({ procs: 10 }) -> { available, meters: [{ name, kind, watts,
+//   joules }], package, core, dram, gpu (W or null), battery, processes:
+//   [{ pid, name, cpu, watts, joules }], interval, error }
+// Process energy splits core (else package) power by CPU share of the
+// last process snapshot; it needs getProcessList() running.
+napi_value GetPowerInfo(napi_env env, napi_callback_info info);
+
+#endif // ENERGY_H
@@ -0,0 +1,433 @@
+#include "handles.h"
+#include "ntinfo.h"
+#include "selfstats.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <thread>
+
+static const size_t RESOLVE_PER_CALL = 4096;
+static const DWORD FILE_QUERY_TIMEOUT_MS = 100;
+static const DWORD CANCEL_GRACE_MS = 50;
+static const LONG MAX_HUNG_QUERIES = 4;
+static const size_t MAX_GROUPS = 4096;
+static const size_t MAX_WATCHES = 4;
+static const ULONGLONG WATCH_IDLE_MS = 60000;
+
+struct HandleGroup {
+    std::string type, target;
+    uint32_t count, prevCount;
+};
+
+// Compact per-handle record: 16 bytes, so 100k handles cost ~1.6 MB
+struct HandleSeen { uint32_t value, typeIndex, access, group; };
+
+struct HandleWatch {
+    DWORD pid;
+    ULONGLONG lastMs;
+    bool truncated;
+    std::vector<HandleGroup> groups;
+    std::unordered_map<std::string, uint32_t> groupIndex;
+    std::vector<HandleSeen> seen;   // sorted by value
+};
+static std::vector<HandleWatch> watches;
+
+static ReusableBuffer handleBuffer("processHandles");
+static std::vector<HandleSeen> nextSeen;
+static std::vector<uint32_t> order, remap;
+// Object type indexes are system-wide
+static std::unordered_map<uint32_t, std::string> typeNames;
+
+static uint32_t GroupId(HandleWatch& w, const std::string& type, const std::string& target) {
+    std::string key = type;
+    key += '\n';
+    key += target;
+    auto it = w.groupIndex.find(key);
+    if (it != w.groupIndex.end()) return it->second;
+    if (w.groups.size() >= MAX_GROUPS && target != "(other)") {
+        w.truncated = true;
+        return GroupId(w, type, "(other)");
+    }
+    uint32_t id = (uint32_t)w.groups.size();
+    w.groups.push_back({ type, target, 0, 0 });
+    w.groupIndex.emplace(key, id);
+    return id;
+}
+
+static const std::string& TypeName(uint32_t typeIndex, HANDLE dup) {
+    auto it = typeNames.find(typeIndex);
+    if (it != typeNames.end()) return it->second;
+    std::string name;
+    if (!dup || !NtObjectTypeName(dup, name) || name.empty()) {
+        char buf[32];
+        sprintf(buf, "Type %u", typeIndex);
+        // Not cached: a later handle with DUP access may resolve it
+        static std::string fallback;
+        fallback = buf;
+        return fallback;
+    }
+    return typeNames.emplace(typeIndex, name).first->second;
+}
+
+static std::string WideToUtf8Handles(const wchar_t* wstr) {
+    if (!wstr) return "";
+    int len = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 1) return "";
+    std::string result(len - 1, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wstr, -1, &result[0], len, nullptr, nullptr);
+    return result;
+}
+
+// ---- File queries ----
+// GetFileType, GetNamedPipeInfo and GetFinalPathNameByHandle on another
+// process's file handle can block (a synchronous pipe with a read pending,
+// an unreachable share), so they run on a worker thread and the JS thread
+// waits at most FILE_QUERY_TIMEOUT_MS per handle. A stuck query is
+// cancelled; if it still does not return, the worker is abandoned with the
+// query (it cleans up and exits if the call ever completes) and a fresh
+// one serves the next handle. At most MAX_HUNG_QUERIES workers may be stuck
+// at a time; beyond that file handles are not queried.
+enum FileQueryState { QUERY_IDLE, QUERY_BUSY, QUERY_DONE, QUERY_ABANDONED, QUERY_QUIT };
+enum FileQueryResult { FILE_QUERIED, FILE_SKIPPED, FILE_HUNG };
+
+struct FileQuery {
+    HANDLE request, done;
+    volatile LONG state;
+    HANDLE dup;                     // in
+    DWORD type, flags, len;         // out
+    BOOL pipe;
+    wchar_t path[1024];
+};
+
+static FileQuery* fileQuery = nullptr;
+static std::thread fileWorker;
+static volatile LONG hungQueries = 0;
+static bool cleanupHooked = false;
+
+static void FileQueryRun(FileQuery* q) {
+    q->type = GetFileType(q->dup);
+    q->len = 0;
+    q->pipe = FALSE;
+    if (q->type == FILE_TYPE_DISK) {
+        q->len = GetFinalPathNameByHandleW(q->dup, q->path, 1024, FILE_NAME_NORMALIZED | VOLUME_NAME_DOS);
+    } else if (q->type == FILE_TYPE_PIPE) {
+        q->flags = 0;
+        q->pipe = GetNamedPipeInfo(q->dup, &q->flags, nullptr, nullptr, nullptr);
+    }
+}
+
+// Owns `q` once started; frees it on quit or after an abandoned query
+static void FileQueryLoop(FileQuery* q) {
+    for (;;) {
+        WaitForSingleObject(q->request, INFINITE);
+        if (q->state == QUERY_QUIT) break;
+        FileQueryRun(q);
+        if (InterlockedCompareExchange(&q->state, QUERY_DONE, QUERY_BUSY) != QUERY_BUSY) {
+            CloseHandle(q->dup);
+            InterlockedDecrement(&hungQueries);
+            break;
+        }
+        SetEvent(q->done);
+    }
+    CloseHandle(q->request);
+    CloseHandle(q->done);
+    delete q;
+}
+
+static void StopFileWorker(void*) {
+    if (!fileQuery) return;
+    fileQuery->state = QUERY_QUIT;
+    SetEvent(fileQuery->request);
+    fileWorker.join();
+    fileQuery = nullptr;
+}
+
+static bool StartFileWorker() {
+    FileQuery* q = new FileQuery();
+    q->request = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    q->done = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!q->request || !q->done) {
+        if (q->request) CloseHandle(q->request);
+        if (q->done) CloseHandle(q->done);
+        delete q;
+        return false;
+    }
+    q->state = QUERY_IDLE;
+    fileWorker = std::thread(FileQueryLoop, q);
+    fileQuery = q;
+    return true;
+}
+
+// Runs the queries for `dup` on the worker. FILE_HUNG: they did not finish
+// in time and the worker now owns `dup`
+static FileQueryResult QueryFile(HANDLE dup, FileQuery& out) {
+    if (!fileQuery && (hungQueries >= MAX_HUNG_QUERIES || !StartFileWorker())) return FILE_SKIPPED;
+    FileQuery* q = fileQuery;
+    q->dup = dup;
+    q->state = QUERY_BUSY;
+    SetEvent(q->request);
+    if (WaitForSingleObject(q->done, FILE_QUERY_TIMEOUT_MS) != WAIT_OBJECT_0) {
+        CancelSynchronousIo(fileWorker.native_handle());
+        if (WaitForSingleObject(q->done, CANCEL_GRACE_MS) != WAIT_OBJECT_0) {
+            InterlockedIncrement(&hungQueries);
+            if (InterlockedCompareExchange(&q->state, QUERY_ABANDONED, QUERY_BUSY) == QUERY_BUSY) {
+                fileWorker.detach();
+                fileQuery = nullptr;
+                return FILE_HUNG;
+            }
+            // Finished right at the deadline
+            InterlockedDecrement(&hungQueries);
+            WaitForSingleObject(q->done, INFINITE);
+        }
+    }
+    q->state = QUERY_IDLE;
+    out.type = q->type;
+    out.flags = q->flags;
+    out.len = q->len;
+    out.pipe = q->pipe;
+    if (q->type == FILE_TYPE_DISK && q->len > 0 && q->len < 1024) memcpy(out.path, q->path, (q->len + 1) * sizeof(wchar_t));
+    return FILE_QUERIED;
+}
+
+// Files are split by what they really are; only disk files are asked for a
+// name (name queries on synchronous pipes can block forever). `owned` is
+// cleared when a hung query keeps `dup`.
+static uint32_t ResolveFile(HandleWatch& w, HANDLE dup, bool& owned) {
+    FileQuery r;
+    FileQueryResult result = QueryFile(dup, r);
+    if (result == FILE_HUNG) owned = false;
+    if (result != FILE_QUERIED) return GroupId(w, "File", "(unresponsive)");
+    if (r.type == FILE_TYPE_DISK) {
+        if (r.len == 0 || r.len >= 1024) return GroupId(w, "File", "");
+        const wchar_t* p = r.path;
+        if (wcsncmp(p, L"\\\\?\\", 4) == 0) p += 4;
+        return GroupId(w, "File", WideToUtf8Handles(p));
+    }
+    if (r.type == FILE_TYPE_PIPE) {
+        if (r.pipe) {
+            return GroupId(w, "Pipe", (r.flags & PIPE_SERVER_END) ? "server end" : "client end");
+        }
+        // AFD endpoints report FILE_TYPE_PIPE but are not pipes
+        return GroupId(w, "Socket", "");
+    }
+    return GroupId(w, "Device", r.type == FILE_TYPE_CHAR ? "character device" : "");
+}
+
+static uint32_t Resolve(napi_env env, HandleWatch& w, HANDLE proc, uint32_t value, uint32_t typeIndex) {
+    HANDLE dup = NULL;
+    if (!proc || !DuplicateHandle(proc, (HANDLE)(ULONG_PTR)value, GetCurrentProcess(), &dup, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+        return GroupId(w, TypeName(typeIndex, NULL), "");
+    }
+    std::string type = TypeName(typeIndex, dup);
+    uint32_t group;
+    char buf[32];
+    bool owned = true;
+    if (!cleanupHooked && type == "File") {
+        napi_add_env_cleanup_hook(env, StopFileWorker, nullptr);
+        cleanupHooked = true;
+    }
+    if (type == "File") {
+        group = ResolveFile(w, dup, owned);
+    } else if (type == "Process") {
+        sprintf(buf, "pid %lu", (unsigned long)GetProcessId(dup));
+        group = GroupId(w, type, buf);
+    } else if (type == "Thread") {
+        // Grouped by owning process, not per thread
+        sprintf(buf, "pid %lu", (unsigned long)GetProcessIdOfThread(dup));
+        group = GroupId(w, type, buf);
+    } else if (type == "Key" || type == "Section" || type == "Mutant" || type == "Event" ||
+               type == "Semaphore" || type == "ALPC Port" || type == "Directory" ||
+               type == "SymbolicLink" || type == "Timer" || type == "Job" ||
+               type == "WindowStation" || type == "Desktop") {
+        std::string name;
+        NtObjectName(dup, name);
+        group = GroupId(w, type, name);
+    } else {
+        group = GroupId(w, type, "");
+    }
+    if (owned) CloseHandle(dup);
+    return group;
+}
+
+static HandleWatch& Watch(DWORD pid, ULONGLONG now) {
+    watches.erase(std::remove_if(watches.begin(), watches.end(),
+        [&](const HandleWatch& w) { return w.pid != pid && now - w.lastMs > WATCH_IDLE_MS; }), watches.end());
+    for (auto& w : watches) if (w.pid == pid) return w;
+    if (watches.size() >= MAX_WATCHES) {
+        auto oldest = std::min_element(watches.begin(), watches.end(),
+            [](const HandleWatch& a, const HandleWatch& b) { return a.lastMs < b.lastMs; });
+        watches.erase(oldest);
+    }
+    watches.emplace_back();
+    HandleWatch& w = watches.back();
+    w.pid = pid;
+    w.lastMs = 0;
+    w.truncated = false;
+    return w;
+}
+
+// Drops groups that are empty in this snapshot; their drop to zero was
+// reported in `changes` by the call that just built the result
+static void Compact(HandleWatch& w) {
+    remap.assign(w.groups.size(), UINT32_MAX);
+    size_t kept = 0;
+    for (size_t i = 0; i < w.groups.size(); i++) {
+        if (w.groups[i].count == 0) continue;
+        if (kept != i) w.groups[kept] = std::move(w.groups[i]);
+        remap[i] = (uint32_t)kept++;
+    }
+    if (kept == w.groups.size()) return;
+    w.groups.resize(kept);
+    w.groupIndex.clear();
+    for (size_t i = 0; i < kept; i++) {
+        std::string key = w.groups[i].type;
+        key += '\n';
+        key += w.groups[i].target;
+        w.groupIndex.emplace(key, (uint32_t)i);
+    }
+    for (auto& s : w.seen) s.group = remap[s.group];
+}
+
+static napi_value GroupObject(napi_env env, const HandleGroup& g) {
+    napi_value item, v;
+    napi_create_object(env, &item);
+    napi_create_string_utf8(env, g.type.c_str(), g.type.size(), &v); napi_set_named_property(env, item, "type", v);
+    napi_create_string_utf8(env, g.target.c_str(), g.target.size(), &v); napi_set_named_property(env, item, "target", v);
+    napi_create_uint32(env, g.count, &v); napi_set_named_property(env, item, "count", v);
+    napi_create_int32(env, (int32_t)g.count - (int32_t)g.prevCount, &v); napi_set_named_property(env, item, "delta", v);
+    return item;
+}
+
+napi_value GetProcessHandles(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t pid = 0, top = 50;
+    if (argc > 0) napi_get_value_uint32(env, argv[0], &pid);
+    if (argc > 1) {
+        napi_valuetype t;
+        napi_typeof(env, argv[1], &t);
+        bool has = false;
+        if (t == napi_object && napi_has_named_property(env, argv[1], "top", &has) == napi_ok && has) {
+            napi_value v;
+            napi_get_named_property(env, argv[1], "top", &v);
+            napi_get_value_uint32(env, v, &top);
+        }
+    }
+
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_create_uint32(env, pid, &v); napi_set_named_property(env, result, "pid", v);
+
+    SelfStatsQueryBegin();
+    HANDLE proc = pid ? OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_DUP_HANDLE, FALSE, pid) : NULL;
+    bool canResolve = proc != NULL;
+    // Without DUP access the handle table is still readable, just not the targets
+    if (!proc && pid) proc = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, pid);
+    const NtHandleSnapshot* snap = proc ? NtQueryProcessHandles(proc, handleBuffer) : nullptr;
+    SelfStatsQueryEnd(snap ? snap->NumberOfHandles * sizeof(NtHandleEntry) : 0);
+
+    if (!snap) {
+        if (proc) CloseHandle(proc);
+        napi_get_boolean(env, false, &v); napi_set_named_property(env, result, "found", v);
+        return result;
+    }
+
+    ULONGLONG now = GetTickCount64();
+    HandleWatch& w = Watch(pid, now);
+    bool first = w.lastMs == 0;
+    for (auto& g : w.groups) {
+        g.prevCount = g.count;
+        g.count = 0;
+    }
+
+    nextSeen.clear();
+    size_t resolved = 0;
+    uint32_t pending = 0;
+    for (ULONG_PTR i = 0; i < snap->NumberOfHandles; i++) {
+        const NtHandleEntry& e = snap->Handles[i];
+        uint32_t value = (uint32_t)(ULONG_PTR)e.HandleValue;
+        uint32_t group = UINT32_MAX;
+        auto it = std::lower_bound(w.seen.begin(), w.seen.end(), value,
+            [](const HandleSeen& s, uint32_t val) { return s.value < val; });
+        if (it != w.seen.end() && it->value == value && it->typeIndex == e.ObjectTypeIndex && it->access == e.GrantedAccess) {
+            group = it->group;
+        } else if (resolved < RESOLVE_PER_CALL) {
+            group = Resolve(env, w, canResolve ? proc : NULL, value, e.ObjectTypeIndex);
+            resolved++;
+        }
+        if (group == UINT32_MAX) {
+            // Over this call's budget: counted now, resolved on a later call
+            w.groups[GroupId(w, TypeName(e.ObjectTypeIndex, NULL), "(pending)")].count++;
+            pending++;
+            continue;
+        }
+        w.groups[group].count++;
+        nextSeen.push_back({ value, (uint32_t)e.ObjectTypeIndex, (uint32_t)e.GrantedAccess, group });
+    }
+    CloseHandle(proc);
+
+    std::sort(nextSeen.begin(), nextSeen.end(), [](const HandleSeen& a, const HandleSeen& b) { return a.value < b.value; });
+    w.seen.swap(nextSeen);
+    double window = first ? 0 : (now - w.lastMs) / 1000.0;
+    w.lastMs = now;
+
+    // Totals per type
+    napi_value byType, list;
+    napi_create_array(env, &byType);
+    std::vector<HandleGroup>& groups = w.groups;
+    order.clear();
+    for (uint32_t i = 0; i < groups.size(); i++) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return groups[a].type < groups[b].type; });
+    uint32_t idx = 0;
+    for (size_t i = 0; i < order.size(); ) {
+        HandleGroup sum = { groups[order[i]].type, "", 0, 0 };
+        for (; i < order.size() && groups[order[i]].type == sum.type; i++) {
+            sum.count += groups[order[i]].count;
+            sum.prevCount += groups[order[i]].prevCount;
+        }
+        if (first) sum.prevCount = sum.count;
+        napi_value item = GroupObject(env, sum);
+        napi_set_element(env, byType, idx++, item);
+    }
+    napi_set_named_property(env, result, "byType", byType);
+
+    // Largest groups
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return groups[a].count > groups[b].count; });
+    napi_create_array(env, &list);
+    idx = 0;
+    for (size_t i = 0; i < order.size() && idx < top && groups[order[i]].count > 0; i++) {
+        if (first) groups[order[i]].prevCount = groups[order[i]].count;
+        napi_set_element(env, list, idx++, GroupObject(env, groups[order[i]]));
+    }
+    napi_set_named_property(env, result, "groups", list);
+
+    // Biggest changes since the previous snapshot
+    napi_create_array(env, &list);
+    idx = 0;
+    if (!first) {
+        auto change = [&](uint32_t i) { return abs((int32_t)groups[i].count - (int32_t)groups[i].prevCount); };
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return change(a) > change(b); });
+        for (size_t i = 0; i < order.size() && idx < top && change(order[i]) > 0; i++) {
+            napi_set_element(env, list, idx++, GroupObject(env, groups[order[i]]));
+        }
+    }
+    napi_set_named_property(env, result, "changes", list);
+
+    napi_get_boolean(env, true, &v); napi_set_named_property(env, result, "found", v);
+    napi_get_boolean(env, canResolve, &v); napi_set_named_property(env, result, "resolved", v);
+    napi_create_double(env, (double)snap->NumberOfHandles, &v); napi_set_named_property(env, result, "total", v);
+    napi_create_uint32(env, pending, &v); napi_set_named_property(env, result, "pending", v);
+    napi_create_uint32(env, (uint32_t)groups.size(), &v); napi_set_named_property(env, result, "groupCount", v);
+    napi_get_boolean(env, w.truncated, &v); napi_set_named_property(env, result, "truncated", v);
+    napi_create_double(env, window, &v); napi_set_named_property(env, result, "window", v);
+
+    Compact(w);
+    return result;
+}
@@ -0,0 +1,17 @@
+#ifndef HANDLES_H
+#define HANDLES_H
+
+#include <node_api.h>
+
+// getProcessHandles(pid, { top }) - open handles of one process grouped by
+// type and target (file path, pipe, socket, registry key, ...), with the
+// change of every group since the previous call for that pid.
+// Snapshots are incremental: a handle value seen before with the same type
+// and access keeps its resolved target, and at most RESOLVE_PER_CALL new
+// handles are resolved per call (the rest show up as "(pending)").
+// File handles are queried on a worker thread with a short timeout; one
+// whose query hangs is grouped as File "(unresponsive)" and not retried.
+// Groups per process are capped; overflow is counted as "(other)".
+napi_value GetProcessHandles(napi_env env, napi_callback_info info);
+
+#endif // HANDLES_H
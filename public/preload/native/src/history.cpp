@@ -0,0 +1,532 @@
+#include "history.h"
+#include "snapshot.h"
+#include <windows.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+static const size_t MAX_SERIES = 256;
+static const size_t MAX_BINS = 256;
+static const uint64_t DEFAULT_WINDOW_MS = 3600 * 1000;
+static const uint32_t MAX_PERCENTILES = 16;
+// Raw samples kept per series for charting: two hours at 1 Hz
+static const size_t RAW_POINTS = 7200;
+static const uint32_t MAX_WIDTH = 16384;
+
+struct Tier { uint64_t widthMs; uint32_t slots; };
+static const Tier tiers[] = { { 60 * 1000, 180 }, { 3600 * 1000, 192 } };
+static const int TIER_COUNT = sizeof(tiers) / sizeof(tiers[0]);
+
+// ---- DDSketch ----
+// Positive values land in bin ceil(log_gamma(v)); every value of a bin is
+// within ALPHA of the bin's representative. Values at or below MIN_VALUE
+// (idle counters, and the odd negative) are counted as zeros.
+static const double ALPHA = 0.01;
+static const double GAMMA = (1 + ALPHA) / (1 - ALPHA);
+static const double MIN_VALUE = 1e-9;
+static const int MIN_INDEX = -1100, MAX_INDEX = 1800;      // ~1e-9 .. ~1e15
+static const double INV_LOG_GAMMA = 1 / log(GAMMA);
+
+struct Bin {
+    int16_t index;
+    uint32_t count;
+};
+
+struct Sketch {
+    uint64_t start = UINT64_MAX;        // bucket start (epoch ms), UINT64_MAX = unused
+    uint64_t count = 0, zeros = 0;
+    double min = 0, max = 0, sum = 0;
+    std::vector<Bin> bins;              // ascending index
+
+    void Reset(uint64_t bucketStart) {
+        start = bucketStart;
+        count = zeros = 0;
+        min = max = sum = 0;
+        bins.clear();
+    }
+
+    void Add(double v) {
+        min = count ? (v < min ? v : min) : v;
+        max = count ? (v > max ? v : max) : v;
+        sum += v;
+        count++;
+        if (v <= MIN_VALUE) {
+            zeros++;
+            return;
+        }
+        int idx = (int)ceil(log(v) * INV_LOG_GAMMA);
+        idx = idx < MIN_INDEX ? MIN_INDEX : idx > MAX_INDEX ? MAX_INDEX : idx;
+        auto it = std::lower_bound(bins.begin(), bins.end(), idx, [](const Bin& b, int i) { return b.index < i; });
+        if (it != bins.end() && it->index == idx) {
+            it->count++;
+            return;
+        }
+        bins.insert(it, { (int16_t)idx, 1 });
+        // Collapse the lowest bins: the high percentiles are the ones asked for
+        if (bins.size() > MAX_BINS) {
+            bins[1].count += bins[0].count;
+            bins.erase(bins.begin());
+        }
+    }
+};
+
+static double BinValue(int index) {
+    return 2 * pow(GAMMA, index) / (GAMMA + 1);
+}
+
+struct Series {
+    std::string name;
+    std::vector<Sketch> rings[TIER_COUNT];
+    // Raw ring, oldest at rawHead once full
+    std::vector<uint64_t> rawTime;
+    std::vector<float> rawValue;
+    size_t rawHead = 0, rawCount = 0;
+};
+
+static std::unordered_map<std::string, Series*> seriesByName;
+static std::vector<Series*> seriesList;
+
+static uint64_t NowEpochMs() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000ULL) / 10000;
+}
+
+static Series* FindSeries(const std::string& name, bool create) {
+    auto it = seriesByName.find(name);
+    if (it != seriesByName.end()) return it->second;
+    if (!create || seriesList.size() >= MAX_SERIES) return nullptr;
+    Series* s = new Series();
+    s->name = name;
+    for (int t = 0; t < TIER_COUNT; t++) s->rings[t].resize(tiers[t].slots);
+    seriesByName.emplace(name, s);
+    seriesList.push_back(s);
+    return s;
+}
+
+static void Add(const std::string& name, double value, uint64_t epochMs) {
+    if (isnan(value)) return;
+    Series* s = FindSeries(name, true);
+    if (!s) return;
+    for (int t = 0; t < TIER_COUNT; t++) {
+        uint64_t start = epochMs - epochMs % tiers[t].widthMs;
+        Sketch& k = s->rings[t][(start / tiers[t].widthMs) % tiers[t].slots];
+        if (k.start != start) k.Reset(start);
+        k.Add(value);
+    }
+    if (s->rawTime.empty()) {
+        s->rawTime.resize(RAW_POINTS);
+        s->rawValue.resize(RAW_POINTS);
+    }
+    size_t slot = (s->rawHead + s->rawCount) % RAW_POINTS;
+    s->rawTime[slot] = epochMs;
+    s->rawValue[slot] = (float)value;
+    if (s->rawCount < RAW_POINTS) s->rawCount++;
+    else s->rawHead = (s->rawHead + 1) % RAW_POINTS;
+}
+
+// disk['C:'].usedPercent
+static std::string Keyed(const char* section, const char* key, const char* field) {
+    std::string name = section;
+    name += "['";
+    name += key ? key : "";
+    name += "'].";
+    name += field;
+    return name;
+}
+
+bool HistoryNeed(uint32_t section) {
+    // Per-process series would be unbounded
+    return section != SNAP_PROC;
+}
+
+void HistoryRecord(uint32_t section, uint64_t nowMs) {
+    (void)nowMs;
+    uint64_t now = NowEpochMs();
+    const Snapshot& s = snapshot;
+    switch (section) {
+    case SNAP_CPU:
+        Add("cpu.total", s.cpuTotal, now);
+        break;
+    case SNAP_MEM:
+        Add("mem.used", s.memUsed, now);
+        Add("mem.usedPercent", s.memUsedPercent, now);
+        Add("mem.committed", s.memCommitted, now);
+        Add("mem.swapUsed", s.swapUsed, now);
+        break;
+    case SNAP_SENSOR:
+        Add("sensor.cpuTemp", s.cpuTemp, now);
+        Add("sensor.cpuFreq", s.cpuFreq, now);
+        Add("sensor.cpuPerf", s.cpuPerf, now);
+        Add("sensor.perfLimit", s.cpuPerfLimit, now);
+        break;
+    case SNAP_PRESSURE:
+        Add("pressure.pageFaultsSec", s.pageFaultsSec, now);
+        Add("pressure.hardFaultsSec", s.hardFaultsSec, now);
+        Add("pressure.pagesSec", s.pagesSec, now);
+        Add("pressure.runQueue", s.runQueue, now);
+        Add("pressure.diskQueue", s.diskQueue, now);
+        break;
+    case SNAP_DISK:
+        for (auto& d : s.disks) {
+            Add(Keyed("disk", d.fs, "used"), d.used, now);
+            Add(Keyed("disk", d.fs, "usedPercent"), d.usedPercent, now);
+        }
+        break;
+    case SNAP_NET: {
+        double rx = 0, tx = 0;
+        for (auto& n : s.net) {
+            Add(Keyed("net", n.name, "rxSec"), n.rxSec, now);
+            Add(Keyed("net", n.name, "txSec"), n.txSec, now);
+            Add(Keyed("net", n.name, "utilization"), n.utilization, now);
+            rx += n.rxSec;
+            tx += n.txSec;
+        }
+        Add("net.rxSec", rx, now);
+        Add("net.txSec", tx, now);
+        break;
+    }
+    }
+}
+
+// ---- Queries ----
+
+static bool GetDoubleOption(napi_env env, napi_value opts, const char* name, double& out) {
+    bool has = false;
+    if (napi_has_named_property(env, opts, name, &has) != napi_ok || !has) return false;
+    napi_value v;
+    napi_get_named_property(env, opts, name, &v);
+    return napi_get_value_double(env, v, &out) == napi_ok;
+}
+
+static void SetNumber(napi_env env, napi_value obj, const char* name, double value, bool valid) {
+    napi_value v;
+    if (valid) napi_create_double(env, value, &v);
+    else napi_get_null(env, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+napi_value QueryMetric(napi_env env, napi_callback_info info) {
+    LARGE_INTEGER freq, t0, t1;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t0);
+
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    std::string name;
+    size_t len = 0;
+    if (argc > 0 && napi_get_value_string_utf8(env, argv[0], nullptr, 0, &len) == napi_ok) {
+        name.resize(len);
+        napi_get_value_string_utf8(env, argv[0], &name[0], len + 1, &len);
+    }
+    uint64_t now = NowEpochMs();
+    double window = (double)DEFAULT_WINDOW_MS, from = -1, to = -1;
+    double percentiles[MAX_PERCENTILES] = { 50, 90, 95, 99 };
+    uint32_t pctCount = 4;
+    napi_valuetype type = napi_undefined;
+    if (argc > 1) napi_typeof(env, argv[1], &type);
+    if (type == napi_object) {
+        GetDoubleOption(env, argv[1], "window", window);
+        GetDoubleOption(env, argv[1], "from", from);
+        GetDoubleOption(env, argv[1], "to", to);
+        bool has = false, isArray = false;
+        napi_value list;
+        if (napi_has_named_property(env, argv[1], "percentiles", &has) == napi_ok && has &&
+            napi_get_named_property(env, argv[1], "percentiles", &list) == napi_ok &&
+            napi_is_array(env, list, &isArray) == napi_ok && isArray) {
+            uint32_t n = 0;
+            napi_get_array_length(env, list, &n);
+            pctCount = 0;
+            for (uint32_t i = 0; i < n && pctCount < MAX_PERCENTILES; i++) {
+                napi_value e;
+                double p;
+                napi_get_element(env, list, i, &e);
+                if (napi_get_value_double(env, e, &p) == napi_ok && p >= 0 && p <= 100) percentiles[pctCount++] = p;
+            }
+        }
+    }
+    uint64_t end = to >= 0 && to < (double)now ? (uint64_t)to : now;
+    uint64_t begin = from >= 0 ? (uint64_t)from : (window < (double)end ? end - (uint64_t)window : 0);
+    if (begin > end) begin = end;
+
+    // Finest tier whose ring still reaches back to `begin`
+    int t = 0;
+    while (t < TIER_COUNT - 1) {
+        uint64_t oldest = now - now % tiers[t].widthMs - (uint64_t)(tiers[t].slots - 1) * tiers[t].widthMs;
+        if (begin >= oldest) break;
+        t++;
+    }
+    const Tier& tier = tiers[t];
+    uint64_t first = begin - begin % tier.widthMs, last = end - end % tier.widthMs;
+
+    Series* series = FindSeries(name, false);
+    // Dense merge over the bin range; zeroing only what was touched
+    static std::vector<uint64_t> merged(MAX_INDEX - MIN_INDEX + 1);
+    int lo = MAX_INDEX, hi = MIN_INDEX;
+    uint64_t count = 0, zeros = 0, buckets = 0;
+    double min = 0, max = 0, sum = 0;
+    if (series) {
+        uint64_t steps = (last - first) / tier.widthMs + 1;
+        if (steps > tier.slots) {
+            steps = tier.slots;
+            first = last - (steps - 1) * tier.widthMs;
+        }
+        for (uint64_t b = first; b <= last; b += tier.widthMs) {
+            const Sketch& k = series->rings[t][(b / tier.widthMs) % tier.slots];
+            if (k.start != b || !k.count) continue;
+            min = count ? std::min(min, k.min) : k.min;
+            max = count ? std::max(max, k.max) : k.max;
+            sum += k.sum;
+            count += k.count;
+            zeros += k.zeros;
+            buckets++;
+            for (auto& bin : k.bins) {
+                merged[bin.index - MIN_INDEX] += bin.count;
+                lo = std::min(lo, (int)bin.index);
+                hi = std::max(hi, (int)bin.index);
+            }
+        }
+    }
+
+    napi_value result, pcts, v;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, name.c_str(), name.size(), &v); napi_set_named_property(env, result, "metric", v);
+    napi_get_boolean(env, series != nullptr, &v); napi_set_named_property(env, result, "found", v);
+    napi_create_double(env, (double)first, &v); napi_set_named_property(env, result, "from", v);
+    napi_create_double(env, (double)(last + tier.widthMs), &v); napi_set_named_property(env, result, "to", v);
+    napi_create_double(env, (double)tier.widthMs, &v); napi_set_named_property(env, result, "bucket", v);
+    napi_create_double(env, (double)buckets, &v); napi_set_named_property(env, result, "buckets", v);
+    napi_create_double(env, (double)count, &v); napi_set_named_property(env, result, "count", v);
+    SetNumber(env, result, "min", min, count > 0);
+    SetNumber(env, result, "max", max, count > 0);
+    SetNumber(env, result, "mean", count ? sum / count : 0, count > 0);
+
+    napi_create_object(env, &pcts);
+    std::sort(percentiles, percentiles + pctCount);
+    // One walk over the merged bins answers every percentile;
+    // cumulative counts the zeros and the bins below idx
+    uint64_t cumulative = zeros;
+    int idx = lo;
+    for (uint32_t i = 0; i < pctCount; i++) {
+        double value = 0;
+        double rank = percentiles[i] / 100 * (double)(count ? count - 1 : 0);
+        if (rank >= (double)zeros && lo <= hi) {
+            while (idx < hi && (double)(cumulative + merged[idx - MIN_INDEX]) <= rank) {
+                cumulative += merged[idx - MIN_INDEX];
+                idx++;
+            }
+            value = BinValue(idx);
+        }
+        // Bin representatives can overshoot the observed extremes
+        if (count) value = std::max(min, std::min(max, value));
+        char key[16];
+        snprintf(key, sizeof(key), "p%g", percentiles[i]);
+        SetNumber(env, pcts, key, value, count > 0);
+    }
+    napi_set_named_property(env, result, "percentiles", pcts);
+    if (lo <= hi) std::fill(merged.begin() + (lo - MIN_INDEX), merged.begin() + (hi - MIN_INDEX) + 1, 0);
+
+    QueryPerformanceCounter(&t1);
+    napi_create_double(env, (double)(t1.QuadPart - t0.QuadPart) * 1e6 / freq.QuadPart, &v);
+    napi_set_named_property(env, result, "elapsed", v);
+    return result;
+}
+
+napi_value GetMetricNames(napi_env env, napi_callback_info info) {
+    std::vector<const std::string*> names;
+    for (auto* s : seriesList) names.push_back(&s->name);
+    std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+    napi_value result, v;
+    napi_create_array(env, &result);
+    for (uint32_t i = 0; i < names.size(); i++) {
+        napi_create_string_utf8(env, names[i]->c_str(), names[i]->size(), &v);
+        napi_set_element(env, result, i, v);
+    }
+    return result;
+}
+
+// ---- Downsampling ----
+
+struct ChartPoint { double t, v, lo, hi; };
+
+// Points of [from, to] from the finest source that reaches back to `from`:
+// raw samples, else per-bucket means (lo/hi carry the bucket min/max)
+static const char* CollectPoints(const Series* s, uint64_t from, uint64_t to, uint64_t now,
+                                 std::vector<ChartPoint>& out) {
+    // Raw while it reaches back far enough, or while nothing older was ever dropped
+    if (s->rawCount && (s->rawTime[s->rawHead] <= from || s->rawCount < RAW_POINTS)) {
+        for (size_t i = 0; i < s->rawCount; i++) {
+            size_t slot = (s->rawHead + i) % RAW_POINTS;
+            uint64_t t = s->rawTime[slot];
+            if (t < from) continue;
+            if (t > to) break;
+            double v = s->rawValue[slot];
+            out.push_back({ (double)t, v, v, v });
+        }
+        return "raw";
+    }
+    int tier = 0;
+    while (tier < TIER_COUNT - 1) {
+        uint64_t oldest = now - now % tiers[tier].widthMs - (uint64_t)(tiers[tier].slots - 1) * tiers[tier].widthMs;
+        if (from >= oldest) break;
+        tier++;
+    }
+    const Tier& t = tiers[tier];
+    uint64_t first = from - from % t.widthMs, last = to - to % t.widthMs;
+    if ((last - first) / t.widthMs >= t.slots) first = last - (uint64_t)(t.slots - 1) * t.widthMs;
+    for (uint64_t b = first; b <= last; b += t.widthMs) {
+        const Sketch& k = s->rings[tier][(b / t.widthMs) % t.slots];
+        if (k.start != b || !k.count) continue;
+        out.push_back({ (double)(b + t.widthMs / 2), k.sum / k.count, k.min, k.max });
+    }
+    return tier == 0 ? "1m" : "1h";
+}
+
+// Largest-Triangle-Three-Buckets: keeps the first and last point and, per
+// bucket, the point spanning the largest triangle with the previously kept
+// point and the next bucket's average
+static void Lttb(const std::vector<ChartPoint>& in, uint32_t threshold, std::vector<ChartPoint>& out) {
+    size_t n = in.size();
+    if (threshold >= n || threshold < 3) {
+        out = in;
+        return;
+    }
+    double every = (double)(n - 2) / (threshold - 2);
+    size_t a = 0;
+    out.push_back(in[0]);
+    for (uint32_t i = 0; i < threshold - 2; i++) {
+        size_t avgStart = (size_t)((i + 1) * every) + 1, avgEnd = (size_t)((i + 2) * every) + 1;
+        if (avgEnd > n) avgEnd = n;
+        double avgT = 0, avgV = 0;
+        for (size_t j = avgStart; j < avgEnd; j++) {
+            avgT += in[j].t;
+            avgV += in[j].v;
+        }
+        size_t span = avgEnd > avgStart ? avgEnd - avgStart : 1;
+        avgT /= span;
+        avgV /= span;
+
+        size_t start = (size_t)(i * every) + 1, end = (size_t)((i + 1) * every) + 1;
+        double best = -1;
+        size_t pick = start;
+        for (size_t j = start; j < end && j < n - 1; j++) {
+            double area = fabs((in[a].t - avgT) * (in[j].v - in[a].v) - (in[a].t - in[j].t) * (avgV - in[a].v));
+            if (area > best) {
+                best = area;
+                pick = j;
+            }
+        }
+        out.push_back(in[pick]);
+        a = pick;
+    }
+    out.push_back(in[n - 1]);
+}
+
+// Pixel column of time t. Bucket midpoints can fall just outside [from, to],
+// so the column is clamped (a negative double -> uint32_t cast is undefined)
+static uint32_t Column(double t, uint64_t from, double span, uint32_t width) {
+    double x = (t - (double)from) / span * width;
+    if (!(x > 0)) return 0;
+    if (x >= width) return width - 1;
+    return (uint32_t)x;
+}
+
+// Per pixel column: its lowest and highest point, in time order
+static void MinMax(const std::vector<ChartPoint>& in, uint64_t from, uint64_t to, uint32_t width,
+                   std::vector<ChartPoint>& out) {
+    double span = (double)(to - from) + 1;
+    size_t i = 0;
+    while (i < in.size()) {
+        uint32_t px = Column(in[i].t, from, span, width);
+        ChartPoint lo = in[i], hi = in[i];
+        lo.v = in[i].lo;
+        hi.v = in[i].hi;
+        for (i++; i < in.size() && Column(in[i].t, from, span, width) == px; i++) {
+            if (in[i].lo < lo.v) { lo = in[i]; lo.v = in[i].lo; }
+            if (in[i].hi > hi.v) { hi = in[i]; hi.v = in[i].hi; }
+        }
+        if (lo.t > hi.t) std::swap(lo, hi);
+        out.push_back(lo);
+        if (hi.t != lo.t || hi.v != lo.v) out.push_back(hi);
+    }
+}
+
+static napi_value Float64Array(napi_env env, const std::vector<ChartPoint>& pts, bool times) {
+    void* data = nullptr;
+    napi_value buffer, array;
+    napi_create_arraybuffer(env, pts.size() * sizeof(double), &data, &buffer);
+    double* d = (double*)data;
+    for (size_t i = 0; i < pts.size(); i++) d[i] = times ? pts[i].t : pts[i].v;
+    napi_create_typedarray(env, napi_float64_array, pts.size(), buffer, 0, &array);
+    return array;
+}
+
+napi_value Downsample(napi_env env, napi_callback_info info) {
+    LARGE_INTEGER freq, t0, t1;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t0);
+
+    size_t argc = 5;
+    napi_value argv[5];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    std::string name, mode;
+    size_t len = 0;
+    if (argc > 0 && napi_get_value_string_utf8(env, argv[0], nullptr, 0, &len) == napi_ok) {
+        name.resize(len);
+        napi_get_value_string_utf8(env, argv[0], &name[0], len + 1, &len);
+    }
+    uint64_t now = NowEpochMs();
+    double from = 0, to = (double)now;
+    uint32_t width = 300;
+    if (argc > 1) napi_get_value_double(env, argv[1], &from);
+    if (argc > 2) napi_get_value_double(env, argv[2], &to);
+    if (argc > 3) napi_get_value_uint32(env, argv[3], &width);
+    napi_valuetype type = napi_undefined;
+    if (argc > 4) napi_typeof(env, argv[4], &type);
+    if (type == napi_object) {
+        bool has = false;
+        napi_value v;
+        if (napi_has_named_property(env, argv[4], "mode", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[4], "mode", &v);
+            if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) == napi_ok) {
+                mode.resize(len);
+                napi_get_value_string_utf8(env, v, &mode[0], len + 1, &len);
+            }
+        }
+    }
+    if (to > (double)now) to = (double)now;
+    if (from < 0) from = 0;
+    if (from > to) from = to;
+    if (width < 3) width = 3;
+    if (width > MAX_WIDTH) width = MAX_WIDTH;
+    bool minmax = mode == "minmax";
+
+    const Series* s = FindSeries(name, false);
+    static std::vector<ChartPoint> points, picked;
+    points.clear();
+    picked.clear();
+    const char* source = s ? CollectPoints(s, (uint64_t)from, (uint64_t)to, now, points) : "raw";
+    if (minmax) MinMax(points, (uint64_t)from, (uint64_t)to, width, picked);
+    else Lttb(points, width, picked);
+
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, name.c_str(), name.size(), &v); napi_set_named_property(env, result, "metric", v);
+    napi_get_boolean(env, s != nullptr, &v); napi_set_named_property(env, result, "found", v);
+    napi_create_double(env, from, &v); napi_set_named_property(env, result, "from", v);
+    napi_create_double(env, to, &v); napi_set_named_property(env, result, "to", v);
+    napi_create_string_utf8(env, source, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "source", v);
+    napi_create_uint32(env, (uint32_t)points.size(), &v); napi_set_named_property(env, result, "input", v);
+    napi_set_named_property(env, result, "times", Float64Array(env, picked, true));
+    napi_set_named_property(env, result, "values", Float64Array(env, picked, false));
+    QueryPerformanceCounter(&t1);
+    napi_create_double(env, (double)(t1.QuadPart - t0.QuadPart) * 1e6 / freq.QuadPart, &v);
+    napi_set_named_property(env, result, "elapsed", v);
+    return result;
+}
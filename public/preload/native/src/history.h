@@ -0,0 +1,41 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Long-window metric history without keeping samples in JS.
+// Every published snapshot section is folded into per-metric DDSketches
+// (relative accuracy 1%, bounded bins) plus count/min/max/sum, one per time
+// bucket: 1-minute buckets for the last 3 hours and 1-hour buckets for the
+// last 8 days. Queries merge the buckets covering the window, so their cost
+// depends on the number of buckets, not on the number of samples.
+// Metric names follow the alert rule syntax: cpu.total, mem.usedPercent,
+// disk['C:'].usedPercent, net['Ethernet'].rxSec, net.rxSec (all adapters),
+// sensor.cpuTemp, pressure.runQueue, ...
+
+// Called from SnapshotPublish after a collector updated `snapshot`
+void HistoryRecord(uint32_t section, uint64_t nowMs);
+// Whether collectors must publish the section for the history
+bool HistoryNeed(uint32_t section);
+
+// queryMetric(metric, { window | from, to, percentiles: [50, 95, 99] })
+//   -> { metric, found, from, to, bucket, buckets, count, min, max, mean,
+//        percentiles: { p50, p95, p99 }, elapsed }
+// window is ms back from now (default 1h); from/to are epoch ms. The
+// window is widened to whole buckets of the finest tier that reaches back
+// far enough; bucket is that tier's width in ms, elapsed the query time in us.
+napi_value QueryMetric(napi_env env, napi_callback_info info);
+// downsample(metric, from, to, width, { mode: 'lttb' | 'minmax' })
+//   -> { metric, found, from, to, source, input, times, values, elapsed }
+// Chart-ready points of [from, to] (epoch ms): Largest-Triangle-Three-Buckets
+// down to `width` points, or the min and max of every pixel column (up to
+// 2 * width points). times/values are Float64Arrays. The input is the raw
+// samples while they reach back far enough (source 'raw', about two hours
+// at 1 Hz), else the per-bucket means ('1m' / '1h'), so the work and the
+// output size stay bounded however long the window is.
+napi_value Downsample(napi_env env, napi_callback_info info);
+// getMetricNames() -> [name, ...]
+napi_value GetMetricNames(napi_env env, napi_callback_info info);
+
+#endif // HISTORY_H
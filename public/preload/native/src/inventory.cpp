@@ -0,0 +1,717 @@
+#include "inventory.h"
+#include "selfstats.h"
+#include "snapshot.h"
+#include <windows.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const char FILE_MAGIC[8] = { 'S', 'M', 'I', 'N', 'V', 'E', 'N', 'T' };
+// Bump when an export's result shape changes, so old files are ignored
+static const uint32_t INVENTORY_VERSION = 2;
+static const int MAX_DEPTH = 16;
+
+enum ValueTag { T_NULL, T_UNDEFINED, T_FALSE, T_TRUE, T_UINT, T_DOUBLE, T_STRING, T_ARRAY, T_OBJECT };
+
+struct Gated {
+    const char* name;
+    napi_callback fn;
+    uint32_t hits;          // calls answered from the file
+    bool live;              // refreshed this session; calls go straight through
+    const char* const* liveFields;                  // left out of the file
+    void (*overlay)(napi_env env, napi_value result);
+    void* (*collect)();                             // off-thread refresh, see InventoryOffThread
+    napi_value (*build)(napi_env env, void* state);
+};
+
+static Gated gated[] = {
+    { "getSystemInfo" },
+    { "getCpuInfo" },
+    { "getGpuInfo" },
+    { "getMemoryHardware" },
+};
+static const int GATED_COUNT = sizeof(gated) / sizeof(gated[0]);
+
+struct Item {
+    std::string key, blob;
+};
+
+static bool enabled = true;
+static std::wstring path;
+static uint32_t refreshDelayMs = 2000;
+static bool loaded = false, valid = false, dirty = false;
+static uint64_t fingerprint = 0, savedAt = 0;
+static double loadMs = 0;
+static uint32_t refreshes = 0;
+static std::string lastError;
+static std::vector<Item> items;
+struct NativeRefresher {
+    void* (*collect)();
+    void (*store)(void* state);
+    void* state;
+};
+static std::vector<NativeRefresher> nativeRefreshers;
+
+static napi_threadsafe_function refreshTsfn = nullptr;
+static napi_ref onRefreshRef = nullptr;
+static std::thread timer;
+static std::mutex timerLock;
+static std::condition_variable timerWake;
+static bool refreshPending = false, stopping = false;
+
+// ---- Blob helpers ----
+
+void InventoryWriter::U(uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((char)v);
+}
+
+void InventoryWriter::D(double v) {
+    out.append((const char*)&v, sizeof(v));
+}
+
+void InventoryWriter::S(const std::string& s) {
+    U(s.size());
+    out.append(s);
+}
+
+uint64_t InventoryReader::U() {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p >= end) break;
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    ok = false;
+    return 0;
+}
+
+double InventoryReader::D() {
+    double v = 0;
+    if (end - p < (ptrdiff_t)sizeof(v)) {
+        ok = false;
+        return 0;
+    }
+    memcpy(&v, p, sizeof(v));
+    p += sizeof(v);
+    return v;
+}
+
+std::string InventoryReader::S() {
+    uint64_t n = U();
+    if (!ok || (uint64_t)(end - p) < n) {
+        ok = false;
+        return "";
+    }
+    std::string s((const char*)p, (size_t)n);
+    p += n;
+    return s;
+}
+
+// ---- napi value <-> blob ----
+
+static bool Skipped(const char* const* skip, const std::string& key) {
+    for (; skip && *skip; skip++) {
+        if (key == *skip) return true;
+    }
+    return false;
+}
+
+// `skip` lists top-level object keys to leave out
+static bool EncodeValue(napi_env env, napi_value value, InventoryWriter& w, int depth,
+                        const char* const* skip = nullptr) {
+    if (depth > MAX_DEPTH) return false;
+    napi_valuetype type;
+    if (napi_typeof(env, value, &type) != napi_ok) return false;
+    switch (type) {
+    case napi_null: w.out.push_back(T_NULL); return true;
+    case napi_undefined: w.out.push_back(T_UNDEFINED); return true;
+    case napi_boolean: {
+        bool b = false;
+        napi_get_value_bool(env, value, &b);
+        w.out.push_back(b ? T_TRUE : T_FALSE);
+        return true;
+    }
+    case napi_number: {
+        double d = 0;
+        napi_get_value_double(env, value, &d);
+        // Counts, sizes and ids are whole numbers; varints keep them small
+        if (d >= 0 && d < 4503599627370496.0 && d == floor(d)) {
+            w.out.push_back(T_UINT);
+            w.U((uint64_t)d);
+        } else {
+            w.out.push_back(T_DOUBLE);
+            w.D(d);
+        }
+        return true;
+    }
+    case napi_string: {
+        size_t len = 0;
+        napi_get_value_string_utf8(env, value, nullptr, 0, &len);
+        std::string s(len, 0);
+        napi_get_value_string_utf8(env, value, &s[0], len + 1, &len);
+        w.out.push_back(T_STRING);
+        w.S(s);
+        return true;
+    }
+    case napi_object: {
+        bool isArray = false;
+        napi_is_array(env, value, &isArray);
+        napi_value keys = value;
+        if (!isArray && napi_get_property_names(env, value, &keys) != napi_ok) return false;
+        uint32_t n = 0;
+        napi_get_array_length(env, keys, &n);
+        w.out.push_back(isArray ? T_ARRAY : T_OBJECT);
+        // The count is patched once skipped keys are known; one varint byte while it fits
+        size_t countAt = w.out.size();
+        w.U(n);
+        uint32_t written = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            napi_value key, item;
+            if (isArray) {
+                napi_get_element(env, value, i, &item);
+            } else {
+                napi_get_element(env, keys, i, &key);
+                size_t len = 0;
+                napi_get_value_string_utf8(env, key, nullptr, 0, &len);
+                std::string s(len, 0);
+                napi_get_value_string_utf8(env, key, &s[0], len + 1, &len);
+                if (depth == 0 && Skipped(skip, s)) continue;
+                w.S(s);
+                napi_get_property(env, value, key, &item);
+            }
+            if (!EncodeValue(env, item, w, depth + 1)) return false;
+            written++;
+        }
+        if (written != n) {
+            InventoryWriter count;
+            count.U(written);
+            size_t old = 0;
+            while (w.out[countAt + old] & 0x80) old++;
+            w.out.replace(countAt, old + 1, count.out);
+        }
+        return true;
+    }
+    default:
+        return false;   // functions, symbols, ... never appear in inventory results
+    }
+}
+
+static bool DecodeValue(napi_env env, InventoryReader& r, napi_value* out, int depth) {
+    if (depth > MAX_DEPTH || r.p >= r.end) return false;
+    uint8_t tag = *r.p++;
+    switch (tag) {
+    case T_NULL: napi_get_null(env, out); break;
+    case T_UNDEFINED: napi_get_undefined(env, out); break;
+    case T_FALSE: napi_get_boolean(env, false, out); break;
+    case T_TRUE: napi_get_boolean(env, true, out); break;
+    case T_UINT: napi_create_double(env, (double)r.U(), out); break;
+    case T_DOUBLE: napi_create_double(env, r.D(), out); break;
+    case T_STRING: {
+        std::string s = r.S();
+        napi_create_string_utf8(env, s.data(), s.size(), out);
+        break;
+    }
+    case T_ARRAY: {
+        uint64_t n = r.U();
+        if (!r.ok || n > (uint64_t)(r.end - r.p)) return false;
+        napi_create_array_with_length(env, (size_t)n, out);
+        for (uint32_t i = 0; i < n; i++) {
+            napi_value item;
+            if (!DecodeValue(env, r, &item, depth + 1)) return false;
+            napi_set_element(env, *out, i, item);
+        }
+        break;
+    }
+    case T_OBJECT: {
+        uint64_t n = r.U();
+        if (!r.ok || n > (uint64_t)(r.end - r.p)) return false;
+        napi_create_object(env, out);
+        for (uint64_t i = 0; i < n; i++) {
+            std::string key = r.S();
+            napi_value item;
+            if (!r.ok || !DecodeValue(env, r, &item, depth + 1)) return false;
+            napi_set_named_property(env, *out, key.c_str(), item);
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return r.ok;
+}
+
+// ---- File ----
+
+static uint64_t NowEpochMs() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (t - 116444736000000000ULL) / 10000;
+}
+
+static uint64_t Fnv(uint64_t h, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        h ^= (v >> (i * 8)) & 0xff;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Cheap enough for every startup: a registry value and a few counters
+static uint64_t ComputeFingerprint() {
+    uint64_t h = 1469598103934665603ULL;
+    DWORD bootId = 0, size = sizeof(bootId);
+    if (RegGetValueW(HKEY_LOCAL_MACHINE,
+            L"SYSTEM\\CurrentControlSet\\Control\\Session Manager\\Memory Management\\PrefetchParameters",
+            L"BootId", RRF_RT_REG_DWORD, nullptr, &bootId, &size) != ERROR_SUCCESS) {
+        // No boot counter: boot time to the minute (a rare miss only costs a cold start)
+        bootId = (DWORD)((NowEpochMs() - GetTickCount64()) / 60000);
+    }
+    h = Fnv(h, bootId);
+    SYSTEM_INFO si; GetNativeSystemInfo(&si);
+    h = Fnv(h, si.dwNumberOfProcessors);
+    MEMORYSTATUSEX mem = {};
+    mem.dwLength = sizeof(mem);
+    GlobalMemoryStatusEx(&mem);
+    h = Fnv(h, mem.ullTotalPhys);
+    h = Fnv(h, (uint64_t)GetSystemMetrics(SM_CMONITORS));
+    h = Fnv(h, ((uint64_t)GetSystemMetrics(SM_CXVIRTUALSCREEN) << 32) | (uint32_t)GetSystemMetrics(SM_CYVIRTUALSCREEN));
+    h = Fnv(h, GetLogicalDrives());
+    return h;
+}
+
+static std::string WideToUtf8Inv(const std::wstring& w) {
+    if (w.empty()) return "";
+    int len = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return "";
+    std::string s(len - 1, 0);
+    WideCharToMultiByte(CP_UTF8, 0, w.c_str(), -1, &s[0], len, nullptr, nullptr);
+    return s;
+}
+
+static std::wstring Utf8ToWideInv(const std::string& s) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
+    if (len <= 0) return L"";
+    std::wstring w(len - 1, 0);
+    MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, &w[0], len);
+    return w;
+}
+
+static void DefaultPath() {
+    wchar_t base[MAX_PATH];
+    DWORD n = GetEnvironmentVariableW(L"LOCALAPPDATA", base, MAX_PATH);
+    if (n == 0 || n >= MAX_PATH) n = GetTempPathW(MAX_PATH, base);
+    path.assign(base, n);
+    if (!path.empty() && path.back() != L'\\') path += L'\\';
+    path += L"sysmon\\inventory.bin";
+}
+
+static void EnsureLoaded() {
+    if (loaded) return;
+    loaded = true;
+    LARGE_INTEGER freq, t0, t1;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t0);
+    if (path.empty()) DefaultPath();
+    fingerprint = ComputeFingerprint();
+
+    std::string data;
+    FILE* f = _wfopen(path.c_str(), L"rb");
+    if (f) {
+        char buf[16384];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.append(buf, n);
+        fclose(f);
+    }
+    if (data.size() > sizeof(FILE_MAGIC) && memcmp(data.data(), FILE_MAGIC, sizeof(FILE_MAGIC)) == 0) {
+        InventoryReader r(data);
+        r.p += sizeof(FILE_MAGIC);
+        uint64_t version = r.U(), fp = r.U(), saved = r.U(), count = r.U();
+        if (r.ok && version == INVENTORY_VERSION && fp == fingerprint) {
+            std::vector<Item> next;
+            for (uint64_t i = 0; i < count && r.ok; i++) {
+                Item item;
+                item.key = r.S();
+                item.blob = r.S();
+                next.push_back(std::move(item));
+            }
+            if (r.ok) {
+                items.swap(next);
+                savedAt = saved;
+                valid = true;
+            }
+        }
+    }
+    QueryPerformanceCounter(&t1);
+    loadMs = (double)(t1.QuadPart - t0.QuadPart) * 1000.0 / freq.QuadPart;
+}
+
+static void Save() {
+    InventoryWriter w;
+    w.out.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+    w.U(INVENTORY_VERSION);
+    w.U(fingerprint);
+    uint64_t now = NowEpochMs();
+    w.U(now);
+    w.U(items.size());
+    for (const auto& item : items) {
+        w.S(item.key);
+        w.S(item.blob);
+    }
+
+    size_t slash = path.find_last_of(L"\\/");
+    if (slash != std::wstring::npos) CreateDirectoryW(path.substr(0, slash).c_str(), nullptr);
+    // Write then rename, so a crash never leaves a torn file
+    std::wstring tmp = path + L".tmp";
+    FILE* f = _wfopen(tmp.c_str(), L"wb");
+    bool ok = f && fwrite(w.out.data(), 1, w.out.size(), f) == w.out.size();
+    if (f) ok = fclose(f) == 0 && ok;
+    if (ok && MoveFileExW(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        dirty = false;
+        valid = true;
+        savedAt = now;
+        lastError.clear();
+    } else {
+        lastError = "cannot write " + WideToUtf8Inv(path);
+    }
+}
+
+static const std::string* Find(const char* key) {
+    for (const auto& item : items) {
+        if (item.key == key) return &item.blob;
+    }
+    return nullptr;
+}
+
+static void Put(const char* key, const std::string& blob) {
+    for (auto& item : items) {
+        if (item.key != key) continue;
+        if (item.blob != blob) {
+            item.blob = blob;
+            dirty = true;
+        }
+        return;
+    }
+    items.push_back({ key, blob });
+    dirty = true;
+}
+
+// ---- Deferred refresh ----
+
+static void ScheduleRefresh() {
+    if (refreshPending || !refreshTsfn) return;
+    refreshPending = true;
+    if (timer.joinable()) timer.join();
+    uint32_t delay = refreshDelayMs;
+    timer = std::thread([delay] {
+        std::unique_lock<std::mutex> lock(timerLock);
+        if (timerWake.wait_for(lock, std::chrono::milliseconds(delay), [] { return stopping; })) return;
+        lock.unlock();
+        napi_call_threadsafe_function(refreshTsfn, nullptr, napi_tsfn_nonblocking);
+    });
+}
+
+struct RefreshJob {
+    napi_async_work work = nullptr;
+    bool run[GATED_COUNT] = {};
+    void* state[GATED_COUNT] = {};
+    std::vector<NativeRefresher> natives;
+};
+
+// Worker thread: only the split collectors and native refreshers, nothing
+// shared with the JS thread
+static void ExecuteRefresh(napi_env, void* data) {
+    RefreshJob* job = (RefreshJob*)data;
+    for (int i = 0; i < GATED_COUNT; i++) {
+        if (job->run[i] && gated[i].collect) job->state[i] = gated[i].collect();
+    }
+    for (auto& n : job->natives) n.state = n.collect();
+}
+
+// JS thread: values for everything answered from the file, then the
+// native refreshers' stores, the save and the onRefresh callback
+static void CompleteRefresh(napi_env env, napi_status, void* data) {
+    RefreshJob* job = (RefreshJob*)data;
+    napi_value fresh;
+    napi_create_object(env, &fresh);
+    bool any = false;
+    // Collector state (physical drives, ...) is shared with the snapshot pump
+    std::unique_lock<std::recursive_mutex> guard(snapshotLock);
+    for (int i = 0; i < GATED_COUNT; i++) {
+        Gated& g = gated[i];
+        if (!job->run[i]) continue;
+        g.live = true;
+        napi_value result;
+        if (g.collect) {
+            result = g.build(env, job->state[i]);
+        } else {
+            napi_value fn, global;
+            napi_get_global(env, &global);
+            napi_create_function(env, g.name, NAPI_AUTO_LENGTH, g.fn, nullptr, &fn);
+            if (napi_call_function(env, global, fn, 0, nullptr, &result) != napi_ok) {
+                napi_value error;
+                napi_get_and_clear_last_exception(env, &error);
+                continue;
+            }
+        }
+        InventoryWriter w;
+        if (EncodeValue(env, result, w, 0, g.liveFields)) Put(g.name, w.out);
+        napi_set_named_property(env, fresh, g.name, result);
+        any = true;
+    }
+    for (auto& n : job->natives) n.store(n.state);
+    napi_delete_async_work(env, job->work);
+    delete job;
+
+    refreshes++;
+    // Stores made by the refreshers above are saved here, not rescheduled
+    refreshPending = false;
+    if (dirty && enabled) Save();
+    // Queued while this refresh was running
+    if (!nativeRefreshers.empty()) ScheduleRefresh();
+    guard.unlock();
+
+    // Hand the fresh values to the page, which only asked once at startup
+    napi_value callback, global, ignored;
+    if (any && onRefreshRef && napi_get_reference_value(env, onRefreshRef, &callback) == napi_ok && callback) {
+        napi_get_global(env, &global);
+        if (napi_call_function(env, global, callback, 1, &fresh, &ignored) != napi_ok) {
+            napi_value error;
+            napi_get_and_clear_last_exception(env, &error);
+        }
+    }
+}
+
+// Runs on the JS thread once the refresh delay has passed
+static void RunRefresh(napi_env env, napi_value, void*, void*) {
+    if (!env) return;
+    std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+    RefreshJob* job = new RefreshJob();
+    for (int i = 0; i < GATED_COUNT; i++) {
+        job->run[i] = !gated[i].live && gated[i].fn && gated[i].hits;
+    }
+    job->natives.swap(nativeRefreshers);
+    napi_value name;
+    napi_create_string_utf8(env, "sysmonInventoryRefresh", NAPI_AUTO_LENGTH, &name);
+    if (napi_create_async_work(env, nullptr, name, ExecuteRefresh, CompleteRefresh, job, &job->work) != napi_ok ||
+        napi_queue_async_work(env, job->work) != napi_ok) {
+        // No worker: collect inline rather than never refreshing
+        ExecuteRefresh(env, job);
+        CompleteRefresh(env, napi_ok, job);
+    }
+}
+
+static napi_value RunGated(Gated& g, napi_env env, napi_callback_info info) {
+    if (enabled && !g.live) {
+        EnsureLoaded();
+        const std::string* blob = valid ? Find(g.name) : nullptr;
+        napi_value cached;
+        if (blob) {
+            InventoryReader r(*blob);
+            if (DecodeValue(env, r, &cached, 0)) {
+                napi_value v;
+                napi_get_boolean(env, true, &v);
+                napi_set_named_property(env, cached, "cached", v);
+                if (g.overlay) g.overlay(env, cached);
+                g.hits++;
+                SelfStatsSkip();
+                ScheduleRefresh();
+                return cached;
+            }
+        }
+    }
+
+    napi_value result = g.fn(env, info);
+    if (enabled && !g.live && result) {
+        // Cold start: keep this answer for the next session
+        g.live = true;
+        InventoryWriter w;
+        if (EncodeValue(env, result, w, 0, g.liveFields)) Put(g.name, w.out);
+        if (dirty) ScheduleRefresh();
+    }
+    return result;
+}
+
+template <int N>
+static napi_value Gate(napi_env env, napi_callback_info info) {
+    return RunGated(gated[N], env, info);
+}
+static const napi_callback gates[] = { Gate<0>, Gate<1>, Gate<2>, Gate<3> };
+static_assert(sizeof(gates) / sizeof(gates[0]) == GATED_COUNT, "one gate per cached export");
+
+static void CleanupInventory(void* arg) {
+    {
+        std::lock_guard<std::mutex> lock(timerLock);
+        stopping = true;
+    }
+    timerWake.notify_all();
+    if (timer.joinable()) timer.join();
+    if (refreshTsfn) napi_release_threadsafe_function(refreshTsfn, napi_tsfn_abort);
+    refreshTsfn = nullptr;
+    if (onRefreshRef) napi_delete_reference((napi_env)arg, onRefreshRef);
+    onRefreshRef = nullptr;
+}
+
+static Gated* FindGated(const char* name) {
+    for (auto& g : gated) {
+        if (strcmp(g.name, name) == 0) return &g;
+    }
+    return nullptr;
+}
+
+void InventoryLive(const char* name, const char* const* fields, void (*overlay)(napi_env env, napi_value result)) {
+    Gated* g = FindGated(name);
+    if (!g) return;
+    g->liveFields = fields;
+    g->overlay = overlay;
+}
+
+void InventoryOffThread(const char* name, void* (*collect)(), napi_value (*build)(napi_env env, void* state)) {
+    Gated* g = FindGated(name);
+    if (!g) return;
+    g->collect = collect;
+    g->build = build;
+}
+
+void InventoryAttach(napi_env env, napi_property_descriptor* props, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (!props[i].utf8name || !props[i].method) continue;
+        for (int j = 0; j < GATED_COUNT; j++) {
+            if (strcmp(props[i].utf8name, gated[j].name) != 0) continue;
+            gated[j].fn = props[i].method;
+            props[i].method = gates[j];
+            break;
+        }
+    }
+    if (refreshTsfn) return;
+    napi_value name;
+    napi_create_string_utf8(env, "inventoryRefresh", NAPI_AUTO_LENGTH, &name);
+    if (napi_create_threadsafe_function(env, nullptr, nullptr, name, 0, 1, nullptr, nullptr, nullptr,
+            RunRefresh, &refreshTsfn) == napi_ok) {
+        // A pending refresh must not keep the process alive
+        napi_unref_threadsafe_function(env, refreshTsfn);
+        napi_add_env_cleanup_hook(env, CleanupInventory, env);
+    }
+}
+
+bool InventoryLoad(const char* key, std::string& blob, void* (*collect)(), void (*store)(void* state)) {
+    if (!enabled) return false;
+    EnsureLoaded();
+    const std::string* found = valid ? Find(key) : nullptr;
+    if (!found) return false;
+    blob = *found;
+    bool queued = false;
+    for (auto& n : nativeRefreshers) queued = queued || n.collect == collect;
+    if (!queued) nativeRefreshers.push_back({ collect, store, nullptr });
+    ScheduleRefresh();
+    return true;
+}
+
+void InventoryStore(const char* key, const std::string& blob) {
+    if (!enabled) return;
+    EnsureLoaded();
+    Put(key, blob);
+    if (dirty) ScheduleRefresh();
+}
+
+// ---- N-API exports ----
+
+napi_value GetInventoryCache(napi_env env, napi_callback_info info) {
+    if (enabled) EnsureLoaded();
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    napi_get_boolean(env, enabled, &v); napi_set_named_property(env, result, "enabled", v);
+    std::string p = WideToUtf8Inv(path);
+    napi_create_string_utf8(env, p.c_str(), p.size(), &v); napi_set_named_property(env, result, "path", v);
+    napi_get_boolean(env, valid, &v); napi_set_named_property(env, result, "valid", v);
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)fingerprint);
+    napi_create_string_utf8(env, hex, 16, &v); napi_set_named_property(env, result, "fingerprint", v);
+
+    uint32_t hits = 0;
+    napi_create_array(env, &list);
+    for (size_t i = 0; i < items.size(); i++) {
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, items[i].key.c_str(), items[i].key.size(), &v); napi_set_named_property(env, item, "key", v);
+        napi_create_uint32(env, (uint32_t)items[i].blob.size(), &v); napi_set_named_property(env, item, "bytes", v);
+        uint32_t itemHits = 0;
+        for (const auto& g : gated) {
+            if (items[i].key == g.name) itemHits = g.hits;
+        }
+        hits += itemHits;
+        napi_create_uint32(env, itemHits, &v); napi_set_named_property(env, item, "hits", v);
+        napi_set_element(env, list, (uint32_t)i, item);
+    }
+    napi_set_named_property(env, result, "entries", list);
+    napi_create_uint32(env, hits, &v); napi_set_named_property(env, result, "hits", v);
+    napi_create_uint32(env, refreshes, &v); napi_set_named_property(env, result, "refreshed", v);
+    napi_create_double(env, (double)savedAt, &v); napi_set_named_property(env, result, "savedAt", v);
+    napi_create_double(env, loadMs, &v); napi_set_named_property(env, result, "loadMs", v);
+    if (lastError.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, lastError.c_str(), lastError.size(), &v);
+    napi_set_named_property(env, result, "error", v);
+    return result;
+}
+
+napi_value SetInventoryCache(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type != napi_object) return GetInventoryCache(env, info);
+
+    bool has = false;
+    napi_value v;
+    if (napi_has_named_property(env, argv[0], "enabled", &has) == napi_ok && has) {
+        napi_get_named_property(env, argv[0], "enabled", &v);
+        napi_get_value_bool(env, v, &enabled);
+    }
+    if (napi_has_named_property(env, argv[0], "refreshDelay", &has) == napi_ok && has) {
+        napi_get_named_property(env, argv[0], "refreshDelay", &v);
+        napi_get_value_uint32(env, v, &refreshDelayMs);
+    }
+    if (napi_has_named_property(env, argv[0], "path", &has) == napi_ok && has) {
+        napi_get_named_property(env, argv[0], "path", &v);
+        size_t len = 0;
+        if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) == napi_ok) {
+            std::string s(len, 0);
+            napi_get_value_string_utf8(env, v, &s[0], len + 1, &len);
+            path = Utf8ToWideInv(s);
+            // Reload from the new location on next use
+            loaded = valid = dirty = false;
+            items.clear();
+        }
+    }
+    if (napi_has_named_property(env, argv[0], "onRefresh", &has) == napi_ok && has) {
+        napi_get_named_property(env, argv[0], "onRefresh", &v);
+        napi_valuetype t = napi_undefined;
+        napi_typeof(env, v, &t);
+        if (onRefreshRef) napi_delete_reference(env, onRefreshRef);
+        onRefreshRef = nullptr;
+        if (t == napi_function) napi_create_reference(env, v, 1, &onRefreshRef);
+    }
+    if (napi_has_named_property(env, argv[0], "clear", &has) == napi_ok && has) {
+        bool clear = false;
+        napi_get_named_property(env, argv[0], "clear", &v);
+        napi_get_value_bool(env, v, &clear);
+        if (clear) {
+            if (path.empty()) DefaultPath();
+            DeleteFileW(path.c_str());
+            items.clear();
+            valid = dirty = false;
+        }
+    }
+    return GetInventoryCache(env, info);
+}
@@ -0,0 +1,66 @@
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include <node_api.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// Persistent cache of static hardware inventory, for fast panel startup.
+// InventoryAttach() must run before SelfStatsInstrument(). It routes
+// getSystemInfo / getCpuInfo / getGpuInfo / getMemoryHardware through a
+// gate that answers the first calls of a session from a compact binary
+// file (%LOCALAPPDATA%\sysmon\inventory.bin), tagged `cached: true`, as
+// long as its fingerprint (boot id, processors, installed memory,
+// monitors, drive letters) matches this machine. A refresh runs the real
+// collectors a moment later, off the startup path, rewrites the file if
+// anything changed and passes the fresh values to the onRefresh callback;
+// from then on the exports run live.
+void InventoryAttach(napi_env env, napi_property_descriptor* props, size_t count);
+
+// Fields of a gated export that change while running (null-terminated
+// list): they are not saved, and `overlay` fills them in on every answer
+// served from the file.
+void InventoryLive(const char* name, const char* const* fields, void (*overlay)(napi_env env, napi_value result));
+
+// A gated export whose collection blocks (WMI): the refresh runs `collect`
+// on a worker thread and `build` turns its state into the value on the JS
+// thread, taking ownership of the state.
+void InventoryOffThread(const char* name, void* (*collect)(), napi_value (*build)(napi_env env, void* state));
+
+// Native inventory items outside the exports (e.g. physical drives).
+// InventoryLoad returns the cached blob while the fingerprint matches and
+// queues a deferred refresh: `collect` runs on a worker thread and must not
+// touch collector state; `store` takes its state on the JS thread (with
+// snapshotLock held). InventoryStore saves a blob.
+bool InventoryLoad(const char* key, std::string& blob, void* (*collect)(), void (*store)(void* state));
+void InventoryStore(const char* key, const std::string& blob);
+
+// Blob helpers: varints, doubles and length-prefixed strings
+struct InventoryWriter {
+    std::string out;
+    void U(uint64_t v);
+    void D(double v);
+    void S(const std::string& s);
+};
+
+struct InventoryReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+    explicit InventoryReader(const std::string& s)
+        : p((const uint8_t*)s.data()), end((const uint8_t*)s.data() + s.size()) {}
+    uint64_t U();
+    double D();
+    std::string S();
+};
+
+// getInventoryCache() -> { enabled, path, valid, fingerprint, entries,
+//   hits, refreshed, savedAt, loadMs, error }
+napi_value GetInventoryCache(napi_env env, napi_callback_info info);
+// setInventoryCache({ enabled, path, refreshDelay, clear, onRefresh }) -> status
+// Takes effect for calls not yet answered; clear deletes the file.
+// onRefresh({ [exportName]: freshValue }) runs after each deferred refresh.
+napi_value SetInventoryCache(napi_env env, napi_callback_info info);
+
+#endif // INVENTORY_H
@@ -1,4 +1,8 @@
 #include "network.h"
+#include "snapshot.h"
+#include "arena.h"
+#include "selfstats.h"
+#include "scheduler.h"
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
@@ -19,128 +23,138 @@ std::string WideToUtf8Network(const wchar_t* wstr) {
     return result;
 }
 
-// Network cache for speed calculation
-struct NetCache { DWORD idx; ULONGLONG rx, tx; };
-static std::vector<NetCache> netCache;
+// Network cache for speed / error rate calculation
+struct NetCache {
+    DWORD idx;
+    ULONGLONG rx, tx;
+    ULONGLONG rxPkts, txPkts;
+    ULONGLONG rxErrors, txErrors, rxDrops, txDrops;
+};
+static std::vector<NetCache> netCache, newNetCache;
 static ULONGLONG netTime = 0;
 
-napi_value GetNetworkStats(napi_env env, napi_callback_info info) {
-    napi_value result, ifaces;
-    napi_create_object(env, &result);
-    napi_create_array(env, &ifaces);
-    
-    ULONG bufLen = 15000;
-    PIP_ADAPTER_ADDRESSES addrs = (PIP_ADAPTER_ADDRESSES)malloc(bufLen);
-    if (!addrs) {
-        napi_set_named_property(env, result, "interfaces", ifaces);
-        return result;
+// Adapter metadata (addresses, DNS, DHCP, MAC) almost never changes, so it is
+// cached and only rebuilt when Windows reports an interface or unicast address
+// change. The per-tick path just reads counters for the cached set.
+struct AdapterInfo {
+    NET_IFINDEX idx;
+    IFTYPE ifType;
+    const char* type;
+    bool isVirtual;
+    std::string name, ip4, ip6, subnet, mac;
+    std::string dns[2];
+    int dnsCount;
+    bool dhcp;
+};
+static std::vector<AdapterInfo> adapterCache;
+static volatile LONG adaptersDirty = 1;
+static HANDLE ifaceNotify = NULL, addrNotify = NULL;
+static bool notifyInit = false;
+static ULONGLONG adaptersTime = 0;
+static uint32_t adaptersGeneration = 0;
+static ReusableBuffer adapterBuffer("adapterAddresses");
+// DNS server changes raise no notification; re-read occasionally as a safety net
+static const ULONGLONG ADAPTER_REFRESH_MS = 60000;
+
+static VOID WINAPI OnInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW row, MIB_NOTIFICATION_TYPE type) {
+    InterlockedExchange(&adaptersDirty, 1);
+}
+
+static VOID WINAPI OnAddressChange(PVOID context, PMIB_UNICASTIPADDRESS_ROW row, MIB_NOTIFICATION_TYPE type) {
+    InterlockedExchange(&adaptersDirty, 1);
+}
+
+static void CancelAdapterNotify(void* arg) {
+    if (ifaceNotify) { CancelMibChangeNotify2(ifaceNotify); ifaceNotify = NULL; }
+    if (addrNotify) { CancelMibChangeNotify2(addrNotify); addrNotify = NULL; }
+}
+
+// Interface class from IANA ifType
+static const char* ClassifyInterface(IFTYPE ifType) {
+    switch (ifType) {
+        case IF_TYPE_ETHERNET_CSMACD: return "wired";
+        case IF_TYPE_IEEE80211: return "wireless";
+        case IF_TYPE_SOFTWARE_LOOPBACK: return "loopback";
+        case IF_TYPE_TUNNEL: return "tunnel";
+        case IF_TYPE_PPP: return "ppp";
+        case IF_TYPE_PROP_VIRTUAL: return "virtual";
+        case IF_TYPE_WWANPP:
+        case IF_TYPE_WWANPP2: return "mobile";
+        default: return "other";
     }
+}
+
+static double Rate(ULONGLONG cur, ULONGLONG prev, double dt) {
+    return cur >= prev ? (cur - prev) / dt : 0;
+}
+
+static void FormatIPv4(const sockaddr_in* sa, char* buf) {
+    sprintf(buf, "%d.%d.%d.%d",
+        sa->sin_addr.S_un.S_un_b.s_b1, sa->sin_addr.S_un.S_un_b.s_b2,
+        sa->sin_addr.S_un.S_un_b.s_b3, sa->sin_addr.S_un.S_un_b.s_b4);
+}
+
+static bool RefreshAdapters() {
+    if (!adapterBuffer.Reserve(15000)) return false;
     
-    // Get adapter addresses with more info (including DNS)
+    // Get adapter addresses with more info (including DNS); the buffer only grows
     ULONG flags = GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_INCLUDE_PREFIX;
-    if (GetAdaptersAddresses(AF_UNSPEC, flags, nullptr, addrs, &bufLen) == ERROR_BUFFER_OVERFLOW) {
-        free(addrs);
-        addrs = (PIP_ADAPTER_ADDRESSES)malloc(bufLen);
-        if (!addrs) {
-            napi_set_named_property(env, result, "interfaces", ifaces);
-            return result;
-        }
-    }
-    
-    if (GetAdaptersAddresses(AF_UNSPEC, flags, nullptr, addrs, &bufLen) != NO_ERROR) {
-        free(addrs);
-        napi_set_named_property(env, result, "interfaces", ifaces);
-        return result;
+    ULONG bufLen = (ULONG)adapterBuffer.Size();
+    ULONG rc = GetAdaptersAddresses(AF_UNSPEC, flags, nullptr, (PIP_ADAPTER_ADDRESSES)adapterBuffer.Data(), &bufLen);
+    if (rc == ERROR_BUFFER_OVERFLOW && adapterBuffer.Reserve(bufLen)) {
+        bufLen = (ULONG)adapterBuffer.Size();
+        rc = GetAdaptersAddresses(AF_UNSPEC, flags, nullptr, (PIP_ADAPTER_ADDRESSES)adapterBuffer.Data(), &bufLen);
     }
+    if (rc != NO_ERROR) return false;
+    PIP_ADAPTER_ADDRESSES addrs = (PIP_ADAPTER_ADDRESSES)adapterBuffer.Data();
     
-    ULONGLONG now = GetTickCount64();
-    double dt = netTime > 0 ? (now - netTime) / 1000.0 : 1.0;
-    if (dt < 0.1) dt = 1.0;
-    
-    std::vector<NetCache> newCache;
-    uint32_t idx = 0;
-    
+    std::vector<AdapterInfo> adapters;
     for (auto a = addrs; a; a = a->Next) {
-        // Skip non-physical adapters
-        if (a->IfType != IF_TYPE_ETHERNET_CSMACD && a->IfType != IF_TYPE_IEEE80211) continue;
-        if (a->OperStatus != IfOperStatusUp) continue;
-        
+        AdapterInfo ai;
+        ai.idx = a->IfIndex;
+        ai.ifType = a->IfType;
+        ai.type = ClassifyInterface(a->IfType);
+        // Hyper-V / WSL / Docker switches report as Ethernet; only the hardware flag tells them apart
         MIB_IF_ROW2 row = {0};
         row.InterfaceIndex = a->IfIndex;
-        if (GetIfEntry2(&row) != NO_ERROR) continue;
-        
-        napi_value iface;
-        napi_create_object(env, &iface);
-        napi_value v;
-        
-        // Interface name
-        napi_create_string_utf8(env, WideToUtf8Network(a->FriendlyName).c_str(), NAPI_AUTO_LENGTH, &v);
-        napi_set_named_property(env, iface, "iface", v);
-        
-        // Connection type
-        const char* type = (a->IfType == IF_TYPE_IEEE80211) ? "wireless" : "wired";
-        napi_create_string_utf8(env, type, NAPI_AUTO_LENGTH, &v);
-        napi_set_named_property(env, iface, "type", v);
+        ai.isVirtual = GetIfEntry2(&row) == NO_ERROR ? !row.InterfaceAndOperStatusFlags.HardwareInterface
+                                                      : (a->IfType != IF_TYPE_ETHERNET_CSMACD && a->IfType != IF_TYPE_IEEE80211);
+        ai.name = WideToUtf8Network(a->FriendlyName);
+        ai.dhcp = a->Dhcpv4Enabled != 0;
+        ai.dnsCount = 0;
         
         // IPv4 and IPv6 addresses
-        std::string ip4, ip6, subnet;
         for (auto ua = a->FirstUnicastAddress; ua; ua = ua->Next) {
             if (ua->Address.lpSockaddr->sa_family == AF_INET) {
-                auto sa = (sockaddr_in*)ua->Address.lpSockaddr;
                 char buf[16];
-                sprintf(buf, "%d.%d.%d.%d", 
-                    sa->sin_addr.S_un.S_un_b.s_b1, sa->sin_addr.S_un.S_un_b.s_b2,
-                    sa->sin_addr.S_un.S_un_b.s_b3, sa->sin_addr.S_un.S_un_b.s_b4);
-                ip4 = buf;
+                FormatIPv4((sockaddr_in*)ua->Address.lpSockaddr, buf);
+                ai.ip4 = buf;
                 
                 // Calculate subnet mask from prefix length
                 ULONG mask = 0xFFFFFFFF << (32 - ua->OnLinkPrefixLength);
                 sprintf(buf, "%d.%d.%d.%d",
                     (mask >> 24) & 0xFF, (mask >> 16) & 0xFF,
                     (mask >> 8) & 0xFF, mask & 0xFF);
-                subnet = buf;
-            } else if (ua->Address.lpSockaddr->sa_family == AF_INET6 && ip6.empty()) {
+                ai.subnet = buf;
+            } else if (ua->Address.lpSockaddr->sa_family == AF_INET6 && ai.ip6.empty()) {
                 auto sa = (sockaddr_in6*)ua->Address.lpSockaddr;
                 char buf[46];
                 inet_ntop(AF_INET6, &sa->sin6_addr, buf, sizeof(buf));
-                ip6 = buf;
+                ai.ip6 = buf;
             }
         }
         
-        napi_create_string_utf8(env, ip4.c_str(), NAPI_AUTO_LENGTH, &v);
-        napi_set_named_property(env, iface, "ip4", v);
-        
-        napi_create_string_utf8(env, ip6.c_str(), NAPI_AUTO_LENGTH, &v);
-        napi_set_named_property(env, iface, "ip6", v);
-        
-        napi_create_string_utf8(env, subnet.c_str(), NAPI_AUTO_LENGTH, &v);
-        napi_set_named_property(env, iface, "subnet", v);
-        
         // DNS servers
-        napi_value dnsArray;
-        napi_create_array(env, &dnsArray);
-        uint32_t dnsIdx = 0;
-        for (auto dns = a->FirstDnsServerAddress; dns && dnsIdx < 2; dns = dns->Next) {
+        for (auto dns = a->FirstDnsServerAddress; dns && ai.dnsCount < 2; dns = dns->Next) {
             char buf[46] = {0};
             if (dns->Address.lpSockaddr->sa_family == AF_INET) {
-                auto sa = (sockaddr_in*)dns->Address.lpSockaddr;
-                sprintf(buf, "%d.%d.%d.%d",
-                    sa->sin_addr.S_un.S_un_b.s_b1, sa->sin_addr.S_un.S_un_b.s_b2,
-                    sa->sin_addr.S_un.S_un_b.s_b3, sa->sin_addr.S_un.S_un_b.s_b4);
+                FormatIPv4((sockaddr_in*)dns->Address.lpSockaddr, buf);
             } else if (dns->Address.lpSockaddr->sa_family == AF_INET6) {
                 auto sa = (sockaddr_in6*)dns->Address.lpSockaddr;
                 inet_ntop(AF_INET6, &sa->sin6_addr, buf, sizeof(buf));
             }
-            if (buf[0]) {
-                napi_create_string_utf8(env, buf, NAPI_AUTO_LENGTH, &v);
-                napi_set_element(env, dnsArray, dnsIdx++, v);
-            }
+            if (buf[0]) ai.dns[ai.dnsCount++] = buf;
         }
-        napi_set_named_property(env, iface, "dns", dnsArray);
-        
-        // DHCP enabled
-        napi_get_boolean(env, a->Dhcpv4Enabled, &v);
-        napi_set_named_property(env, iface, "dhcp", v);
         
         // MAC address
         char mac[18] = {0};
@@ -149,63 +163,245 @@ napi_value GetNetworkStats(napi_env env, napi_callback_info info) {
                 a->PhysicalAddress[0], a->PhysicalAddress[1], a->PhysicalAddress[2],
                 a->PhysicalAddress[3], a->PhysicalAddress[4], a->PhysicalAddress[5]);
         }
-        napi_create_string_utf8(env, mac, NAPI_AUTO_LENGTH, &v);
+        ai.mac = mac;
+        
+        adapters.push_back(ai);
+    }
+    
+    adapterCache.swap(adapters);
+    adaptersGeneration++;
+    return true;
+}
+
+// Per-tick counters of the adapters that are up; `adapter` indexes adapterCache
+struct NetSample {
+    size_t adapter;
+    MIB_IF_ROW2 row;
+    double rxSec, txSec, rxPktSec, txPktSec, rxErrSec, txErrSec, rxDropSec, txDropSec;
+    double utilization;
+};
+static std::vector<NetSample> netSamples;
+
+bool NetworkSample() {
+    ULONGLONG now = GetTickCount64();
+    
+    if (!notifyInit) {
+        // Without notifications we fall back to re-reading metadata every call
+        bool ok = NotifyIpInterfaceChange(AF_UNSPEC, OnInterfaceChange, nullptr, FALSE, &ifaceNotify) == NO_ERROR;
+        ok = NotifyUnicastIpAddressChange(AF_UNSPEC, OnAddressChange, nullptr, FALSE, &addrNotify) == NO_ERROR && ok;
+        if (!ok) CancelAdapterNotify(nullptr);
+        notifyInit = true;
+    }
+    
+    bool stale = !ifaceNotify || now - adaptersTime >= ADAPTER_REFRESH_MS;
+    if (InterlockedExchange(&adaptersDirty, 0) || stale) {
+        SelfStatsQueryBegin();
+        bool refreshed = RefreshAdapters();
+        SelfStatsQueryEnd(refreshed ? adapterBuffer.Size() : 0);
+        if (refreshed) {
+            adaptersTime = now;
+        } else {
+            InterlockedExchange(&adaptersDirty, 1);
+        }
+    }
+    
+    double dt = netTime > 0 ? (now - netTime) / 1000.0 : 1.0;
+    if (dt < 0.1) dt = 1.0;
+    
+    newNetCache.clear();
+    netSamples.clear();
+    double totalSec = 0;
+    bool publish = SnapshotNeeded(SNAP_NET);
+    if (publish) {
+        snapshot.net.clear();
+        SnapshotStrings(SNAP_NET).Reset();
+    }
+    
+    for (size_t i = 0; i < adapterCache.size(); i++) {
+        const AdapterInfo& a = adapterCache[i];
+        NetSample n = {};
+        n.adapter = i;
+        MIB_IF_ROW2& row = n.row;
+        row.InterfaceIndex = a.idx;
+        SelfStatsQueryBegin();
+        DWORD rc = GetIfEntry2(&row);
+        SelfStatsQueryEnd(sizeof(row));
+        if (rc != NO_ERROR) continue;
+        if (row.OperStatus != IfOperStatusUp) continue;
+        
+        ULONGLONG rx = row.InOctets, tx = row.OutOctets;
+        // Packet statistics (unicast + multicast/broadcast)
+        ULONGLONG rxPkts = row.InUcastPkts + row.InNUcastPkts;
+        ULONGLONG txPkts = row.OutUcastPkts + row.OutNUcastPkts;
+        ULONGLONG rxErrors = row.InErrors, txErrors = row.OutErrors;
+        ULONGLONG rxDrops = row.InDiscards, txDrops = row.OutDiscards;
+        
+        // Rate calculation
+        for (auto& c : netCache) {
+            if (c.idx == a.idx) {
+                n.rxSec = Rate(rx, c.rx, dt);
+                n.txSec = Rate(tx, c.tx, dt);
+                n.rxPktSec = Rate(rxPkts, c.rxPkts, dt);
+                n.txPktSec = Rate(txPkts, c.txPkts, dt);
+                n.rxErrSec = Rate(rxErrors, c.rxErrors, dt);
+                n.txErrSec = Rate(txErrors, c.txErrors, dt);
+                n.rxDropSec = Rate(rxDrops, c.rxDrops, dt);
+                n.txDropSec = Rate(txDrops, c.txDrops, dt);
+                break;
+            }
+        }
+        
+        // Network utilization (%)
+        double maxSpeed = (double)row.TransmitLinkSpeed / 8; // bits/sec -> bytes/sec
+        if (maxSpeed > 0) {
+            double currentSpeed = (n.rxSec > n.txSec) ? n.rxSec : n.txSec;
+            n.utilization = (currentSpeed / maxSpeed) * 100.0;
+            if (n.utilization > 100) n.utilization = 100;
+        }
+        
+        newNetCache.push_back({ a.idx, rx, tx, rxPkts, txPkts, rxErrors, txErrors, rxDrops, txDrops });
+        totalSec += n.rxSec + n.txSec;
+        if (publish) snapshot.net.push_back({ SnapshotStrings(SNAP_NET).Copy(a.name.c_str()), n.rxSec, n.txSec, n.utilization });
+        netSamples.push_back(n);
+    }
+    
+    netCache.swap(newNetCache);
+    netTime = now;
+    SchedulerSignal((double)netSamples.size(), 0.5);
+    SchedulerSignal(totalSec, 64.0 * 1024);
+    if (publish) SnapshotPublish(SNAP_NET, now);
+    return true;
+}
+
+napi_value GetNetworkStats(napi_env env, napi_callback_info info) {
+    napi_value result, ifaces;
+    napi_create_object(env, &result);
+    napi_create_array(env, &ifaces);
+    NetworkSample();
+    
+    uint32_t idx = 0;
+    for (const NetSample& n : netSamples) {
+        const AdapterInfo& a = adapterCache[n.adapter];
+        const MIB_IF_ROW2& row = n.row;
+        
+        napi_value iface;
+        napi_create_object(env, &iface);
+        napi_value v;
+        
+        // Interface name
+        napi_create_string_utf8(env, a.name.c_str(), NAPI_AUTO_LENGTH, &v);
+        napi_set_named_property(env, iface, "iface", v);
+        
+        // Connection type
+        napi_create_string_utf8(env, a.type, NAPI_AUTO_LENGTH, &v);
+        napi_set_named_property(env, iface, "type", v);
+        napi_create_uint32(env, a.ifType, &v);
+        napi_set_named_property(env, iface, "ifType", v);
+        napi_get_boolean(env, a.isVirtual, &v);
+        napi_set_named_property(env, iface, "virtual", v);
+        
+        napi_create_string_utf8(env, a.ip4.c_str(), NAPI_AUTO_LENGTH, &v);
+        napi_set_named_property(env, iface, "ip4", v);
+        
+        napi_create_string_utf8(env, a.ip6.c_str(), NAPI_AUTO_LENGTH, &v);
+        napi_set_named_property(env, iface, "ip6", v);
+        
+        napi_create_string_utf8(env, a.subnet.c_str(), NAPI_AUTO_LENGTH, &v);
+        napi_set_named_property(env, iface, "subnet", v);
+        
+        // DNS servers
+        napi_value dnsArray;
+        napi_create_array(env, &dnsArray);
+        for (int d = 0; d < a.dnsCount; d++) {
+            napi_create_string_utf8(env, a.dns[d].c_str(), NAPI_AUTO_LENGTH, &v);
+            napi_set_element(env, dnsArray, d, v);
+        }
+        napi_set_named_property(env, iface, "dns", dnsArray);
+        
+        // DHCP enabled
+        napi_get_boolean(env, a.dhcp, &v);
+        napi_set_named_property(env, iface, "dhcp", v);
+        
+        // MAC address
+        napi_create_string_utf8(env, a.mac.c_str(), NAPI_AUTO_LENGTH, &v);
         napi_set_named_property(env, iface, "mac", v);
         
         // Traffic statistics
-        ULONGLONG rx = row.InOctets, tx = row.OutOctets;
-        napi_create_double(env, (double)rx, &v);
+        napi_create_double(env, (double)row.InOctets, &v);
         napi_set_named_property(env, iface, "rxBytes", v);
-        napi_create_double(env, (double)tx, &v);
+        napi_create_double(env, (double)row.OutOctets, &v);
         napi_set_named_property(env, iface, "txBytes", v);
         
-        // Packet statistics
-        napi_create_double(env, (double)row.InUcastPkts, &v);
+        // Packet statistics (unicast + multicast/broadcast)
+        napi_create_double(env, (double)(row.InUcastPkts + row.InNUcastPkts), &v);
         napi_set_named_property(env, iface, "rxPackets", v);
-        napi_create_double(env, (double)row.OutUcastPkts, &v);
+        napi_create_double(env, (double)(row.OutUcastPkts + row.OutNUcastPkts), &v);
         napi_set_named_property(env, iface, "txPackets", v);
+        napi_create_double(env, (double)row.InNUcastPkts, &v);
+        napi_set_named_property(env, iface, "rxNonUnicastPackets", v);
+        napi_create_double(env, (double)row.OutNUcastPkts, &v);
+        napi_set_named_property(env, iface, "txNonUnicastPackets", v);
+        napi_create_double(env, (double)row.InMulticastOctets, &v);
+        napi_set_named_property(env, iface, "rxMulticastBytes", v);
+        napi_create_double(env, (double)row.OutMulticastOctets, &v);
+        napi_set_named_property(env, iface, "txMulticastBytes", v);
         
-        // Speed calculation
-        double rxSec = 0, txSec = 0;
-        for (auto& c : netCache) {
-            if (c.idx == a->IfIndex) {
-                rxSec = (rx - c.rx) / dt;
-                txSec = (tx - c.tx) / dt;
-                break;
-            }
-        }
-        if (rxSec < 0) rxSec = 0;
-        if (txSec < 0) txSec = 0;
+        // Errors and drops
+        napi_create_double(env, (double)row.InErrors, &v);
+        napi_set_named_property(env, iface, "rxErrors", v);
+        napi_create_double(env, (double)row.OutErrors, &v);
+        napi_set_named_property(env, iface, "txErrors", v);
+        napi_create_double(env, (double)row.InDiscards, &v);
+        napi_set_named_property(env, iface, "rxDrops", v);
+        napi_create_double(env, (double)row.OutDiscards, &v);
+        napi_set_named_property(env, iface, "txDrops", v);
+        napi_create_double(env, (double)row.InUnknownProtos, &v);
+        napi_set_named_property(env, iface, "rxUnknownProtos", v);
         
-        napi_create_double(env, rxSec, &v);
+        napi_create_double(env, n.rxSec, &v);
         napi_set_named_property(env, iface, "rxSec", v);
-        napi_create_double(env, txSec, &v);
+        napi_create_double(env, n.txSec, &v);
         napi_set_named_property(env, iface, "txSec", v);
+        napi_create_double(env, n.rxPktSec, &v);
+        napi_set_named_property(env, iface, "rxPacketsSec", v);
+        napi_create_double(env, n.txPktSec, &v);
+        napi_set_named_property(env, iface, "txPacketsSec", v);
+        napi_create_double(env, n.rxErrSec, &v);
+        napi_set_named_property(env, iface, "rxErrorsSec", v);
+        napi_create_double(env, n.txErrSec, &v);
+        napi_set_named_property(env, iface, "txErrorsSec", v);
+        napi_create_double(env, n.rxDropSec, &v);
+        napi_set_named_property(env, iface, "rxDropsSec", v);
+        napi_create_double(env, n.txDropSec, &v);
+        napi_set_named_property(env, iface, "txDropsSec", v);
+        
+        // Packet loss over the sampling window (%)
+        double rxLoss = n.rxPktSec + n.rxDropSec + n.rxErrSec > 0 ? (n.rxDropSec + n.rxErrSec) / (n.rxPktSec + n.rxDropSec + n.rxErrSec) * 100.0 : 0;
+        double txLoss = n.txPktSec + n.txDropSec + n.txErrSec > 0 ? (n.txDropSec + n.txErrSec) / (n.txPktSec + n.txDropSec + n.txErrSec) * 100.0 : 0;
+        napi_create_double(env, rxLoss, &v);
+        napi_set_named_property(env, iface, "rxLossPercent", v);
+        napi_create_double(env, txLoss, &v);
+        napi_set_named_property(env, iface, "txLossPercent", v);
         
         // Link speed (Mbps)
-        double linkSpeed = (double)a->TransmitLinkSpeed / 1e6;
-        napi_create_double(env, linkSpeed, &v);
+        napi_create_double(env, (double)row.TransmitLinkSpeed / 1e6, &v);
         napi_set_named_property(env, iface, "speed", v);
         
         // Network utilization (%)
-        double maxSpeed = linkSpeed * 1e6 / 8; // Convert Mbps to bytes/sec
-        double utilization = 0;
-        if (maxSpeed > 0) {
-            double currentSpeed = (rxSec > txSec) ? rxSec : txSec;
-            utilization = (currentSpeed / maxSpeed) * 100.0;
-            if (utilization > 100) utilization = 100;
-        }
-        napi_create_double(env, utilization, &v);
+        napi_create_double(env, n.utilization, &v);
         napi_set_named_property(env, iface, "utilization", v);
         
-        newCache.push_back({ a->IfIndex, rx, tx });
         napi_set_element(env, ifaces, idx++, iface);
     }
     
-    free(addrs);
-    netCache = newCache;
-    netTime = now;
-    
     napi_set_named_property(env, result, "interfaces", ifaces);
+    // Bumped whenever adapter metadata was re-read
+    napi_value v;
+    napi_create_uint32(env, adaptersGeneration, &v);
+    napi_set_named_property(env, result, "generation", v);
     return result;
 }
+
+void NetworkAttach(napi_env env) {
+    napi_add_env_cleanup_hook(env, CancelAdapterNotify, nullptr);
+}
@@ -6,4 +6,9 @@
 // Network statistics function
 napi_value GetNetworkStats(napi_env env, napi_callback_info info);
 
+// Takes a sample and publishes the SNAP_NET snapshot section
+bool NetworkSample();
+// Cancels the adapter change notifications at unload (before SnapshotPumpAttach)
+void NetworkAttach(napi_env env);
+
 #endif // NETWORK_H
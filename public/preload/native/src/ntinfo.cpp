@@ -0,0 +1,140 @@
+#include "ntinfo.h"
+#include "replay.h"
+
+typedef LONG (WINAPI *NtQuerySystemInformationFn)(ULONG, PVOID, ULONG, PULONG);
+typedef LONG (WINAPI *NtQueryInformationProcessFn)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+typedef LONG (WINAPI *NtQueryObjectFn)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+
+static const ULONG SystemProcessInformation = 5;
+static const ULONG ProcessHandleInformation = 51;
+static const ULONG ProcessCommandLineInformation = 60;
+static const ULONG ObjectNameInformation = 1;
+static const ULONG ObjectTypeInformation = 2;
+static const LONG STATUS_INFO_LENGTH_MISMATCH = (LONG)0xC0000004;
+
+// Resolved at runtime so the addon doesn't need to link ntdll.lib
+static FARPROC NtProc(const char* name) {
+    return GetProcAddress(GetModuleHandleW(L"ntdll.dll"), name);
+}
+
+static void Utf8(const NtUnicodeString& s, std::string& out) {
+    out.clear();
+    int chars = s.Length / sizeof(wchar_t);
+    if (!s.Buffer || chars <= 0) return;
+    int len = WideCharToMultiByte(CP_UTF8, 0, s.Buffer, chars, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return;
+    out.resize(len);
+    WideCharToMultiByte(CP_UTF8, 0, s.Buffer, chars, &out[0], len, nullptr, nullptr);
+}
+
+// Image names point into the buffer; move them to where it is now.
+// Recorded buffers come from a file, so the list is cut at the first
+// record (with its threads) or NextEntryOffset that leaves the buffer, and
+// names outside it are dropped
+static const NtProcessInfo* RebaseProcesses(ReusableBuffer& buf, size_t size, uint64_t base) {
+    uintptr_t from = (uintptr_t)base, to = (uintptr_t)buf.Data();
+    BYTE* data = (BYTE*)buf.Data();
+    NtProcessInfo* prev = nullptr;
+    for (size_t offset = 0;;) {
+        NtProcessInfo* p = (NtProcessInfo*)(data + offset);
+        size_t room = size - offset;
+        if (room < sizeof(NtProcessInfo) ||
+            p->NumberOfThreads > (room - sizeof(NtProcessInfo)) / sizeof(NtThreadInfo)) {
+            if (!prev) return nullptr;
+            prev->NextEntryOffset = 0;
+            break;
+        }
+        uintptr_t name = (uintptr_t)p->ImageName.Buffer;
+        if (name >= from && name < from + size && p->ImageName.Length <= from + size - name) {
+            p->ImageName.Buffer = (PWSTR)(name - from + to);
+        } else {
+            p->ImageName.Buffer = nullptr;
+            p->ImageName.Length = 0;
+        }
+        if (!p->NextEntryOffset) break;
+        if (p->NextEntryOffset >= room) {
+            p->NextEntryOffset = 0;
+            break;
+        }
+        prev = p;
+        offset += p->NextEntryOffset;
+    }
+    return (const NtProcessInfo*)data;
+}
+
+const NtProcessInfo* NtQueryProcesses(ReusableBuffer& buf) {
+    size_t recorded = 0;
+    uint64_t base = 0;
+    ReplayResult replay = ReplayFill(buf, recorded, &base);
+    if (replay != REPLAY_LIVE) return replay == REPLAY_SERVED ? RebaseProcesses(buf, recorded, base) : nullptr;
+
+    static NtQuerySystemInformationFn query = (NtQuerySystemInformationFn)NtProc("NtQuerySystemInformation");
+    if (!query) return nullptr;
+
+    if (!buf.Size() && !buf.Reserve(256 * 1024)) return nullptr;
+    // Processes can appear between calls; retry a few times
+    for (int i = 0; i < 4; i++) {
+        ULONG needed = 0;
+        LONG status = query(SystemProcessInformation, buf.Data(), (ULONG)buf.Size(), &needed);
+        if (status >= 0) {
+            ReplayCapture(buf, needed);
+            return (const NtProcessInfo*)buf.Data();
+        }
+        if (status != STATUS_INFO_LENGTH_MISMATCH) return nullptr;
+        if (!buf.Reserve(needed + 64 * 1024)) return nullptr;
+    }
+    return nullptr;
+}
+
+const NtHandleSnapshot* NtQueryProcessHandles(HANDLE process, ReusableBuffer& buf) {
+    static NtQueryInformationProcessFn query = (NtQueryInformationProcessFn)NtProc("NtQueryInformationProcess");
+    if (!query) return nullptr;
+
+    if (!buf.Size() && !buf.Reserve(64 * 1024)) return nullptr;
+    for (int i = 0; i < 4; i++) {
+        ULONG needed = 0;
+        LONG status = query(process, ProcessHandleInformation, buf.Data(), (ULONG)buf.Size(), &needed);
+        if (status >= 0) return (const NtHandleSnapshot*)buf.Data();
+        if (status != STATUS_INFO_LENGTH_MISMATCH) return nullptr;
+        if (!buf.Reserve(needed + 16 * 1024)) return nullptr;
+    }
+    return nullptr;
+}
+
+bool NtProcessCommandLine(HANDLE process, ReusableBuffer& buf, std::string& out) {
+    static NtQueryInformationProcessFn query = (NtQueryInformationProcessFn)NtProc("NtQueryInformationProcess");
+    out.clear();
+    if (!query) return false;
+
+    if (!buf.Size() && !buf.Reserve(4096)) return false;
+    for (int i = 0; i < 2; i++) {
+        ULONG needed = 0;
+        LONG status = query(process, ProcessCommandLineInformation, buf.Data(), (ULONG)buf.Size(), &needed);
+        if (status >= 0) {
+            Utf8(*(const NtUnicodeString*)buf.Data(), out);
+            return true;
+        }
+        if (status != STATUS_INFO_LENGTH_MISMATCH || !buf.Reserve(needed)) return false;
+    }
+    return false;
+}
+
+// Both information classes return a UNICODE_STRING followed by its characters
+static bool QueryObjectString(HANDLE h, ULONG infoClass, std::string& out) {
+    static NtQueryObjectFn query = (NtQueryObjectFn)NtProc("NtQueryObject");
+    out.clear();
+    if (!query) return false;
+    alignas(8) BYTE buffer[2048];
+    ULONG needed = 0;
+    if (query(h, infoClass, buffer, sizeof(buffer), &needed) < 0) return false;
+    Utf8(*(const NtUnicodeString*)buffer, out);
+    return true;
+}
+
+bool NtObjectTypeName(HANDLE h, std::string& out) {
+    return QueryObjectString(h, ObjectTypeInformation, out);
+}
+
+bool NtObjectName(HANDLE h, std::string& out) {
+    return QueryObjectString(h, ObjectNameInformation, out);
+}
@@ -0,0 +1,90 @@
+#ifndef NTINFO_H
+#define NTINFO_H
+
+#include <windows.h>
+#include "arena.h"
+#include <string>
+
+// Layouts returned by NtQuerySystemInformation(SystemProcessInformation).
+// winternl.h only exposes them with Reserved fields, so they are spelled
+// out here. Each process record is followed by NumberOfThreads thread records.
+struct NtUnicodeString {
+    USHORT Length, MaximumLength;
+    PWSTR Buffer;
+};
+
+struct NtThreadInfo {
+    LARGE_INTEGER KernelTime, UserTime, CreateTime;
+    ULONG WaitTime;
+    PVOID StartAddress;
+    HANDLE UniqueProcess, UniqueThread;
+    LONG Priority, BasePriority;
+    ULONG ContextSwitches;
+    ULONG ThreadState, WaitReason;
+};
+
+struct NtProcessInfo {
+    ULONG NextEntryOffset;
+    ULONG NumberOfThreads;
+    LARGE_INTEGER WorkingSetPrivateSize;
+    ULONG HardFaultCount;
+    ULONG NumberOfThreadsHighWatermark;
+    ULONGLONG CycleTime;
+    LARGE_INTEGER CreateTime, UserTime, KernelTime;
+    NtUnicodeString ImageName;
+    LONG BasePriority;
+    HANDLE UniqueProcessId;
+    HANDLE InheritedFromUniqueProcessId;
+    ULONG HandleCount;
+    ULONG SessionId;
+    ULONG_PTR UniqueProcessKey;
+    SIZE_T PeakVirtualSize, VirtualSize;
+    ULONG PageFaultCount;
+    SIZE_T PeakWorkingSetSize, WorkingSetSize;
+    SIZE_T QuotaPeakPagedPoolUsage, QuotaPagedPoolUsage;
+    SIZE_T QuotaPeakNonPagedPoolUsage, QuotaNonPagedPoolUsage;
+    SIZE_T PagefileUsage, PeakPagefileUsage, PrivatePageCount;
+    LARGE_INTEGER ReadOperationCount, WriteOperationCount, OtherOperationCount;
+    LARGE_INTEGER ReadTransferCount, WriteTransferCount, OtherTransferCount;
+
+    const NtThreadInfo* Threads() const { return (const NtThreadInfo*)(this + 1); }
+    const NtProcessInfo* Next() const {
+        return NextEntryOffset ? (const NtProcessInfo*)((const BYTE*)this + NextEntryOffset) : nullptr;
+    }
+};
+
+// NtQueryInformationProcess(ProcessHandleInformation), Windows 8+
+struct NtHandleEntry {
+    HANDLE HandleValue;
+    ULONG_PTR HandleCount;
+    ULONG_PTR PointerCount;
+    ULONG GrantedAccess;
+    ULONG ObjectTypeIndex;
+    ULONG HandleAttributes;
+    ULONG Reserved;
+};
+
+struct NtHandleSnapshot {
+    ULONG_PTR NumberOfHandles;
+    ULONG_PTR Reserved;
+    NtHandleEntry Handles[1];
+};
+
+// Fills `buf` with the system process/thread list (grows it as needed).
+// Returns the first record, or nullptr on failure.
+const NtProcessInfo* NtQueryProcesses(ReusableBuffer& buf);
+
+// Handle table of one process (opened with PROCESS_QUERY_INFORMATION)
+const NtHandleSnapshot* NtQueryProcessHandles(HANDLE process, ReusableBuffer& buf);
+
+// Command line of a process (opened with PROCESS_QUERY_LIMITED_INFORMATION),
+// as UTF-8. Windows 8.1+; false if the process is gone or protected.
+bool NtProcessCommandLine(HANDLE process, ReusableBuffer& buf, std::string& out);
+
+// Object type ("File", "Key", ...) and name of a handle owned by this
+// process, as UTF-8. Never call NtObjectName on File handles: it can block
+// forever on synchronous pipes.
+bool NtObjectTypeName(HANDLE h, std::string& out);
+bool NtObjectName(HANDLE h, std::string& out);
+
+#endif // NTINFO_H
@@ -0,0 +1,123 @@
+#include "pressure.h"
+#include "snapshot.h"
+#include "selfstats.h"
+#include <windows.h>
+#include <pdh.h>
+
+enum PressureCounter {
+    PC_PAGE_FAULTS,       // all faults (soft + hard)
+    PC_PAGE_READS,        // hard fault read operations (~ pgmajfault)
+    PC_PAGES_INPUT,       // pages read from disk to resolve faults (~ pswpin)
+    PC_PAGES_OUTPUT,      // pages written to disk to free memory (~ pswpout)
+    PC_PAGES,             // input + output
+    PC_TRANSITION_FAULTS, // resolved from the standby / modified lists
+    PC_CACHE_FAULTS,
+    PC_RUN_QUEUE,         // threads ready but waiting for a CPU
+    PC_CONTEXT_SWITCHES,
+    PC_DISK_QUEUE,        // average over the window
+    PC_DISK_IDLE,
+    PC_COUNT
+};
+
+static const wchar_t* counterPaths[PC_COUNT] = {
+    L"\\Memory\\Page Faults/sec",
+    L"\\Memory\\Page Reads/sec",
+    L"\\Memory\\Pages Input/sec",
+    L"\\Memory\\Pages Output/sec",
+    L"\\Memory\\Pages/sec",
+    L"\\Memory\\Transition Faults/sec",
+    L"\\Memory\\Cache Faults/sec",
+    L"\\System\\Processor Queue Length",
+    L"\\System\\Context Switches/sec",
+    L"\\PhysicalDisk(_Total)\\Avg. Disk Queue Length",
+    L"\\PhysicalDisk(_Total)\\% Idle Time",
+};
+
+static PDH_HQUERY pressureQuery = NULL;
+static PDH_HCOUNTER counters[PC_COUNT];
+static bool pressureInit = false;
+static ULONGLONG lastCollect = 0;
+static double values[PC_COUNT];
+
+static double window = 0;
+static bool valid = false;
+
+bool PressureSample() {
+    ULONGLONG now = GetTickCount64();
+
+    if (!pressureInit) {
+        if (PdhOpenQuery(NULL, 0, &pressureQuery) == ERROR_SUCCESS) {
+            for (int i = 0; i < PC_COUNT; i++) {
+                if (PdhAddEnglishCounterW(pressureQuery, counterPaths[i], 0, &counters[i]) != ERROR_SUCCESS) counters[i] = NULL;
+            }
+            PdhCollectQueryData(pressureQuery); // First call to initialize rate counters
+            lastCollect = now;
+        } else {
+            pressureQuery = NULL;
+        }
+        pressureInit = true;
+    }
+
+    // Rates cover the time since the previous collection
+    window = (now - lastCollect) / 1000.0;
+    bool ok = false;
+    if (pressureQuery) {
+        SelfStatsQueryBegin();
+        ok = PdhCollectQueryData(pressureQuery) == ERROR_SUCCESS;
+        if (ok) {
+            for (int i = 0; i < PC_COUNT; i++) {
+                PDH_FMT_COUNTERVALUE value;
+                if (counters[i] && PdhGetFormattedCounterValue(counters[i], PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, NULL, &value) == ERROR_SUCCESS) {
+                    values[i] = value.doubleValue < 0 ? 0 : value.doubleValue;
+                }
+            }
+            lastCollect = now;
+        }
+        SelfStatsQueryEnd(PC_COUNT * sizeof(PDH_FMT_COUNTERVALUE));
+    }
+    valid = ok;
+    if (!ok) return false;
+
+    snapshot.pageFaultsSec = values[PC_PAGE_FAULTS];
+    snapshot.hardFaultsSec = values[PC_PAGE_READS];
+    snapshot.pagesSec = values[PC_PAGES];
+    snapshot.runQueue = values[PC_RUN_QUEUE];
+    snapshot.diskQueue = values[PC_DISK_QUEUE];
+    SnapshotPublish(SNAP_PRESSURE, now);
+    return true;
+}
+
+napi_value GetPressure(napi_env env, napi_callback_info info) {
+    napi_value result; napi_create_object(env, &result);
+    PressureSample();
+
+    SYSTEM_INFO si; GetNativeSystemInfo(&si);
+    double diskIdle = values[PC_DISK_IDLE] > 100 ? 100 : values[PC_DISK_IDLE];
+
+    napi_value mem, cpu, io, v;
+    napi_create_object(env, &mem);
+    napi_create_double(env, values[PC_PAGE_FAULTS], &v); napi_set_named_property(env, mem, "pageFaultsSec", v);
+    napi_create_double(env, values[PC_PAGE_READS], &v); napi_set_named_property(env, mem, "hardFaultsSec", v);
+    napi_create_double(env, values[PC_PAGES_INPUT], &v); napi_set_named_property(env, mem, "pagesInSec", v);
+    napi_create_double(env, values[PC_PAGES_OUTPUT], &v); napi_set_named_property(env, mem, "pagesOutSec", v);
+    napi_create_double(env, values[PC_PAGES], &v); napi_set_named_property(env, mem, "pagesSec", v);
+    napi_create_double(env, values[PC_TRANSITION_FAULTS], &v); napi_set_named_property(env, mem, "transitionFaultsSec", v);
+    napi_create_double(env, values[PC_CACHE_FAULTS], &v); napi_set_named_property(env, mem, "cacheFaultsSec", v);
+    napi_set_named_property(env, result, "memory", mem);
+
+    napi_create_object(env, &cpu);
+    napi_create_double(env, values[PC_RUN_QUEUE], &v); napi_set_named_property(env, cpu, "runQueue", v);
+    napi_create_double(env, values[PC_RUN_QUEUE] / si.dwNumberOfProcessors, &v); napi_set_named_property(env, cpu, "runQueuePerCpu", v);
+    napi_create_double(env, values[PC_CONTEXT_SWITCHES], &v); napi_set_named_property(env, cpu, "contextSwitchesSec", v);
+    napi_set_named_property(env, result, "cpu", cpu);
+
+    napi_create_object(env, &io);
+    napi_create_double(env, values[PC_DISK_QUEUE], &v); napi_set_named_property(env, io, "queueLength", v);
+    // Share of the window with at least one request outstanding
+    napi_create_double(env, 100 - diskIdle, &v); napi_set_named_property(env, io, "busyPercent", v);
+    napi_set_named_property(env, result, "io", io);
+
+    napi_create_double(env, window, &v); napi_set_named_property(env, result, "window", v);
+    napi_get_boolean(env, valid, &v); napi_set_named_property(env, result, "valid", v);
+    return result;
+}
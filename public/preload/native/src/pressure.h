@@ -0,0 +1,13 @@
+#ifndef PRESSURE_H
+#define PRESSURE_H
+
+#include <node_api.h>
+
+// Resource contention rates over the window since the previous sample:
+// paging (page faults, hard faults, pages in/out), run queue and disk queue.
+// Windows has no PSI; these PDH counters are the closest equivalents.
+// Takes a sample and publishes the SNAP_PRESSURE snapshot section
+bool PressureSample();
+napi_value GetPressure(napi_env env, napi_callback_info info);
+
+#endif // PRESSURE_H
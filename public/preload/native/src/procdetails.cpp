@@ -0,0 +1,176 @@
+#include "procdetails.h"
+#include "ntinfo.h"
+#include "snapshot.h"
+#include "arena.h"
+#include <unordered_map>
+#include <vector>
+
+static std::unordered_map<uint32_t, ProcDetails> details;
+static std::unordered_map<std::string, std::string> accountNames;   // SID bytes -> DOMAIN\user
+static ReusableBuffer commandLineBuffer("processCommandLine");
+static std::vector<napi_ref> staleRefs;
+static uint32_t currentTick = 1;
+static bool cleanupHooked = false;
+
+static std::string Utf8(const wchar_t* w, int chars = -1) {
+    int len = WideCharToMultiByte(CP_UTF8, 0, w, chars, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string();
+    std::string s(len, 0);
+    WideCharToMultiByte(CP_UTF8, 0, w, chars, &s[0], len, nullptr, nullptr);
+    if (chars < 0) s.resize(len - 1);
+    return s;
+}
+
+// LookupAccountSid can go to a domain controller; resolve each SID once
+static std::string AccountName(HANDLE process) {
+    HANDLE token;
+    if (!OpenProcessToken(process, TOKEN_QUERY, &token)) return std::string();
+    alignas(8) BYTE buffer[sizeof(TOKEN_USER) + SECURITY_MAX_SID_SIZE];
+    DWORD size = 0;
+    bool ok = GetTokenInformation(token, TokenUser, buffer, sizeof(buffer), &size) != 0;
+    CloseHandle(token);
+    if (!ok) return std::string();
+
+    PSID sid = ((TOKEN_USER*)buffer)->User.Sid;
+    std::string key((const char*)sid, GetLengthSid(sid));
+    auto it = accountNames.find(key);
+    if (it != accountNames.end()) return it->second;
+
+    wchar_t user[256], domain[256];
+    DWORD userLen = 256, domainLen = 256;
+    SID_NAME_USE use;
+    std::string name;
+    if (LookupAccountSidW(nullptr, sid, user, &userLen, domain, &domainLen, &use)) {
+        name = domainLen ? Utf8(domain) + "\\" + Utf8(user) : Utf8(user);
+    }
+    accountNames.emplace(key, name);
+    return name;
+}
+
+static void Fetch(ProcDetails& d, uint32_t pid, HANDLE process) {
+    HANDLE h = process ? process : OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!h) return;
+    if (!d.createTime) {
+        FILETIME createTime, exitTime, kernelTime, userTime;
+        if (GetProcessTimes(h, &createTime, &exitTime, &kernelTime, &userTime))
+            d.createTime = ((uint64_t)createTime.dwHighDateTime << 32) | createTime.dwLowDateTime;
+    }
+    if (d.createTime) d.startTime = (double)((d.createTime - 116444736000000000ULL) / 10000);
+
+    wchar_t path[1024];
+    DWORD size = 1024;
+    if (QueryFullProcessImageNameW(h, 0, path, &size)) d.path = Utf8(path, (int)size);
+    NtProcessCommandLine(h, commandLineBuffer, d.cmdline);
+    d.user = AccountName(h);
+    if (h != process) CloseHandle(h);
+}
+
+static void Cleanup(void*) {
+    std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+    // References die with the env; just forget them
+    details.clear();
+    staleRefs.clear();
+}
+
+const ProcDetails* ProcDetailsGet(uint32_t pid, uint64_t createTime, HANDLE process) {
+    auto it = details.find(pid);
+    if (it != details.end()) {
+        ProcDetails& d = it->second;
+        if (createTime && createTime == d.createTime) {
+            d.tick = currentTick;
+            return &d;
+        }
+    }
+    ProcDetails& d = details[pid];
+    // A reused pid: the old entry's JS object is released at the end of the tick
+    if (d.value) staleRefs.push_back(d.value);
+    d = ProcDetails();
+    d.createTime = createTime;
+    Fetch(d, pid, process);
+    d.tick = currentTick;
+    return &d;
+}
+
+static void SetString(napi_env env, napi_value obj, const char* key, const std::string& s) {
+    napi_value v;
+    if (s.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, s.data(), s.size(), &v);
+    napi_set_named_property(env, obj, key, v);
+}
+
+static napi_value NewValue(napi_env env, const ProcDetails& d) {
+    napi_value obj, v;
+    napi_create_object(env, &obj);
+    SetString(env, obj, "path", d.path);
+    SetString(env, obj, "cmdline", d.cmdline);
+    SetString(env, obj, "user", d.user);
+    if (d.startTime) napi_create_double(env, d.startTime, &v);
+    else napi_get_null(env, &v);
+    napi_set_named_property(env, obj, "startTime", v);
+    return obj;
+}
+
+napi_value ProcDetailsValue(napi_env env, const ProcDetails* cd) {
+    ProcDetails* d = const_cast<ProcDetails*>(cd);
+    napi_value obj = nullptr;
+    if (d->value && napi_get_reference_value(env, d->value, &obj) == napi_ok && obj) return obj;
+    if (!cleanupHooked) {
+        napi_add_env_cleanup_hook(env, Cleanup, nullptr);
+        cleanupHooked = true;
+    }
+    obj = NewValue(env, *d);
+    napi_create_reference(env, obj, 1, &d->value);
+    return obj;
+}
+
+void ProcDetailsEndTick() {
+    for (auto it = details.begin(); it != details.end();) {
+        if (it->second.tick != currentTick) {
+            if (it->second.value) staleRefs.push_back(it->second.value);
+            it = details.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    currentTick++;
+}
+
+void ProcDetailsRelease(napi_env env) {
+    for (napi_ref r : staleRefs) napi_delete_reference(env, r);
+    staleRefs.clear();
+}
+
+napi_value GetProcessDetails(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1], result;
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t pid = 0;
+    if (argc < 1 || napi_get_value_uint32(env, argv[0], &pid) != napi_ok) {
+        napi_get_null(env, &result);
+        return result;
+    }
+
+    bool cached = true;
+    const ProcDetails* d = nullptr;
+    auto it = details.find(pid);
+    if (it != details.end()) {
+        d = &it->second;
+    } else {
+        // Not listed yet: look it up without keeping it, getProcessList owns the cache
+        cached = false;
+        static ProcDetails probe;
+        probe = ProcDetails();
+        Fetch(probe, pid, nullptr);
+        if (!probe.createTime) {
+            napi_get_null(env, &result);
+            return result;
+        }
+        d = &probe;
+    }
+
+    napi_value v;
+    result = NewValue(env, *d);
+    napi_create_uint32(env, pid, &v); napi_set_named_property(env, result, "pid", v);
+    napi_get_boolean(env, cached, &v); napi_set_named_property(env, result, "cached", v);
+    return result;
+}
@@ -0,0 +1,39 @@
+#ifndef PROCDETAILS_H
+#define PROCDETAILS_H
+
+#include <node_api.h>
+#include <windows.h>
+#include <stdint.h>
+#include <string>
+
+// Per-process facts that never change during a process lifetime: image
+// path, command line, owning user and start time. They are fetched once per
+// (pid, create time) and kept until the process is gone, so a steady-state
+// getProcessList tick only pays a hash lookup per row. Each entry also owns
+// its JS object, which rows share instead of rebuilding the strings.
+struct ProcDetails {
+    uint64_t createTime = 0;    // FILETIME; 0 if unknown
+    std::string path, cmdline, user;
+    double startTime = 0;       // epoch ms; 0 if unknown
+    uint32_t tick = 0;
+    napi_ref value = nullptr;
+};
+
+// `process` is the collector's handle or null (no access), in which case a
+// limited handle is tried on a miss. Entries are keyed on (pid, createTime);
+// with createTime 0 (unknown) a reused pid can't be told apart, so such an
+// entry is fetched again on every call.
+const ProcDetails* ProcDetailsGet(uint32_t pid, uint64_t createTime, HANDLE process);
+// { path, cmdline, user, startTime } of an entry, created on first use
+napi_value ProcDetailsValue(napi_env env, const ProcDetails* d);
+// Ends a process list tick: drops the entries of processes not seen in it
+// (any thread, like ProcDetailsGet)
+void ProcDetailsEndTick();
+// Releases the JS objects of dropped entries (JS thread)
+void ProcDetailsRelease(napi_env env);
+
+// getProcessDetails(pid) -> { pid, path, cmdline, user, startTime, cached }
+// or null if the process does not exist
+napi_value GetProcessDetails(napi_env env, napi_callback_info info);
+
+#endif // PROCDETAILS_H
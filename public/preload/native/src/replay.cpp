@@ -0,0 +1,211 @@
+#include "replay.h"
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+static const char ARCHIVE_MAGIC[8] = { 'S', 'Y', 'S', 'M', 'O', 'N', 'R', 'R' };
+static const uint32_t ARCHIVE_VERSION = 1;
+
+enum ReplayMode { MODE_OFF, MODE_RECORD, MODE_PLAY };
+
+struct ReplayRecord {
+    uint64_t timeMs, base;
+    std::vector<uint8_t> bytes;
+};
+
+struct ReplayTrack {
+    std::vector<ReplayRecord> records;
+    size_t next = 0;
+    uint64_t served = 0, captured = 0;
+};
+
+static ReplayMode mode = MODE_OFF;
+static bool loop = false;
+static std::string archivePath;
+static FILE* recordFile = nullptr;
+static ULONGLONG recordStart = 0;
+static std::unordered_map<std::string, ReplayTrack> tracks;
+static std::string lastError;
+
+ReplayResult ReplayFill(ReusableBuffer& buf, size_t& size, uint64_t* base) {
+    if (mode != MODE_PLAY) return REPLAY_LIVE;
+    auto it = tracks.find(buf.name);
+    if (it == tracks.end()) return REPLAY_EMPTY;
+    ReplayTrack& t = it->second;
+    if (t.next >= t.records.size()) {
+        if (!loop || t.records.empty()) return REPLAY_EMPTY;
+        t.next = 0;
+    }
+    const ReplayRecord& r = t.records[t.next++];
+    if (!buf.Reserve(r.bytes.size())) return REPLAY_EMPTY;
+    memcpy(buf.Data(), r.bytes.data(), r.bytes.size());
+    size = r.bytes.size();
+    if (base) *base = r.base;
+    t.served++;
+    return REPLAY_SERVED;
+}
+
+ReplayResult ReplayFillTable(ReusableBuffer& buf, size_t header, size_t rowSize) {
+    size_t size = 0;
+    ReplayResult replay = ReplayFill(buf, size);
+    if (replay != REPLAY_SERVED) return replay;
+    if (size < header || *(const DWORD*)buf.Data() > (size - header) / rowSize) {
+        lastError = std::string("malformed record for ") + buf.name;
+        return REPLAY_EMPTY;
+    }
+    return REPLAY_SERVED;
+}
+
+void ReplayCapture(ReusableBuffer& buf, size_t size) {
+    if (mode != MODE_RECORD || !recordFile) return;
+    uint16_t nameLen = (uint16_t)strlen(buf.name);
+    uint64_t timeMs = GetTickCount64() - recordStart;
+    uint64_t base = (uint64_t)(uintptr_t)buf.Data();
+    uint32_t size32 = (uint32_t)size;
+    fwrite(&nameLen, sizeof(nameLen), 1, recordFile);
+    fwrite(buf.name, 1, nameLen, recordFile);
+    fwrite(&timeMs, sizeof(timeMs), 1, recordFile);
+    fwrite(&base, sizeof(base), 1, recordFile);
+    fwrite(&size32, sizeof(size32), 1, recordFile);
+    fwrite(buf.Data(), 1, size, recordFile);
+    tracks[buf.name].captured++;
+}
+
+static FILE* OpenArchive(const std::string& path, const wchar_t* fmode) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring wpath(len > 0 ? len : 1, 0);
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], len);
+    return _wfopen(wpath.c_str(), fmode);
+}
+
+static void Stop() {
+    if (recordFile) {
+        fclose(recordFile);
+        recordFile = nullptr;
+    }
+    tracks.clear();
+    mode = MODE_OFF;
+}
+
+static bool StartRecord(const std::string& path) {
+    recordFile = OpenArchive(path, L"wb");
+    if (!recordFile) {
+        lastError = "cannot create archive";
+        return false;
+    }
+    fwrite(ARCHIVE_MAGIC, 1, sizeof(ARCHIVE_MAGIC), recordFile);
+    fwrite(&ARCHIVE_VERSION, sizeof(ARCHIVE_VERSION), 1, recordFile);
+    recordStart = GetTickCount64();
+    mode = MODE_RECORD;
+    return true;
+}
+
+static bool StartPlay(const std::string& path) {
+    FILE* f = OpenArchive(path, L"rb");
+    if (!f) {
+        lastError = "cannot open archive";
+        return false;
+    }
+    char magic[8];
+    uint32_t version = 0;
+    bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) && memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) == 0 &&
+              fread(&version, sizeof(version), 1, f) == 1 && version == ARCHIVE_VERSION;
+    if (!ok) lastError = "not a replay archive";
+    while (ok) {
+        uint16_t nameLen;
+        if (fread(&nameLen, sizeof(nameLen), 1, f) != 1) break;     // clean end
+        std::string name(nameLen, 0);
+        ReplayRecord r;
+        uint32_t size = 0;
+        ok = fread(&name[0], 1, nameLen, f) == nameLen &&
+             fread(&r.timeMs, sizeof(r.timeMs), 1, f) == 1 &&
+             fread(&r.base, sizeof(r.base), 1, f) == 1 &&
+             fread(&size, sizeof(size), 1, f) == 1;
+        if (ok) {
+            r.bytes.resize(size);
+            ok = fread(r.bytes.data(), 1, size, f) == size;
+        }
+        if (!ok) {
+            lastError = "truncated archive";
+            break;
+        }
+        tracks[name].records.push_back(std::move(r));
+    }
+    fclose(f);
+    if (!ok) {
+        tracks.clear();
+        return false;
+    }
+    mode = MODE_PLAY;
+    return true;
+}
+
+static napi_value Status(napi_env env) {
+    static const char* modeNames[] = { "off", "record", "play" };
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, modeNames[mode], NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "mode", v);
+    napi_create_string_utf8(env, archivePath.c_str(), archivePath.size(), &v); napi_set_named_property(env, result, "path", v);
+    napi_get_boolean(env, loop, &v); napi_set_named_property(env, result, "loop", v);
+    if (lastError.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, lastError.c_str(), lastError.size(), &v);
+    napi_set_named_property(env, result, "error", v);
+
+    napi_create_array(env, &list);
+    uint32_t idx = 0;
+    for (auto& t : tracks) {
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, t.first.c_str(), t.first.size(), &v); napi_set_named_property(env, item, "name", v);
+        napi_create_uint32(env, (uint32_t)t.second.records.size(), &v); napi_set_named_property(env, item, "records", v);
+        napi_create_double(env, (double)t.second.served, &v); napi_set_named_property(env, item, "served", v);
+        napi_create_double(env, (double)t.second.captured, &v); napi_set_named_property(env, item, "captured", v);
+        napi_set_element(env, list, idx++, item);
+    }
+    napi_set_named_property(env, result, "sources", list);
+    return result;
+}
+
+// setReplay({ mode: 'off' | 'record' | 'play', path, loop })
+napi_value SetReplay(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) {
+        char modeName[16] = {0};
+        std::string path;
+        bool has = false;
+        napi_value v;
+        size_t len = 0;
+        if (napi_has_named_property(env, argv[0], "mode", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "mode", &v);
+            napi_get_value_string_utf8(env, v, modeName, sizeof(modeName), &len);
+        }
+        if (napi_has_named_property(env, argv[0], "path", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "path", &v);
+            if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) == napi_ok) {
+                path.resize(len);
+                napi_get_value_string_utf8(env, v, &path[0], len + 1, &len);
+            }
+        }
+        loop = false;
+        if (napi_has_named_property(env, argv[0], "loop", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "loop", &v);
+            napi_get_value_bool(env, v, &loop);
+        }
+
+        Stop();
+        lastError.clear();
+        archivePath = path;
+        if (strcmp(modeName, "record") == 0) StartRecord(path);
+        else if (strcmp(modeName, "play") == 0) StartPlay(path);
+        else archivePath.clear();
+    }
+    return Status(env);
+}
@@ -0,0 +1,42 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <node_api.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+// Record and replay of the raw OS tables collectors read into a
+// ReusableBuffer (TCP/UDP tables, the NT process list, ...).
+// Collectors call ReplayFill() before querying the OS and ReplayCapture()
+// after a successful query. The buffer's name identifies the source.
+//
+// setReplay({ mode: 'record', path }) appends every captured buffer to an
+// archive. setReplay({ mode: 'play', path, loop }) loads one and serves the
+// recorded buffers in order per source instead of the live OS. This makes
+// large scenarios (200k sockets, 50k processes) reproducible on any box;
+// archives can also be synthesized (see test-replay.js).
+//
+// Archive: "SYSMONRR", u32 version, then per record
+//   u16 nameLen, name, u64 timeMs, u64 base, u32 size, size bytes
+// (little endian; `base` is the address the buffer had when recorded, used
+// to rebase self-referencing pointers).
+
+enum ReplayResult {
+    REPLAY_LIVE,        // not playing: query the OS
+    REPLAY_SERVED,      // buf holds the next recorded buffer
+    REPLAY_EMPTY        // playing but nothing (left) for this source: fail the query
+};
+
+// `size` receives the recorded size, `base` the recorded buffer address
+ReplayResult ReplayFill(ReusableBuffer& buf, size_t& size, uint64_t* base = nullptr);
+// ReplayFill for MIB-style tables (a DWORD row count, rows from `header`):
+// a recorded buffer whose row count doesn't fit its size is not served
+ReplayResult ReplayFillTable(ReusableBuffer& buf, size_t header, size_t rowSize);
+// No-op unless recording
+void ReplayCapture(ReusableBuffer& buf, size_t size);
+
+// setReplay(opts) -> status; setReplay() only returns the status
+napi_value SetReplay(napi_env env, napi_callback_info info);
+
+#endif // REPLAY_H
@@ -0,0 +1,442 @@
+#include "scanner.h"
+#include <windows.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+static const uint32_t MAX_THREADS = 32;
+static const uint32_t MAX_TOP = 1000;
+
+// One node per directory; parents outlive children so sizes can be summed
+// bottom-up once the walk is done. Only the name segment is stored.
+struct DirNode {
+    DirNode* parent;
+    std::wstring name;
+    uint32_t depth;
+    uint64_t own, total;
+    uint64_t files;
+};
+
+struct WorkItem {
+    DirNode* node;
+    std::wstring path;
+};
+
+struct FileHit {
+    uint64_t size;
+    DirNode* dir;
+    std::wstring name;
+};
+
+// Min-heap on size: the root is the smallest of the current top N
+static bool HitGreater(const FileHit& a, const FileHit& b) { return a.size > b.size; }
+
+struct ScanJob;
+
+struct ScanWorker {
+    ScanJob* job;
+    uint32_t index;
+    std::mutex lock;
+    std::deque<WorkItem> queue;
+    std::deque<DirNode> nodes;      // stable addresses
+    std::vector<FileHit> topFiles;
+    std::atomic<uint64_t> files{0}, dirs{0}, bytes{0}, errors{0};
+};
+
+struct ScanJob {
+    uint32_t id;
+    std::wstring root;              // as given (UTF-16)
+    std::wstring walkRoot;          // \\?\ prefixed full path
+    uint32_t top, threadCount, progressMs;
+    std::atomic<bool> cancel{false};
+    std::atomic<int64_t> outstanding{0};
+    std::vector<ScanWorker*> workers;
+    DirNode* rootNode = nullptr;
+    bool found = false;
+    double elapsed = 0;
+
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+    napi_threadsafe_function progress = nullptr;
+};
+
+struct ScanProgress { uint64_t files, dirs, bytes; double elapsed; };
+
+static std::vector<ScanJob*> jobs;
+static uint32_t nextJobId = 1;
+
+static std::string WideToUtf8Scan(const wchar_t* wstr) {
+    if (!wstr) return "";
+    int len = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return "";
+    std::string result(len - 1, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wstr, -1, &result[0], len, nullptr, nullptr);
+    return result;
+}
+
+static std::wstring Utf8ToWideScan(const std::string& str) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+    if (len <= 0) return L"";
+    std::wstring result(len - 1, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &result[0], len);
+    return result;
+}
+
+// Full path with the \\?\ prefix so paths past MAX_PATH can be walked
+static std::wstring LongPath(const std::wstring& path) {
+    DWORD len = GetFullPathNameW(path.c_str(), 0, nullptr, nullptr);
+    if (len == 0) return L"";
+    std::wstring full(len, 0);
+    len = GetFullPathNameW(path.c_str(), len, &full[0], nullptr);
+    full.resize(len);
+    // "C:\" keeps its backslash, "C:\Users\" loses it
+    if (full.size() > 3 && full.back() == L'\\') full.pop_back();
+    if (full.compare(0, 4, L"\\\\?\\") == 0) return full;
+    if (full.compare(0, 2, L"\\\\") == 0) return L"\\\\?\\UNC\\" + full.substr(2);
+    return L"\\\\?\\" + full;
+}
+
+static std::wstring NodePath(const ScanJob* job, const DirNode* node) {
+    std::vector<const DirNode*> chain;
+    for (; node && node->parent; node = node->parent) chain.push_back(node);
+    std::wstring path = job->root;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if (!path.empty() && path.back() != L'\\') path += L'\\';
+        path += (*it)->name;
+    }
+    return path;
+}
+
+static void ScanOne(ScanWorker* w, WorkItem& item) {
+    ScanJob* job = w->job;
+    std::wstring pattern = item.path;
+    if (pattern.back() != L'\\') pattern += L'\\';
+    size_t base = pattern.size();
+    pattern += L'*';
+
+    WIN32_FIND_DATAW fd;
+    // Basic info skips the 8.3 name; large fetch asks for bigger directory reads
+    HANDLE find = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &fd, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE) {
+        w->errors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    DirNode* node = item.node;
+    uint64_t files = 0, bytes = 0;
+    do {
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (fd.cFileName[0] == L'.' && (!fd.cFileName[1] || (fd.cFileName[1] == L'.' && !fd.cFileName[2]))) continue;
+            // Junctions and symlinks would double count or loop
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+            w->nodes.push_back({ node, fd.cFileName, node->depth + 1, 0, 0, 0 });
+            WorkItem child = { &w->nodes.back(), pattern.substr(0, base) + fd.cFileName };
+            job->outstanding.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(w->lock);
+            w->queue.push_back(std::move(child));
+        } else {
+            uint64_t size = ((uint64_t)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+            files++;
+            bytes += size;
+            auto& heap = w->topFiles;
+            if (heap.size() < job->top) {
+                heap.push_back({ size, node, fd.cFileName });
+                std::push_heap(heap.begin(), heap.end(), HitGreater);
+            } else if (job->top > 0 && size > heap.front().size) {
+                std::pop_heap(heap.begin(), heap.end(), HitGreater);
+                heap.back() = { size, node, fd.cFileName };
+                std::push_heap(heap.begin(), heap.end(), HitGreater);
+            }
+        }
+    } while (!job->cancel.load(std::memory_order_relaxed) && FindNextFileW(find, &fd));
+    FindClose(find);
+
+    node->own = bytes;
+    node->files = files;
+    w->files.fetch_add(files, std::memory_order_relaxed);
+    w->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    w->dirs.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Own deque from the back (depth first), others from the front (the oldest,
+// shallowest entries carry the largest subtrees)
+static bool NextItem(ScanWorker* w, WorkItem& out) {
+    {
+        std::lock_guard<std::mutex> guard(w->lock);
+        if (!w->queue.empty()) {
+            out = std::move(w->queue.back());
+            w->queue.pop_back();
+            return true;
+        }
+    }
+    ScanJob* job = w->job;
+    uint32_t n = (uint32_t)job->workers.size();
+    for (uint32_t i = 1; i < n; i++) {
+        ScanWorker* victim = job->workers[(w->index + i) % n];
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if (!victim->queue.empty()) {
+            out = std::move(victim->queue.front());
+            victim->queue.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+static void WorkerLoop(ScanWorker* w) {
+    ScanJob* job = w->job;
+    WorkItem item;
+    uint32_t idle = 0;
+    while (!job->cancel.load(std::memory_order_relaxed)) {
+        if (NextItem(w, item)) {
+            idle = 0;
+            ScanOne(w, item);
+            job->outstanding.fetch_sub(1, std::memory_order_acq_rel);
+            continue;
+        }
+        // Nothing to steal: done once no directory is queued or being read
+        if (job->outstanding.load(std::memory_order_acquire) == 0) break;
+        if (++idle < 64) std::this_thread::yield();
+        else Sleep(1);
+    }
+}
+
+static uint64_t Sum(ScanJob* job, std::atomic<uint64_t> ScanWorker::*field) {
+    uint64_t total = 0;
+    for (auto* w : job->workers) total += (w->*field).load(std::memory_order_relaxed);
+    return total;
+}
+
+static void CallProgressJs(napi_env env, napi_value jsCb, void* context, void* data) {
+    ScanProgress* p = (ScanProgress*)data;
+    if (env && jsCb) {
+        napi_value ev, v, undefined;
+        napi_create_object(env, &ev);
+        napi_create_double(env, (double)p->files, &v); napi_set_named_property(env, ev, "files", v);
+        napi_create_double(env, (double)p->dirs, &v); napi_set_named_property(env, ev, "dirs", v);
+        napi_create_double(env, (double)p->bytes, &v); napi_set_named_property(env, ev, "bytes", v);
+        napi_create_double(env, p->elapsed, &v); napi_set_named_property(env, ev, "elapsed", v);
+        napi_get_undefined(env, &undefined);
+        napi_call_function(env, undefined, jsCb, 1, &ev, nullptr);
+    }
+    delete p;
+}
+
+static void EmitProgress(ScanJob* job) {
+    if (!job->progress) return;
+    ScanProgress* p = new ScanProgress{ Sum(job, &ScanWorker::files), Sum(job, &ScanWorker::dirs),
+                                        Sum(job, &ScanWorker::bytes), job->elapsed };
+    // Dropped when JS is not keeping up; the next one carries the totals anyway
+    if (napi_call_threadsafe_function(job->progress, p, napi_tsfn_nonblocking) != napi_ok) delete p;
+}
+
+// Runs on a libuv pool thread: starts the workers and reports progress until they finish
+static void ExecuteScan(napi_env env, void* data) {
+    ScanJob* job = (ScanJob*)data;
+    LARGE_INTEGER freq, start, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+
+    DWORD attrs = job->walkRoot.empty() ? INVALID_FILE_ATTRIBUTES : GetFileAttributesW(job->walkRoot.c_str());
+    job->found = attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY);
+    if (!job->found) return;
+
+    for (uint32_t i = 0; i < job->threadCount; i++) {
+        ScanWorker* w = new ScanWorker();
+        w->job = job;
+        w->index = i;
+        job->workers.push_back(w);
+    }
+    ScanWorker* first = job->workers[0];
+    first->nodes.push_back({ nullptr, L"", 0, 0, 0, 0 });
+    job->rootNode = &first->nodes.back();
+    job->outstanding = 1;
+    first->queue.push_back({ job->rootNode, job->walkRoot });
+
+    std::vector<std::thread> threads;
+    for (auto* w : job->workers) threads.emplace_back(WorkerLoop, w);
+
+    while (job->outstanding.load(std::memory_order_acquire) > 0 && !job->cancel.load(std::memory_order_relaxed)) {
+        Sleep(job->progressMs < 50 ? job->progressMs : 50);
+        QueryPerformanceCounter(&now);
+        double elapsed = (double)(now.QuadPart - start.QuadPart) / freq.QuadPart;
+        if ((elapsed - job->elapsed) * 1000 >= job->progressMs) {
+            job->elapsed = elapsed;
+            EmitProgress(job);
+        }
+    }
+    for (auto& t : threads) t.join();
+    QueryPerformanceCounter(&now);
+    job->elapsed = (double)(now.QuadPart - start.QuadPart) / freq.QuadPart;
+
+    // Recursive totals: children before parents
+    std::vector<DirNode*> all;
+    for (auto* w : job->workers) for (auto& n : w->nodes) all.push_back(&n);
+    std::sort(all.begin(), all.end(), [](const DirNode* a, const DirNode* b) { return a->depth > b->depth; });
+    for (auto* n : all) n->total += n->own;
+    for (auto* n : all) {
+        if (n->parent) {
+            n->parent->total += n->total;
+            n->parent->files += n->files;
+        }
+    }
+}
+
+static void FreeJob(ScanJob* job) {
+    for (auto* w : job->workers) delete w;
+    delete job;
+}
+
+static void CompleteScan(napi_env env, napi_status status, void* data) {
+    ScanJob* job = (ScanJob*)data;
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), job), jobs.end());
+    if (job->progress) {
+        EmitProgress(job);
+        napi_release_threadsafe_function(job->progress, napi_tsfn_release);
+    }
+
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    std::string root = WideToUtf8Scan(job->root.c_str());
+    napi_create_string_utf8(env, root.c_str(), root.size(), &v); napi_set_named_property(env, result, "root", v);
+    napi_get_boolean(env, job->found, &v); napi_set_named_property(env, result, "found", v);
+    napi_get_boolean(env, job->cancel.load(), &v); napi_set_named_property(env, result, "cancelled", v);
+    napi_create_double(env, (double)Sum(job, &ScanWorker::files), &v); napi_set_named_property(env, result, "files", v);
+    napi_create_double(env, (double)Sum(job, &ScanWorker::dirs), &v); napi_set_named_property(env, result, "dirs", v);
+    napi_create_double(env, (double)Sum(job, &ScanWorker::bytes), &v); napi_set_named_property(env, result, "bytes", v);
+    napi_create_double(env, (double)Sum(job, &ScanWorker::errors), &v); napi_set_named_property(env, result, "errors", v);
+    napi_create_double(env, job->elapsed, &v); napi_set_named_property(env, result, "elapsed", v);
+    napi_create_uint32(env, job->threadCount, &v); napi_set_named_property(env, result, "threads", v);
+
+    // Largest directories (the root itself excluded)
+    std::vector<DirNode*> dirs;
+    for (auto* w : job->workers) for (auto& n : w->nodes) if (n.parent) dirs.push_back(&n);
+    size_t n = std::min<size_t>(job->top, dirs.size());
+    std::partial_sort(dirs.begin(), dirs.begin() + n, dirs.end(), [](const DirNode* a, const DirNode* b) { return a->total > b->total; });
+    napi_create_array(env, &list);
+    for (size_t i = 0; i < n; i++) {
+        napi_value item;
+        napi_create_object(env, &item);
+        std::string path = WideToUtf8Scan(NodePath(job, dirs[i]).c_str());
+        napi_create_string_utf8(env, path.c_str(), path.size(), &v); napi_set_named_property(env, item, "path", v);
+        napi_create_double(env, (double)dirs[i]->total, &v); napi_set_named_property(env, item, "size", v);
+        napi_create_double(env, (double)dirs[i]->files, &v); napi_set_named_property(env, item, "files", v);
+        napi_set_element(env, list, (uint32_t)i, item);
+    }
+    napi_set_named_property(env, result, "topDirs", list);
+
+    // Largest files: merge the per-worker heaps
+    std::vector<FileHit*> hits;
+    for (auto* w : job->workers) for (auto& h : w->topFiles) hits.push_back(&h);
+    n = std::min<size_t>(job->top, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + n, hits.end(), [](const FileHit* a, const FileHit* b) { return a->size > b->size; });
+    napi_create_array(env, &list);
+    for (size_t i = 0; i < n; i++) {
+        napi_value item;
+        napi_create_object(env, &item);
+        std::wstring wpath = NodePath(job, hits[i]->dir);
+        if (!wpath.empty() && wpath.back() != L'\\') wpath += L'\\';
+        wpath += hits[i]->name;
+        std::string path = WideToUtf8Scan(wpath.c_str());
+        napi_create_string_utf8(env, path.c_str(), path.size(), &v); napi_set_named_property(env, item, "path", v);
+        napi_create_double(env, (double)hits[i]->size, &v); napi_set_named_property(env, item, "size", v);
+        napi_set_element(env, list, (uint32_t)i, item);
+    }
+    napi_set_named_property(env, result, "topFiles", list);
+
+    napi_resolve_deferred(env, job->deferred, result);
+    napi_delete_async_work(env, job->work);
+    FreeJob(job);
+}
+
+static bool GetUint32Option(napi_env env, napi_value opts, const char* name, uint32_t& out) {
+    bool has = false;
+    if (napi_has_named_property(env, opts, name, &has) != napi_ok || !has) return false;
+    napi_value v;
+    napi_get_named_property(env, opts, name, &v);
+    return napi_get_value_uint32(env, v, &out) == napi_ok;
+}
+
+napi_value ScanDirectory(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    ScanJob* job = new ScanJob();
+    job->id = nextJobId++;
+    job->top = 20;
+    job->progressMs = 250;
+    job->threadCount = std::thread::hardware_concurrency();
+    // Directory reads block on I/O, so more threads than cores still helps on SSDs
+    if (job->threadCount < 4) job->threadCount = 4;
+
+    if (argc > 0) {
+        size_t len = 0;
+        if (napi_get_value_string_utf8(env, argv[0], nullptr, 0, &len) == napi_ok) {
+            std::string root(len, 0);
+            napi_get_value_string_utf8(env, argv[0], &root[0], len + 1, &len);
+            job->root = Utf8ToWideScan(root);
+        }
+    }
+    if (argc > 1) {
+        napi_valuetype t;
+        napi_typeof(env, argv[1], &t);
+        if (t == napi_object) {
+            GetUint32Option(env, argv[1], "top", job->top);
+            GetUint32Option(env, argv[1], "threads", job->threadCount);
+            GetUint32Option(env, argv[1], "progressInterval", job->progressMs);
+            bool has = false;
+            napi_value fn;
+            if (napi_has_named_property(env, argv[1], "onProgress", &has) == napi_ok && has &&
+                napi_get_named_property(env, argv[1], "onProgress", &fn) == napi_ok &&
+                napi_typeof(env, fn, &t) == napi_ok && t == napi_function) {
+                napi_value name;
+                napi_create_string_utf8(env, "sysmonScanProgress", NAPI_AUTO_LENGTH, &name);
+                if (napi_create_threadsafe_function(env, fn, nullptr, name, 4, 1, nullptr, nullptr, nullptr,
+                                                    CallProgressJs, &job->progress) != napi_ok) {
+                    job->progress = nullptr;
+                }
+            }
+        }
+    }
+    if (job->top > MAX_TOP) job->top = MAX_TOP;
+    if (job->threadCount < 1) job->threadCount = 1;
+    if (job->threadCount > MAX_THREADS) job->threadCount = MAX_THREADS;
+    if (job->progressMs < 10) job->progressMs = 10;
+    if (!job->root.empty()) job->walkRoot = LongPath(job->root);
+
+    napi_value promise, name, result, v;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_create_string_utf8(env, "sysmonScanDirectory", NAPI_AUTO_LENGTH, &name);
+    napi_create_async_work(env, nullptr, name, ExecuteScan, CompleteScan, job, &job->work);
+    napi_queue_async_work(env, job->work);
+    jobs.push_back(job);
+
+    napi_create_object(env, &result);
+    napi_create_uint32(env, job->id, &v); napi_set_named_property(env, result, "id", v);
+    napi_set_named_property(env, result, "result", promise);
+    return result;
+}
+
+napi_value CancelScan(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t id = 0;
+    if (argc > 0) napi_get_value_uint32(env, argv[0], &id);
+
+    bool found = false;
+    for (auto* job : jobs) {
+        if (job->id == id) {
+            job->cancel = true;
+            found = true;
+        }
+    }
+    napi_value result;
+    napi_get_boolean(env, found, &result);
+    return result;
+}
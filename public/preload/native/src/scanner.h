@@ -0,0 +1,19 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <node_api.h>
+
+// scanDirectory(root, { top, threads, onProgress, progressInterval })
+//   -> { id, result: Promise<{ root, found, cancelled, files, dirs, bytes,
+//        errors, elapsed, threads, topDirs[{ path, size, files }], topFiles[{ path, size }] }> }
+// Walks the tree on worker threads as an async job. Each worker keeps its own
+// deque of pending directories (LIFO for locality) and steals the oldest
+// entry of another worker's deque when it runs dry, so one deep subtree does
+// not leave the other threads idle. Directory sizes are recursive totals.
+// onProgress({ files, dirs, bytes, elapsed }) is called every progressInterval ms.
+napi_value ScanDirectory(napi_env env, napi_callback_info info);
+// cancelScan(id) - stops a running scan; its promise resolves with what was
+// counted so far and cancelled: true. Returns false for unknown ids.
+napi_value CancelScan(napi_env env, napi_callback_info info);
+
+#endif // SCANNER_H
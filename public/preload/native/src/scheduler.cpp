@@ -0,0 +1,246 @@
+#include "scheduler.h"
+#include "selfstats.h"
+#include "snapshot.h"
+#include <windows.h>
+#include <math.h>
+#include <string.h>
+
+static const int MAX_SIGNALS = 4;
+
+struct SchedEntry {
+    const char* name;
+    double minMs, maxMs;   // interval range
+    bool expensive;        // stretched while the host is loaded
+    double budget;         // max share of wall time this collector may use
+    // Runtime state
+    napi_callback fn;
+    napi_ref cached;
+    ULONGLONG lastRun;
+    double interval;       // change-driven interval
+    double effective;      // after load / budget stretching
+    double costMs;         // EWMA of the real call cost
+    double signals[MAX_SIGNALS];
+    int signalCount, signalIdx;
+    bool changed;
+    const char* reason;
+    uint32_t samples, served;
+};
+
+static SchedEntry entries[] = {
+    { "getMemoryInfo",         1000,  5000, false, 0.01 },
+    { "getSystemStats",        1000, 10000, true,  0.02 },
+    { "getDiskIO",             1000,  5000, false, 0.01 },
+    { "getNetworkStats",       1000,  5000, false, 0.01 },
+    { "getNetworkConnections", 1000, 10000, true,  0.02 },
+    { "getProcessList",        1000, 10000, true,  0.02 },
+    { "getDiskInfo",           5000, 60000, false, 0.01 },
+    { "getBatteryInfo",        5000, 30000, false, 0.01 },
+};
+static const int ENTRY_COUNT = sizeof(entries) / sizeof(entries[0]);
+
+static bool enabled = true;
+static double hostCpuHigh = 80;   // total CPU % above which expensive collectors slow down
+static double backoff = 1.5;      // interval growth per unchanged sample
+static const double DUE_SLACK_MS = 100;  // JS timers fire a little early or late
+
+static SchedEntry* current = nullptr;
+static double msPerTick = 0;
+
+void SchedulerSignal(double value, double tolerance) {
+    if (!current) return;
+    SchedEntry& e = *current;
+    int i = e.signalIdx++;
+    if (i >= MAX_SIGNALS) return;
+    if (i >= e.signalCount) {
+        e.signalCount = i + 1;
+        e.changed = true;
+    } else if (fabs(value - e.signals[i]) > tolerance) {
+        e.changed = true;
+    }
+    e.signals[i] = value;
+}
+
+static void Adjust(SchedEntry& e) {
+    if (e.changed) {
+        e.interval = e.minMs;
+        e.reason = "changing";
+    } else {
+        e.interval = e.interval * backoff;
+        if (e.interval >= e.maxMs) e.interval = e.maxMs;
+        e.reason = e.interval >= e.maxMs ? "stable" : "settling";
+    }
+
+    double eff = e.interval;
+    if (e.expensive && snapshot.cpuTotal >= hostCpuHigh) {
+        eff *= 2;
+        e.reason = "hostLoad";
+    }
+    if (e.budget > 0 && e.costMs / e.budget > eff) {
+        eff = e.costMs / e.budget;
+        e.reason = "overBudget";
+    }
+    if (eff > e.maxMs) eff = e.maxMs;
+    if (eff < e.minMs) eff = e.minMs;
+    e.effective = eff;
+}
+
+static void Tag(napi_env env, napi_value result, const SchedEntry& e, ULONGLONG now) {
+    napi_valuetype type;
+    if (napi_typeof(env, result, &type) != napi_ok || type != napi_object) return;
+    napi_value v;
+    napi_create_double(env, e.effective, &v); napi_set_named_property(env, result, "sampleInterval", v);
+    napi_create_double(env, (double)(now - e.lastRun), &v); napi_set_named_property(env, result, "sampleAge", v);
+}
+
+static napi_value RunScheduled(SchedEntry& e, napi_env env, napi_callback_info info) {
+    ULONGLONG now = GetTickCount64();
+    if (enabled && e.cached && now - e.lastRun + DUE_SLACK_MS < e.effective) {
+        napi_value cached = nullptr;
+        if (napi_get_reference_value(env, e.cached, &cached) == napi_ok && cached) {
+            e.served++;
+            SelfStatsSkip();
+            Tag(env, cached, e, now);
+            return cached;
+        }
+    }
+
+    current = &e;
+    e.signalIdx = 0;
+    e.changed = e.samples == 0;
+    LARGE_INTEGER t0, t1;
+    QueryPerformanceCounter(&t0);
+    napi_value result = e.fn(env, info);
+    QueryPerformanceCounter(&t1);
+    current = nullptr;
+
+    double cost = (t1.QuadPart - t0.QuadPart) * msPerTick;
+    e.costMs = e.samples ? e.costMs * 0.8 + cost * 0.2 : cost;
+    e.samples++;
+    e.lastRun = now;
+    Adjust(e);
+
+    if (e.cached) napi_delete_reference(env, e.cached);
+    e.cached = nullptr;
+    if (result) napi_create_reference(env, result, 1, &e.cached);
+    Tag(env, result, e, now);
+    return result;
+}
+
+// One gate per entry, so the property's data slot stays free for SelfStats
+template <int N>
+static napi_value Gate(napi_env env, napi_callback_info info) {
+    return RunScheduled(entries[N], env, info);
+}
+static const napi_callback gates[] = {
+    Gate<0>, Gate<1>, Gate<2>, Gate<3>, Gate<4>, Gate<5>, Gate<6>, Gate<7>,
+};
+static_assert(sizeof(gates) / sizeof(gates[0]) == ENTRY_COUNT, "one gate per scheduled collector");
+
+static void ReleaseCached(void*) {
+    for (auto& e : entries) e.cached = nullptr;
+}
+
+void SchedulerAttach(napi_env env, napi_property_descriptor* props, size_t count) {
+    LARGE_INTEGER freq; QueryPerformanceFrequency(&freq);
+    msPerTick = 1000.0 / (double)freq.QuadPart;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!props[i].utf8name || !props[i].method) continue;
+        for (int j = 0; j < ENTRY_COUNT; j++) {
+            if (strcmp(props[i].utf8name, entries[j].name) != 0) continue;
+            entries[j].fn = props[i].method;
+            entries[j].interval = entries[j].effective = entries[j].minMs;
+            entries[j].reason = "initial";
+            props[i].method = gates[j];
+            break;
+        }
+    }
+    // References die with the env; forget them so a new env starts clean
+    napi_add_env_cleanup_hook(env, ReleaseCached, nullptr);
+}
+
+// getSchedule() - effective interval and the reason for every scheduled collector
+napi_value GetSchedule(napi_env env, napi_callback_info info) {
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    napi_get_boolean(env, enabled, &v); napi_set_named_property(env, result, "enabled", v);
+    napi_create_double(env, hostCpuHigh, &v); napi_set_named_property(env, result, "hostCpuHigh", v);
+    napi_create_double(env, backoff, &v); napi_set_named_property(env, result, "backoff", v);
+    napi_create_double(env, snapshot.cpuTotal, &v); napi_set_named_property(env, result, "hostCpu", v);
+
+    ULONGLONG now = GetTickCount64();
+    napi_create_array(env, &list);
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        const SchedEntry& e = entries[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, e.name, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "name", v);
+        napi_create_double(env, e.effective, &v); napi_set_named_property(env, item, "interval", v);
+        napi_create_double(env, e.interval, &v); napi_set_named_property(env, item, "baseInterval", v);
+        napi_create_double(env, e.minMs, &v); napi_set_named_property(env, item, "min", v);
+        napi_create_double(env, e.maxMs, &v); napi_set_named_property(env, item, "max", v);
+        napi_create_double(env, e.budget, &v); napi_set_named_property(env, item, "budget", v);
+        napi_get_boolean(env, e.expensive, &v); napi_set_named_property(env, item, "expensive", v);
+        napi_create_double(env, e.costMs, &v); napi_set_named_property(env, item, "cost", v);
+        napi_create_string_utf8(env, e.reason ? e.reason : "", NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "reason", v);
+        napi_create_uint32(env, e.samples, &v); napi_set_named_property(env, item, "samples", v);
+        napi_create_uint32(env, e.served, &v); napi_set_named_property(env, item, "served", v);
+        napi_create_double(env, e.samples ? (double)(now - e.lastRun) : 0, &v); napi_set_named_property(env, item, "age", v);
+        napi_set_element(env, list, i, item);
+    }
+    napi_set_named_property(env, result, "collectors", list);
+    return result;
+}
+
+static bool ReadNumber(napi_env env, napi_value obj, const char* key, double& out) {
+    bool has = false;
+    if (napi_has_named_property(env, obj, key, &has) != napi_ok || !has) return false;
+    napi_value v; double d;
+    napi_get_named_property(env, obj, key, &v);
+    if (napi_get_value_double(env, v, &d) != napi_ok || d < 0) return false;
+    out = d;
+    return true;
+}
+
+// setSchedule({ enabled, hostCpuHigh, backoff, collectors: { name: { min, max, budget } } })
+napi_value SetSchedule(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) {
+        bool has = false;
+        if (napi_has_named_property(env, argv[0], "enabled", &has) == napi_ok && has) {
+            napi_value v; bool b;
+            napi_get_named_property(env, argv[0], "enabled", &v);
+            if (napi_get_value_bool(env, v, &b) == napi_ok) enabled = b;
+        }
+        ReadNumber(env, argv[0], "hostCpuHigh", hostCpuHigh);
+        double b = backoff;
+        if (ReadNumber(env, argv[0], "backoff", b) && b >= 1) backoff = b;
+
+        napi_value collectors;
+        if (napi_has_named_property(env, argv[0], "collectors", &has) == napi_ok && has &&
+            napi_get_named_property(env, argv[0], "collectors", &collectors) == napi_ok) {
+            for (auto& e : entries) {
+                napi_value c;
+                if (napi_has_named_property(env, collectors, e.name, &has) != napi_ok || !has) continue;
+                napi_get_named_property(env, collectors, e.name, &c);
+                double minMs = e.minMs, maxMs = e.maxMs;
+                ReadNumber(env, c, "min", minMs);
+                ReadNumber(env, c, "max", maxMs);
+                ReadNumber(env, c, "budget", e.budget);
+                if (minMs < 100) minMs = 100;
+                if (maxMs < minMs) maxMs = minMs;
+                e.minMs = minMs;
+                e.maxMs = maxMs;
+                // Take effect on the next call
+                e.interval = e.effective = minMs;
+                e.lastRun = 0;
+            }
+        }
+    }
+    return GetSchedule(env, info);
+}
@@ -0,0 +1,24 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <node_api.h>
+#include <stddef.h>
+
+// Adaptive sampling for the periodic collectors.
+// SchedulerAttach() must run before SelfStatsInstrument(). It routes the
+// scheduled exports through a gate that returns the previous result until
+// the collector's current interval has elapsed. Intervals shrink to the
+// minimum while the collector reports changes and back off while it is
+// flat. Expensive collectors are stretched further when host CPU is high
+// or when their measured cost exceeds their share of wall time.
+void SchedulerAttach(napi_env env, napi_property_descriptor* props, size_t count);
+
+// Reports a key value of the running collector. The sample counts as
+// "changing" if any reported value moved by more than `tolerance`.
+// Collectors may report several values per call; no-op when unscheduled.
+void SchedulerSignal(double value, double tolerance);
+
+napi_value GetSchedule(napi_env env, napi_callback_info info);
+napi_value SetSchedule(napi_env env, napi_callback_info info);
+
+#endif // SCHEDULER_H
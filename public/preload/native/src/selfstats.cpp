@@ -0,0 +1,257 @@
+#include "selfstats.h"
+#include "snapshot.h"
+#include <windows.h>
+#include <psapi.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Log-linear histogram (HDR style): 16 linear sub-buckets per power of two,
+// so a recorded value is reported within ~6%. Values are ns or bytes.
+static const int SUB_BITS = 4;
+static const int SUB_COUNT = 1 << SUB_BITS;
+static const int MAX_EXP = 40;  // 2^40 ns is ~18 minutes, 2^40 bytes is 1 TB
+static const int BUCKETS = (MAX_EXP - SUB_BITS + 2) * SUB_COUNT;
+
+static int Log2(uint64_t v) {
+    int r = 0;
+    if (v >> 32) { v >>= 32; r += 32; }
+    if (v >> 16) { v >>= 16; r += 16; }
+    if (v >> 8) { v >>= 8; r += 8; }
+    if (v >> 4) { v >>= 4; r += 4; }
+    if (v >> 2) { v >>= 2; r += 2; }
+    if (v >> 1) r += 1;
+    return r;
+}
+
+static int BucketOf(uint64_t v) {
+    if (v < SUB_COUNT) return (int)v;
+    int e = Log2(v);
+    if (e > MAX_EXP) return BUCKETS - 1;
+    return (e - SUB_BITS + 1) * SUB_COUNT + (int)((v >> (e - SUB_BITS)) & (SUB_COUNT - 1));
+}
+
+// Midpoint of a bucket
+static uint64_t BucketValue(int idx) {
+    if (idx < SUB_COUNT) return (uint64_t)idx;
+    int e = idx / SUB_COUNT + SUB_BITS - 1;
+    uint64_t width = 1ULL << (e - SUB_BITS);
+    return (uint64_t)(SUB_COUNT + idx % SUB_COUNT) * width + width / 2;
+}
+
+struct Histogram {
+    uint32_t counts[BUCKETS];
+    uint64_t count, max;
+    double sum;
+
+    void Record(uint64_t v) {
+        counts[BucketOf(v)]++;
+        count++;
+        sum += (double)v;
+        if (v > max) max = v;
+    }
+
+    void Reset() { memset(this, 0, sizeof(*this)); }
+
+    uint64_t Percentile(double p) const {
+        if (!count) return 0;
+        uint64_t target = (uint64_t)(p * count + 0.5);
+        if (target < 1) target = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= target) {
+                uint64_t v = BucketValue(i);
+                return v < max ? v : max;
+            }
+        }
+        return max;
+    }
+};
+
+struct CollectorStats {
+    const char* name;
+    napi_callback fn;
+    uint64_t calls, skipped;
+    Histogram total, query, marshal, bytes;
+};
+
+// One zeroed slot per export, sized from the export table when it is
+// instrumented, so exports added later are never left unmeasured
+static CollectorStats* collectors = nullptr;
+static int collectorCount = 0;
+
+// State of the call in progress (exports run on the JS thread, under snapshotLock)
+static CollectorStats* current = nullptr;
+static LONGLONG queryStart = 0, queryTicks = 0;
+static size_t queryBytes = 0;
+static bool queried = false, skipped = false;
+
+static double nsPerTick = 0;
+static uint64_t nativeNs = 0;  // time spent inside exports since load
+
+static LONGLONG Now() {
+    LARGE_INTEGER t; QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+void SelfStatsQueryBegin() {
+    if (!current) return;
+    queryStart = Now();
+}
+
+void SelfStatsQueryEnd(size_t bytes) {
+    if (!current || !queryStart) return;
+    queryTicks += Now() - queryStart;
+    queryStart = 0;
+    queryBytes += bytes;
+    queried = true;
+}
+
+void SelfStatsSkip() {
+    if (current) skipped = true;
+}
+
+static napi_value Instrumented(napi_env env, napi_callback_info info) {
+    void* data = nullptr;
+    napi_get_cb_info(env, info, nullptr, nullptr, nullptr, &data);
+    CollectorStats* s = (CollectorStats*)data;
+    if (current) return s->fn(env, info);  // re-entered from JS, outer call owns the timing
+
+    // Waits out a pump tick; not counted in the call's time
+    std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+    current = s;
+    queryStart = queryTicks = 0;
+    queryBytes = 0;
+    queried = false;
+    skipped = false;
+
+    LONGLONG start = Now();
+    napi_value result = s->fn(env, info);
+    LONGLONG elapsed = Now() - start;
+    current = nullptr;
+    if (skipped) {
+        s->skipped++;
+        return result;
+    }
+
+    uint64_t totalNs = (uint64_t)(elapsed * nsPerTick);
+    s->calls++;
+    s->total.Record(totalNs);
+    if (queried) {
+        uint64_t queryNs = (uint64_t)(queryTicks * nsPerTick);
+        s->query.Record(queryNs);
+        s->marshal.Record(totalNs > queryNs ? totalNs - queryNs : 0);
+        s->bytes.Record(queryBytes);
+    } else {
+        s->query.Record(totalNs);
+    }
+    nativeNs += totalNs;
+    return result;
+}
+
+void SelfStatsInstrument(napi_property_descriptor* props, size_t count) {
+    LARGE_INTEGER freq; QueryPerformanceFrequency(&freq);
+    nsPerTick = 1e9 / (double)freq.QuadPart;
+
+    // Never freed: the export table keeps pointers into it for the life of the process
+    CollectorStats* slots = (CollectorStats*)calloc(count, sizeof(CollectorStats));
+    if (!slots) return;
+    collectors = slots;
+    collectorCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!props[i].method || props[i].method == GetSelfStats) continue;
+        CollectorStats& s = collectors[collectorCount++];
+        s.name = props[i].utf8name;
+        s.fn = props[i].method;
+        props[i].method = Instrumented;
+        props[i].data = &s;
+    }
+}
+
+static napi_value TimingObject(napi_env env, const Histogram& h) {
+    napi_value obj, v;
+    napi_create_object(env, &obj);
+    napi_create_double(env, h.Percentile(0.5) / 1e6, &v); napi_set_named_property(env, obj, "p50", v);
+    napi_create_double(env, h.Percentile(0.99) / 1e6, &v); napi_set_named_property(env, obj, "p99", v);
+    napi_create_double(env, h.max / 1e6, &v); napi_set_named_property(env, obj, "max", v);
+    napi_create_double(env, h.count ? h.sum / h.count / 1e6 : 0, &v); napi_set_named_property(env, obj, "mean", v);
+    return obj;
+}
+
+// Previous getSelfStats() call, for rates
+static ULONGLONG lastWallMs = 0, lastProcCpu = 0, lastNativeNs = 0;
+
+// getSelfStats(reset?) - per-export latency (ms) and the addon's own cost
+napi_value GetSelfStats(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    bool reset = false;
+    if (argc > 0) napi_get_value_bool(env, argv[0], &reset);
+
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    napi_create_array(env, &list);
+
+    uint32_t idx = 0;
+    for (int i = 0; i < collectorCount; i++) {
+        CollectorStats& s = collectors[i];
+        if (!s.calls && !s.skipped) continue;
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, s.name, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "name", v);
+        napi_create_double(env, (double)s.calls, &v); napi_set_named_property(env, item, "calls", v);
+        napi_create_double(env, (double)s.skipped, &v); napi_set_named_property(env, item, "skipped", v);
+        napi_set_named_property(env, item, "total", TimingObject(env, s.total));
+        napi_set_named_property(env, item, "query", TimingObject(env, s.query));
+        napi_set_named_property(env, item, "marshal", TimingObject(env, s.marshal));
+        napi_value bytes;
+        napi_create_object(env, &bytes);
+        napi_create_double(env, (double)s.bytes.Percentile(0.5), &v); napi_set_named_property(env, bytes, "p50", v);
+        napi_create_double(env, (double)s.bytes.Percentile(0.99), &v); napi_set_named_property(env, bytes, "p99", v);
+        napi_create_double(env, (double)s.bytes.max, &v); napi_set_named_property(env, bytes, "max", v);
+        napi_set_named_property(env, item, "bytes", bytes);
+        napi_set_element(env, list, idx++, item);
+
+        if (reset) {
+            s.total.Reset(); s.query.Reset(); s.marshal.Reset(); s.bytes.Reset();
+            s.calls = s.skipped = 0;
+        }
+    }
+    napi_set_named_property(env, result, "collectors", list);
+
+    // Own process cost since the previous call
+    ULONGLONG wallMs = GetTickCount64();
+    FILETIME createTime, exitTime, kernelTime, userTime;
+    ULONGLONG procCpu = 0;
+    if (GetProcessTimes(GetCurrentProcess(), &createTime, &exitTime, &kernelTime, &userTime)) {
+        procCpu = (((ULONGLONG)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime) +
+                  (((ULONGLONG)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime);
+    }
+    SYSTEM_INFO si; GetNativeSystemInfo(&si);
+    double cpuPercent = 0, nativePercent = 0;
+    if (lastWallMs && wallMs > lastWallMs) {
+        double wall100ns = (wallMs - lastWallMs) * 10000.0;
+        cpuPercent = (procCpu - lastProcCpu) / (wall100ns * si.dwNumberOfProcessors) * 100.0;
+        // Share of one core (the JS thread) spent inside native exports
+        nativePercent = (nativeNs - lastNativeNs) / ((wallMs - lastWallMs) * 1e6) * 100.0;
+    }
+    lastWallMs = wallMs;
+    lastProcCpu = procCpu;
+    lastNativeNs = nativeNs;
+
+    napi_value proc;
+    napi_create_object(env, &proc);
+    napi_create_double(env, cpuPercent, &v); napi_set_named_property(env, proc, "cpuPercent", v);
+    napi_create_double(env, procCpu / 10000.0, &v); napi_set_named_property(env, proc, "cpuTime", v);
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
+        napi_create_double(env, (double)pmc.WorkingSetSize, &v); napi_set_named_property(env, proc, "rss", v);
+        napi_create_double(env, (double)pmc.PrivateUsage, &v); napi_set_named_property(env, proc, "privateBytes", v);
+    }
+    napi_set_named_property(env, result, "process", proc);
+
+    napi_create_double(env, nativeNs / 1e6, &v); napi_set_named_property(env, result, "nativeTime", v);
+    napi_create_double(env, nativePercent, &v); napi_set_named_property(env, result, "nativePercent", v);
+    return result;
+}
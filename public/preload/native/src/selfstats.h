@@ -0,0 +1,23 @@
+#ifndef SELFSTATS_H
+#define SELFSTATS_H
+
+#include <node_api.h>
+#include <stddef.h>
+
+// Self-instrumentation of the native exports.
+// SelfStatsInstrument() wraps every method in the export table so each call
+// is timed (QueryPerformanceCounter) into per-export log-linear histograms.
+void SelfStatsInstrument(napi_property_descriptor* props, size_t count);
+
+// Brackets an OS query inside an export. Time between Begin and End counts
+// as query time, the rest of the call as marshaling. `bytes` is the size of
+// the raw data the OS handed back. Exports that never call these are
+// recorded as query time only. No-ops outside an instrumented call.
+void SelfStatsQueryBegin();
+void SelfStatsQueryEnd(size_t bytes = 0);
+// Marks the current call as answered from cache (counted, not timed)
+void SelfStatsSkip();
+
+napi_value GetSelfStats(napi_env env, napi_callback_info info);
+
+#endif // SELFSTATS_H
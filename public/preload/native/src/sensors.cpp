@@ -0,0 +1,213 @@
+#include "sensors.h"
+#include "snapshot.h"
+#include "arena.h"
+#include "selfstats.h"
+#include <windows.h>
+#include <pdh.h>
+#include <math.h>
+#include <string.h>
+#include <wchar.h>
+#include <stdlib.h>
+#include <vector>
+
+struct CoreSample { DWORD group, number; double nominal, perf; };
+struct ZoneSample { char name[64]; double tempC, passiveLimit, throttleReasons; };
+
+static PDH_HQUERY sensorQuery = NULL;
+static bool sensorInit = false;
+// _Total instances
+static PDH_HCOUNTER freqCounter = NULL, perfCounter = NULL, limitCounter = NULL, flagsCounter = NULL;
+// Wildcard instances
+static PDH_HCOUNTER coreFreqCounter = NULL, corePerfCounter = NULL;
+static PDH_HCOUNTER zoneTempCounter = NULL, zonePassiveCounter = NULL, zoneReasonsCounter = NULL;
+
+static ReusableBuffer arrayBuffer("sensorArrays");
+static std::vector<CoreSample> cores;
+static std::vector<ZoneSample> zones;
+
+static double baseMHz = 0, perfPercent = 0, perfLimit = 100, limitFlags = 0;
+static bool sampled = false;
+
+static void AddCounter(const wchar_t* path, PDH_HCOUNTER* c) {
+    if (PdhAddEnglishCounterW(sensorQuery, path, 0, c) != ERROR_SUCCESS) *c = NULL;
+}
+
+static bool ReadValue(PDH_HCOUNTER c, double& out) {
+    PDH_FMT_COUNTERVALUE value;
+    // % Processor Performance goes above 100 while boosting
+    if (!c || PdhGetFormattedCounterValue(c, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, NULL, &value) != ERROR_SUCCESS) return false;
+    out = value.doubleValue;
+    return true;
+}
+
+// Formats a wildcard counter into arrayBuffer; returns the item count (0 on failure)
+static DWORD ReadArray(PDH_HCOUNTER c, PDH_FMT_COUNTERVALUE_ITEM_W*& items) {
+    if (!c) return 0;
+    DWORD size = (DWORD)arrayBuffer.Size(), count = 0;
+    PDH_STATUS st = PdhGetFormattedCounterArrayW(c, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &size, &count,
+                                                 (PDH_FMT_COUNTERVALUE_ITEM_W*)arrayBuffer.Data());
+    if (st == PDH_MORE_DATA) {
+        if (!arrayBuffer.Reserve(size)) return 0;
+        size = (DWORD)arrayBuffer.Size();
+        st = PdhGetFormattedCounterArrayW(c, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &size, &count,
+                                          (PDH_FMT_COUNTERVALUE_ITEM_W*)arrayBuffer.Data());
+    }
+    if (st != ERROR_SUCCESS) return 0;
+    items = (PDH_FMT_COUNTERVALUE_ITEM_W*)arrayBuffer.Data();
+    return count;
+}
+
+// "0,3" -> group 0, number 3; rejects "_Total" and "0,_Total"
+static bool ParseCoreInstance(const wchar_t* name, DWORD& group, DWORD& number) {
+    const wchar_t* comma = wcschr(name, L',');
+    if (!comma || name[0] == L'_' || comma[1] == L'_') return false;
+    group = wcstoul(name, nullptr, 10);
+    number = wcstoul(comma + 1, nullptr, 10);
+    return true;
+}
+
+static CoreSample* FindCore(DWORD group, DWORD number) {
+    for (auto& c : cores) if (c.group == group && c.number == number) return &c;
+    return nullptr;
+}
+
+static ZoneSample* FindZone(const wchar_t* name) {
+    char utf8[64];
+    WideCharToMultiByte(CP_UTF8, 0, name, -1, utf8, sizeof(utf8), nullptr, nullptr);
+    utf8[sizeof(utf8) - 1] = 0;
+    for (auto& z : zones) if (strcmp(z.name, utf8) == 0) return &z;
+    return nullptr;
+}
+
+bool SensorsSample() {
+    if (!sensorInit) {
+        if (PdhOpenQuery(NULL, 0, &sensorQuery) == ERROR_SUCCESS) {
+            AddCounter(L"\\Processor Information(_Total)\\Processor Frequency", &freqCounter);
+            AddCounter(L"\\Processor Information(_Total)\\% Processor Performance", &perfCounter);
+            AddCounter(L"\\Processor Information(_Total)\\% Performance Limit", &limitCounter);
+            AddCounter(L"\\Processor Information(_Total)\\Performance Limit Flags", &flagsCounter);
+            AddCounter(L"\\Processor Information(*)\\Processor Frequency", &coreFreqCounter);
+            AddCounter(L"\\Processor Information(*)\\% Processor Performance", &corePerfCounter);
+            // Thermal zones report Kelvin; present on most ACPI systems without admin rights
+            AddCounter(L"\\Thermal Zone Information(*)\\Temperature", &zoneTempCounter);
+            AddCounter(L"\\Thermal Zone Information(*)\\% Passive Limit", &zonePassiveCounter);
+            AddCounter(L"\\Thermal Zone Information(*)\\Throttle Reasons", &zoneReasonsCounter);
+            PdhCollectQueryData(sensorQuery); // First call to initialize rate counters
+        } else {
+            sensorQuery = NULL;
+        }
+        sensorInit = true;
+    }
+    if (!sensorQuery) return false;
+
+    SelfStatsQueryBegin();
+    bool ok = PdhCollectQueryData(sensorQuery) == ERROR_SUCCESS;
+    size_t bytes = 0;
+    if (ok) {
+        ReadValue(freqCounter, baseMHz);
+        ReadValue(perfCounter, perfPercent);
+        ReadValue(limitCounter, perfLimit);
+        ReadValue(flagsCounter, limitFlags);
+
+        PDH_FMT_COUNTERVALUE_ITEM_W* items = nullptr;
+        cores.clear();
+        DWORD n = ReadArray(corePerfCounter, items);
+        for (DWORD i = 0; i < n; i++) {
+            CoreSample c = { 0, 0, 0, items[i].FmtValue.doubleValue };
+            if (ParseCoreInstance(items[i].szName, c.group, c.number)) cores.push_back(c);
+        }
+        bytes += n * sizeof(*items);
+        n = ReadArray(coreFreqCounter, items);
+        for (DWORD i = 0; i < n; i++) {
+            DWORD group, number;
+            if (!ParseCoreInstance(items[i].szName, group, number)) continue;
+            if (CoreSample* c = FindCore(group, number)) c->nominal = items[i].FmtValue.doubleValue;
+        }
+        bytes += n * sizeof(*items);
+
+        zones.clear();
+        n = ReadArray(zoneTempCounter, items);
+        for (DWORD i = 0; i < n; i++) {
+            ZoneSample z = { {0}, items[i].FmtValue.doubleValue - 273.15, 100, 0 };
+            WideCharToMultiByte(CP_UTF8, 0, items[i].szName, -1, z.name, sizeof(z.name), nullptr, nullptr);
+            z.name[sizeof(z.name) - 1] = 0;
+            zones.push_back(z);
+        }
+        bytes += n * sizeof(*items);
+        n = ReadArray(zonePassiveCounter, items);
+        for (DWORD i = 0; i < n; i++) {
+            if (ZoneSample* z = FindZone(items[i].szName)) z->passiveLimit = items[i].FmtValue.doubleValue;
+        }
+        n = ReadArray(zoneReasonsCounter, items);
+        for (DWORD i = 0; i < n; i++) {
+            if (ZoneSample* z = FindZone(items[i].szName)) z->throttleReasons = items[i].FmtValue.doubleValue;
+        }
+        sampled = true;
+    }
+    SelfStatsQueryEnd(bytes);
+    if (!ok) return false;
+
+    double maxTemp = NAN;
+    for (auto& z : zones) if (isnan(maxTemp) || z.tempC > maxTemp) maxTemp = z.tempC;
+    snapshot.cpuTemp = maxTemp;
+    snapshot.cpuFreq = SensorsCpuMHz();
+    snapshot.cpuPerf = perfPercent;
+    snapshot.cpuPerfLimit = perfLimit;
+    SnapshotPublish(SNAP_SENSOR, GetTickCount64());
+    return true;
+}
+
+double SensorsCpuMHz() {
+    return sampled ? baseMHz * perfPercent / 100.0 : 0;
+}
+
+// getSensors() - effective CPU frequency per core, throttling and thermal zones
+napi_value GetSensors(napi_env env, napi_callback_info info) {
+    SensorsSample();
+
+    napi_value result, cpu, list, v;
+    napi_create_object(env, &result);
+    napi_create_object(env, &cpu);
+
+    bool throttled = perfLimit < 100;
+    for (auto& z : zones) if (z.throttleReasons != 0 || z.passiveLimit < 100) throttled = true;
+
+    napi_create_double(env, baseMHz, &v); napi_set_named_property(env, cpu, "baseFrequency", v);
+    napi_create_double(env, SensorsCpuMHz(), &v); napi_set_named_property(env, cpu, "frequency", v);
+    napi_create_double(env, perfPercent, &v); napi_set_named_property(env, cpu, "performance", v);
+    napi_create_double(env, perfLimit, &v); napi_set_named_property(env, cpu, "performanceLimit", v);
+    napi_create_uint32(env, (uint32_t)limitFlags, &v); napi_set_named_property(env, cpu, "limitFlags", v);
+    napi_get_boolean(env, throttled, &v); napi_set_named_property(env, cpu, "throttled", v);
+
+    napi_create_array(env, &list);
+    uint32_t idx = 0;
+    for (auto& c : cores) {
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_uint32(env, c.group, &v); napi_set_named_property(env, item, "group", v);
+        napi_create_uint32(env, c.number, &v); napi_set_named_property(env, item, "core", v);
+        napi_create_double(env, c.nominal * c.perf / 100.0, &v); napi_set_named_property(env, item, "frequency", v);
+        napi_create_double(env, c.perf, &v); napi_set_named_property(env, item, "performance", v);
+        napi_set_element(env, list, idx++, item);
+    }
+    napi_set_named_property(env, cpu, "cores", list);
+    napi_set_named_property(env, result, "cpu", cpu);
+
+    napi_create_array(env, &list);
+    idx = 0;
+    for (auto& z : zones) {
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_string_utf8(env, z.name, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "zone", v);
+        napi_create_double(env, z.tempC, &v); napi_set_named_property(env, item, "temperature", v);
+        napi_create_double(env, z.passiveLimit, &v); napi_set_named_property(env, item, "passiveLimit", v);
+        napi_create_uint32(env, (uint32_t)z.throttleReasons, &v); napi_set_named_property(env, item, "throttleReasons", v);
+        napi_set_element(env, list, idx++, item);
+    }
+    napi_set_named_property(env, result, "thermal", list);
+
+    if (isnan(snapshot.cpuTemp)) napi_get_null(env, &v);
+    else napi_create_double(env, snapshot.cpuTemp, &v);
+    napi_set_named_property(env, result, "cpuTemperature", v);
+    return result;
+}
@@ -0,0 +1,18 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <node_api.h>
+
+// CPU frequency / throttling and thermal zones via PDH.
+// Effective frequency = "Processor Frequency" x "% Processor Performance",
+// throttling from "% Performance Limit" and the thermal zone counters.
+// One PDH query is kept open; a sample is a single collection.
+
+// Takes a sample and publishes the SNAP_SENSOR snapshot section
+bool SensorsSample();
+// Effective CPU frequency of the last sample in MHz (0 until available)
+double SensorsCpuMHz();
+
+napi_value GetSensors(napi_env env, napi_callback_info info);
+
+#endif // SENSORS_H
@@ -0,0 +1,661 @@
+#include "shared.h"
+#include "snapshot.h"
+#include <windows.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+static const uint32_t SEGMENT_MAGIC = 0x4853534d;   // "MSSH"
+// Bump whenever SharedSegment changes; readers refuse other versions
+static const uint32_t SEGMENT_VERSION = 3;
+static const uint32_t MAX_DISKS = 32, MAX_NETS = 32, MAX_PROCS = 4096;
+static const uint32_t STRING_POOL = 8 << 20;   // process names and details
+static const uint32_t HISTORY_POINTS = 3600;   // an hour of 1 Hz cpu samples
+static const uint32_t MAX_RETRIES = 1000;
+static const double READER_TIMEOUT_MS = 5000;   // readers stamp the segment on every read
+static const int SECTION_COUNT = 7;
+static const char* const sectionNames[SECTION_COUNT] = {
+    "cpu", "mem", "disk", "net", "proc", "sensor", "pressure"
+};
+
+struct SharedDisk {
+    char fs[128];
+    double size, used, free, usedPercent, timeToFull;
+};
+
+struct SharedNet {
+    char name[128];
+    double rxSec, txSec, utilization;
+};
+
+// Strings are offsets into SharedSegment::strings; offset 0 is ""
+struct SharedProc {
+    uint32_t pid, handles, threads, reserved;
+    double cpu, memory, startTime;
+    uint32_t name, path, cmdline, user;
+};
+
+struct SharedPoint {
+    double time;
+    float cpu, memUsedPercent, rxSec, txSec;
+};
+
+// Fixed layout, only fixed-width fields; strings are NUL-terminated UTF-8
+struct SharedSegment {
+    uint32_t magic, version, size, ownerPid;
+    volatile LONG seq;              // odd while the publisher writes
+    uint32_t sections;              // sections published at least once
+    uint64_t publishes;
+    volatile LONG64 readerSeen;     // epoch ms of the last read; the only field readers write
+    double updated[8];              // epoch ms per section bit
+    double cpuTotal;
+    double memTotal, memUsed, memFree, memUsedPercent, memCommitted, swapUsed;
+    double cpuTemp, cpuFreq, cpuPerf, cpuPerfLimit;
+    double pageFaultsSec, hardFaultsSec, pagesSec, runQueue, diskQueue;
+    double rxSec, txSec;            // all adapters
+    uint32_t diskCount, netCount, procCount;
+    uint32_t procTotal;             // processes in the last sample, published or not
+    uint32_t stringsUsed;
+    uint32_t historyHead, historyCount, reserved;
+    SharedDisk disks[MAX_DISKS];
+    SharedNet net[MAX_NETS];
+    SharedProc procs[MAX_PROCS];
+    SharedPoint history[HISTORY_POINTS];
+    char strings[STRING_POOL];
+};
+
+enum SharedMode { MODE_OFF, MODE_AUTO, MODE_PUBLISH, MODE_ATTACH };
+enum SharedRole { ROLE_OFF, ROLE_READER, ROLE_PUBLISHER };
+static const char* const modeNames[] = { "off", "auto", "publish", "attach" };
+static const char* const roleNames[] = { "off", "reader", "publisher" };
+
+static SharedMode mode = MODE_OFF;
+static SharedRole role = ROLE_OFF;
+static std::string segmentName = "sysmon", lastError;
+static HANDLE mapping = nullptr, ownerMutex = nullptr;
+static SharedSegment* view = nullptr;
+static SharedSegment* copy = nullptr;   // reader-side consistent copy
+static bool cleanupHooked = false;
+
+static double NowEpochMs() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (double)((t - 116444736000000000ULL) / 10000);
+}
+
+static std::wstring ObjectName(const char* suffix) {
+    std::string s = "Local\\" + segmentName + suffix;
+    return std::wstring(s.begin(), s.end());   // names are restricted to ASCII
+}
+
+// Truncates at a character boundary so readers never see half a code point
+static void CopyName(char* dst, size_t cap, const char* src) {
+    size_t n = src ? strlen(src) : 0;
+    if (n >= cap) {
+        n = cap - 1;
+        while (n > 0 && ((unsigned char)src[n] & 0xC0) == 0x80) n--;
+    }
+    if (n) memcpy(dst, src, n);
+    dst[n] = 0;
+}
+
+// Appends a NUL-terminated string to the pool; false when it is full
+static bool PoolString(SharedSegment* s, uint32_t& offset, const char* src) {
+    size_t n = src ? strlen(src) : 0;
+    offset = 0;
+    if (!n) return true;
+    if (n + 1 > STRING_POOL - s->stringsUsed) return false;
+    offset = s->stringsUsed;
+    memcpy(s->strings + offset, src, n + 1);
+    s->stringsUsed += (uint32_t)n + 1;
+    return true;
+}
+
+static void Unmap() {
+    if (view) UnmapViewOfFile(view);
+    if (mapping) CloseHandle(mapping);
+    view = nullptr;
+    mapping = nullptr;
+}
+
+static void Detach() {
+    if (role == ROLE_PUBLISHER) {
+        InterlockedIncrement(&view->seq);
+        view->ownerPid = 0;
+        InterlockedIncrement(&view->seq);
+        ReleaseMutex(ownerMutex);
+    }
+    Unmap();
+    if (ownerMutex) CloseHandle(ownerMutex);
+    ownerMutex = nullptr;
+    role = ROLE_OFF;
+}
+
+static bool CheckLayout(const SharedSegment* s) {
+    if (s->version == SEGMENT_VERSION && s->size == sizeof(SharedSegment)) return true;
+    lastError = "segment has an incompatible layout (version " + std::to_string(s->version) + ")";
+    return false;
+}
+
+// Publishing rights: the owner mutex is abandoned when its holder exits
+static bool TryClaim() {
+    if (!ownerMutex) ownerMutex = CreateMutexW(nullptr, FALSE, ObjectName(".owner").c_str());
+    if (!ownerMutex) return false;
+    DWORD w = WaitForSingleObject(ownerMutex, 0);
+    return w == WAIT_OBJECT_0 || w == WAIT_ABANDONED;
+}
+
+static bool OpenPublisher() {
+    mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+        (DWORD)sizeof(SharedSegment), ObjectName(".snapshot").c_str());
+    if (mapping) view = (SharedSegment*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(SharedSegment));
+    if (!view) {
+        lastError = "cannot create the shared segment";
+        Unmap();
+        return false;
+    }
+    // A segment left by a previous publisher keeps its history
+    if (view->magic == SEGMENT_MAGIC && !CheckLayout(view)) {
+        Unmap();
+        return false;
+    }
+    // The previous owner may have died mid-write; close its write first
+    if (view->seq & 1) InterlockedIncrement(&view->seq);
+    InterlockedIncrement(&view->seq);
+    if (view->magic != SEGMENT_MAGIC) {
+        view->version = SEGMENT_VERSION;
+        view->size = (uint32_t)sizeof(SharedSegment);
+        view->magic = SEGMENT_MAGIC;
+    }
+    view->ownerPid = GetCurrentProcessId();
+    InterlockedIncrement(&view->seq);
+    role = ROLE_PUBLISHER;
+    lastError.clear();
+    return true;
+}
+
+static bool OpenReader() {
+    // Writable only so that reads can stamp readerSeen
+    mapping = OpenFileMappingW(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, ObjectName(".snapshot").c_str());
+    if (!mapping) {
+        lastError = "no publisher";
+        return false;
+    }
+    view = (SharedSegment*)MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+    if (!view || view->magic != SEGMENT_MAGIC || !CheckLayout(view)) {
+        if (!view || view->magic != SEGMENT_MAGIC) lastError = "segment not initialized";
+        Unmap();
+        return false;
+    }
+    if (!copy) copy = new SharedSegment();
+    role = ROLE_READER;
+    lastError.clear();
+    return true;
+}
+
+// Moves towards the role the mode asks for; readers in 'auto' mode take
+// over once the publisher is gone
+static void Ensure() {
+    if (mode == MODE_OFF || role == ROLE_PUBLISHER) return;
+    if (mode != MODE_ATTACH && TryClaim()) {
+        Unmap();
+        role = ROLE_OFF;
+        if (!OpenPublisher()) ReleaseMutex(ownerMutex);
+        return;
+    }
+    if (mode == MODE_PUBLISH) {
+        lastError = "another instance is publishing";
+        return;
+    }
+    if (role != ROLE_READER) OpenReader();
+}
+
+bool SharedPublishing() {
+    return role == ROLE_PUBLISHER;
+}
+
+bool SharedReadersAttached() {
+    return role == ROLE_PUBLISHER && NowEpochMs() - (double)view->readerSeen < READER_TIMEOUT_MS;
+}
+
+void SharedPublish(uint32_t section) {
+    if (role != ROLE_PUBLISHER) return;
+    SharedSegment* s = view;
+    const Snapshot& snap = snapshot;
+    double now = NowEpochMs();
+
+    InterlockedIncrement(&s->seq);
+    switch (section) {
+    case SNAP_CPU: {
+        s->cpuTotal = snap.cpuTotal;
+        SharedPoint& p = s->history[s->historyHead];
+        p.time = now;
+        p.cpu = (float)snap.cpuTotal;
+        p.memUsedPercent = (float)s->memUsedPercent;
+        p.rxSec = (float)s->rxSec;
+        p.txSec = (float)s->txSec;
+        s->historyHead = (s->historyHead + 1) % HISTORY_POINTS;
+        if (s->historyCount < HISTORY_POINTS) s->historyCount++;
+        break;
+    }
+    case SNAP_MEM:
+        s->memTotal = snap.memTotal;
+        s->memUsed = snap.memUsed;
+        s->memFree = snap.memFree;
+        s->memUsedPercent = snap.memUsedPercent;
+        s->memCommitted = snap.memCommitted;
+        s->swapUsed = snap.swapUsed;
+        break;
+    case SNAP_DISK:
+        s->diskCount = 0;
+        for (const auto& d : snap.disks) {
+            if (s->diskCount == MAX_DISKS) break;
+            SharedDisk& o = s->disks[s->diskCount++];
+            CopyName(o.fs, sizeof(o.fs), d.fs);
+            o.size = d.size;
+            o.used = d.used;
+            o.free = d.free;
+            o.usedPercent = d.usedPercent;
+            o.timeToFull = d.timeToFull;
+        }
+        break;
+    case SNAP_NET:
+        s->netCount = 0;
+        s->rxSec = s->txSec = 0;
+        for (const auto& n : snap.net) {
+            s->rxSec += n.rxSec;
+            s->txSec += n.txSec;
+            if (s->netCount == MAX_NETS) continue;
+            SharedNet& o = s->net[s->netCount++];
+            CopyName(o.name, sizeof(o.name), n.name);
+            o.rxSec = n.rxSec;
+            o.txSec = n.txSec;
+            o.utilization = n.utilization;
+        }
+        break;
+    case SNAP_PROC:
+        // Stops at the first process that doesn't fit, so readers can tell
+        // a complete list (procCount == procTotal) from a truncated one
+        s->procCount = 0;
+        s->procTotal = (uint32_t)snap.procs.size();
+        s->strings[0] = 0;
+        s->stringsUsed = 1;
+        for (const auto& p : snap.procs) {
+            if (s->procCount == MAX_PROCS) break;
+            SharedProc& o = s->procs[s->procCount];
+            uint32_t used = s->stringsUsed;
+            if (!PoolString(s, o.name, p.name) || !PoolString(s, o.path, p.path) ||
+                !PoolString(s, o.cmdline, p.cmdline) || !PoolString(s, o.user, p.user)) {
+                s->stringsUsed = used;
+                break;
+            }
+            o.pid = p.pid;
+            o.handles = p.handles;
+            o.threads = p.threads;
+            o.cpu = p.cpu;
+            o.memory = p.memory;
+            o.startTime = p.startTime;
+            s->procCount++;
+        }
+        break;
+    case SNAP_SENSOR:
+        s->cpuTemp = snap.cpuTemp;
+        s->cpuFreq = snap.cpuFreq;
+        s->cpuPerf = snap.cpuPerf;
+        s->cpuPerfLimit = snap.cpuPerfLimit;
+        break;
+    case SNAP_PRESSURE:
+        s->pageFaultsSec = snap.pageFaultsSec;
+        s->hardFaultsSec = snap.hardFaultsSec;
+        s->pagesSec = snap.pagesSec;
+        s->runQueue = snap.runQueue;
+        s->diskQueue = snap.diskQueue;
+        break;
+    }
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        if (section & (1u << i)) s->updated[i] = now;
+    }
+    s->sections |= section;
+    s->publishes++;
+    InterlockedIncrement(&s->seq);
+}
+
+// Seqlock read: copies the header and the used part of each table (the
+// last `points` history samples, oldest first), retrying while the
+// publisher is mid-write or moved on during the copy
+static bool ReadConsistent(bool procs, uint32_t points, uint32_t& retries) {
+    const SharedSegment* s = view;
+    for (retries = 0; retries < MAX_RETRIES; retries++) {
+        LONG seq = s->seq;
+        if (seq & 1) {
+            if (retries > 64) Sleep(0);
+            else YieldProcessor();
+            continue;
+        }
+        MemoryBarrier();
+        memcpy((void*)copy, (const void*)s, offsetof(SharedSegment, disks));
+        uint32_t disks = copy->diskCount < MAX_DISKS ? copy->diskCount : MAX_DISKS;
+        uint32_t nets = copy->netCount < MAX_NETS ? copy->netCount : MAX_NETS;
+        uint32_t procCount = procs ? (copy->procCount < MAX_PROCS ? copy->procCount : MAX_PROCS) : 0;
+        memcpy(copy->disks, s->disks, disks * sizeof(SharedDisk));
+        memcpy(copy->net, s->net, nets * sizeof(SharedNet));
+        memcpy(copy->procs, s->procs, procCount * sizeof(SharedProc));
+        uint32_t used = procs ? (copy->stringsUsed < STRING_POOL ? copy->stringsUsed : STRING_POOL) : 0;
+        memcpy(copy->strings, s->strings, used);
+        uint32_t n = points < copy->historyCount ? points : copy->historyCount;
+        uint32_t head = copy->historyHead % HISTORY_POINTS;
+        uint32_t start = (head + HISTORY_POINTS - n) % HISTORY_POINTS;
+        uint32_t first = HISTORY_POINTS - start < n ? HISTORY_POINTS - start : n;
+        memcpy(copy->history, s->history + start, first * sizeof(SharedPoint));
+        memcpy(copy->history + first, s->history, (n - first) * sizeof(SharedPoint));
+        MemoryBarrier();
+        if (s->seq == seq) {
+            copy->diskCount = disks;
+            copy->netCount = nets;
+            copy->procCount = procCount;
+            copy->stringsUsed = used;
+            copy->historyCount = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ProcessAlive(uint32_t pid) {
+    if (!pid) return false;
+    HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if (!h) return false;
+    bool alive = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+    CloseHandle(h);
+    return alive;
+}
+
+static void CleanupShared(void*) {
+    std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+    Detach();
+    mode = MODE_OFF;
+    delete copy;
+    copy = nullptr;
+}
+
+static napi_value Status(napi_env env) {
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, modeNames[mode], NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "mode", v);
+    napi_create_string_utf8(env, roleNames[role], NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "role", v);
+    napi_create_string_utf8(env, segmentName.c_str(), segmentName.size(), &v); napi_set_named_property(env, result, "name", v);
+    napi_create_uint32(env, SEGMENT_VERSION, &v); napi_set_named_property(env, result, "version", v);
+    napi_create_uint32(env, (uint32_t)sizeof(SharedSegment), &v); napi_set_named_property(env, result, "size", v);
+    napi_create_uint32(env, view ? view->ownerPid : 0, &v); napi_set_named_property(env, result, "ownerPid", v);
+    napi_create_double(env, view ? (double)view->publishes : 0, &v); napi_set_named_property(env, result, "publishes", v);
+    napi_create_double(env, view ? (double)view->readerSeen : 0, &v); napi_set_named_property(env, result, "readerSeen", v);
+    if (lastError.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, lastError.c_str(), lastError.size(), &v);
+    napi_set_named_property(env, result, "error", v);
+    return result;
+}
+
+static std::string GetStringOption(napi_env env, napi_value opts, const char* name) {
+    bool has = false;
+    napi_value v;
+    size_t len = 0;
+    if (napi_has_named_property(env, opts, name, &has) != napi_ok || !has) return "";
+    napi_get_named_property(env, opts, name, &v);
+    if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) != napi_ok) return "";
+    std::string s(len, 0);
+    napi_get_value_string_utf8(env, v, &s[0], len + 1, &len);
+    return s;
+}
+
+static bool ValidName(const std::string& name) {
+    if (name.empty() || name.size() > 64) return false;
+    for (char c : name) {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '.' || c == '_' || c == '-';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+napi_value SetSharedSnapshot(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type != napi_object) {
+        Ensure();
+        return Status(env);
+    }
+
+    std::string newMode = GetStringOption(env, argv[0], "mode");
+    std::string newName = GetStringOption(env, argv[0], "name");
+    if (newName.empty()) newName = segmentName;
+    SharedMode m = MODE_AUTO;
+    if (newMode == "off") m = MODE_OFF;
+    else if (newMode == "publish") m = MODE_PUBLISH;
+    else if (newMode == "attach") m = MODE_ATTACH;
+    else if (!newMode.empty() && newMode != "auto") {
+        lastError = "unknown mode: " + newMode;
+        return Status(env);
+    }
+    if (!ValidName(newName)) {
+        lastError = "invalid name (use letters, digits, '.', '_', '-')";
+        return Status(env);
+    }
+
+    Detach();
+    lastError.clear();
+    mode = m;
+    segmentName = newName;
+    Ensure();
+    if (mode != MODE_OFF && !cleanupHooked) {
+        napi_add_env_cleanup_hook(env, CleanupShared, nullptr);
+        cleanupHooked = true;
+    }
+    return Status(env);
+}
+
+static void SetDouble(napi_env env, napi_value obj, const char* key, double value) {
+    napi_value v;
+    if (isnan(value)) napi_get_null(env, &v);
+    else napi_create_double(env, value, &v);
+    napi_set_named_property(env, obj, key, v);
+}
+
+static void SetString(napi_env env, napi_value obj, const char* key, const char* s, size_t cap) {
+    napi_value v;
+    napi_create_string_utf8(env, s, strnlen(s, cap), &v);
+    napi_set_named_property(env, obj, key, v);
+}
+
+// Reader side: offsets come from another process, so they are checked
+// against the copied part of the pool
+static const char* PoolAt(const SharedSegment* s, uint32_t offset, size_t& cap) {
+    if (offset >= s->stringsUsed) offset = 0;
+    cap = s->stringsUsed > offset ? s->stringsUsed - offset : 0;
+    return s->strings + offset;
+}
+
+// null for an empty string, like the local collector's details
+static void SetPoolString(napi_env env, napi_value obj, const char* key, const SharedSegment* s, uint32_t offset) {
+    size_t cap;
+    const char* str = PoolAt(s, offset, cap);
+    napi_value v;
+    if (!cap || !str[0]) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, str, strnlen(str, cap), &v);
+    napi_set_named_property(env, obj, key, v);
+}
+
+static napi_value HistoryColumn(napi_env env, const SharedSegment* s, int column) {
+    void* data = nullptr;
+    napi_value buffer, array;
+    napi_create_arraybuffer(env, s->historyCount * sizeof(double), &data, &buffer);
+    double* d = (double*)data;
+    for (uint32_t i = 0; i < s->historyCount; i++) {
+        const SharedPoint& p = s->history[i];
+        d[i] = column == 0 ? p.time : column == 1 ? p.cpu : column == 2 ? p.memUsedPercent :
+            column == 3 ? p.rxSec : p.txSec;
+    }
+    napi_create_typedarray(env, napi_float64_array, s->historyCount, buffer, 0, &array);
+    return array;
+}
+
+napi_value GetSharedSnapshot(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    bool withProcs = true;
+    uint32_t points = 0;
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) {
+        bool has = false;
+        napi_value v;
+        if (napi_has_named_property(env, argv[0], "procs", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "procs", &v);
+            napi_get_value_bool(env, v, &withProcs);
+        }
+        if (napi_has_named_property(env, argv[0], "history", &has) == napi_ok && has) {
+            napi_get_named_property(env, argv[0], "history", &v);
+            napi_get_value_uint32(env, v, &points);
+        }
+    }
+
+    Ensure();
+    // Keeps the publisher's pump running while somebody reads
+    if (role == ROLE_READER) InterlockedExchange64(&view->readerSeen, (LONG64)NowEpochMs());
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, roleNames[role], NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, result, "role", v);
+
+    // The publisher reads its own segment through the same path
+    uint32_t retries = 0;
+    if (role != ROLE_OFF && !copy) copy = new SharedSegment();
+    bool found = role != ROLE_OFF && ReadConsistent(withProcs, points, retries);
+    napi_get_boolean(env, found, &v); napi_set_named_property(env, result, "found", v);
+    napi_create_uint32(env, retries, &v); napi_set_named_property(env, result, "retries", v);
+    if (!found) {
+        std::string error = role != ROLE_OFF ? "segment busy, retry" : lastError;
+        if (error.empty()) napi_get_null(env, &v);
+        else napi_create_string_utf8(env, error.c_str(), error.size(), &v);
+        napi_set_named_property(env, result, "error", v);
+        return result;
+    }
+
+    const SharedSegment* s = copy;
+    double now = NowEpochMs(), updated = 0;
+    napi_create_uint32(env, s->ownerPid, &v); napi_set_named_property(env, result, "ownerPid", v);
+    napi_get_boolean(env, role == ROLE_PUBLISHER || ProcessAlive(s->ownerPid), &v);
+    napi_set_named_property(env, result, "ownerAlive", v);
+    napi_value ages;
+    napi_create_object(env, &ages);
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        if (!(s->sections & (1u << i))) continue;
+        if (s->updated[i] > updated) updated = s->updated[i];
+        napi_create_double(env, now - s->updated[i], &v); napi_set_named_property(env, ages, sectionNames[i], v);
+    }
+    napi_set_named_property(env, result, "ages", ages);
+    napi_create_double(env, updated, &v); napi_set_named_property(env, result, "updated", v);
+    napi_create_double(env, updated ? now - updated : 0, &v); napi_set_named_property(env, result, "age", v);
+
+    napi_value cpu, mem, sensors, pressure, list;
+    napi_create_object(env, &cpu);
+    SetDouble(env, cpu, "total", s->cpuTotal);
+    napi_set_named_property(env, result, "cpu", cpu);
+
+    napi_create_object(env, &mem);
+    SetDouble(env, mem, "total", s->memTotal);
+    SetDouble(env, mem, "used", s->memUsed);
+    SetDouble(env, mem, "free", s->memFree);
+    SetDouble(env, mem, "usedPercent", s->memUsedPercent);
+    SetDouble(env, mem, "committed", s->memCommitted);
+    SetDouble(env, mem, "swapUsed", s->swapUsed);
+    napi_set_named_property(env, result, "mem", mem);
+
+    napi_create_object(env, &sensors);
+    SetDouble(env, sensors, "cpuTemp", s->cpuTemp);
+    SetDouble(env, sensors, "cpuFreq", s->cpuFreq);
+    SetDouble(env, sensors, "cpuPerf", s->cpuPerf);
+    SetDouble(env, sensors, "cpuPerfLimit", s->cpuPerfLimit);
+    napi_set_named_property(env, result, "sensors", sensors);
+
+    napi_create_object(env, &pressure);
+    SetDouble(env, pressure, "pageFaultsSec", s->pageFaultsSec);
+    SetDouble(env, pressure, "hardFaultsSec", s->hardFaultsSec);
+    SetDouble(env, pressure, "pagesSec", s->pagesSec);
+    SetDouble(env, pressure, "runQueue", s->runQueue);
+    SetDouble(env, pressure, "diskQueue", s->diskQueue);
+    napi_set_named_property(env, result, "pressure", pressure);
+
+    napi_create_array_with_length(env, s->diskCount, &list);
+    for (uint32_t i = 0; i < s->diskCount; i++) {
+        const SharedDisk& d = s->disks[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        SetString(env, item, "fs", d.fs, sizeof(d.fs));
+        SetDouble(env, item, "size", d.size);
+        SetDouble(env, item, "used", d.used);
+        SetDouble(env, item, "free", d.free);
+        SetDouble(env, item, "usedPercent", d.usedPercent);
+        SetDouble(env, item, "timeToFull", d.timeToFull);
+        napi_set_element(env, list, i, item);
+    }
+    napi_set_named_property(env, result, "disks", list);
+
+    napi_create_array_with_length(env, s->netCount, &list);
+    for (uint32_t i = 0; i < s->netCount; i++) {
+        const SharedNet& n = s->net[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        SetString(env, item, "name", n.name, sizeof(n.name));
+        SetDouble(env, item, "rxSec", n.rxSec);
+        SetDouble(env, item, "txSec", n.txSec);
+        SetDouble(env, item, "utilization", n.utilization);
+        napi_set_element(env, list, i, item);
+    }
+    napi_set_named_property(env, result, "net", list);
+
+    napi_create_array_with_length(env, s->procCount, &list);
+    for (uint32_t i = 0; i < s->procCount; i++) {
+        const SharedProc& p = s->procs[i];
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_uint32(env, p.pid, &v); napi_set_named_property(env, item, "pid", v);
+        size_t cap;
+        const char* name = PoolAt(s, p.name, cap);
+        napi_create_string_utf8(env, name, strnlen(name, cap), &v); napi_set_named_property(env, item, "name", v);
+        SetDouble(env, item, "cpu", p.cpu);
+        SetDouble(env, item, "memory", p.memory);
+        napi_create_uint32(env, p.handles, &v); napi_set_named_property(env, item, "handles", v);
+        napi_create_uint32(env, p.threads, &v); napi_set_named_property(env, item, "threads", v);
+        // Same shape as the local collector's details
+        napi_value details;
+        napi_create_object(env, &details);
+        SetPoolString(env, details, "path", s, p.path);
+        SetPoolString(env, details, "cmdline", s, p.cmdline);
+        SetPoolString(env, details, "user", s, p.user);
+        if (p.startTime) napi_create_double(env, p.startTime, &v);
+        else napi_get_null(env, &v);
+        napi_set_named_property(env, details, "startTime", v);
+        napi_set_named_property(env, item, "details", details);
+        napi_set_element(env, list, i, item);
+    }
+    napi_set_named_property(env, result, "procs", list);
+    napi_create_uint32(env, s->procTotal, &v); napi_set_named_property(env, result, "procTotal", v);
+
+    if (points > 0) {
+        napi_value history;
+        napi_create_object(env, &history);
+        napi_set_named_property(env, history, "times", HistoryColumn(env, s, 0));
+        napi_set_named_property(env, history, "cpu", HistoryColumn(env, s, 1));
+        napi_set_named_property(env, history, "memUsedPercent", HistoryColumn(env, s, 2));
+        napi_set_named_property(env, history, "rxSec", HistoryColumn(env, s, 3));
+        napi_set_named_property(env, history, "txSec", HistoryColumn(env, s, 4));
+        napi_set_named_property(env, result, "history", history);
+    }
+    return result;
+}
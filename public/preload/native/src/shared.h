@@ -0,0 +1,44 @@
+#ifndef SHARED_H
+#define SHARED_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Shared snapshot segment, so that several windows or processes loading
+// the addon don't each run the collectors. One instance (the publisher)
+// copies every published `snapshot` section, plus a ring of recent host
+// samples, into a named file mapping (Local\<name>.snapshot) with a
+// versioned fixed layout. Writes are bracketed by a sequence counter
+// (odd while writing), so readers copy what they need lock-free and retry
+// on a torn read. Publishing rights are a named mutex: when the publisher
+// exits, the mutex is abandoned and an 'auto' reader takes over on its
+// next read, keeping the segment and its history. Every reader read
+// stamps readerSeen; the publisher's background pump only keeps sections
+// fresh while a reader stamped it in the last 5 s.
+//
+// setSharedSnapshot({ mode: 'auto' | 'publish' | 'attach' | 'off', name })
+//   -> { mode, role: 'publisher' | 'reader' | 'off', name, version, size,
+//        ownerPid, publishes, readerSeen, error }
+// 'auto' publishes unless another live instance already does, 'attach'
+// never publishes. setSharedSnapshot() returns the status.
+napi_value SetSharedSnapshot(napi_env env, napi_callback_info info);
+
+// getSharedSnapshot({ history: n, procs: true })
+//   -> { found, role, ownerPid, ownerAlive, updated, age, ages, retries,
+//        cpu, mem, sensors, pressure, disks, net, procs, procTotal,
+//        history: { times, cpu, memUsedPercent, rxSec, txSec } }
+// updated/age: epoch ms and ms since the last publish of any section;
+// ages: ms per section. procs carry the same `details` as getProcessList;
+// fewer procs than procTotal means the publisher ran out of room (4096
+// processes or 8 MB of strings). history holds the last n host samples (one per
+// cpu sample, Float64Arrays) and is omitted unless n > 0.
+napi_value GetSharedSnapshot(napi_env env, napi_callback_info info);
+
+// Called from SnapshotPublish after a collector updated `snapshot`
+void SharedPublish(uint32_t section);
+// Whether this instance publishes (collectors must publish every section)
+bool SharedPublishing();
+// Whether this instance publishes and a reader read the segment recently
+bool SharedReadersAttached();
+
+#endif // SHARED_H
@@ -0,0 +1,96 @@
+#include "snapshot.h"
+#include "alerts.h"
+#include "stream.h"
+#include "history.h"
+#include "shared.h"
+#include "energy.h"
+#include <windows.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Latest values published by the collectors (read by the subscribers below)
+Snapshot snapshot;
+std::recursive_mutex snapshotLock;
+static ScratchArena diskStrings("snapshotDisks"), netStrings("snapshotNet"), procStrings("snapshotProcs");
+
+static const uint32_t PUMP_INTERVAL_MS = 1000;
+static const uint64_t PUMP_STALE_MS = 2000;
+
+static uint64_t lastPublished[SNAP_SECTION_COUNT];
+
+static SnapshotSampler pumpSamplers[SNAP_SECTION_COUNT];
+static std::thread pumpThread;
+static std::mutex pumpLock;
+static std::condition_variable pumpWake;
+static bool stopping = false;
+
+ScratchArena& SnapshotStrings(uint32_t section) {
+    if (section & SNAP_DISK) return diskStrings;
+    if (section & SNAP_NET) return netStrings;
+    return procStrings;
+}
+
+void SnapshotPublish(uint32_t section, uint64_t nowMs) {
+    for (int i = 0; i < SNAP_SECTION_COUNT; i++) {
+        if (section & (1u << i)) lastPublished[i] = nowMs;
+    }
+    StreamPublish(section, nowMs);
+    HistoryRecord(section, nowMs);
+    SharedPublish(section);
+    AlertsEvaluate(section, nowMs);
+}
+
+bool SnapshotNeeded(uint32_t section) {
+    return AlertsNeed(section) || StreamActive() || HistoryNeed(section) || SharedPublishing() ||
+           EnergyNeed(section);
+}
+
+// ---- Background pump ----
+
+// History and energy attribution only record what gets collected anyway,
+// so they don't keep collectors running on their own; neither does an
+// unread shared segment
+static bool PumpNeeded(uint32_t section) {
+    return AlertsNeed(section) || StreamActive() || SharedReadersAttached();
+}
+
+// Pump thread, with snapshotLock held
+static void RunPump() {
+    uint64_t now = GetTickCount64();
+    for (int i = 0; i < SNAP_SECTION_COUNT; i++) {
+        if (!pumpSamplers[i] || !PumpNeeded(1u << i) || now - lastPublished[i] < PUMP_STALE_MS) continue;
+        pumpSamplers[i]();
+        // Don't retry a collector that didn't publish every tick
+        if (now - lastPublished[i] >= PUMP_STALE_MS) lastPublished[i] = now;
+    }
+}
+
+static void CleanupPump(void*) {
+    {
+        std::lock_guard<std::mutex> lock(pumpLock);
+        stopping = true;
+    }
+    pumpWake.notify_all();
+    if (pumpThread.joinable()) pumpThread.join();
+}
+
+void SnapshotPumpAttach(napi_env env, const SnapshotSampler samplers[SNAP_SECTION_COUNT]) {
+    if (pumpThread.joinable()) return;
+    for (int i = 0; i < SNAP_SECTION_COUNT; i++) pumpSamplers[i] = samplers[i];
+    // Hooks run in reverse order: this one goes before the collectors' hooks
+    // registered in Init; subscribers hooked later take snapshotLock instead
+    napi_add_env_cleanup_hook(env, CleanupPump, nullptr);
+    pumpThread = std::thread([] {
+        std::unique_lock<std::mutex> lock(pumpLock);
+        while (!pumpWake.wait_for(lock, std::chrono::milliseconds(PUMP_INTERVAL_MS), [] { return stopping; })) {
+            lock.unlock();
+            {
+                std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+                RunPump();
+            }
+            lock.lock();
+        }
+    });
+}
@@ -0,0 +1,98 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "arena.h"
+#include <node_api.h>
+#include <math.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+// Latest parsed values of each collector, published natively so that
+// consumers (alert rules, ...) don't depend on what JS keeps around.
+// Name pointers live in the section's SnapshotStrings() arena, so they stay
+// valid until the section is published again even if its collector has run
+// (and reused its own storage) in between.
+struct DiskSnapshot {
+    const char* fs;             // "C:" or a mounted folder path (UTF-8)
+    double size, used, free, usedPercent;
+    double timeToFull;          // seconds; NAN while not filling
+};
+
+struct NetSnapshot {
+    const char* name;           // friendly name (UTF-8)
+    double rxSec, txSec, utilization;
+};
+
+struct ProcSnapshot {
+    uint32_t pid;
+    const char* name;           // UTF-8
+    double cpu, memory;
+    uint32_t handles, threads;
+    // From the process details cache (procdetails.h), copied like the name;
+    // empty when unknown, nullptr in snapshots not built by the collector
+    const char* user = nullptr;
+    const char* path = nullptr;
+    const char* cmdline = nullptr;
+    double startTime = 0;       // epoch ms; 0 if unknown
+};
+
+struct Snapshot {
+    double cpuTotal = 0;
+    double memTotal = 0, memUsed = 0, memFree = 0, memUsedPercent = 0;
+    double memCommitted = 0, swapUsed = 0;
+    // Sensors; cpuTemp is NAN when no thermal zone is exposed
+    double cpuTemp = NAN, cpuFreq = 0, cpuPerf = 0, cpuPerfLimit = 100;
+    // Contention rates over the pressure collector's window
+    double pageFaultsSec = 0, hardFaultsSec = 0, pagesSec = 0, runQueue = 0, diskQueue = 0;
+    std::vector<DiskSnapshot> disks;
+    std::vector<NetSnapshot> net;
+    std::vector<ProcSnapshot> procs;
+};
+
+// Section bits, also used as rule dependency masks
+enum SnapshotSection {
+    SNAP_CPU  = 1 << 0,
+    SNAP_MEM  = 1 << 1,
+    SNAP_DISK = 1 << 2,
+    SNAP_NET  = 1 << 3,
+    SNAP_PROC = 1 << 4,
+    SNAP_SENSOR = 1 << 5,
+    SNAP_PRESSURE = 1 << 6
+};
+static const int SNAP_SECTION_COUNT = 7;
+
+extern Snapshot snapshot;
+// Serializes collector and subscriber state (and `snapshot`) between the JS
+// thread and the pump thread. Every instrumented export call holds it
+// (selfstats.cpp), as do the JS-thread callbacks and cleanup hooks outside
+// the exports that touch such state. Recursive, since those can nest.
+extern std::recursive_mutex snapshotLock;
+
+// Storage for the name strings of a section (SNAP_DISK, SNAP_NET or
+// SNAP_PROC). A publishing collector resets it together with clearing its
+// vector and copies every name in with Copy().
+ScratchArena& SnapshotStrings(uint32_t section);
+
+// Called by collectors after updating `snapshot` (section = SnapshotSection
+// bit). Fans the section out to its subscribers: the metrics stream
+// (stream.h), history (history.h), the shared segment (shared.h) and the
+// alert rules (alerts.h).
+void SnapshotPublish(uint32_t section, uint64_t nowMs);
+// Whether any subscriber (or process energy attribution) reads the section
+// (lets collectors skip publishing)
+bool SnapshotNeeded(uint32_t section);
+
+// Takes a sample of a collector without building its JS value and publishes
+// the section; callable from any thread while snapshotLock is held
+typedef bool (*SnapshotSampler)();
+
+// Keeps the sections read by alert rules, the stream and the shared segment
+// fresh when nothing calls their collectors (UI hidden, no UI at all): once
+// a second a background thread takes snapshotLock and runs the sampler of
+// each such section not published for 2 s, so rules are evaluated and
+// frames published without the JS thread. `samplers` has one entry per
+// section, in bit order. Runs last in Init.
+void SnapshotPumpAttach(napi_env env, const SnapshotSampler samplers[SNAP_SECTION_COUNT]);
+
+#endif // SNAPSHOT_H
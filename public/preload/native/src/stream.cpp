@@ -0,0 +1,443 @@
+#include "stream.h"
+#include "wire.h"
+#include "snapshot.h"
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const uint64_t CONNECT_TIMEOUT_MS = 10000;
+static const uint64_t RETRY_MIN_MS = 1000;
+static const uint64_t RETRY_MAX_MS = 30000;
+// Unsent bytes beyond this mean the aggregator is not reading: reconnect
+static const size_t MAX_PENDING = 256 * 1024;
+
+enum StreamState { STREAM_OFF, STREAM_IDLE, STREAM_CONNECTING, STREAM_CONNECTED };
+
+static StreamState state = STREAM_OFF;
+static std::string target, hostName, lastError;
+static uint32_t intervalMs = 1000;
+static SOCKET sock = INVALID_SOCKET;
+static WireEncoder encoder;
+static std::vector<uint8_t> pending;
+static size_t pendingSent = 0;
+static uint64_t lastFrameMs = 0, connectStart = 0, retryAt = 0, retryDelay = RETRY_MIN_MS;
+static uint64_t connectedAt = 0, connectedBytes = 0, bytesSent = 0, reconnects = 0;
+static bool cleanupHooked = false;
+
+static void CloseSocket() {
+    if (sock != INVALID_SOCKET) closesocket(sock);
+    sock = INVALID_SOCKET;
+    pending.clear();
+    pendingSent = 0;
+}
+
+static void Fail(const char* error, uint64_t now) {
+    CloseSocket();
+    lastError = error;
+    state = STREAM_IDLE;
+    retryAt = now + retryDelay;
+    retryDelay = retryDelay * 2 > RETRY_MAX_MS ? RETRY_MAX_MS : retryDelay * 2;
+}
+
+static void OnConnected(uint64_t now) {
+    state = STREAM_CONNECTED;
+    if (connectedAt) reconnects++;
+    connectedAt = now;
+    connectedBytes = 0;
+    retryDelay = RETRY_MIN_MS;
+    lastError.clear();
+    encoder.Reset();
+    WireEncoder::Hello(hostName, intervalMs, pending);
+}
+
+static void Connect(uint64_t now) {
+    sockaddr_storage addr;
+    int addrLen = 0;
+    if (!WireStartup() || !WireResolve(target, addr, addrLen)) {
+        Fail("cannot resolve target", now);
+        return;
+    }
+    sock = socket(addr.ss_family, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET) {
+        Fail("cannot create socket", now);
+        return;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+    if (addr.ss_family != AF_UNIX) {
+        BOOL noDelay = TRUE;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+    }
+    connectStart = now;
+    if (connect(sock, (const sockaddr*)&addr, addrLen) == 0) OnConnected(now);
+    else if (WSAGetLastError() == WSAEWOULDBLOCK) state = STREAM_CONNECTING;
+    else Fail("connect failed", now);
+}
+
+static void PollConnect(uint64_t now) {
+    fd_set writable, failed;
+    FD_ZERO(&writable);
+    FD_ZERO(&failed);
+    FD_SET(sock, &writable);
+    FD_SET(sock, &failed);
+    timeval zero = { 0, 0 };
+    if (select(0, nullptr, &writable, &failed, &zero) > 0) {
+        if (FD_ISSET(sock, &writable)) OnConnected(now);
+        else Fail("connect failed", now);
+    } else if (now - connectStart >= CONNECT_TIMEOUT_MS) {
+        Fail("connect timed out", now);
+    }
+}
+
+static void Flush(uint64_t now) {
+    while (pendingSent < pending.size()) {
+        int n = send(sock, (const char*)pending.data() + pendingSent, (int)(pending.size() - pendingSent), 0);
+        if (n > 0) {
+            pendingSent += n;
+            bytesSent += n;
+            connectedBytes += n;
+        } else if (WSAGetLastError() == WSAEWOULDBLOCK) {
+            break;
+        } else {
+            Fail("connection lost", now);
+            return;
+        }
+    }
+    if (pendingSent == pending.size()) {
+        pending.clear();
+        pendingSent = 0;
+    } else if (pending.size() - pendingSent > MAX_PENDING) {
+        Fail("aggregator not reading", now);
+    }
+}
+
+bool StreamActive() {
+    return state != STREAM_OFF;
+}
+
+void StreamPublish(uint32_t section, uint64_t nowMs) {
+    (void)section;
+    if (state == STREAM_OFF) return;
+    // Collectors tick at about the stream interval; don't skip one over timer jitter
+    if (lastFrameMs && nowMs - lastFrameMs + intervalMs / 10 < intervalMs) return;
+    lastFrameMs = nowMs;
+
+    if (state == STREAM_IDLE && nowMs >= retryAt) Connect(nowMs);
+    if (state == STREAM_CONNECTING) PollConnect(nowMs);
+    if (state != STREAM_CONNECTED) return;
+    encoder.Encode(snapshot, nowMs, pending);
+    Flush(nowMs);
+}
+
+static void CleanupStream(void*) {
+    std::lock_guard<std::recursive_mutex> guard(snapshotLock);
+    CloseSocket();
+    state = STREAM_OFF;
+}
+
+static napi_value Status(napi_env env) {
+    uint64_t now = GetTickCount64();
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_get_boolean(env, state != STREAM_OFF, &v); napi_set_named_property(env, result, "enabled", v);
+    if (target.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, target.c_str(), target.size(), &v);
+    napi_set_named_property(env, result, "target", v);
+    napi_create_string_utf8(env, hostName.c_str(), hostName.size(), &v); napi_set_named_property(env, result, "host", v);
+    napi_create_uint32(env, intervalMs, &v); napi_set_named_property(env, result, "interval", v);
+    napi_get_boolean(env, state == STREAM_CONNECTED, &v); napi_set_named_property(env, result, "connected", v);
+    napi_create_double(env, (double)encoder.frames, &v); napi_set_named_property(env, result, "frames", v);
+    napi_create_double(env, (double)encoder.keyframes, &v); napi_set_named_property(env, result, "keyframes", v);
+    napi_create_double(env, (double)bytesSent, &v); napi_set_named_property(env, result, "bytes", v);
+    double rate = state == STREAM_CONNECTED && now > connectedAt ? connectedBytes * 1000.0 / (now - connectedAt) : 0;
+    napi_create_double(env, rate, &v); napi_set_named_property(env, result, "bytesPerSec", v);
+    napi_create_double(env, (double)reconnects, &v); napi_set_named_property(env, result, "reconnects", v);
+    if (lastError.empty()) napi_get_null(env, &v);
+    else napi_create_string_utf8(env, lastError.c_str(), lastError.size(), &v);
+    napi_set_named_property(env, result, "error", v);
+    return result;
+}
+
+static std::string GetStringOption(napi_env env, napi_value opts, const char* name) {
+    bool has = false;
+    napi_value v;
+    size_t len = 0;
+    if (napi_has_named_property(env, opts, name, &has) != napi_ok || !has) return "";
+    napi_get_named_property(env, opts, name, &v);
+    if (napi_get_value_string_utf8(env, v, nullptr, 0, &len) != napi_ok) return "";
+    std::string s(len, 0);
+    napi_get_value_string_utf8(env, v, &s[0], len + 1, &len);
+    return s;
+}
+
+static bool GetUint32Option(napi_env env, napi_value opts, const char* name, uint32_t& out) {
+    bool has = false;
+    if (napi_has_named_property(env, opts, name, &has) != napi_ok || !has) return false;
+    napi_value v;
+    napi_get_named_property(env, opts, name, &v);
+    return napi_get_value_uint32(env, v, &out) == napi_ok;
+}
+
+napi_value SetStream(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type != napi_object) return Status(env);
+
+    std::string newTarget = GetStringOption(env, argv[0], "target");
+    std::string newHost = GetStringOption(env, argv[0], "host");
+    if (newHost.empty()) {
+        char name[256];
+        DWORD len = sizeof(name);
+        newHost = GetComputerNameA(name, &len) ? std::string(name, len) : "unknown";
+    }
+    uint32_t interval = 1000;
+    GetUint32Option(env, argv[0], "interval", interval);
+    if (interval < 100) interval = 100;
+
+    CloseSocket();
+    lastError.clear();
+    target = newTarget;
+    hostName = newHost;
+    intervalMs = interval;
+    lastFrameMs = 0;
+    retryAt = 0;
+    retryDelay = RETRY_MIN_MS;
+    connectedAt = 0;
+    reconnects = 0;
+    bytesSent = 0;
+    encoder = WireEncoder();
+    state = target.empty() ? STREAM_OFF : STREAM_IDLE;
+    if (state != STREAM_OFF && !cleanupHooked) {
+        napi_add_env_cleanup_hook(env, CleanupStream, nullptr);
+        cleanupHooked = true;
+    }
+    return Status(env);
+}
+
+// ---- Loopback simulator ----
+
+static const char* const simNames[] = {
+    "System", "smss.exe", "csrss.exe", "wininit.exe", "services.exe", "lsass.exe", "svchost.exe",
+    "svchost.exe", "svchost.exe", "svchost.exe", "svchost.exe", "svchost.exe", "dwm.exe",
+    "explorer.exe", "chrome.exe", "chrome.exe", "chrome.exe", "msedge.exe", "msedge.exe",
+    "Code.exe", "Code.exe", "node.exe", "conhost.exe", "conhost.exe", "RuntimeBroker.exe",
+    "SearchHost.exe", "MsMpEng.exe", "spoolsv.exe", "WmiPrvSE.exe", "dllhost.exe", "sihost.exe",
+    "taskhostw.exe", "ctfmon.exe", "audiodg.exe", "OneDrive.exe", "Teams.exe", "Slack.exe",
+    "postgres.exe", "sqlservr.exe", "java.exe", "python.exe", "uTools.exe",
+};
+static const size_t SIM_NAME_COUNT = sizeof(simNames) / sizeof(simNames[0]);
+
+struct SimAgent {
+    Snapshot snap;
+    WireEncoder encoder;
+    SOCKET sock = INVALID_SOCKET;
+    uint64_t rng;
+    uint32_t nextPid = 4;
+    std::string host;
+
+    double Rand() {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return (double)(rng >> 11) / 9007199254740992.0;
+    }
+    ProcSnapshot NewProc() {
+        ProcSnapshot p;
+        p.pid = nextPid;
+        nextPid += 4;
+        p.name = simNames[(size_t)(Rand() * SIM_NAME_COUNT)];
+        p.cpu = 0;
+        p.memory = (5 + Rand() * 400) * 1048576;
+        p.handles = 100 + (uint32_t)(Rand() * 1500);
+        p.threads = 1 + (uint32_t)(Rand() * 60);
+        return p;
+    }
+};
+
+struct SimJob {
+    std::string target;
+    uint32_t agents = 100, seconds = 10, intervalMs = 1000, procs = 200;
+    std::vector<SimAgent*> sims;
+    uint64_t connected = 0, frames = 0, keyframes = 0, bytes = 0, helloBytes = 0, keyframeBytes = 0;
+    double encodeMs = 0, elapsed = 0;
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+};
+
+static void SimInit(SimAgent* a, uint32_t index, uint32_t procs) {
+    char host[32];
+    snprintf(host, sizeof(host), "sim-%05u", index);
+    a->host = host;
+    a->rng = 0x9E3779B97F4A7C15ull * (index + 1);
+    Snapshot& s = a->snap;
+    s.memTotal = 16.0 * 1073741824;
+    s.memUsed = s.memTotal * 0.5;
+    s.cpuTemp = 55;
+    s.cpuFreq = 3200;
+    s.cpuPerf = 100;
+    s.disks.push_back({ "C:", 512.0 * 1073741824, 300.0 * 1073741824, 212.0 * 1073741824, 58.6, NAN });
+    s.disks.push_back({ "D:", 2048.0 * 1073741824, 900.0 * 1073741824, 1148.0 * 1073741824, 43.9, NAN });
+    s.net.push_back({ "Ethernet", 0, 0, 0 });
+    s.net.push_back({ "Wi-Fi", 0, 0, 0 });
+    for (uint32_t i = 0; i < procs; i++) s.procs.push_back(a->NewProc());
+}
+
+// One collection interval of plausible change: a few busy processes, working
+// set drift, rare process churn, noisy host counters
+static void SimTick(SimAgent* a) {
+    Snapshot& s = a->snap;
+    double cpu = 0;
+    for (auto& p : s.procs) {
+        if (a->Rand() < 0.004) p = a->NewProc();
+        bool busy = a->Rand() < 0.08;
+        p.cpu = busy ? a->Rand() * 12 : 0;
+        cpu += p.cpu;
+        if (busy) p.memory += (a->Rand() - 0.4) * 4 * 1048576;
+        if (busy && a->Rand() < 0.3) p.handles += (uint32_t)(a->Rand() * 5);
+    }
+    s.cpuTotal = cpu > 100 ? 100 : cpu;
+    s.memUsed += (a->Rand() - 0.5) * 64 * 1048576;
+    s.memFree = s.memTotal - s.memUsed;
+    s.memUsedPercent = s.memUsed / s.memTotal * 100;
+    s.memCommitted = s.memUsed * 1.3;
+    s.cpuTemp = 50 + s.cpuTotal / 4 + a->Rand() * 2;
+    s.pageFaultsSec = a->Rand() * 3000;
+    s.hardFaultsSec = a->Rand() < 0.1 ? a->Rand() * 50 : 0;
+    s.runQueue = a->Rand() * 2;
+    s.diskQueue = a->Rand() * 0.5;
+    s.disks[0].used += a->Rand() * 1048576;
+    s.disks[0].free = s.disks[0].size - s.disks[0].used;
+    s.disks[0].usedPercent = s.disks[0].used / s.disks[0].size * 100;
+    s.net[0].rxSec = a->Rand() * 200000;
+    s.net[0].txSec = a->Rand() * 50000;
+    s.net[0].utilization = s.net[0].rxSec / 1.25e6;
+}
+
+static bool SendAll(SOCKET s, const std::vector<uint8_t>& buf) {
+    size_t sent = 0;
+    while (sent < buf.size()) {
+        int n = send(s, (const char*)buf.data() + sent, (int)(buf.size() - sent), 0);
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+static void ExecuteSimulation(napi_env env, void* data) {
+    SimJob* job = (SimJob*)data;
+    LARGE_INTEGER freq, start, t0, t1;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&start);
+
+    sockaddr_storage addr;
+    int addrLen = 0;
+    if (!WireResolve(job->target, addr, addrLen)) return;
+    std::vector<uint8_t> out;
+    for (uint32_t i = 0; i < job->agents; i++) {
+        SimAgent* a = new SimAgent();
+        SimInit(a, i, job->procs);
+        job->sims.push_back(a);
+        a->sock = socket(addr.ss_family, SOCK_STREAM, 0);
+        if (a->sock == INVALID_SOCKET) continue;
+        out.clear();
+        WireEncoder::Hello(a->host, job->intervalMs, out);
+        if (connect(a->sock, (const sockaddr*)&addr, addrLen) != 0 || !SendAll(a->sock, out)) {
+            closesocket(a->sock);
+            a->sock = INVALID_SOCKET;
+            continue;
+        }
+        job->connected++;
+        job->bytes += out.size();
+        job->helloBytes += out.size();
+    }
+
+    uint32_t ticks = job->seconds * 1000 / job->intervalMs;
+    uint64_t tickStart = GetTickCount64();
+    for (uint32_t t = 0; t < ticks; t++) {
+        for (auto* a : job->sims) {
+            if (a->sock == INVALID_SOCKET) continue;
+            SimTick(a);
+            out.clear();
+            QueryPerformanceCounter(&t0);
+            a->encoder.Encode(a->snap, tickStart + (uint64_t)t * job->intervalMs, out);
+            QueryPerformanceCounter(&t1);
+            job->encodeMs += (double)(t1.QuadPart - t0.QuadPart) * 1000 / freq.QuadPart;
+            if (!SendAll(a->sock, out)) {
+                closesocket(a->sock);
+                a->sock = INVALID_SOCKET;
+                continue;
+            }
+            job->bytes += out.size();
+            if (t == 0) job->keyframeBytes += out.size();
+        }
+        uint64_t due = tickStart + (uint64_t)(t + 1) * job->intervalMs, now = GetTickCount64();
+        if (t + 1 < ticks && due > now) Sleep((DWORD)(due - now));
+    }
+    for (auto* a : job->sims) {
+        job->frames += a->encoder.frames;
+        job->keyframes += a->encoder.keyframes;
+        if (a->sock != INVALID_SOCKET) closesocket(a->sock);
+    }
+    QueryPerformanceCounter(&t1);
+    job->elapsed = (double)(t1.QuadPart - start.QuadPart) / freq.QuadPart;
+}
+
+static void CompleteSimulation(napi_env env, napi_status status, void* data) {
+    SimJob* job = (SimJob*)data;
+    uint64_t deltaFrames = job->frames - job->keyframes;
+    uint64_t deltaBytes = job->bytes - job->helloBytes - job->keyframeBytes;
+    double perFrame = deltaFrames ? (double)deltaBytes / deltaFrames : 0;
+
+    napi_value result, v;
+    napi_create_object(env, &result);
+    napi_create_uint32(env, job->agents, &v); napi_set_named_property(env, result, "agents", v);
+    napi_create_double(env, (double)job->connected, &v); napi_set_named_property(env, result, "connected", v);
+    napi_create_double(env, (double)job->frames, &v); napi_set_named_property(env, result, "frames", v);
+    napi_create_double(env, (double)job->keyframes, &v); napi_set_named_property(env, result, "keyframes", v);
+    napi_create_double(env, (double)job->bytes, &v); napi_set_named_property(env, result, "bytes", v);
+    napi_create_double(env, (double)job->keyframeBytes, &v); napi_set_named_property(env, result, "keyframeBytes", v);
+    napi_create_double(env, perFrame, &v); napi_set_named_property(env, result, "avgFrameBytes", v);
+    napi_create_double(env, perFrame * 1000 / job->intervalMs, &v); napi_set_named_property(env, result, "bytesPerAgentSec", v);
+    napi_create_double(env, job->encodeMs, &v); napi_set_named_property(env, result, "encodeMs", v);
+    napi_create_double(env, job->elapsed, &v); napi_set_named_property(env, result, "elapsed", v);
+
+    napi_resolve_deferred(env, job->deferred, result);
+    napi_delete_async_work(env, job->work);
+    for (auto* a : job->sims) delete a;
+    delete job;
+}
+
+napi_value SimulateAgents(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+
+    SimJob* job = new SimJob();
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) napi_typeof(env, argv[0], &type);
+    if (type == napi_object) {
+        job->target = GetStringOption(env, argv[0], "target");
+        GetUint32Option(env, argv[0], "agents", job->agents);
+        GetUint32Option(env, argv[0], "seconds", job->seconds);
+        GetUint32Option(env, argv[0], "interval", job->intervalMs);
+        GetUint32Option(env, argv[0], "procs", job->procs);
+    }
+    if (job->agents > 20000) job->agents = 20000;
+    if (job->procs > 5000) job->procs = 5000;
+    if (job->intervalMs < 100) job->intervalMs = 100;
+    WireStartup();
+
+    napi_value promise, name;
+    napi_create_promise(env, &job->deferred, &promise);
+    napi_create_string_utf8(env, "sysmonSimulateAgents", NAPI_AUTO_LENGTH, &name);
+    napi_create_async_work(env, nullptr, name, ExecuteSimulation, CompleteSimulation, job, &job->work);
+    napi_queue_async_work(env, job->work);
+    return promise;
+}
@@ -0,0 +1,32 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <node_api.h>
+#include <stdint.h>
+
+// Agent side of the metrics stream (protocol in wire.h).
+// setStream({ target: 'host:port' | 'unix:path', host, interval }) connects
+// to an aggregator and sends one frame per interval, encoded from `snapshot`
+// right after a collector publishes, so nothing is collected twice and no
+// extra thread touches the snapshot. Sockets are non-blocking; a lost or
+// backed-up connection is dropped and retried with backoff, and the first
+// frame after every connect is a keyframe.
+// setStream({ target: null }) stops; setStream() returns the status:
+//   { enabled, target, host, interval, connected, frames, keyframes, bytes,
+//     bytesPerSec, reconnects, error }
+napi_value SetStream(napi_env env, napi_callback_info info);
+
+// simulateAgents({ target, agents, seconds, interval, procs }) -> Promise<{
+//   agents, connected, frames, keyframes, bytes, keyframeBytes,
+//   avgFrameBytes, bytesPerAgentSec, encodeMs, elapsed }>
+// Loopback load generator: `agents` connections, each streaming a synthetic
+// host (procs processes with churn and random-walk load) from a worker thread.
+// bytesPerAgentSec is the steady-state rate (keyframes excluded).
+napi_value SimulateAgents(napi_env env, napi_callback_info info);
+
+// Called from SnapshotPublish after a collector updated `snapshot`
+void StreamPublish(uint32_t section, uint64_t nowMs);
+// Whether collectors must publish every section for the stream
+bool StreamActive();
+
+#endif // STREAM_H
@@ -6,14 +6,37 @@
 #include <psapi.h>
 #include <iphlpapi.h>
 #include <tlhelp32.h>
-#include <winioctl.h>
 #include <pdh.h>
 #include <comdef.h>
 #include <Wbemidl.h>
 #include <vector>
 #include <string>
+#include <math.h>
 #include "network.h"
 #include "connections.h"
+#include "anomaly.h"
+#include "alerts.h"
+#include "snapshot.h"
+#include "arena.h"
+#include "selfstats.h"
+#include "scheduler.h"
+#include "sensors.h"
+#include "pressure.h"
+#include "threads.h"
+#include "handles.h"
+#include "disks.h"
+#include "scanner.h"
+#include "tcpstats.h"
+#include "replay.h"
+#include "stream.h"
+#include "aggregator.h"
+#include "history.h"
+#include "shared.h"
+#include "inventory.h"
+#include "energy.h"
+#include "procdetails.h"
+#include "topology.h"
+#include "container.h"
 
 #pragma comment(lib, "psapi.lib")
 #pragma comment(lib, "iphlpapi.lib")
@@ -31,20 +54,80 @@ std::string WideToUtf8(const wchar_t* wstr) {
 }
 
 // Memory Info (extended with GetPerformanceInfo)
+static MEMORYSTATUSEX memStatus;
+static PERFORMANCE_INFORMATION memPerf;
+static bool memOk = false, perfOk = false;
+// Physical memory as reported: the job's commit limit when there is one
+static double memTotal = 0, memFree = 0, memUsed = 0, memUsedPercent = 0;
+static bool memContained = false;
+
+// Takes a sample and publishes the SNAP_MEM snapshot section (any thread)
+static bool MemorySample() {
+    memStatus.dwLength = sizeof(memStatus);
+    memPerf.cb = sizeof(memPerf);
+    SelfStatsQueryBegin();
+    memOk = GlobalMemoryStatusEx(&memStatus) != 0;
+    perfOk = GetPerformanceInfo(&memPerf, sizeof(memPerf)) != 0;
+    SelfStatsQueryEnd(sizeof(memStatus) + sizeof(memPerf));
+    
+    if (memOk) {
+        memTotal = (double)memStatus.ullTotalPhys;
+        memFree = (double)memStatus.ullAvailPhys;
+        memUsed = memTotal - memFree;
+        memUsedPercent = (double)memStatus.dwMemoryLoad;
+        // Under a job commit limit, report against the limit; host values go under `host`
+        const ContainerState& job = ContainerSample();
+        memContained = job.memLimited && job.memLimit > 0;
+        if (memContained) {
+            memTotal = job.memLimit;
+            memUsed = job.memUsed < memTotal ? job.memUsed : memTotal;
+            memFree = memTotal - memUsed;
+            memUsedPercent = memUsed / memTotal * 100;
+        }
+        snapshot.memTotal = memTotal;
+        snapshot.memFree = memFree;
+        snapshot.memUsed = memUsed;
+        snapshot.memUsedPercent = memUsedPercent;
+        double swapTotal = (double)(memStatus.ullTotalPageFile - memStatus.ullTotalPhys);
+        double swapFree = (double)(memStatus.ullAvailPageFile - memStatus.ullAvailPhys);
+        snapshot.swapUsed = (swapTotal < 0 ? 0 : swapTotal) - (swapFree < 0 ? 0 : swapFree);
+        SchedulerSignal(snapshot.memUsed, snapshot.memTotal * 0.01);
+    }
+    if (perfOk) {
+        double pageSize = (double)memPerf.PageSize;
+        snapshot.memCommitted = (double)memPerf.CommitTotal * pageSize;
+        SchedulerSignal(snapshot.memCommitted, (double)memPerf.CommitLimit * pageSize * 0.01);
+    }
+    
+    SnapshotPublish(SNAP_MEM, GetTickCount64());
+    return memOk || perfOk;
+}
+
 napi_value GetMemoryInfo(napi_env env, napi_callback_info info) {
     napi_value result;
     napi_create_object(env, &result);
     napi_value v;
+    MemorySample();
     
-    MEMORYSTATUSEX mem; mem.dwLength = sizeof(mem);
-    if (GlobalMemoryStatusEx(&mem)) {
-        napi_create_double(env, (double)mem.ullTotalPhys, &v); napi_set_named_property(env, result, "total", v);
-        napi_create_double(env, (double)mem.ullAvailPhys, &v); napi_set_named_property(env, result, "free", v);
-        napi_create_double(env, (double)(mem.ullTotalPhys - mem.ullAvailPhys), &v); napi_set_named_property(env, result, "used", v);
-        napi_create_double(env, (double)mem.dwMemoryLoad, &v); napi_set_named_property(env, result, "usedPercent", v);
+    if (memOk) {
+        if (memContained) {
+            double hostTotal = (double)memStatus.ullTotalPhys, hostFree = (double)memStatus.ullAvailPhys;
+            napi_value host;
+            napi_create_object(env, &host);
+            napi_create_double(env, hostTotal, &v); napi_set_named_property(env, host, "total", v);
+            napi_create_double(env, hostFree, &v); napi_set_named_property(env, host, "free", v);
+            napi_create_double(env, hostTotal - hostFree, &v); napi_set_named_property(env, host, "used", v);
+            napi_create_double(env, (double)memStatus.dwMemoryLoad, &v); napi_set_named_property(env, host, "usedPercent", v);
+            napi_set_named_property(env, result, "host", host);
+            napi_get_boolean(env, true, &v); napi_set_named_property(env, result, "container", v);
+        }
+        napi_create_double(env, memTotal, &v); napi_set_named_property(env, result, "total", v);
+        napi_create_double(env, memFree, &v); napi_set_named_property(env, result, "free", v);
+        napi_create_double(env, memUsed, &v); napi_set_named_property(env, result, "used", v);
+        napi_create_double(env, memUsedPercent, &v); napi_set_named_property(env, result, "usedPercent", v);
         // Swap (PageFile - Physical = Swap)
-        double swapTotal = (double)(mem.ullTotalPageFile - mem.ullTotalPhys);
-        double swapFree = (double)(mem.ullAvailPageFile - mem.ullAvailPhys);
+        double swapTotal = (double)(memStatus.ullTotalPageFile - memStatus.ullTotalPhys);
+        double swapFree = (double)(memStatus.ullAvailPageFile - memStatus.ullAvailPhys);
         if (swapTotal < 0) swapTotal = 0;
         if (swapFree < 0) swapFree = 0;
         napi_create_double(env, swapTotal, &v); napi_set_named_property(env, result, "swapTotal", v);
@@ -53,22 +136,21 @@ napi_value GetMemoryInfo(napi_env env, napi_callback_info info) {
     }
     
     // GetPerformanceInfo for detailed memory composition
-    PERFORMANCE_INFORMATION pi; pi.cb = sizeof(pi);
-    if (GetPerformanceInfo(&pi, sizeof(pi))) {
-        SIZE_T pageSize = pi.PageSize;
+    if (perfOk) {
+        SIZE_T pageSize = memPerf.PageSize;
         // Committed memory (total commit charge)
-        napi_create_double(env, (double)(pi.CommitTotal * pageSize), &v); 
+        napi_create_double(env, (double)(memPerf.CommitTotal * pageSize), &v); 
         napi_set_named_property(env, result, "committed", v);
-        napi_create_double(env, (double)(pi.CommitLimit * pageSize), &v); 
+        napi_create_double(env, (double)(memPerf.CommitLimit * pageSize), &v); 
         napi_set_named_property(env, result, "commitLimit", v);
         // Cache (system cache)
-        napi_create_double(env, (double)(pi.SystemCache * pageSize), &v); 
+        napi_create_double(env, (double)(memPerf.SystemCache * pageSize), &v); 
         napi_set_named_property(env, result, "cached", v);
         // Paged pool
-        napi_create_double(env, (double)(pi.KernelPaged * pageSize), &v); 
+        napi_create_double(env, (double)(memPerf.KernelPaged * pageSize), &v); 
         napi_set_named_property(env, result, "pagedPool", v);
         // Non-paged pool
-        napi_create_double(env, (double)(pi.KernelNonpaged * pageSize), &v); 
+        napi_create_double(env, (double)(memPerf.KernelNonpaged * pageSize), &v); 
         napi_set_named_property(env, result, "nonPagedPool", v);
         // Page size
         napi_create_double(env, (double)pageSize, &v); 
@@ -83,16 +165,12 @@ static PDH_HQUERY cpuQuery = NULL;
 static PDH_HCOUNTER cpuCounter = NULL;
 static bool cpuInit = false;
 static double lastCpuLoad = 0;
+// Under a job CPU cap: the job's share of the cap, and the cap in CPUs
+static double cpuJobLoad = 0, cpuJobLimit = 0;
+static bool cpuContained = false;
 
-// Per-Core CPU Usage
-static PDH_HQUERY perCoreQuery = NULL;
-static std::vector<PDH_HCOUNTER> perCoreCounters;
-static bool perCoreInit = false;
-static std::vector<double> lastPerCoreLoad;
-
-napi_value GetCpuUsage(napi_env env, napi_callback_info info) {
-    napi_value result; napi_create_object(env, &result);
-    
+// Takes a sample and publishes the SNAP_CPU snapshot section (any thread)
+static bool CpuSample() {
     if (!cpuInit) {
         if (PdhOpenQuery(NULL, 0, &cpuQuery) == ERROR_SUCCESS) {
             // % Processor Utility is what Task Manager uses on modern CPUs
@@ -105,74 +183,47 @@ napi_value GetCpuUsage(napi_env env, napi_callback_info info) {
         cpuInit = true;
     }
     
-    double load = lastCpuLoad;
-    
+    bool ok = false;
     if (cpuQuery && cpuCounter) {
+        SelfStatsQueryBegin();
         if (PdhCollectQueryData(cpuQuery) == ERROR_SUCCESS) {
             PDH_FMT_COUNTERVALUE value;
             if (PdhGetFormattedCounterValue(cpuCounter, PDH_FMT_DOUBLE, NULL, &value) == ERROR_SUCCESS) {
-                load = value.doubleValue;
+                double load = value.doubleValue;
                 if (load < 0) load = 0;
                 if (load > 100) load = 100;
                 lastCpuLoad = load;
+                ok = true;
             }
         }
+        SelfStatsQueryEnd(sizeof(PDH_FMT_COUNTERVALUE));
     }
     
-    napi_value v;
-    napi_create_double(env, load, &v); napi_set_named_property(env, result, "load", v);
-    return result;
+    const ContainerState& job = ContainerSample();
+    cpuContained = job.cpuLimited;
+    cpuJobLoad = job.cpuPercent;
+    cpuJobLimit = job.cpus;
+    
+    snapshot.cpuTotal = cpuContained ? cpuJobLoad : lastCpuLoad;
+    SnapshotPublish(SNAP_CPU, GetTickCount64());
+    return ok;
 }
 
-// Per-Core CPU Usage
-napi_value GetPerCoreUsage(napi_env env, napi_callback_info info) {
-    napi_value result; napi_create_array(env, &result);
-    
-    SYSTEM_INFO si; GetNativeSystemInfo(&si);
-    int numCores = si.dwNumberOfProcessors;
-    
-    if (!perCoreInit) {
-        if (PdhOpenQuery(NULL, 0, &perCoreQuery) == ERROR_SUCCESS) {
-            perCoreCounters.resize(numCores);
-            lastPerCoreLoad.resize(numCores, 0);
-            
-            for (int i = 0; i < numCores; i++) {
-                wchar_t path[256];
-                // Try Processor Information first (modern, matches Task Manager)
-                swprintf(path, 256, L"\\Processor Information(0,%d)\\%% Processor Utility", i);
-                if (PdhAddEnglishCounterW(perCoreQuery, path, 0, &perCoreCounters[i]) != ERROR_SUCCESS) {
-                    // Fallback to old Processor counter
-                    swprintf(path, 256, L"\\Processor(%d)\\%% Processor Time", i);
-                    PdhAddEnglishCounterW(perCoreQuery, path, 0, &perCoreCounters[i]);
-                }
-            }
-            PdhCollectQueryData(perCoreQuery); // First call to initialize
-        }
-        perCoreInit = true;
-    }
-    
-    if (perCoreQuery) {
-        if (PdhCollectQueryData(perCoreQuery) == ERROR_SUCCESS) {
-            for (int i = 0; i < numCores; i++) {
-                if (perCoreCounters[i]) {
-                    PDH_FMT_COUNTERVALUE value;
-                    if (PdhGetFormattedCounterValue(perCoreCounters[i], PDH_FMT_DOUBLE, NULL, &value) == ERROR_SUCCESS) {
-                        double load = value.doubleValue;
-                        if (load < 0) load = 0;
-                        if (load > 100) load = 100;
-                        lastPerCoreLoad[i] = load;
-                    }
-                }
-            }
-        }
-    }
+napi_value GetCpuUsage(napi_env env, napi_callback_info info) {
+    napi_value result; napi_create_object(env, &result);
+    CpuSample();
     
-    for (int i = 0; i < numCores; i++) {
-        napi_value v;
-        napi_create_double(env, lastPerCoreLoad[i], &v);
-        napi_set_element(env, result, i, v);
+    napi_value v;
+    double load = lastCpuLoad;
+    // Under a job CPU cap, load is the job's share of the cap; the machine-wide value goes under `host`
+    if (cpuContained) {
+        napi_create_double(env, load, &v); napi_set_named_property(env, result, "host", v);
+        napi_create_double(env, cpuJobLimit, &v); napi_set_named_property(env, result, "cpuLimit", v);
+        napi_get_boolean(env, true, &v); napi_set_named_property(env, result, "container", v);
+        load = cpuJobLoad;
     }
     
+    napi_create_double(env, load, &v); napi_set_named_property(env, result, "load", v);
     return result;
 }
 
@@ -204,6 +255,8 @@ napi_value GetSystemStats(napi_env env, napi_callback_info info) {
         }
         CloseHandle(snap);
     }
+    SchedulerSignal(processCount, 0.5);
+    SchedulerSignal(threadCount, 50);
     
     // Get system handle count using PDH (same as Task Manager)
     DWORD handleCount = 0;
@@ -283,28 +336,39 @@ napi_value GetSystemInfo(napi_env env, napi_callback_info info) {
 }
 
 // CPU Info
+// Fields of getCpuInfo that change while running; the inventory cache keeps
+// them out of the file and refills them on every answer served from it
+static const char* const cpuInfoLiveFields[] = { "currentSpeed", nullptr };
+
+// ~MHz is the nominal clock; the current one comes from the PDH performance counters
+static void CpuInfoLive(napi_env env, napi_value result) {
+    SensorsSample();
+    double current = SensorsCpuMHz() / 1000.0;
+    napi_value v;
+    bool has = false;
+    if (!(current > 0)) {
+        if (napi_has_named_property(env, result, "speed", &has) != napi_ok || !has) return;
+        napi_get_named_property(env, result, "speed", &v);
+        napi_get_value_double(env, v, &current);
+    }
+    napi_create_double(env, current, &v);
+    napi_set_named_property(env, result, "currentSpeed", v);
+}
+
 napi_value GetCpuInfo(napi_env env, napi_callback_info info) {
     napi_value result; napi_create_object(env, &result);
-    SYSTEM_INFO si; GetNativeSystemInfo(&si);
     napi_value v;
     
-    // 逻辑核心数
-    napi_create_uint32(env, si.dwNumberOfProcessors, &v);
+    // 物理核心数 / 插槽 / NUMA 节点 (通过 GetLogicalProcessorInformationEx, 覆盖所有处理器组)
+    const CpuTopology& topo = TopologyGet();
+    napi_create_uint32(env, (uint32_t)topo.processors.size(), &v);
     napi_set_named_property(env, result, "cores", v);
-    
-    // 物理核心数 (通过 GetLogicalProcessorInformation)
-    DWORD len = 0;
-    GetLogicalProcessorInformation(nullptr, &len);
-    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> buffer(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
-    int physicalCores = 0;
-    if (GetLogicalProcessorInformation(buffer.data(), &len)) {
-        for (auto& info : buffer) {
-            if (info.Relationship == RelationProcessorCore) physicalCores++;
-        }
-    }
-    if (physicalCores == 0) physicalCores = si.dwNumberOfProcessors / 2;
-    napi_create_uint32(env, physicalCores, &v);
+    napi_create_uint32(env, topo.cores, &v);
     napi_set_named_property(env, result, "physicalCores", v);
+    napi_create_uint32(env, topo.sockets, &v);
+    napi_set_named_property(env, result, "sockets", v);
+    napi_create_uint32(env, (uint32_t)topo.nodeNumbers.size(), &v);
+    napi_set_named_property(env, result, "numaNodes", v);
     
     HKEY hKey;
     if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
@@ -316,7 +380,7 @@ napi_value GetCpuInfo(napi_env env, napi_callback_info info) {
         DWORD mhz = 0, mhzSize = sizeof(mhz);
         if (RegQueryValueExW(hKey, L"~MHz", nullptr, nullptr, (LPBYTE)&mhz, &mhzSize) == ERROR_SUCCESS) {
             napi_create_double(env, mhz / 1000.0, &v); napi_set_named_property(env, result, "speed", v);
-            napi_create_double(env, mhz / 1000.0, &v); napi_set_named_property(env, result, "currentSpeed", v);
+            CpuInfoLive(env, result);
         }
         
         // Check virtualization support
@@ -446,111 +510,27 @@ napi_value GetBatteryInfo(napi_env env, napi_callback_info info) {
         napi_create_uint32(env, sps.BatteryLifePercent, &v); napi_set_named_property(env, result, "percent", v);
         // 修复：正在充电 = AC在线 且 (电池标志显示充电中 或 电量未满)
         bool isCharging = (sps.ACLineStatus == 1) && ((sps.BatteryFlag & 8) || (sps.BatteryLifePercent < 100));
+        SchedulerSignal(sps.BatteryLifePercent, 0.5);
+        SchedulerSignal(isCharging ? 1 : 0, 0.5);
         napi_get_boolean(env, isCharging, &v); 
         napi_set_named_property(env, result, "isCharging", v);
+        // Smoothed rate and time estimates (energy.h); null when the battery reports neither
+        BatteryEstimate be;
+        bool estimated = EnergyBattery(be);
+        double rate = estimated && be.rate < 0 ? -be.rate : NAN;
+        double toEmpty = estimated ? be.timeToEmpty : NAN, toFull = estimated ? be.timeToFull : NAN;
+        if (isnan(rate)) napi_get_null(env, &v); else napi_create_double(env, rate, &v);
+        napi_set_named_property(env, result, "dischargeRate", v);
+        if (isnan(toEmpty)) napi_get_null(env, &v); else napi_create_double(env, toEmpty, &v);
+        napi_set_named_property(env, result, "timeToEmpty", v);
+        if (isnan(toFull)) napi_get_null(env, &v); else napi_create_double(env, toFull, &v);
+        napi_set_named_property(env, result, "timeToFull", v);
     } else {
         napi_get_boolean(env, false, &v); napi_set_named_property(env, result, "hasBattery", v);
     }
     return result;
 }
 
-// Disk Info
-napi_value GetDiskInfo(napi_env env, napi_callback_info info) {
-    napi_value result, partitions, physical; 
-    napi_create_object(env, &result); 
-    napi_create_array(env, &partitions);
-    napi_create_array(env, &physical);
-    
-    // 分区信息
-    DWORD drives = GetLogicalDrives();
-    uint32_t idx = 0;
-    for (char letter = 'A'; letter <= 'Z'; letter++) {
-        if (!(drives & (1 << (letter - 'A')))) continue;
-        char root[4] = { letter, ':', '\\', 0 };
-        if (GetDriveTypeA(root) != DRIVE_FIXED) continue;
-        ULARGE_INTEGER freeAvail, total, totalFree;
-        if (!GetDiskFreeSpaceExA(root, &freeAvail, &total, &totalFree)) continue;
-        
-        napi_value disk; napi_create_object(env, &disk);
-        napi_value v;
-        char fs[3] = { letter, ':', 0 };
-        napi_create_string_utf8(env, root, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, disk, "mount", v);
-        napi_create_string_utf8(env, fs, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, disk, "fs", v);
-        napi_create_double(env, (double)total.QuadPart, &v); napi_set_named_property(env, disk, "size", v);
-        napi_create_double(env, (double)totalFree.QuadPart, &v); napi_set_named_property(env, disk, "free", v);
-        napi_create_double(env, (double)(total.QuadPart - totalFree.QuadPart), &v); napi_set_named_property(env, disk, "used", v);
-        double pct = total.QuadPart > 0 ? (double)(total.QuadPart - totalFree.QuadPart) / total.QuadPart * 100.0 : 0;
-        napi_create_double(env, pct, &v); napi_set_named_property(env, disk, "usedPercent", v);
-        
-        // 获取文件系统类型
-        char fsType[32] = {0};
-        GetVolumeInformationA(root, nullptr, 0, nullptr, nullptr, nullptr, fsType, sizeof(fsType));
-        napi_create_string_utf8(env, fsType[0] ? fsType : "NTFS", NAPI_AUTO_LENGTH, &v);
-        napi_set_named_property(env, disk, "type", v);
-        
-        napi_set_element(env, partitions, idx++, disk);
-    }
-    napi_set_named_property(env, result, "partitions", partitions);
-    
-    // 物理磁盘信息
-    uint32_t pIdx = 0;
-    for (int i = 0; i < 16; i++) {
-        char path[32]; sprintf(path, "\\\\.\\PhysicalDrive%d", i);
-        HANDLE hDisk = CreateFileA(path, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
-        if (hDisk == INVALID_HANDLE_VALUE) continue;
-        
-        STORAGE_PROPERTY_QUERY query = {StorageDeviceProperty, PropertyStandardQuery};
-        char buffer[1024] = {0};
-        DWORD bytesReturned;
-        
-        if (DeviceIoControl(hDisk, IOCTL_STORAGE_QUERY_PROPERTY, &query, sizeof(query), buffer, sizeof(buffer), &bytesReturned, nullptr)) {
-            STORAGE_DEVICE_DESCRIPTOR* desc = (STORAGE_DEVICE_DESCRIPTOR*)buffer;
-            napi_value disk; napi_create_object(env, &disk);
-            napi_value v;
-            
-            // 型号
-            if (desc->ProductIdOffset) {
-                std::string model = (char*)buffer + desc->ProductIdOffset;
-                // 去除首尾空格
-                size_t start = model.find_first_not_of(" ");
-                size_t end = model.find_last_not_of(" ");
-                if (start != std::string::npos) model = model.substr(start, end - start + 1);
-                napi_create_string_utf8(env, model.c_str(), NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, disk, "name", v);
-            }
-            
-            // 厂商
-            if (desc->VendorIdOffset) {
-                std::string vendor = (char*)buffer + desc->VendorIdOffset;
-                size_t start = vendor.find_first_not_of(" ");
-                size_t end = vendor.find_last_not_of(" ");
-                if (start != std::string::npos) vendor = vendor.substr(start, end - start + 1);
-                napi_create_string_utf8(env, vendor.c_str(), NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, disk, "vendor", v);
-            }
-            
-            // 类型 (SSD/HDD)
-            const char* type = desc->BusType == BusTypeSata ? "SATA" : 
-                              desc->BusType == BusTypeNvme ? "NVMe" : "Unknown";
-            napi_create_string_utf8(env, type, NAPI_AUTO_LENGTH, &v);
-            napi_set_named_property(env, disk, "interfaceType", v);
-            
-            // 大小
-            DISK_GEOMETRY_EX geo;
-            if (DeviceIoControl(hDisk, IOCTL_DISK_GET_DRIVE_GEOMETRY_EX, nullptr, 0, &geo, sizeof(geo), &bytesReturned, nullptr)) {
-                napi_create_double(env, (double)geo.DiskSize.QuadPart, &v);
-                napi_set_named_property(env, disk, "size", v);
-            }
-            
-            napi_set_element(env, physical, pIdx++, disk);
-        }
-        CloseHandle(hDisk);
-    }
-    napi_set_named_property(env, result, "physical", physical);
-    
-    return result;
-}
-
 // Disk IO Stats (read/write bytes per second)
 static ULONGLONG prevDiskReadBytes = 0, prevDiskWriteBytes = 0;
 static ULONGLONG prevDiskTime = 0;
@@ -590,6 +570,7 @@ napi_value GetDiskIO(napi_env env, napi_callback_info info) {
     double readsPerSec = 0, writesPerSec = 0;
     
     if (diskQuery) {
+        SelfStatsQueryBegin();
         if (PdhCollectQueryData(diskQuery) == ERROR_SUCCESS) {
             PDH_FMT_COUNTERVALUE value;
             
@@ -621,6 +602,7 @@ napi_value GetDiskIO(napi_env env, napi_callback_info info) {
                 writesPerSec = value.doubleValue;
             }
         }
+        SelfStatsQueryEnd(8 * sizeof(PDH_FMT_COUNTERVALUE));
     }
     
     // Clamp values
@@ -633,6 +615,8 @@ napi_value GetDiskIO(napi_env env, napi_callback_info info) {
     if (avgWriteTime < 0) avgWriteTime = 0;
     if (readsPerSec < 0) readsPerSec = 0;
     if (writesPerSec < 0) writesPerSec = 0;
+    SchedulerSignal(readSec + writeSec, 256.0 * 1024);
+    SchedulerSignal(queueLength, 0.5);
     
     // IO throughput
     napi_create_double(env, readSec, &v); napi_set_named_property(env, result, "readSec", v);
@@ -652,13 +636,19 @@ napi_value GetDiskIO(napi_env env, napi_callback_info info) {
 
 // Process List with detailed info
 struct ProcessCpuCache { DWORD pid; ULONGLONG kernelTime, userTime; };
-static std::vector<ProcessCpuCache> procCpuCache;
+static std::vector<ProcessCpuCache> procCpuCache, newCpuCache;
 static ULONGLONG procCpuTime = 0;
 
-napi_value GetProcessList(napi_env env, napi_callback_info info) {
-    napi_value result, procs; napi_create_object(env, &result); napi_create_array(env, &procs);
-    
+// Per-tick process rows; names live in procArena until the next refresh
+struct ProcInfo { DWORD pid; const char* name; DWORD threads; SIZE_T memory; DWORD handles; double cpu; const ProcDetails* details; };
+static std::vector<ProcInfo> procList;
+static ScratchArena procArena("processList");
+
+// Takes a sample into procList and publishes the SNAP_PROC snapshot section
+// (any thread; JS objects of the details cache are released by the export)
+static bool ProcessesSample() {
     // Get system times for CPU calculation
+    SelfStatsQueryBegin();
     FILETIME idleTime, kernelTime, userTime;
     GetSystemTimes(&idleTime, &kernelTime, &userTime);
     ULONGLONG sysKernel = ((ULONGLONG)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
@@ -670,22 +660,28 @@ napi_value GetProcessList(napi_env env, napi_callback_info info) {
     
     HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (snap == INVALID_HANDLE_VALUE) {
-        napi_set_named_property(env, result, "processes", procs);
-        napi_value v; napi_create_uint32(env, 0, &v); napi_set_named_property(env, result, "count", v);
-        return result;
+        SelfStatsQueryEnd();
+        procList.clear();
+        return false;
     }
     
     PROCESSENTRY32W pe; pe.dwSize = sizeof(pe);
-    struct ProcInfo { DWORD pid; std::wstring name; DWORD threads; SIZE_T memory; DWORD handles; double cpu; };
-    std::vector<ProcInfo> list;
-    std::vector<ProcessCpuCache> newCpuCache;
+    // Vectors keep their capacity between calls, so steady-state ticks don't allocate
+    procArena.Reset();
+    procList.clear();
+    newCpuCache.clear();
+    SYSTEM_INFO si; GetNativeSystemInfo(&si);
     
     if (Process32FirstW(snap, &pe)) do {
         if (pe.th32ProcessID == 0) continue;
         
-        ProcInfo pi = { pe.th32ProcessID, pe.szExeFile, pe.cntThreads, 0, 0, 0 };
+        ProcInfo pi = { pe.th32ProcessID, procArena.Utf8(pe.szExeFile), pe.cntThreads, 0, 0, 0, nullptr };
+        bool hasCpu = false;
         
         HANDLE h = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pe.th32ProcessID);
+        // Services and elevated processes usually still grant this, which is
+        // enough for times (so the create time that keys the details), memory and handles
+        if (!h) h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pe.th32ProcessID);
         if (h) {
             // Memory
             PROCESS_MEMORY_COUNTERS pmc;
@@ -710,51 +706,103 @@ napi_value GetProcessList(napi_env env, napi_callback_info info) {
                         ULONGLONG kDiff = pKernel - c.kernelTime;
                         ULONGLONG uDiff = pUser - c.userTime;
                         // CPU % = (process time diff) / (elapsed time * num cores) * 100
-                        SYSTEM_INFO si; GetNativeSystemInfo(&si);
                         double elapsed = dt * 10000000.0; // Convert to 100ns units
                         pi.cpu = ((double)(kDiff + uDiff) / (elapsed * si.dwNumberOfProcessors)) * 100.0;
                         if (pi.cpu < 0) pi.cpu = 0;
                         if (pi.cpu > 100) pi.cpu = 100;
+                        hasCpu = true;
                         break;
                     }
                 }
                 newCpuCache.push_back({ pe.th32ProcessID, pKernel, pUser });
+                
+                // Feed the anomaly detector (O(1) per process)
+                ULONGLONG created = ((ULONGLONG)createTime.dwHighDateTime << 32) | createTime.dwLowDateTime;
+                AnomalyObserve(pe.th32ProcessID, created, pi.name, (double)pi.memory, pi.handles, pi.cpu, hasCpu, now);
+                // Path / command line / user, fetched once per process lifetime
+                pi.details = ProcDetailsGet(pe.th32ProcessID, created, h);
             }
             CloseHandle(h);
         }
+        if (!pi.details) pi.details = ProcDetailsGet(pe.th32ProcessID, 0, nullptr);
         
-        list.push_back(pi);
+        procList.push_back(pi);
     } while (Process32NextW(snap, &pe));
     CloseHandle(snap);
+    SelfStatsQueryEnd(procList.size() * (sizeof(PROCESSENTRY32W) + sizeof(PROCESS_MEMORY_COUNTERS)));
     
-    procCpuCache = newCpuCache;
+    procCpuCache.swap(newCpuCache);
     procCpuTime = now;
+    double cpuSum = 0;
+    for (auto& p : procList) cpuSum += p.cpu;
+    SchedulerSignal((double)procList.size(), 0.5);
+    SchedulerSignal(cpuSum, 5);
+    AnomalyEndTick(now);
+    
+    if (SnapshotNeeded(SNAP_PROC)) {
+        snapshot.procs.clear();
+        ScratchArena& strings = SnapshotStrings(SNAP_PROC);
+        strings.Reset();
+        for (auto& p : procList) {
+            snapshot.procs.push_back({ p.pid, strings.Copy(p.name), p.cpu, (double)p.memory, p.handles, p.threads,
+                                       strings.Copy(p.details->user.c_str()), strings.Copy(p.details->path.c_str()),
+                                       strings.Copy(p.details->cmdline.c_str()), p.details->startTime });
+        }
+        SnapshotPublish(SNAP_PROC, now);
+    }
+    ProcDetailsEndTick();
+    return true;
+}
+
+napi_value GetProcessList(napi_env env, napi_callback_info info) {
+    napi_value result, procs; napi_create_object(env, &result); napi_create_array(env, &procs);
+    ProcessesSample();
     
     uint32_t idx = 0;
-    for (auto& p : list) {
+    for (auto& p : procList) {
         napi_value proc; napi_create_object(env, &proc);
         napi_value v;
         napi_create_uint32(env, p.pid, &v); napi_set_named_property(env, proc, "pid", v);
-        napi_create_string_utf8(env, WideToUtf8(p.name.c_str()).c_str(), NAPI_AUTO_LENGTH, &v);
+        napi_create_string_utf8(env, p.name, NAPI_AUTO_LENGTH, &v);
         napi_set_named_property(env, proc, "name", v);
         napi_create_double(env, (double)p.memory, &v); napi_set_named_property(env, proc, "memory", v);
         napi_create_uint32(env, p.threads, &v); napi_set_named_property(env, proc, "threads", v);
         napi_create_uint32(env, p.handles, &v); napi_set_named_property(env, proc, "handles", v);
         napi_create_double(env, p.cpu, &v); napi_set_named_property(env, proc, "cpu", v);
+        // Shared per process, so steady-state rows don't rebuild the strings
+        napi_set_named_property(env, proc, "details", ProcDetailsValue(env, p.details));
         napi_set_element(env, procs, idx++, proc);
     }
+    ProcDetailsRelease(env);
     
     napi_set_named_property(env, result, "processes", procs);
-    napi_value v; napi_create_uint32(env, (uint32_t)list.size(), &v); napi_set_named_property(env, result, "count", v);
+    napi_value v; napi_create_uint32(env, (uint32_t)procList.size(), &v); napi_set_named_property(env, result, "count", v);
     return result;
 }
 
-// Memory Hardware Info via WMI
-napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
-    napi_value result, modules;
-    napi_create_object(env, &result);
-    napi_create_array(env, &modules);
-    
+// Memory Hardware Info via WMI. Collection is split from building the value
+// so the inventory refresh can run the WMI queries on a worker thread.
+struct MemoryModuleInfo {
+    std::string bank, type, formFactor, manufacturer, partNumber;   // empty = not reported
+    double capacity = -1;
+    int64_t speed = -1;
+};
+
+struct MemoryHardwareInfo {
+    std::vector<MemoryModuleInfo> modules;
+    int64_t totalSlots = -1;
+    bool queried = false;
+};
+
+static std::string TrimWmi(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t");
+    size_t end = s.find_last_not_of(" \t");
+    return start != std::string::npos ? s.substr(start, end - start + 1) : s;
+}
+
+// Any thread
+static void* CollectMemoryHardware() {
+    MemoryHardwareInfo* hw = new MemoryHardwareInfo();
     HRESULT hr = CoInitializeEx(0, COINIT_MULTITHREADED);
     bool needUninit = SUCCEEDED(hr);
     
@@ -781,18 +829,14 @@ napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
         
         IWbemClassObject* pObj = NULL;
         ULONG uReturn = 0;
-        uint32_t idx = 0;
         
         while (pEnum->Next(WBEM_INFINITE, 1, &pObj, &uReturn) == S_OK && uReturn > 0) {
-            napi_value mod;
-            napi_create_object(env, &mod);
-            napi_value v;
+            MemoryModuleInfo mod;
             VARIANT vtProp;
             
             // BankLabel
             if (SUCCEEDED(pObj->Get(L"BankLabel", 0, &vtProp, 0, 0)) && vtProp.vt == VT_BSTR) {
-                napi_create_string_utf8(env, WideToUtf8(vtProp.bstrVal).c_str(), NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, mod, "bank", v);
+                mod.bank = WideToUtf8(vtProp.bstrVal);
                 VariantClear(&vtProp);
             }
             
@@ -801,15 +845,13 @@ napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
                 ULONGLONG cap = 0;
                 if (vtProp.vt == VT_BSTR) cap = _wtoi64(vtProp.bstrVal);
                 else if (vtProp.vt == VT_I8 || vtProp.vt == VT_UI8) cap = vtProp.ullVal;
-                napi_create_double(env, (double)cap, &v);
-                napi_set_named_property(env, mod, "capacity", v);
+                mod.capacity = (double)cap;
                 VariantClear(&vtProp);
             }
             
             // Speed
             if (SUCCEEDED(pObj->Get(L"Speed", 0, &vtProp, 0, 0)) && (vtProp.vt == VT_I4 || vtProp.vt == VT_UI4)) {
-                napi_create_uint32(env, vtProp.uintVal, &v);
-                napi_set_named_property(env, mod, "speed", v);
+                mod.speed = vtProp.uintVal;
                 VariantClear(&vtProp);
             }
             
@@ -821,8 +863,7 @@ napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
                     case 26: type = "DDR4"; break;
                     case 34: type = "DDR5"; break;
                 }
-                napi_create_string_utf8(env, type, NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, mod, "type", v);
+                mod.type = type;
                 VariantClear(&vtProp);
             }
             
@@ -833,35 +874,21 @@ napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
                     case 8: form = "DIMM"; break;
                     case 12: form = "SODIMM"; break;
                 }
-                napi_create_string_utf8(env, form, NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, mod, "formFactor", v);
+                mod.formFactor = form;
                 VariantClear(&vtProp);
             }
             
-            // Manufacturer
+            // Manufacturer / PartNumber (padded with spaces)
             if (SUCCEEDED(pObj->Get(L"Manufacturer", 0, &vtProp, 0, 0)) && vtProp.vt == VT_BSTR) {
-                std::string mfr = WideToUtf8(vtProp.bstrVal);
-                // Trim whitespace
-                size_t start = mfr.find_first_not_of(" \t");
-                size_t end = mfr.find_last_not_of(" \t");
-                if (start != std::string::npos) mfr = mfr.substr(start, end - start + 1);
-                napi_create_string_utf8(env, mfr.c_str(), NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, mod, "manufacturer", v);
+                mod.manufacturer = TrimWmi(WideToUtf8(vtProp.bstrVal));
                 VariantClear(&vtProp);
             }
-            
-            // PartNumber
             if (SUCCEEDED(pObj->Get(L"PartNumber", 0, &vtProp, 0, 0)) && vtProp.vt == VT_BSTR) {
-                std::string pn = WideToUtf8(vtProp.bstrVal);
-                size_t start = pn.find_first_not_of(" \t");
-                size_t end = pn.find_last_not_of(" \t");
-                if (start != std::string::npos) pn = pn.substr(start, end - start + 1);
-                napi_create_string_utf8(env, pn.c_str(), NAPI_AUTO_LENGTH, &v);
-                napi_set_named_property(env, mod, "partNumber", v);
+                mod.partNumber = TrimWmi(WideToUtf8(vtProp.bstrVal));
                 VariantClear(&vtProp);
             }
             
-            napi_set_element(env, modules, idx++, mod);
+            hw->modules.push_back(std::move(mod));
             pObj->Release();
         }
         
@@ -874,19 +901,14 @@ napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
             if (pEnum2->Next(WBEM_INFINITE, 1, &pObj, &uReturn) == S_OK && uReturn > 0) {
                 VARIANT vtProp;
                 if (SUCCEEDED(pObj->Get(L"MemoryDevices", 0, &vtProp, 0, 0)) && (vtProp.vt == VT_I4 || vtProp.vt == VT_UI4)) {
-                    napi_value v;
-                    napi_create_uint32(env, vtProp.uintVal, &v);
-                    napi_set_named_property(env, result, "totalSlots", v);
+                    hw->totalSlots = vtProp.uintVal;
                     VariantClear(&vtProp);
                 }
                 pObj->Release();
             }
             pEnum2->Release();
         }
-        
-        napi_value v;
-        napi_create_uint32(env, idx, &v);
-        napi_set_named_property(env, result, "usedSlots", v);
+        hw->queried = true;
         
     } while (0);
     
@@ -894,11 +916,52 @@ napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
     if (pSvc) pSvc->Release();
     if (pLoc) pLoc->Release();
     if (needUninit) CoUninitialize();
-    
+    return hw;
+}
+
+static void SetNonEmpty(napi_env env, napi_value obj, const char* key, const std::string& s) {
+    if (s.empty()) return;
+    napi_value v;
+    napi_create_string_utf8(env, s.c_str(), s.size(), &v);
+    napi_set_named_property(env, obj, key, v);
+}
+
+// JS thread; takes ownership of the collected state
+static napi_value BuildMemoryHardware(napi_env env, void* state) {
+    MemoryHardwareInfo* hw = (MemoryHardwareInfo*)state;
+    napi_value result, modules, v;
+    napi_create_object(env, &result);
+    napi_create_array_with_length(env, hw->modules.size(), &modules);
+    for (size_t i = 0; i < hw->modules.size(); i++) {
+        const MemoryModuleInfo& m = hw->modules[i];
+        napi_value mod;
+        napi_create_object(env, &mod);
+        SetNonEmpty(env, mod, "bank", m.bank);
+        if (m.capacity >= 0) { napi_create_double(env, m.capacity, &v); napi_set_named_property(env, mod, "capacity", v); }
+        if (m.speed >= 0) { napi_create_uint32(env, (uint32_t)m.speed, &v); napi_set_named_property(env, mod, "speed", v); }
+        SetNonEmpty(env, mod, "type", m.type);
+        SetNonEmpty(env, mod, "formFactor", m.formFactor);
+        SetNonEmpty(env, mod, "manufacturer", m.manufacturer);
+        SetNonEmpty(env, mod, "partNumber", m.partNumber);
+        napi_set_element(env, modules, (uint32_t)i, mod);
+    }
+    if (hw->totalSlots >= 0) {
+        napi_create_uint32(env, (uint32_t)hw->totalSlots, &v);
+        napi_set_named_property(env, result, "totalSlots", v);
+    }
+    if (hw->queried) {
+        napi_create_uint32(env, (uint32_t)hw->modules.size(), &v);
+        napi_set_named_property(env, result, "usedSlots", v);
+    }
     napi_set_named_property(env, result, "modules", modules);
+    delete hw;
     return result;
 }
 
+napi_value GetMemoryHardware(napi_env env, napi_callback_info info) {
+    return BuildMemoryHardware(env, CollectMemoryHardware());
+}
+
 // Module Init
 napi_value Init(napi_env env, napi_value exports) {
     napi_property_descriptor props[] = {
@@ -916,9 +979,58 @@ napi_value Init(napi_env env, napi_value exports) {
         { "getDiskIO", 0, GetDiskIO, 0, 0, 0, napi_default, 0 },
         { "getNetworkStats", 0, GetNetworkStats, 0, 0, 0, napi_default, 0 },
         { "getNetworkConnections", 0, GetNetworkConnections, 0, 0, 0, napi_default, 0 },
+        { "getConnectionQuality", 0, GetConnectionQuality, 0, 0, 0, napi_default, 0 },
+        { "findPortOwner", 0, FindPortOwner, 0, 0, 0, napi_default, 0 },
+        { "getListeningPorts", 0, GetListeningPorts, 0, 0, 0, napi_default, 0 },
+        { "getListeningChanges", 0, GetListeningChanges, 0, 0, 0, napi_default, 0 },
         { "getProcessList", 0, GetProcessList, 0, 0, 0, napi_default, 0 },
+        { "getAnomalyEvents", 0, GetAnomalyEvents, 0, 0, 0, napi_default, 0 },
+        { "setAnomalyOptions", 0, SetAnomalyOptions, 0, 0, 0, napi_default, 0 },
+        { "addAlertRule", 0, AddAlertRule, 0, 0, 0, napi_default, 0 },
+        { "removeAlertRule", 0, RemoveAlertRule, 0, 0, 0, napi_default, 0 },
+        { "getAlertRules", 0, GetAlertRules, 0, 0, 0, napi_default, 0 },
+        { "setAlertCallback", 0, SetAlertCallback, 0, 0, 0, napi_default, 0 },
+        { "setAlertLog", 0, SetAlertLog, 0, 0, 0, napi_default, 0 },
+        { "getAllocatorStats", 0, GetAllocatorStats, 0, 0, 0, napi_default, 0 },
+        { "getSelfStats", 0, GetSelfStats, 0, 0, 0, napi_default, 0 },
+        { "getSchedule", 0, GetSchedule, 0, 0, 0, napi_default, 0 },
+        { "getSensors", 0, GetSensors, 0, 0, 0, napi_default, 0 },
+        { "getPressure", 0, GetPressure, 0, 0, 0, napi_default, 0 },
+        { "getProcessThreads", 0, GetProcessThreads, 0, 0, 0, napi_default, 0 },
+        { "getProcessHandles", 0, GetProcessHandles, 0, 0, 0, napi_default, 0 },
+        { "scanDirectory", 0, ScanDirectory, 0, 0, 0, napi_default, 0 },
+        { "cancelScan", 0, CancelScan, 0, 0, 0, napi_default, 0 },
+        { "setSchedule", 0, SetSchedule, 0, 0, 0, napi_default, 0 },
+        { "setReplay", 0, SetReplay, 0, 0, 0, napi_default, 0 },
+        { "setStream", 0, SetStream, 0, 0, 0, napi_default, 0 },
+        { "simulateAgents", 0, SimulateAgents, 0, 0, 0, napi_default, 0 },
+        { "setAggregator", 0, SetAggregator, 0, 0, 0, napi_default, 0 },
+        { "getAggregatedHosts", 0, GetAggregatedHosts, 0, 0, 0, napi_default, 0 },
+        { "queryMetric", 0, QueryMetric, 0, 0, 0, napi_default, 0 },
+        { "downsample", 0, Downsample, 0, 0, 0, napi_default, 0 },
+        { "getMetricNames", 0, GetMetricNames, 0, 0, 0, napi_default, 0 },
+        { "setSharedSnapshot", 0, SetSharedSnapshot, 0, 0, 0, napi_default, 0 },
+        { "getSharedSnapshot", 0, GetSharedSnapshot, 0, 0, 0, napi_default, 0 },
+        { "getInventoryCache", 0, GetInventoryCache, 0, 0, 0, napi_default, 0 },
+        { "setInventoryCache", 0, SetInventoryCache, 0, 0, 0, napi_default, 0 },
+        { "getPowerInfo", 0, GetPowerInfo, 0, 0, 0, napi_default, 0 },
+        { "getProcessDetails", 0, GetProcessDetails, 0, 0, 0, napi_default, 0 },
+        { "getCpuTopology", 0, GetCpuTopology, 0, 0, 0, napi_default, 0 },
+        { "getContainerInfo", 0, GetContainerInfo, 0, 0, 0, napi_default, 0 },
     };
+    SchedulerAttach(env, props, sizeof(props) / sizeof(props[0]));
+    InventoryLive("getCpuInfo", cpuInfoLiveFields, CpuInfoLive);
+    InventoryOffThread("getMemoryHardware", CollectMemoryHardware, BuildMemoryHardware);
+    InventoryAttach(env, props, sizeof(props) / sizeof(props[0]));
+    SelfStatsInstrument(props, sizeof(props) / sizeof(props[0]));
     napi_define_properties(env, exports, sizeof(props) / sizeof(props[0]), props);
+    DisksAttach(env);
+    NetworkAttach(env);
+    // One per snapshot section, in bit order
+    static const SnapshotSampler samplers[SNAP_SECTION_COUNT] = {
+        CpuSample, MemorySample, DisksSample, NetworkSample, ProcessesSample, SensorsSample, PressureSample,
+    };
+    SnapshotPumpAttach(env, samplers);
     return exports;
 }
 
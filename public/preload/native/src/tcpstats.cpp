@@ -0,0 +1,339 @@
+#include "tcpstats.h"
+#include "arena.h"
+#include "selfstats.h"
+#include "replay.h"
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <iphlpapi.h>
+#include <tcpestats.h>
+#include <stdio.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#pragma comment(lib, "iphlpapi.lib")
+
+static const ULONGLONG WATCH_IDLE_MS = 60000;
+static const size_t MAX_WATCHES = 16;
+static const size_t MAX_CONNECTIONS = 4096;
+static const size_t MAX_HOSTS = 256;
+
+struct PidWatch { DWORD pid; ULONGLONG lastMs; };
+static std::vector<PidWatch> watches;
+
+// IPv6 address; IPv4 ones are stored in their v4-mapped form (::ffff:a.b.c.d)
+struct Addr {
+    uint64_t hi, lo;
+    bool operator==(const Addr& o) const { return hi == o.hi && lo == o.lo; }
+    bool IsV4() const { return hi == 0 && (lo & 0xFFFFFFFFull) == 0xFFFF0000ull; }
+};
+struct AddrHash {
+    size_t operator()(const Addr& a) const { return (size_t)(a.hi * 0x9E3779B97F4A7C15ull ^ a.lo); }
+};
+
+static Addr V4(DWORD addr) {
+    // Network byte order in memory: 00.. ff ff a b c d
+    Addr a = { 0, 0 };
+    uint8_t bytes[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+    memcpy(bytes + 12, &addr, 4);
+    memcpy(&a, bytes, 16);
+    return a;
+}
+
+static Addr V6(const void* bytes) {
+    Addr a;
+    memcpy(&a, bytes, 16);
+    return a;
+}
+
+struct ConnKey {
+    Addr local, remote;
+    DWORD ports;                // local port << 16 | remote port
+    bool operator==(const ConnKey& o) const {
+        return local == o.local && remote == o.remote && ports == o.ports;
+    }
+};
+struct ConnKeyHash {
+    size_t operator()(const ConnKey& k) const {
+        AddrHash h;
+        return (h(k.remote) * 0x9E3779B1u) ^ (h(k.local) << 7) ^ k.ports;
+    }
+};
+
+// Cumulative counters of the previous read, per tracked connection
+struct ConnState {
+    uint32_t generation;
+    bool enabled, primed;
+    ULONG64 bytesIn, bytesOut;
+    ULONG retrans;
+};
+static std::unordered_map<ConnKey, ConnState, ConnKeyHash> conns;
+static uint32_t generation = 0;
+static bool accessDenied = false;
+
+struct HostAgg {
+    Addr addr;                  // :: = "(other)"
+    uint32_t connections, sampled, cwndCount;
+    double rttSum, rttMin, rttMax, cwndSum;
+    double retrans, bytesIn, bytesOut;
+};
+static std::vector<HostAgg> hosts;
+static std::unordered_map<Addr, uint32_t, AddrHash> hostIndex;
+static const Addr OTHER_HOST = { 0, 0 };
+
+static ReusableBuffer tcpBuffer("tcpQualityTable");
+static ReusableBuffer tcp6Buffer("tcp6QualityTable");
+static ULONGLONG lastCallMs = 0;
+
+static bool IsWatched(DWORD pid) {
+    for (auto& w : watches) if (w.pid == pid) return true;
+    return false;
+}
+
+static void Watch(DWORD pid, ULONGLONG now) {
+    for (auto& w : watches) {
+        if (w.pid == pid) { w.lastMs = now; return; }
+    }
+    if (watches.size() >= MAX_WATCHES) {
+        auto oldest = std::min_element(watches.begin(), watches.end(),
+            [](const PidWatch& a, const PidWatch& b) { return a.lastMs < b.lastMs; });
+        watches.erase(oldest);
+    }
+    watches.push_back({ pid, now });
+}
+
+// The IPv4 and IPv6 flavours of the extended statistics calls
+static ULONG SetEStats(MIB_TCPROW& row, TCP_ESTATS_TYPE type, void* rw, ULONG size) {
+    return SetPerTcpConnectionEStats(&row, type, (PUCHAR)rw, 0, size, 0);
+}
+static ULONG SetEStats(MIB_TCP6ROW& row, TCP_ESTATS_TYPE type, void* rw, ULONG size) {
+    return SetPerTcp6ConnectionEStats(&row, type, (PUCHAR)rw, 0, size, 0);
+}
+static ULONG GetEStats(MIB_TCPROW& row, TCP_ESTATS_TYPE type, void* rod, ULONG size) {
+    return GetPerTcpConnectionEStats(&row, type, nullptr, 0, 0, nullptr, 0, 0, (PUCHAR)rod, 0, size);
+}
+static ULONG GetEStats(MIB_TCP6ROW& row, TCP_ESTATS_TYPE type, void* rod, ULONG size) {
+    return GetPerTcp6ConnectionEStats(&row, type, nullptr, 0, 0, nullptr, 0, 0, (PUCHAR)rod, 0, size);
+}
+
+// Data, Path and SndCong collection; the first ERROR_ACCESS_DENIED disables further attempts
+template <typename Row>
+static bool SetCollection(Row& row, bool on) {
+    TCP_ESTATS_DATA_RW_v0 data = { (BOOLEAN)on };
+    TCP_ESTATS_PATH_RW_v0 path = { (BOOLEAN)on };
+    TCP_ESTATS_SND_CONG_RW_v0 cong = { (BOOLEAN)on };
+    ULONG rc = SetEStats(row, TcpConnectionEstatsData, &data, sizeof(data));
+    if (rc == NO_ERROR) rc = SetEStats(row, TcpConnectionEstatsPath, &path, sizeof(path));
+    if (rc == NO_ERROR) rc = SetEStats(row, TcpConnectionEstatsSndCong, &cong, sizeof(cong));
+    if (rc == ERROR_ACCESS_DENIED) accessDenied = true;
+    return rc == NO_ERROR;
+}
+
+static HostAgg& Host(const Addr& addr) {
+    auto it = hostIndex.find(addr);
+    if (it != hostIndex.end()) return hosts[it->second];
+    if (hosts.size() >= MAX_HOSTS && !(addr == OTHER_HOST)) return Host(OTHER_HOST);
+    hostIndex.emplace(addr, (uint32_t)hosts.size());
+    hosts.push_back({ addr, 0, 0, 0, 0, NAN, NAN, 0, 0, 0, 0 });
+    return hosts.back();
+}
+
+template <typename Row>
+static void Sample(HostAgg& h, Row& row, ConnState& s) {
+    TCP_ESTATS_DATA_ROD_v0 data;
+    TCP_ESTATS_PATH_ROD_v0 path;
+    TCP_ESTATS_SND_CONG_ROD_v0 cong;
+    if (GetEStats(row, TcpConnectionEstatsData, &data, sizeof(data)) != NO_ERROR) return;
+    if (GetEStats(row, TcpConnectionEstatsPath, &path, sizeof(path)) != NO_ERROR) return;
+    bool congOk = GetEStats(row, TcpConnectionEstatsSndCong, &cong, sizeof(cong)) == NO_ERROR;
+    // Counters start at enable time; the first read is only a baseline
+    if (s.primed) {
+        h.bytesIn += (double)(data.DataBytesIn - s.bytesIn);
+        h.bytesOut += (double)(data.DataBytesOut - s.bytesOut);
+        h.retrans += (double)(path.PktsRetrans - s.retrans);
+    }
+    s.bytesIn = data.DataBytesIn;
+    s.bytesOut = data.DataBytesOut;
+    s.retrans = path.PktsRetrans;
+    s.primed = true;
+
+    // No RTT sample yet on idle connections
+    if (path.CountRtt == 0) return;
+    h.sampled++;
+    h.rttSum += path.SmoothedRtt;
+    if (isnan(h.rttMin) || path.MinRtt < h.rttMin) h.rttMin = path.MinRtt;
+    if (isnan(h.rttMax) || path.MaxRtt > h.rttMax) h.rttMax = path.MaxRtt;
+    if (congOk) {
+        h.cwndSum += (double)cong.CurCwnd;
+        h.cwndCount++;
+    }
+}
+
+// One row of either table: starts, samples or stops collection for it
+template <typename Row>
+static void Track(const ConnKey& key, Row& row, bool established, DWORD pid, uint32_t& total, uint32_t& untracked) {
+    bool watched = established && IsWatched(pid);
+    auto it = conns.find(key);
+    if (!watched) {
+        // Watch lapsed: stop the kernel from collecting for this connection
+        if (it != conns.end()) {
+            if (it->second.enabled) SetCollection(row, false);
+            conns.erase(it);
+        }
+        return;
+    }
+    total++;
+    HostAgg& h = Host(key.remote);
+    h.connections++;
+    if (it == conns.end()) {
+        if (conns.size() >= MAX_CONNECTIONS) { untracked++; return; }
+        ConnState s = { generation, !accessDenied && SetCollection(row, true), false, 0, 0, 0 };
+        it = conns.emplace(key, s).first;
+    }
+    it->second.generation = generation;
+    if (it->second.enabled) Sample(h, row, it->second);
+}
+
+// GetExtendedTcpTable(family, TCP_TABLE_OWNER_PID_ALL) into `buf`, or the replayed table
+template <typename Table>
+static bool FetchTable(ReusableBuffer& buf, ULONG family) {
+    ReplayResult replay = ReplayFillTable(buf, offsetof(Table, table), sizeof(Table::table[0]));
+    if (replay != REPLAY_LIVE) return replay == REPLAY_SERVED;
+    SelfStatsQueryBegin();
+    ULONG size = (ULONG)buf.Size();
+    DWORD rc = GetExtendedTcpTable(buf.Data(), &size, FALSE, family, TCP_TABLE_OWNER_PID_ALL, 0);
+    for (int i = 0; i < 3 && rc == ERROR_INSUFFICIENT_BUFFER; i++) {
+        if (!buf.Reserve(size)) break;
+        size = (ULONG)buf.Size();
+        rc = GetExtendedTcpTable(buf.Data(), &size, FALSE, family, TCP_TABLE_OWNER_PID_ALL, 0);
+    }
+    SelfStatsQueryEnd(rc == NO_ERROR ? size : 0);
+    if (rc == NO_ERROR) ReplayCapture(buf, size);
+    return rc == NO_ERROR;
+}
+
+static void SetRtt(napi_env env, napi_value obj, const char* name, double ms) {
+    napi_value v;
+    if (isnan(ms)) napi_get_null(env, &v);
+    else napi_create_double(env, ms, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+napi_value GetConnectionQuality(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    ULONGLONG now = GetTickCount64();
+
+    if (argc > 0) {
+        bool isArray = false;
+        napi_is_array(env, argv[0], &isArray);
+        uint32_t pid, n = 1;
+        if (isArray) napi_get_array_length(env, argv[0], &n);
+        for (uint32_t i = 0; i < n; i++) {
+            napi_value item = argv[0];
+            if (isArray) napi_get_element(env, argv[0], i, &item);
+            if (napi_get_value_uint32(env, item, &pid) == napi_ok && pid != 0) Watch(pid, now);
+        }
+    }
+    watches.erase(std::remove_if(watches.begin(), watches.end(),
+        [&](const PidWatch& w) { return now - w.lastMs > WATCH_IDLE_MS; }), watches.end());
+
+    bool v4 = FetchTable<MIB_TCPTABLE_OWNER_PID>(tcpBuffer, AF_INET);
+    bool v6 = FetchTable<MIB_TCP6TABLE_OWNER_PID>(tcp6Buffer, AF_INET6);
+
+    hosts.clear();
+    hostIndex.clear();
+    generation++;
+    uint32_t total = 0, untracked = 0;
+    if (v4) {
+        auto table = (PMIB_TCPTABLE_OWNER_PID)tcpBuffer.Data();
+        for (DWORD i = 0; i < table->dwNumEntries; i++) {
+            auto& src = table->table[i];
+            ConnKey key = { V4(src.dwLocalAddr), V4(src.dwRemoteAddr), ((src.dwLocalPort & 0xFFFF) << 16) | (src.dwRemotePort & 0xFFFF) };
+            MIB_TCPROW row;
+            row.dwState = src.dwState;
+            row.dwLocalAddr = src.dwLocalAddr;
+            row.dwLocalPort = src.dwLocalPort;
+            row.dwRemoteAddr = src.dwRemoteAddr;
+            row.dwRemotePort = src.dwRemotePort;
+            Track(key, row, src.dwState == MIB_TCP_STATE_ESTAB, src.dwOwningPid, total, untracked);
+        }
+    }
+    if (v6) {
+        auto table = (PMIB_TCP6TABLE_OWNER_PID)tcp6Buffer.Data();
+        for (DWORD i = 0; i < table->dwNumEntries; i++) {
+            auto& src = table->table[i];
+            ConnKey key = { V6(src.ucLocalAddr), V6(src.ucRemoteAddr), ((src.dwLocalPort & 0xFFFF) << 16) | (src.dwRemotePort & 0xFFFF) };
+            MIB_TCP6ROW row;
+            row.State = (MIB_TCP_STATE)src.dwState;
+            memcpy(&row.LocalAddr, src.ucLocalAddr, 16);
+            row.dwLocalScopeId = src.dwLocalScopeId;
+            row.dwLocalPort = src.dwLocalPort;
+            memcpy(&row.RemoteAddr, src.ucRemoteAddr, 16);
+            row.dwRemoteScopeId = src.dwRemoteScopeId;
+            row.dwRemotePort = src.dwRemotePort;
+            Track(key, row, src.dwState == MIB_TCP_STATE_ESTAB, src.dwOwningPid, total, untracked);
+        }
+    }
+    // Closed connections
+    for (auto it = conns.begin(); it != conns.end(); ) {
+        if (it->second.generation != generation) it = conns.erase(it);
+        else ++it;
+    }
+
+    double window = lastCallMs ? (now - lastCallMs) / 1000.0 : 0;
+    lastCallMs = now;
+
+    // Slowest upstream first; hosts without RTT samples last
+    std::sort(hosts.begin(), hosts.end(), [](const HostAgg& a, const HostAgg& b) {
+        double ra = a.sampled ? a.rttSum / a.sampled : -1, rb = b.sampled ? b.rttSum / b.sampled : -1;
+        return ra != rb ? ra > rb : a.connections > b.connections;
+    });
+
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    napi_create_array(env, &list);
+    uint32_t idx = 0;
+    for (auto& w : watches) {
+        napi_create_uint32(env, w.pid, &v);
+        napi_set_element(env, list, idx++, v);
+    }
+    napi_set_named_property(env, result, "watched", list);
+    napi_get_boolean(env, !accessDenied, &v); napi_set_named_property(env, result, "enabled", v);
+    napi_create_double(env, window, &v); napi_set_named_property(env, result, "window", v);
+    napi_create_uint32(env, total, &v); napi_set_named_property(env, result, "connections", v);
+    napi_create_uint32(env, untracked, &v); napi_set_named_property(env, result, "untracked", v);
+
+    napi_create_array(env, &list);
+    idx = 0;
+    for (auto& h : hosts) {
+        napi_value item;
+        napi_create_object(env, &item);
+        char addr[INET6_ADDRSTRLEN] = "(other)";
+        if (h.addr.IsV4()) {
+            const uint8_t* b = (const uint8_t*)&h.addr + 12;
+            sprintf(addr, "%d.%d.%d.%d", b[0], b[1], b[2], b[3]);
+        } else if (!(h.addr == OTHER_HOST)) {
+            inet_ntop(AF_INET6, &h.addr, addr, sizeof(addr));
+        }
+        napi_create_string_utf8(env, addr, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "host", v);
+        napi_create_uint32(env, h.connections, &v); napi_set_named_property(env, item, "connections", v);
+        napi_create_uint32(env, h.sampled, &v); napi_set_named_property(env, item, "sampled", v);
+        SetRtt(env, item, "rtt", h.sampled ? h.rttSum / h.sampled : NAN);
+        SetRtt(env, item, "rttMin", h.rttMin);
+        SetRtt(env, item, "rttMax", h.rttMax);
+        napi_create_double(env, h.retrans, &v); napi_set_named_property(env, item, "retransmits", v);
+        napi_create_double(env, window > 0 ? h.retrans / window : 0, &v); napi_set_named_property(env, item, "retransmitsSec", v);
+        napi_create_double(env, window > 0 ? h.bytesIn / window : 0, &v); napi_set_named_property(env, item, "bytesInSec", v);
+        napi_create_double(env, window > 0 ? h.bytesOut / window : 0, &v); napi_set_named_property(env, item, "bytesOutSec", v);
+        napi_create_double(env, h.cwndCount ? h.cwndSum / h.cwndCount : 0, &v); napi_set_named_property(env, item, "cwnd", v);
+        napi_set_element(env, list, idx++, item);
+    }
+    napi_set_named_property(env, result, "hosts", list);
+    return result;
+}
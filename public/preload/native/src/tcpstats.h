@@ -0,0 +1,18 @@
+#ifndef TCPSTATS_H
+#define TCPSTATS_H
+
+#include <node_api.h>
+
+// getConnectionQuality(pid | [pid, ...]) - TCP health of the given
+// processes aggregated per remote host: smoothed/min/max RTT, retransmits,
+// throughput and congestion window over the window since the previous call.
+// Both IPv4 and IPv6 connections are covered; IPv6 hosts are reported in
+// their textual form, v4-mapped peers as plain IPv4.
+// Extended statistics (GetPerTcp[6]ConnectionEStats) are switched on only for
+// established connections of watched PIDs and switched off again when the
+// watch lapses (WATCH_IDLE_MS without a call). Enabling them needs admin
+// rights; without them only connection counts are reported (enabled: false).
+// Tracked connections and hosts are capped.
+napi_value GetConnectionQuality(napi_env env, napi_callback_info info);
+
+#endif // TCPSTATS_H
@@ -0,0 +1,199 @@
+#include "threads.h"
+#include "ntinfo.h"
+#include "selfstats.h"
+#include <windows.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+static const ULONGLONG WATCH_IDLE_MS = 30000;
+static const size_t MAX_WATCHES = 8;
+
+struct ThreadPrev { DWORD tid; ULONGLONG kernel, user; ULONG switches; };
+struct ThreadName { DWORD tid; std::string name; };
+
+struct ThreadWatch {
+    DWORD pid;
+    LONGLONG createTime;   // detects PID reuse
+    ULONGLONG lastMs;
+    std::vector<ThreadPrev> prev;
+    std::vector<ThreadName> names;
+};
+static std::vector<ThreadWatch> watches;
+static ReusableBuffer processBuffer("systemProcesses");
+
+// Per-call rows, reused between calls. Names are looked up by tid when the
+// rows are emitted: `names` grows and is compacted while the rows are built.
+struct ThreadRow {
+    DWORD tid;
+    double kernel, user, switchesSec;
+    ULONG state, waitReason;
+    LONG priority, basePriority;
+};
+static std::vector<ThreadRow> rows;
+static std::vector<ThreadPrev> nextPrev;
+
+static const char* threadStates[] = {
+    "initialized", "ready", "running", "standby", "terminated", "waiting",
+    "transition", "deferredReady", "gateWait", "waitingForProcessSwap",
+};
+
+static const char* waitReasons[] = {
+    "Executive", "FreePage", "PageIn", "PoolAllocation", "DelayExecution", "Suspended",
+    "UserRequest", "WrExecutive", "WrFreePage", "WrPageIn", "WrPoolAllocation",
+    "WrDelayExecution", "WrSuspended", "WrUserRequest", "WrEventPair", "WrQueue",
+    "WrLpcReceive", "WrLpcReply", "WrVirtualMemory", "WrPageOut", "WrRendezvous",
+    "WrKeyedEvent", "WrTerminated", "WrProcessInSwap", "WrCpuRateControl",
+    "WrCalloutStack", "WrKernel", "WrResource", "WrPushLock", "WrMutex",
+    "WrQuantumEnd", "WrDispatchInt", "WrPreempted", "WrYieldExecution",
+    "WrFastMutex", "WrGuardedMutex", "WrRundown", "WrAlertByThreadId", "WrDeferredPreempt",
+};
+
+typedef HRESULT (WINAPI *GetThreadDescriptionFn)(HANDLE, PWSTR*);
+
+// Thread description (SetThreadDescription), Windows 10 1607+
+static std::string ReadThreadName(DWORD tid) {
+    static GetThreadDescriptionFn getDesc = (GetThreadDescriptionFn)
+        GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "GetThreadDescription");
+    std::string name;
+    if (!getDesc) return name;
+    HANDLE h = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, tid);
+    if (!h) return name;
+    PWSTR desc = nullptr;
+    if (SUCCEEDED(getDesc(h, &desc)) && desc) {
+        int len = WideCharToMultiByte(CP_UTF8, 0, desc, -1, nullptr, 0, nullptr, nullptr);
+        if (len > 1) {
+            name.resize(len - 1);
+            WideCharToMultiByte(CP_UTF8, 0, desc, -1, &name[0], len, nullptr, nullptr);
+        }
+        LocalFree(desc);
+    }
+    CloseHandle(h);
+    return name;
+}
+
+static void CacheThreadName(ThreadWatch& w, DWORD tid) {
+    for (auto& n : w.names) if (n.tid == tid) return;
+    w.names.push_back({ tid, ReadThreadName(tid) });
+}
+
+static const char* CachedThreadName(const ThreadWatch& w, DWORD tid) {
+    for (auto& n : w.names) if (n.tid == tid) return n.name.c_str();
+    return "";
+}
+
+static ThreadWatch& Watch(DWORD pid, ULONGLONG now) {
+    // Drop idle watches
+    watches.erase(std::remove_if(watches.begin(), watches.end(),
+        [&](const ThreadWatch& w) { return w.pid != pid && now - w.lastMs > WATCH_IDLE_MS; }), watches.end());
+    for (auto& w : watches) if (w.pid == pid) return w;
+    if (watches.size() >= MAX_WATCHES) {
+        auto oldest = std::min_element(watches.begin(), watches.end(),
+            [](const ThreadWatch& a, const ThreadWatch& b) { return a.lastMs < b.lastMs; });
+        watches.erase(oldest);
+    }
+    watches.push_back({ pid, 0, 0, {}, {} });
+    return watches.back();
+}
+
+napi_value GetProcessThreads(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t pid = 0;
+    if (argc > 0) napi_get_value_uint32(env, argv[0], &pid);
+
+    napi_value result, list, v;
+    napi_create_object(env, &result);
+    napi_create_array(env, &list);
+    napi_create_uint32(env, pid, &v); napi_set_named_property(env, result, "pid", v);
+    if (pid == 0) {
+        napi_get_boolean(env, false, &v); napi_set_named_property(env, result, "found", v);
+        napi_set_named_property(env, result, "threads", list);
+        return result;
+    }
+
+    ULONGLONG now = GetTickCount64();
+    SelfStatsQueryBegin();
+    const NtProcessInfo* p = NtQueryProcesses(processBuffer);
+    while (p && (DWORD)(ULONG_PTR)p->UniqueProcessId != pid) p = p->Next();
+    SelfStatsQueryEnd(p ? p->NumberOfThreads * sizeof(NtThreadInfo) : 0);
+
+    if (!p) {
+        // Process is gone; forget its state
+        watches.erase(std::remove_if(watches.begin(), watches.end(),
+            [&](const ThreadWatch& w) { return w.pid == pid; }), watches.end());
+        napi_get_boolean(env, false, &v); napi_set_named_property(env, result, "found", v);
+        napi_set_named_property(env, result, "threads", list);
+        return result;
+    }
+
+    ThreadWatch& w = Watch(pid, now);
+    if (w.createTime != p->CreateTime.QuadPart) {
+        w.createTime = p->CreateTime.QuadPart;
+        w.lastMs = 0;
+        w.prev.clear();
+        w.names.clear();
+    }
+    // Rates are per core: 100 means one thread kept one CPU busy
+    double window100ns = w.lastMs ? (now - w.lastMs) * 10000.0 : 0;
+
+    rows.clear();
+    nextPrev.clear();
+    const NtThreadInfo* t = p->Threads();
+    for (ULONG i = 0; i < p->NumberOfThreads; i++) {
+        DWORD tid = (DWORD)(ULONG_PTR)t[i].UniqueThread;
+        ULONGLONG kernel = t[i].KernelTime.QuadPart, user = t[i].UserTime.QuadPart;
+        CacheThreadName(w, tid);
+        ThreadRow r = { tid, 0, 0, 0, t[i].ThreadState, t[i].WaitReason, t[i].Priority, t[i].BasePriority };
+        if (window100ns > 0) {
+            for (auto& prev : w.prev) {
+                if (prev.tid != tid) continue;
+                r.kernel = kernel >= prev.kernel ? (kernel - prev.kernel) / window100ns * 100.0 : 0;
+                r.user = user >= prev.user ? (user - prev.user) / window100ns * 100.0 : 0;
+                r.switchesSec = (t[i].ContextSwitches - prev.switches) / (window100ns / 1e7);
+                break;
+            }
+        }
+        rows.push_back(r);
+        nextPrev.push_back({ tid, kernel, user, t[i].ContextSwitches });
+    }
+    w.prev.swap(nextPrev);
+    // Names of exited threads
+    w.names.erase(std::remove_if(w.names.begin(), w.names.end(), [&](const ThreadName& n) {
+        for (auto& r : rows) if (r.tid == n.tid) return false;
+        return true;
+    }), w.names.end());
+    w.lastMs = now;
+
+    std::sort(rows.begin(), rows.end(), [](const ThreadRow& a, const ThreadRow& b) {
+        return a.kernel + a.user > b.kernel + b.user;
+    });
+
+    uint32_t idx = 0;
+    for (auto& r : rows) {
+        napi_value item;
+        napi_create_object(env, &item);
+        napi_create_uint32(env, r.tid, &v); napi_set_named_property(env, item, "tid", v);
+        napi_create_string_utf8(env, CachedThreadName(w, r.tid), NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "name", v);
+        napi_create_double(env, r.kernel + r.user, &v); napi_set_named_property(env, item, "cpu", v);
+        napi_create_double(env, r.kernel, &v); napi_set_named_property(env, item, "kernel", v);
+        napi_create_double(env, r.user, &v); napi_set_named_property(env, item, "user", v);
+        napi_create_double(env, r.switchesSec, &v); napi_set_named_property(env, item, "contextSwitchesSec", v);
+        const char* state = r.state < sizeof(threadStates) / sizeof(threadStates[0]) ? threadStates[r.state] : "unknown";
+        // A waiting thread whose wait reason is Suspended is reported as such
+        if (r.state == 5 && (r.waitReason == 5 || r.waitReason == 12)) state = "suspended";
+        napi_create_string_utf8(env, state, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "state", v);
+        const char* reason = r.state == 5 && r.waitReason < sizeof(waitReasons) / sizeof(waitReasons[0]) ? waitReasons[r.waitReason] : "";
+        napi_create_string_utf8(env, reason, NAPI_AUTO_LENGTH, &v); napi_set_named_property(env, item, "waitReason", v);
+        napi_create_int32(env, r.priority, &v); napi_set_named_property(env, item, "priority", v);
+        napi_create_int32(env, r.basePriority, &v); napi_set_named_property(env, item, "basePriority", v);
+        napi_set_element(env, list, idx++, item);
+    }
+
+    napi_get_boolean(env, true, &v); napi_set_named_property(env, result, "found", v);
+    napi_create_double(env, window100ns / 1e7, &v); napi_set_named_property(env, result, "window", v);
+    napi_create_uint32(env, (uint32_t)rows.size(), &v); napi_set_named_property(env, result, "count", v);
+    napi_set_named_property(env, result, "threads", list);
+    return result;
+}
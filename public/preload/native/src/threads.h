@@ -0,0 +1,13 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <node_api.h>
+
+// getProcessThreads(pid) - per-thread CPU of one process.
+// Calling it starts watching the process: the first call only records a
+// baseline, later calls return rates over the time since the previous one.
+// Delta state is kept only for watched processes and dropped after
+// WATCH_IDLE_MS without a call.
+napi_value GetProcessThreads(napi_env env, napi_callback_info info);
+
+#endif // THREADS_H
@@ -0,0 +1,413 @@
+#include "topology.h"
+#include "selfstats.h"
+#include <windows.h>
+#include <pdh.h>
+#include <stdio.h>
+#include <array>
+#include <algorithm>
+
+static CpuTopology topo;
+static bool topoBuilt = false;
+
+// Flat index of (group, processor number), TOPO_NONE if not active
+static std::vector<std::array<uint32_t, 64>> groupIndex;
+
+static uint32_t Index(WORD group, uint32_t bit) {
+    return group < groupIndex.size() && bit < 64 ? groupIndex[group][bit] : TOPO_NONE;
+}
+
+template <typename Fn>
+static void ForEachProcessor(const GROUP_AFFINITY& ga, Fn fn) {
+    for (uint32_t bit = 0; bit < 64; bit++) {
+        if (!((ga.Mask >> bit) & 1)) continue;
+        uint32_t idx = Index(ga.Group, bit);
+        if (idx != TOPO_NONE) fn(topo.processors[idx]);
+    }
+}
+
+// One socket / core / node per processor when the Ex API is unavailable
+static void BuildFlat() {
+    SYSTEM_INFO si; GetNativeSystemInfo(&si);
+    groupIndex.assign(1, {});
+    groupIndex[0].fill(TOPO_NONE);
+    for (uint32_t i = 0; i < si.dwNumberOfProcessors && i < 64; i++) {
+        groupIndex[0][i] = i;
+        topo.processors.push_back({ 0, (uint8_t)i, 0, 0, 0, 0, i, TOPO_NONE });
+    }
+    topo.sockets = 1;
+    topo.cores = (uint32_t)topo.processors.size();
+}
+
+static void Build() {
+    topoBuilt = true;
+    topo.nodeNumbers.clear();
+    DWORD len = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &len);
+    std::vector<BYTE> buffer(len);
+    if (!len || !GetLogicalProcessorInformationEx(RelationAll, (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer.data(), &len)) {
+        BuildFlat();
+        topo.nodeNumbers.push_back(0);
+        return;
+    }
+    auto each = [&](auto fn) {
+        for (DWORD off = 0; off < len;) {
+            auto* info = (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(buffer.data() + off);
+            fn(*info);
+            off += info->Size;
+        }
+    };
+
+    // Groups first: they define the flat order
+    each([&](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& info) {
+        if (info.Relationship != RelationGroup) return;
+        for (WORD g = 0; g < info.Group.ActiveGroupCount; g++) {
+            std::array<uint32_t, 64> index;
+            index.fill(TOPO_NONE);
+            KAFFINITY mask = info.Group.GroupInfo[g].ActiveProcessorMask;
+            for (uint32_t bit = 0; bit < 64; bit++) {
+                if (!((mask >> bit) & 1)) continue;
+                index[bit] = (uint32_t)topo.processors.size();
+                topo.processors.push_back({ g, (uint8_t)bit, 0, 0, 0, 0, 0, TOPO_NONE });
+            }
+            groupIndex.push_back(index);
+        }
+    });
+    if (topo.processors.empty()) {
+        BuildFlat();
+        topo.nodeNumbers.push_back(0);
+        return;
+    }
+
+    uint8_t minClass = 255, maxClass = 0;
+    each([&](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& info) {
+        switch (info.Relationship) {
+        case RelationProcessorPackage: {
+            uint32_t id = topo.sockets++;
+            for (WORD g = 0; g < info.Processor.GroupCount; g++)
+                ForEachProcessor(info.Processor.GroupMask[g], [&](TopoProcessor& p) { p.socket = id; });
+            break;
+        }
+        case RelationProcessorCore: {
+            uint32_t id = topo.cores++;
+            uint8_t rank = 0;
+            BYTE cls = info.Processor.EfficiencyClass;
+            minClass = std::min<uint8_t>(minClass, cls);
+            maxClass = std::max<uint8_t>(maxClass, cls);
+            if (info.Processor.Flags & LTP_PC_SMT) topo.smt = true;
+            for (WORD g = 0; g < info.Processor.GroupCount; g++) {
+                ForEachProcessor(info.Processor.GroupMask[g], [&](TopoProcessor& p) {
+                    p.core = id;
+                    p.sibling = rank++;
+                    p.efficiency = cls;
+                });
+            }
+            break;
+        }
+        case RelationNumaNode: {
+            // A node spanning groups is reported once per group
+            auto it = std::find(topo.nodeNumbers.begin(), topo.nodeNumbers.end(), info.NumaNode.NodeNumber);
+            uint32_t id = (uint32_t)(it - topo.nodeNumbers.begin());
+            if (it == topo.nodeNumbers.end()) topo.nodeNumbers.push_back(info.NumaNode.NodeNumber);
+            ForEachProcessor(info.NumaNode.GroupMask, [&](TopoProcessor& p) { p.node = id; });
+            break;
+        }
+        case RelationCache:
+            if (info.Cache.Level == 3) {
+                uint32_t id = (uint32_t)topo.l3Sizes.size();
+                topo.l3Sizes.push_back(info.Cache.CacheSize);
+                ForEachProcessor(info.Cache.GroupMask, [&](TopoProcessor& p) { p.l3 = id; });
+            }
+            break;
+        default:
+            break;
+        }
+    });
+    if (topo.sockets == 0) topo.sockets = 1;
+    if (topo.nodeNumbers.empty()) topo.nodeNumbers.push_back(0);
+    topo.hybrid = topo.cores > 0 && minClass != maxClass;
+}
+
+const CpuTopology& TopologyGet() {
+    if (!topoBuilt) Build();
+    return topo;
+}
+
+// ---- Per-processor load ----
+static PDH_HQUERY perCoreQuery = NULL;
+static std::vector<PDH_HCOUNTER> perCoreCounters;
+static bool perCoreInit = false;
+static std::vector<double> lastPerCoreLoad;
+static ULONGLONG lastPerCoreSample = 0;
+
+static void SamplePerCore() {
+    const CpuTopology& t = TopologyGet();
+    size_t count = t.processors.size();
+
+    if (!perCoreInit) {
+        lastPerCoreLoad.resize(count, 0);
+        if (PdhOpenQuery(NULL, 0, &perCoreQuery) == ERROR_SUCCESS) {
+            perCoreCounters.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                wchar_t path[256];
+                // Try Processor Information first (modern, matches Task Manager)
+                swprintf(path, 256, L"\\Processor Information(%u,%u)\\%% Processor Utility",
+                         (unsigned)t.processors[i].group, (unsigned)t.processors[i].number);
+                if (PdhAddEnglishCounterW(perCoreQuery, path, 0, &perCoreCounters[i]) != ERROR_SUCCESS) {
+                    // Fallback to old Processor counter
+                    swprintf(path, 256, L"\\Processor(%u)\\%% Processor Time", (unsigned)i);
+                    PdhAddEnglishCounterW(perCoreQuery, path, 0, &perCoreCounters[i]);
+                }
+            }
+            PdhCollectQueryData(perCoreQuery); // First call to initialize
+        } else {
+            perCoreQuery = NULL;
+        }
+        perCoreInit = true;
+    }
+
+    if (perCoreQuery) {
+        SelfStatsQueryBegin();
+        if (PdhCollectQueryData(perCoreQuery) == ERROR_SUCCESS) {
+            for (size_t i = 0; i < count; i++) {
+                if (perCoreCounters[i]) {
+                    PDH_FMT_COUNTERVALUE value;
+                    if (PdhGetFormattedCounterValue(perCoreCounters[i], PDH_FMT_DOUBLE, NULL, &value) == ERROR_SUCCESS) {
+                        double load = value.doubleValue;
+                        if (load < 0) load = 0;
+                        if (load > 100) load = 100;
+                        lastPerCoreLoad[i] = load;
+                    }
+                }
+            }
+        }
+        SelfStatsQueryEnd(count * sizeof(PDH_FMT_COUNTERVALUE));
+    }
+    lastPerCoreSample = GetTickCount64();
+}
+
+napi_value GetPerCoreUsage(napi_env env, napi_callback_info info) {
+    napi_value result; napi_create_array(env, &result);
+    SamplePerCore();
+    for (size_t i = 0; i < lastPerCoreLoad.size(); i++) {
+        napi_value v;
+        napi_create_double(env, lastPerCoreLoad[i], &v);
+        napi_set_element(env, result, (uint32_t)i, v);
+    }
+    return result;
+}
+
+// ---- NUMA node memory ----
+struct NodeMemory { double total, available; bool valid; };
+static PDH_HQUERY nodeQuery = NULL;
+static std::vector<PDH_HCOUNTER> nodeTotal, nodeAvailable;
+static bool nodeInit = false;
+
+static void SampleNodeMemory(std::vector<NodeMemory>& out) {
+    const CpuTopology& t = TopologyGet();
+    size_t count = t.nodeNumbers.size();
+    if (!nodeInit) {
+        nodeInit = true;
+        if (PdhOpenQuery(NULL, 0, &nodeQuery) == ERROR_SUCCESS) {
+            nodeTotal.assign(count, NULL);
+            nodeAvailable.assign(count, NULL);
+            for (size_t i = 0; i < count; i++) {
+                wchar_t path[128];
+                swprintf(path, 128, L"\\NUMA Node Memory(%u)\\Total MBytes", (unsigned)t.nodeNumbers[i]);
+                if (PdhAddEnglishCounterW(nodeQuery, path, 0, &nodeTotal[i]) != ERROR_SUCCESS) nodeTotal[i] = NULL;
+                swprintf(path, 128, L"\\NUMA Node Memory(%u)\\Available MBytes", (unsigned)t.nodeNumbers[i]);
+                if (PdhAddEnglishCounterW(nodeQuery, path, 0, &nodeAvailable[i]) != ERROR_SUCCESS) nodeAvailable[i] = NULL;
+            }
+        } else {
+            nodeQuery = NULL;
+        }
+    }
+
+    out.assign(count, { 0, 0, false });
+    bool collected = nodeQuery && PdhCollectQueryData(nodeQuery) == ERROR_SUCCESS;
+    for (size_t i = 0; i < count; i++) {
+        PDH_FMT_COUNTERVALUE total, available;
+        if (collected && nodeTotal[i] && nodeAvailable[i] &&
+            PdhGetFormattedCounterValue(nodeTotal[i], PDH_FMT_DOUBLE, NULL, &total) == ERROR_SUCCESS &&
+            PdhGetFormattedCounterValue(nodeAvailable[i], PDH_FMT_DOUBLE, NULL, &available) == ERROR_SUCCESS) {
+            out[i] = { total.doubleValue * 1048576, available.doubleValue * 1048576, true };
+            continue;
+        }
+        // No counters: free memory only
+        ULONGLONG bytes = 0;
+        if (GetNumaAvailableMemoryNodeEx((USHORT)t.nodeNumbers[i], &bytes)) out[i] = { 0, (double)bytes, true };
+    }
+}
+
+// ---- Export ----
+struct LoadSum {
+    double sum = 0;
+    uint32_t count = 0;
+    void Add(double v) { sum += v; count++; }
+    double Load() const { return count ? sum / count : 0; }
+};
+
+static double Spread(const std::vector<LoadSum>& groups) {
+    double lo = 0, hi = 0;
+    bool any = false;
+    for (auto& g : groups) {
+        if (!g.count) continue;
+        double v = g.Load();
+        if (!any || v < lo) lo = v;
+        if (!any || v > hi) hi = v;
+        any = true;
+    }
+    return hi - lo;
+}
+
+static void SetUint(napi_env env, napi_value obj, const char* name, uint32_t value) {
+    napi_value v;
+    if (value == TOPO_NONE) napi_get_null(env, &v);
+    else napi_create_uint32(env, value, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+static void SetDouble(napi_env env, napi_value obj, const char* name, double value) {
+    napi_value v;
+    napi_create_double(env, value, &v);
+    napi_set_named_property(env, obj, name, v);
+}
+
+napi_value GetCpuTopology(napi_env env, napi_callback_info info) {
+    const CpuTopology& t = TopologyGet();
+    // getPerCoreUsage may have sampled just now; PDH needs some spacing anyway
+    if (!lastPerCoreSample || GetTickCount64() - lastPerCoreSample >= 500) SamplePerCore();
+    std::vector<NodeMemory> memory;
+    SampleNodeMemory(memory);
+
+    size_t count = t.processors.size();
+    std::vector<LoadSum> cores(t.cores), caches(t.l3Sizes.size()), nodes(t.nodeNumbers.size()), sockets(t.sockets);
+    std::vector<uint32_t> coreFirst(t.cores, TOPO_NONE), cacheFirst(caches.size(), TOPO_NONE), nodeFirst(nodes.size(), TOPO_NONE);
+    std::vector<uint32_t> socketCores(t.sockets, 0), nodeCores(nodes.size(), 0);
+    for (size_t i = 0; i < count; i++) {
+        const TopoProcessor& p = t.processors[i];
+        double load = i < lastPerCoreLoad.size() ? lastPerCoreLoad[i] : 0;
+        if (p.core < cores.size()) {
+            cores[p.core].Add(load);
+            if (coreFirst[p.core] == TOPO_NONE) {
+                coreFirst[p.core] = (uint32_t)i;
+                if (p.socket < t.sockets) socketCores[p.socket]++;
+                if (p.node < nodes.size()) nodeCores[p.node]++;
+            }
+        }
+        if (p.l3 < caches.size()) {
+            caches[p.l3].Add(load);
+            if (cacheFirst[p.l3] == TOPO_NONE) cacheFirst[p.l3] = (uint32_t)i;
+        }
+        if (p.node < nodes.size()) {
+            nodes[p.node].Add(load);
+            if (nodeFirst[p.node] == TOPO_NONE) nodeFirst[p.node] = (uint32_t)i;
+        }
+        if (p.socket < sockets.size()) sockets[p.socket].Add(load);
+    }
+
+    napi_value result, arr, v;
+    napi_create_object(env, &result);
+    napi_create_uint32(env, (uint32_t)count, &v); napi_set_named_property(env, result, "logical", v);
+    napi_get_boolean(env, t.smt, &v); napi_set_named_property(env, result, "smt", v);
+    napi_get_boolean(env, t.hybrid, &v); napi_set_named_property(env, result, "hybrid", v);
+
+    napi_create_array_with_length(env, count, &arr);
+    for (size_t i = 0; i < count; i++) {
+        const TopoProcessor& p = t.processors[i];
+        napi_value o; napi_create_object(env, &o);
+        SetUint(env, o, "index", (uint32_t)i);
+        SetUint(env, o, "group", p.group);
+        SetUint(env, o, "number", p.number);
+        SetUint(env, o, "socket", p.socket);
+        SetUint(env, o, "node", t.nodeNumbers[p.node]);
+        SetUint(env, o, "core", p.core);
+        SetUint(env, o, "l3", p.l3);
+        SetUint(env, o, "sibling", p.sibling);
+        SetUint(env, o, "efficiencyClass", p.efficiency);
+        SetDouble(env, o, "load", i < lastPerCoreLoad.size() ? lastPerCoreLoad[i] : 0);
+        napi_set_element(env, arr, (uint32_t)i, o);
+    }
+    napi_set_named_property(env, result, "processors", arr);
+
+    napi_create_array_with_length(env, cores.size(), &arr);
+    for (size_t c = 0; c < cores.size(); c++) {
+        napi_value o, logical; napi_create_object(env, &o);
+        napi_create_array(env, &logical);
+        uint32_t n = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (t.processors[i].core != c) continue;
+            napi_create_uint32(env, (uint32_t)i, &v);
+            napi_set_element(env, logical, n++, v);
+        }
+        const TopoProcessor* first = coreFirst[c] != TOPO_NONE ? &t.processors[coreFirst[c]] : nullptr;
+        SetUint(env, o, "id", (uint32_t)c);
+        SetUint(env, o, "socket", first ? first->socket : TOPO_NONE);
+        SetUint(env, o, "node", first ? t.nodeNumbers[first->node] : TOPO_NONE);
+        SetUint(env, o, "l3", first ? first->l3 : TOPO_NONE);
+        SetUint(env, o, "efficiencyClass", first ? first->efficiency : TOPO_NONE);
+        napi_set_named_property(env, o, "logical", logical);
+        SetDouble(env, o, "load", cores[c].Load());
+        napi_set_element(env, arr, (uint32_t)c, o);
+    }
+    napi_set_named_property(env, result, "cores", arr);
+
+    napi_create_array_with_length(env, caches.size(), &arr);
+    for (size_t c = 0; c < caches.size(); c++) {
+        napi_value o; napi_create_object(env, &o);
+        SetUint(env, o, "id", (uint32_t)c);
+        SetDouble(env, o, "size", (double)t.l3Sizes[c]);
+        SetUint(env, o, "socket", cacheFirst[c] != TOPO_NONE ? t.processors[cacheFirst[c]].socket : TOPO_NONE);
+        SetUint(env, o, "logical", caches[c].count);
+        SetDouble(env, o, "load", caches[c].Load());
+        napi_set_element(env, arr, (uint32_t)c, o);
+    }
+    napi_set_named_property(env, result, "caches", arr);
+
+    napi_create_array_with_length(env, nodes.size(), &arr);
+    for (size_t n = 0; n < nodes.size(); n++) {
+        napi_value o, mem; napi_create_object(env, &o);
+        SetUint(env, o, "id", t.nodeNumbers[n]);
+        SetUint(env, o, "socket", nodeFirst[n] != TOPO_NONE ? t.processors[nodeFirst[n]].socket : TOPO_NONE);
+        SetUint(env, o, "cores", nodeCores[n]);
+        SetUint(env, o, "logical", nodes[n].count);
+        SetDouble(env, o, "load", nodes[n].Load());
+        if (memory[n].valid) {
+            napi_create_object(env, &mem);
+            const NodeMemory& m = memory[n];
+            if (m.total > 0) {
+                SetDouble(env, mem, "total", m.total);
+                SetDouble(env, mem, "used", m.total - m.available);
+                SetDouble(env, mem, "usedPercent", (m.total - m.available) / m.total * 100);
+            } else {
+                napi_get_null(env, &v);
+                napi_set_named_property(env, mem, "total", v);
+                napi_set_named_property(env, mem, "used", v);
+                napi_set_named_property(env, mem, "usedPercent", v);
+            }
+            SetDouble(env, mem, "available", m.available);
+        } else {
+            napi_get_null(env, &mem);
+        }
+        napi_set_named_property(env, o, "memory", mem);
+        napi_set_element(env, arr, (uint32_t)n, o);
+    }
+    napi_set_named_property(env, result, "nodes", arr);
+
+    napi_create_array_with_length(env, sockets.size(), &arr);
+    for (size_t s = 0; s < sockets.size(); s++) {
+        napi_value o; napi_create_object(env, &o);
+        SetUint(env, o, "id", (uint32_t)s);
+        SetUint(env, o, "cores", socketCores[s]);
+        SetUint(env, o, "logical", sockets[s].count);
+        SetDouble(env, o, "load", sockets[s].Load());
+        napi_set_element(env, arr, (uint32_t)s, o);
+    }
+    napi_set_named_property(env, result, "sockets", arr);
+
+    napi_value imbalance; napi_create_object(env, &imbalance);
+    SetDouble(env, imbalance, "socket", Spread(sockets));
+    SetDouble(env, imbalance, "node", Spread(nodes));
+    SetDouble(env, imbalance, "l3", Spread(caches));
+    napi_set_named_property(env, result, "imbalance", imbalance);
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <node_api.h>
+#include <stdint.h>
+#include <vector>
+
+// CPU topology and per-NUMA-node memory.
+// The layout is read once with GetLogicalProcessorInformationEx: every
+// logical processor of every processor group gets a flat index (the order
+// of getPerCoreUsage) plus its socket, NUMA node, physical core, L3 domain
+// and SMT sibling rank. Loads come from the "Processor Information(g,n)"
+// counters, so boxes with more than 64 logical processors are covered.
+static const uint32_t TOPO_NONE = 0xFFFFFFFF;
+
+struct TopoProcessor {
+    uint16_t group;
+    uint8_t number;             // within the group
+    uint8_t sibling;            // SMT rank within the core (0 = first thread)
+    uint8_t efficiency;         // EfficiencyClass; higher = faster on hybrid parts
+    uint32_t socket, node, core, l3;    // dense ids; l3 is TOPO_NONE without one
+};
+
+struct CpuTopology {
+    std::vector<TopoProcessor> processors;
+    std::vector<uint32_t> nodeNumbers;  // dense node id -> OS node number
+    std::vector<uint64_t> l3Sizes;      // bytes, per L3 domain
+    uint32_t sockets = 0, cores = 0;
+    bool smt = false, hybrid = false;
+};
+
+const CpuTopology& TopologyGet();
+
+// getPerCoreUsage() -> [load] per logical processor, in topology order
+napi_value GetPerCoreUsage(napi_env env, napi_callback_info info);
+// getCpuTopology() -> { logical, smt, hybrid, processors: [{ index, group,
+//   number, socket, node, core, l3, sibling, efficiencyClass, load }],
+//   cores, caches, nodes (with memory), sockets: [{ id, ..., load }],
+//   imbalance: { socket, node, l3 } }
+// Group loads average their processors; imbalance is max - min in points.
+napi_value GetCpuTopology(napi_env env, napi_callback_info info);
+
+#endif // TOPOLOGY_H
@@ -0,0 +1,386 @@
+#include "wire.h"
+#include <ws2tcpip.h>
+#include <afunix.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+static const size_t MAX_DICT = 65536;
+static const size_t MAX_ROWS = 65536;
+
+const WireField wireHostFields[WIRE_HOST_FIELDS] = {
+    { "cpu", 100 },
+    { "memTotal", 1.0 / 1024 }, { "memUsed", 1.0 / 1024 }, { "memFree", 1.0 / 1024 },
+    { "memUsedPercent", 100 },
+    { "memCommitted", 1.0 / 1024 }, { "swapUsed", 1.0 / 1024 },
+    { "cpuTemp", 10 }, { "cpuFreq", 1 }, { "cpuPerf", 10 }, { "perfLimit", 10 },
+    { "pageFaultsSec", 1 }, { "hardFaultsSec", 1 }, { "pagesSec", 1 },
+    { "runQueue", 100 }, { "diskQueue", 100 },
+};
+
+// Sizes in MiB; a proc's working set jitters by pages every second
+static const double MIB = 1.0 / (1024 * 1024);
+static const WireField diskFields[] = {
+    { "size", MIB }, { "used", MIB }, { "free", MIB }, { "usedPercent", 100 }, { "timeToFull", 1 },
+};
+static const WireField netFields[] = {
+    { "rxSec", 1 }, { "txSec", 1 }, { "utilization", 100 },
+};
+static const WireField procFields[] = {
+    { "name", 1 }, { "cpu", 10 }, { "memory", MIB }, { "handles", 1 }, { "threads", 1 },
+};
+const WireField* const wireListFields[WIRE_LISTS] = { diskFields, netFields, procFields };
+const int wireListFieldCount[WIRE_LISTS] = { 5, 3, 5 };
+
+// ---- Varints ----
+
+static void PutVar(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+// Deltas wrap so that WIRE_NAN round-trips
+static void PutDelta(std::vector<uint8_t>& out, int64_t now, int64_t prev) {
+    int64_t d = (int64_t)((uint64_t)now - (uint64_t)prev);
+    PutVar(out, ((uint64_t)d << 1) ^ (uint64_t)(d >> 63));
+}
+
+static void PutStr(std::vector<uint8_t>& out, const char* s, size_t len) {
+    PutVar(out, len);
+    out.insert(out.end(), (const uint8_t*)s, (const uint8_t*)s + len);
+}
+
+struct WireReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t Var() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) break;
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    int64_t Apply(int64_t prev) {
+        uint64_t z = Var();
+        int64_t d = (int64_t)((z >> 1) ^ (0 - (z & 1)));
+        return (int64_t)((uint64_t)prev + (uint64_t)d);
+    }
+    uint8_t Byte() {
+        if (p >= end) { ok = false; return 0; }
+        return *p++;
+    }
+    bool Str(std::string& s) {
+        uint64_t len = Var();
+        if (!ok || len > (uint64_t)(end - p)) return ok = false;
+        s.assign((const char*)p, (size_t)len);
+        p += len;
+        return true;
+    }
+    // A count can't exceed the bytes left: guards allocations against garbage
+    uint64_t Count() {
+        uint64_t n = Var();
+        if (n > (uint64_t)(end - p)) ok = false;
+        return ok ? n : 0;
+    }
+};
+
+static int64_t Quantize(double v, double scale) {
+    if (isnan(v)) return WIRE_NAN;
+    double q = v * scale;
+    if (q > 4e18) q = 4e18;
+    if (q < -4e18) q = -4e18;
+    return llround(q);
+}
+
+double WireValue(int64_t q, double scale) {
+    return q == WIRE_NAN ? NAN : (double)q / scale;
+}
+
+// ---- Encoder ----
+
+struct WireCur {
+    uint64_t key;
+    int64_t f[WIRE_MAX_FIELDS];
+};
+
+WireEncoder::WireEncoder() {
+    memset(host, 0, sizeof(host));
+}
+
+void WireEncoder::Reset() {
+    keyframe = true;
+}
+
+uint32_t WireEncoder::NameId(const char* name, std::vector<const char*>& fresh) {
+    if (!name) name = "";
+    auto it = dict.find(name);
+    if (it != dict.end()) return it->second;
+    uint32_t id = (uint32_t)dict.size();
+    dict.emplace(name, id);
+    fresh.push_back(name);
+    return id;
+}
+
+static void EncodeList(std::vector<uint8_t>& out, std::unordered_map<uint64_t, WireRow>& rows,
+                       std::vector<WireCur>& cur, int fieldCount, uint32_t gen) {
+    std::sort(cur.begin(), cur.end(), [](const WireCur& a, const WireCur& b) { return a.key < b.key; });
+    cur.erase(std::unique(cur.begin(), cur.end(), [](const WireCur& a, const WireCur& b) { return a.key == b.key; }),
+              cur.end());
+
+    std::vector<std::pair<size_t, uint32_t>> upserts;     // cur index, field mask
+    for (size_t i = 0; i < cur.size(); i++) {
+        auto ins = rows.emplace(cur[i].key, WireRow());
+        WireRow& row = ins.first->second;
+        row.gen = gen;
+        uint32_t mask = 0;
+        for (int f = 0; f < fieldCount; f++) {
+            if (cur[i].f[f] != row.f[f]) mask |= 1u << f;
+        }
+        if (mask || ins.second) upserts.push_back({ i, mask });
+    }
+
+    std::vector<uint64_t> removed;
+    for (auto it = rows.begin(); it != rows.end();) {
+        if (it->second.gen != gen) {
+            removed.push_back(it->first);
+            it = rows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::sort(removed.begin(), removed.end());
+    PutVar(out, removed.size());
+    uint64_t prev = 0;
+    for (uint64_t key : removed) {
+        PutVar(out, key - prev);
+        prev = key;
+    }
+
+    PutVar(out, upserts.size());
+    prev = 0;
+    for (auto& u : upserts) {
+        const WireCur& c = cur[u.first];
+        WireRow& row = rows[c.key];
+        PutVar(out, c.key - prev);
+        prev = c.key;
+        PutVar(out, u.second);
+        for (int f = 0; f < fieldCount; f++) {
+            if (!(u.second & (1u << f))) continue;
+            PutDelta(out, c.f[f], row.f[f]);
+            row.f[f] = c.f[f];
+        }
+    }
+}
+
+void WireEncoder::Encode(const Snapshot& s, uint64_t nowMs, std::vector<uint8_t>& out) {
+    if (dict.size() >= MAX_DICT) keyframe = true;
+    if (keyframe) {
+        dict.clear();
+        for (auto& r : rows) r.clear();
+        memset(host, 0, sizeof(host));
+    }
+    gen++;
+    body.clear();
+    std::vector<const char*> fresh;
+
+    const double values[WIRE_HOST_FIELDS] = {
+        s.cpuTotal, s.memTotal, s.memUsed, s.memFree, s.memUsedPercent, s.memCommitted, s.swapUsed,
+        s.cpuTemp, s.cpuFreq, s.cpuPerf, s.cpuPerfLimit,
+        s.pageFaultsSec, s.hardFaultsSec, s.pagesSec, s.runQueue, s.diskQueue,
+    };
+    int64_t q[WIRE_HOST_FIELDS];
+    uint32_t mask = 0;
+    for (int i = 0; i < WIRE_HOST_FIELDS; i++) {
+        q[i] = Quantize(values[i], wireHostFields[i].scale);
+        if (q[i] != host[i]) mask |= 1u << i;
+    }
+    PutVar(body, mask);
+    for (int i = 0; i < WIRE_HOST_FIELDS; i++) {
+        if (!(mask & (1u << i))) continue;
+        PutDelta(body, q[i], host[i]);
+        host[i] = q[i];
+    }
+
+    std::vector<WireCur> cur;
+    for (auto& d : s.disks) {
+        WireCur c = { NameId(d.fs, fresh), {
+            Quantize(d.size, MIB), Quantize(d.used, MIB), Quantize(d.free, MIB),
+            Quantize(d.usedPercent, 100), Quantize(d.timeToFull, 1) } };
+        cur.push_back(c);
+    }
+    EncodeList(body, rows[WIRE_DISK], cur, wireListFieldCount[WIRE_DISK], gen);
+
+    cur.clear();
+    for (auto& n : s.net) {
+        WireCur c = { NameId(n.name, fresh), {
+            Quantize(n.rxSec, 1), Quantize(n.txSec, 1), Quantize(n.utilization, 100) } };
+        cur.push_back(c);
+    }
+    EncodeList(body, rows[WIRE_NET], cur, wireListFieldCount[WIRE_NET], gen);
+
+    cur.clear();
+    cur.reserve(s.procs.size());
+    for (auto& p : s.procs) {
+        WireCur c = { p.pid, {
+            (int64_t)NameId(p.name, fresh), Quantize(p.cpu, 10), Quantize(p.memory, MIB),
+            (int64_t)p.handles, (int64_t)p.threads } };
+        cur.push_back(c);
+    }
+    EncodeList(body, rows[WIRE_PROC], cur, wireListFieldCount[WIRE_PROC], gen);
+
+    std::vector<uint8_t> head;
+    head.push_back(WIRE_FRAME);
+    head.push_back(keyframe ? 1 : 0);
+    PutVar(head, ++seq);
+    PutVar(head, lastMs && nowMs > lastMs ? nowMs - lastMs : 0);
+    PutVar(head, fresh.size());
+    for (const char* str : fresh) PutStr(head, str, strlen(str));
+
+    PutVar(out, head.size() + body.size());
+    out.insert(out.end(), head.begin(), head.end());
+    out.insert(out.end(), body.begin(), body.end());
+
+    frames++;
+    if (keyframe) keyframes++;
+    keyframe = false;
+    lastMs = nowMs;
+}
+
+void WireEncoder::Hello(const std::string& host, uint32_t intervalMs, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> msg;
+    msg.push_back(WIRE_HELLO);
+    PutVar(msg, WIRE_VERSION);
+    PutStr(msg, host.c_str(), host.size());
+    PutVar(msg, intervalMs);
+    PutVar(out, msg.size());
+    out.insert(out.end(), msg.begin(), msg.end());
+}
+
+// ---- Decoder ----
+
+WireDecoder::WireDecoder() {
+    memset(hostFields, 0, sizeof(hostFields));
+}
+
+static bool DecodeList(WireReader& r, std::unordered_map<uint64_t, WireRow>& rows, int fieldCount) {
+    uint64_t n = r.Count(), key = 0;
+    for (uint64_t i = 0; i < n && r.ok; i++) {
+        key += r.Var();
+        rows.erase(key);
+    }
+    n = r.Count();
+    key = 0;
+    for (uint64_t i = 0; i < n && r.ok; i++) {
+        key += r.Var();
+        uint64_t mask = r.Var();
+        if (mask >> fieldCount) return false;
+        WireRow& row = rows[key];       // value-initialized: all fields 0
+        for (int f = 0; f < fieldCount; f++) {
+            if (mask & (1u << f)) row.f[f] = r.Apply(row.f[f]);
+        }
+    }
+    return r.ok && rows.size() <= MAX_ROWS;
+}
+
+bool WireDecoder::Decode(const uint8_t* p, size_t n) {
+    WireReader r = { p, p + n };
+    uint8_t type = r.Byte();
+    if (type == WIRE_HELLO) {
+        if (r.Var() != WIRE_VERSION || !r.Str(host)) return false;
+        intervalMs = (uint32_t)r.Var();
+        hello = true;
+        return r.ok && r.p == r.end;
+    }
+    if (type != WIRE_FRAME || !hello) return false;
+
+    if (r.Byte() & 1) {
+        dict.clear();
+        for (auto& rs : rows) rs.clear();
+        memset(hostFields, 0, sizeof(hostFields));
+        keyframes++;
+    }
+    seq = r.Var();
+    agentMs += r.Var();
+    uint64_t count = r.Count();
+    if (dict.size() + count > MAX_DICT) return false;
+    for (uint64_t i = 0; i < count && r.ok; i++) {
+        dict.emplace_back();
+        r.Str(dict.back());
+    }
+
+    uint64_t mask = r.Var();
+    if (mask >> WIRE_HOST_FIELDS) return false;
+    for (int i = 0; i < WIRE_HOST_FIELDS; i++) {
+        if (mask & (1u << i)) hostFields[i] = r.Apply(hostFields[i]);
+    }
+    for (int l = 0; l < WIRE_LISTS; l++) {
+        if (!DecodeList(r, rows[l], wireListFieldCount[l])) return false;
+    }
+    frames++;
+    return r.ok && r.p == r.end;
+}
+
+bool WireStartup() {
+    static int state = 0;       // 0 untried, 1 ok, -1 failed
+    if (state == 0) {
+        WSADATA wsa;
+        state = WSAStartup(MAKEWORD(2, 2), &wsa) == 0 ? 1 : -1;
+    }
+    return state > 0;
+}
+
+int WirePeek(const uint8_t* p, size_t n, uint32_t& len, size_t& header) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < 4; i++) {
+        if (i >= n) return 0;
+        v |= (uint64_t)(p[i] & 0x7F) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            if (v == 0 || v > WIRE_MAX_MESSAGE) return -1;
+            len = (uint32_t)v;
+            header = i + 1;
+            return 1;
+        }
+    }
+    return -1;
+}
+
+bool WireResolve(const std::string& target, sockaddr_storage& addr, int& addrLen) {
+    memset(&addr, 0, sizeof(addr));
+    if (target.compare(0, 5, "unix:") == 0) {
+        SOCKADDR_UN* un = (SOCKADDR_UN*)&addr;
+        std::string path = target.substr(5);
+        if (path.empty() || path.size() >= sizeof(un->sun_path)) return false;
+        un->sun_family = AF_UNIX;
+        memcpy(un->sun_path, path.c_str(), path.size() + 1);
+        addrLen = (int)sizeof(SOCKADDR_UN);
+        return true;
+    }
+
+    size_t colon = target.rfind(':');
+    if (colon == std::string::npos) return false;
+    std::string host = target.substr(0, colon), port = target.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+    if (host.empty()) host = "0.0.0.0";
+
+    addrinfo hints = {}, *res = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0 || !res) return false;
+    bool ok = res->ai_addrlen <= sizeof(addr);
+    if (ok) {
+        memcpy(&addr, res->ai_addr, res->ai_addrlen);
+        addrLen = (int)res->ai_addrlen;
+    }
+    freeaddrinfo(res);
+    return ok;
+}
@@ -0,0 +1,104 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <winsock2.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "snapshot.h"
+
+// Binary protocol between streaming agents and the aggregator.
+//
+// A stream is a sequence of messages, each prefixed by its varint length:
+//   HELLO  u8 1, varint version, str host, varint intervalMs
+//   FRAME  u8 2, u8 flags (1 = keyframe), varint seq, varint dtMs,
+//          varint newStrings, str * newStrings,
+//          host fields, then the disk, net and proc lists
+// str is a varint length plus UTF-8 bytes. Every value is quantized to an
+// integer with a fixed per-field scale and sent as the zigzag varint delta
+// to the previous value of the same field, preceded by a varint mask of the
+// fields that changed; unchanged fields cost nothing. Lists are keyed rows:
+//   varint removed, key deltas; varint upserts, (key delta, mask, deltas) *
+// with keys ascending and delta-coded. Disk and net rows are keyed by the
+// dictionary id of their name, proc rows by pid with the name id as field 0.
+// Strings are dictionary-coded: a frame first defines the strings it uses
+// for the first time and both sides number them in order. A keyframe resets
+// all state (values, rows and dictionary) and is sent on every (re)connect.
+
+static const uint32_t WIRE_VERSION = 1;
+static const uint32_t WIRE_MAX_MESSAGE = 1 << 20;
+
+enum WireType : uint8_t { WIRE_HELLO = 1, WIRE_FRAME = 2 };
+enum WireList { WIRE_DISK, WIRE_NET, WIRE_PROC, WIRE_LISTS };
+
+static const int WIRE_HOST_FIELDS = 16;
+static const int WIRE_MAX_FIELDS = 6;
+
+// Field name and quantization scale (value * scale is sent)
+struct WireField { const char* name; double scale; };
+extern const WireField wireHostFields[WIRE_HOST_FIELDS];
+extern const WireField* const wireListFields[WIRE_LISTS];
+extern const int wireListFieldCount[WIRE_LISTS];
+
+// Quantized NaN (cpuTemp, timeToFull)
+static const int64_t WIRE_NAN = INT64_MIN;
+double WireValue(int64_t q, double scale);
+
+struct WireRow {
+    int64_t f[WIRE_MAX_FIELDS];
+    uint32_t gen;
+};
+
+// Diffs successive snapshots into FRAME messages. Not thread-safe; one per stream.
+class WireEncoder {
+public:
+    WireEncoder();
+    // Next frame is a keyframe
+    void Reset();
+    // Appends one length-prefixed FRAME for `s`
+    void Encode(const Snapshot& s, uint64_t nowMs, std::vector<uint8_t>& out);
+    static void Hello(const std::string& host, uint32_t intervalMs, std::vector<uint8_t>& out);
+
+    uint64_t frames = 0, keyframes = 0;
+
+private:
+    uint32_t NameId(const char* name, std::vector<const char*>& fresh);
+
+    bool keyframe = true;
+    uint64_t seq = 0, lastMs = 0;
+    uint32_t gen = 0;
+    int64_t host[WIRE_HOST_FIELDS];
+    std::unordered_map<std::string, uint32_t> dict;
+    std::unordered_map<uint64_t, WireRow> rows[WIRE_LISTS];
+    std::vector<uint8_t> body;      // reused per frame
+};
+
+// Rebuilds the state of one agent from its messages. Not thread-safe.
+class WireDecoder {
+public:
+    WireDecoder();
+    // One message without its length prefix; false when malformed
+    bool Decode(const uint8_t* p, size_t n);
+
+    bool hello = false;
+    std::string host;
+    uint32_t intervalMs = 0;
+    uint64_t seq = 0, frames = 0, keyframes = 0, agentMs = 0;
+    int64_t hostFields[WIRE_HOST_FIELDS];
+    std::vector<std::string> dict;
+    std::unordered_map<uint64_t, WireRow> rows[WIRE_LISTS];
+};
+
+// WSAStartup once per process (getaddrinfo and sockets need it)
+bool WireStartup();
+
+// Varint length prefix of a buffered message: 1 with `len`/`header` set,
+// 0 when more bytes are needed, -1 when malformed
+int WirePeek(const uint8_t* p, size_t n, uint32_t& len, size_t& header);
+
+// "host:port" or "unix:path" -> socket address; port 0 is allowed (listen)
+bool WireResolve(const std::string& target, sockaddr_storage& addr, int& addrLen);
+
+#endif // WIRE_H
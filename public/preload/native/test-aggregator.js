@@ -0,0 +1,73 @@
+/**
+ * 多机汇聚测试 - 本机回环模拟大量 agent, 检查带宽与汇聚端状态
+ * 用法: node test-aggregator.js [agent 数] [秒数]   (默认 1000 个, 10 秒)
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Aggregator Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const agents = parseInt(process.argv[2]) || 1000
+const seconds = parseInt(process.argv[3]) || 10
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+
+async function main() {
+  const agg = sysmon.setAggregator({ listen: '127.0.0.1:0' })
+  if (!agg.listening) {
+    console.log('Cannot listen:', agg.error)
+    process.exit(1)
+  }
+  const target = `127.0.0.1:${agg.port}`
+  console.log(`Aggregator listening on ${target}`)
+
+  // 1. 本机作为 agent 推送真实数据
+  sysmon.setStream({ target, host: 'self', interval: 1000 })
+  for (let i = 0; i < 4; i++) {
+    sysmon.getCpuUsage()
+    sysmon.getMemoryInfo()
+    sysmon.getProcessList()
+    await sleep(1000)
+  }
+  const stream = sysmon.setStream()
+  const [self] = sysmon.getAggregatedHosts({ host: 'self', procs: 5 })
+  console.log(`\nSelf stream: ${stream.frames} frames, ${stream.bytes} bytes, ${stream.bytesPerSec.toFixed(0)} B/s`)
+  if (self) {
+    console.log(`   aggregator sees cpu ${self.cpu}%, mem ${self.memUsedFmt}, ${self.procCount} processes`)
+    self.procs.forEach(p => console.log(`   ${String(p.pid).padStart(6)} ${p.name.padEnd(24)} ${p.cpu}%`))
+  }
+  let ok = !!self && self.procCount > 0 && stream.connected
+  sysmon.setStream({ target: null })
+
+  // 2. 回环模拟大量 agent
+  console.log(`\nSimulating ${agents} agents for ${seconds}s ...`)
+  const before = sysmon.setAggregator()
+  const sim = await sysmon.simulateAgents({ target, agents, seconds, interval: 1000, procs: 250 })
+  await sleep(500)
+  const after = sysmon.setAggregator()
+  const hosts = sysmon.getAggregatedHosts().filter(h => h.host.startsWith('sim-'))
+
+  const frames = after.frames - before.frames
+  const cpuMs = after.cpuMs - before.cpuMs
+  console.log(`   connected ${sim.connected}/${sim.agents}, ${sim.frames} frames, ${(sim.bytes / 1048576).toFixed(1)} MB`)
+  console.log(`   keyframe ${(sim.keyframeBytes / sim.connected).toFixed(0)} B, then ${sim.avgFrameBytes.toFixed(0)} B/frame = ${sim.bytesPerAgentSec.toFixed(0)} B/s per agent`)
+  console.log(`   encode ${(sim.encodeMs * 1000 / sim.frames).toFixed(1)} us/frame`)
+  console.log(`   aggregator: ${frames} messages in ${cpuMs} ms CPU` +
+    (cpuMs ? ` -> ~${Math.floor(frames / cpuMs * 1000)} agents/core at 1 Hz` : ''))
+  console.log(`   hosts tracked: ${hosts.length}, errors: ${after.errors}`)
+
+  ok = ok && sim.connected === agents && hosts.length === agents && after.errors === 0 &&
+    sim.bytesPerAgentSec < 1024 && hosts.every(h => h.procCount === 250)
+
+  sysmon.setAggregator({ listen: null })
+  if (!ok) process.exitCode = 1
+  console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
+
+main()
@@ -0,0 +1,86 @@
+/**
+ * 告警规则测试 - C++ 原生模块
+ */
+
+const path = require('path')
+const os = require('os')
+const sysmon = require('./index.js')
+
+console.log('=== Alert Rules Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+// 1. 编译规则（包括错误示例）
+console.log('1. Compile rules:')
+const rules = {
+  cpuBusy: 'cpu.total > 1 for 2s hysteresis 0.5',
+  memHigh: 'mem.usedPercent > 10',
+  diskC: "disk['C:'].usedPercent > 1",
+  handles: 'proc[name=*.exe].handles > 1000 and proc[name=*.exe].count > 5',
+  bad: 'cpu.total >> 90'
+}
+for (const [id, expr] of Object.entries(rules)) {
+  console.log(`   ${id.padEnd(8)} ${JSON.stringify(sysmon.addAlertRule(id, expr))}`)
+}
+console.log('')
+
+// 2. 回调 + 日志文件
+const logFile = path.join(os.tmpdir(), 'sysmon-alerts.log')
+sysmon.setAlertLog(logFile)
+sysmon.setAlertCallback(e => console.log(`   [${e.state}] ${e.id}: ${e.expr} (value ${e.value.toFixed(1)})`))
+
+console.log('2. Events (5 seconds):')
+let count = 0
+const timer = setInterval(() => {
+  sysmon.getCpuUsage()
+  sysmon.getMemoryInfo()
+  sysmon.getDiskInfo()
+  sysmon.getProcessList()
+
+  if (++count >= 5) {
+    clearInterval(timer)
+    console.log('\n3. Rule state:')
+    sysmon.getAlertRules().forEach(r => console.log(`   ${r.id.padEnd(8)} active=${r.active} value=${r.value} fired=${r.fireCount} ops=${r.ops}`))
+    console.log('\n   Log file:', logFile)
+    sysmon.setAlertLog(null)
+    pumpCheck()
+  }
+}, 1000)
+
+// 4. 没有任何调用方采集时, 后台补采仍然驱动规则
+function pumpCheck() {
+  console.log('\n4. Rules without collector calls (4 seconds):')
+  Object.keys(rules).forEach(id => sysmon.removeAlertRule(id))
+  let fired = false
+  sysmon.setAlertCallback(e => { if (e.id === 'pump' && e.state === 'fired') fired = true })
+  sysmon.addAlertRule('pump', 'mem.usedPercent >= 0')
+  setTimeout(() => {
+    console.log(`   fired without polling: ${fired}`)
+    sysmon.removeAlertRule('pump')
+    sysmon.setAlertCallback(null)
+    if (!fired) process.exitCode = 1
+    busyCheck(fired)
+  }, 4000)
+}
+
+// 5. 后台补采不经过 JS 线程: JS 线程忙时规则照样求值 (日志文件由补采线程写入)
+function busyCheck(ok) {
+  console.log('\n5. Rules while the JS thread is blocked (4 seconds):')
+  const busyLog = path.join(os.tmpdir(), 'sysmon-alerts-busy.log')
+  require('fs').rmSync(busyLog, { force: true })
+  sysmon.setAlertLog(busyLog)
+  sysmon.addAlertRule('busy', 'mem.usedPercent >= 0')
+  const until = Date.now() + 4000
+  while (Date.now() < until) {}
+  sysmon.removeAlertRule('busy')
+  sysmon.setAlertLog(null)
+  const logged = require('fs').readFileSync(busyLog, 'utf8').includes('\tbusy\t')
+  console.log(`   fired while blocked: ${logged}`)
+  if (!logged) process.exitCode = 1
+  console.log(`\n${ok && logged ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
@@ -0,0 +1,84 @@
+/**
+ * 分配预算测试 - 预热后每次采集不应再触发原生堆分配
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Allocation Budget Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const collectors = [
+  'getCpuUsage',
+  'getPerCoreUsage',
+  'getMemoryInfo',
+  'getDiskIO',
+  'getNetworkStats',
+  'getNetworkConnections',
+  'getProcessList'
+]
+
+// 关闭调度器: 否则被调度的导出在间隔内直接返回上次结果, 测到的是缓存而不是采集路径
+sysmon.setSchedule({ enabled: false })
+
+// 1. 预热（让缓冲区增长到稳定大小）
+console.log('1. Warming up...')
+for (let i = 0; i < 5; i++) {
+  for (const name of collectors) sysmon[name]()
+}
+console.log('')
+
+// Arena / 缓冲区扩容走 malloc, 计数的 operator new 看不到, 所以单独统计 growths
+function growthsOf(stats) {
+  const all = {}
+  stats.arenas.forEach(a => { all['arena ' + a.name] = a.growths })
+  stats.buffers.forEach(b => { all['buffer ' + b.name] = b.growths })
+  return all
+}
+const sumGrowths = stats => Object.values(growthsOf(stats)).reduce((n, g) => n + g, 0)
+const warm = growthsOf(sysmon.getAllocatorStats())
+
+// 2. 稳态：每个采集器的堆分配与 arena/缓冲区扩容次数
+// 新进程/新连接出现时缓存会偶尔分配一次，所以允许 10 轮中最多 1 轮分配
+console.log('2. Steady-state heap allocations and arena/buffer growths per call:')
+const ROUNDS = 10
+let failed = false
+for (const name of collectors) {
+  let dirtyRounds = 0, total = 0, grown = 0
+  for (let round = 0; round < ROUNDS; round++) {
+    const before = sysmon.getAllocatorStats()
+    sysmon[name]()
+    const after = sysmon.getAllocatorStats()
+    const delta = after.heapAllocs - before.heapAllocs
+    const growths = sumGrowths(after) - sumGrowths(before)
+    if (delta !== 0 || growths !== 0) dirtyRounds++
+    total += delta
+    grown += growths
+  }
+  const ok = dirtyRounds <= 1
+  if (!ok) failed = true
+  console.log(`   ${ok ? 'OK  ' : 'FAIL'} ${name}: ${total} allocs, ${grown} growths in ${dirtyRounds}/${ROUNDS} calls`)
+}
+console.log('')
+
+// 3. Arena / 缓冲区大小
+const stats = sysmon.getAllocatorStats()
+console.log('3. Arenas:')
+stats.arenas.forEach(a => {
+  console.log(`   ${a.name}: capacity=${a.capacity} highWater=${a.highWater} growths=${a.growths} resets=${a.resets}`)
+})
+console.log('   Buffers:')
+stats.buffers.forEach(b => {
+  console.log(`   ${b.name}: capacity=${b.capacity} growths=${b.growths}`)
+})
+console.log(`   Heap total: ${stats.heapAllocs} allocs, ${stats.heapFrees} frees`)
+const grewAfterWarmup = Object.entries(growthsOf(stats)).filter(([name, g]) => g !== (warm[name] || 0))
+console.log(`   Grown since warm-up: ${grewAfterWarmup.map(([name, g]) => `${name} (+${g - (warm[name] || 0)})`).join(', ') || 'none'}`)
+
+console.log('\n=== ' + (failed ? 'FAILED' : 'PASSED') + ' ===')
+process.exit(failed ? 1 : 0)
@@ -0,0 +1,43 @@
+/**
+ * 进程异常检测测试 - C++ 原生模块
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Anomaly Detection Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+// 调低阈值，便于在短时间内观察到事件
+console.log('Options:', sysmon.setAnomalyOptions({
+  memGrowthMBPerHour: 1,
+  memGrowthMinutes: 0.1,
+  handleGrowthMin: 1,
+  handleGrowthMinutes: 0.1,
+  warmupSamples: 5
+}))
+
+// warmupSamples < 1 会让 EWMA 发散, 应被忽略
+const rejected = sysmon.setAnomalyOptions({ warmupSamples: 0 }).warmupSamples === 5
+console.log(`warmupSamples 0 rejected: ${rejected}`)
+if (!rejected) process.exitCode = 1
+
+let count = 0
+const timer = setInterval(() => {
+  const t0 = process.hrtime.bigint()
+  const proc = sysmon.getProcessList()
+  const ms = Number(process.hrtime.bigint() - t0) / 1e6
+  const r = sysmon.getAnomalyEvents()
+  console.log(`[${++count}] ${proc.count} processes, ${r.tracked} tracked, ${ms.toFixed(1)} ms`)
+  r.events.forEach(e => console.log(`    ${e.type} ${e.name} (PID: ${e.pid}) ${e.valueFmt}`))
+
+  if (count >= 15) {
+    clearInterval(timer)
+    console.log('\n=== Test Complete ===')
+  }
+}, 1000)
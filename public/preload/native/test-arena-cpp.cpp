@@ -0,0 +1,75 @@
+/**
+ * ScratchArena 测试 - 超大分配 (>64 KiB) 与之后的小分配不能重叠, Reset 后合并为单块
+ *
+ * 编译: cl /EHsc /I <node-gyp 缓存>\include\node test-arena-cpp.cpp src\arena.cpp
+ * 或者用 g++: g++ -I <node 头文件目录> test-arena-cpp.cpp src/arena.cpp -o test-arena-cpp.exe
+ * (arena.cpp 中 getAllocatorStats 用到的 N-API 函数在下面以空实现代替, 不需要链接 node)
+ */
+
+#include "src/arena.h"
+#include <iostream>
+#include <string.h>
+
+// getAllocatorStats is not exercised here; these keep the linker happy without node
+extern "C" {
+napi_status napi_create_object(napi_env, napi_value*) { return napi_ok; }
+napi_status napi_create_array(napi_env, napi_value*) { return napi_ok; }
+napi_status napi_create_double(napi_env, double, napi_value*) { return napi_ok; }
+napi_status napi_create_uint32(napi_env, uint32_t, napi_value*) { return napi_ok; }
+napi_status napi_create_string_utf8(napi_env, const char*, size_t, napi_value*) { return napi_ok; }
+napi_status napi_set_named_property(napi_env, napi_value, const char*, napi_value) { return napi_ok; }
+napi_status napi_set_element(napi_env, napi_value, uint32_t, napi_value) { return napi_ok; }
+}
+
+static bool Filled(const char* p, size_t n, char c) {
+    for (size_t i = 0; i < n; i++) if (p[i] != c) return false;
+    return true;
+}
+
+static bool Disjoint(const char* a, size_t an, const char* b, size_t bn) {
+    return a + an <= b || b + bn <= a;
+}
+
+int main() {
+    std::cout << "=== ScratchArena Test (C++) ===" << std::endl << std::endl;
+    bool ok = true;
+    const size_t BIG = 100 * 1024, SMALL = 100;
+
+    // 1. 空 arena: 超大分配后紧跟小分配
+    ScratchArena arena("test");
+    char* big = (char*)arena.Alloc(BIG);
+    memset(big, 0xAA, BIG);
+    char* small = (char*)arena.Alloc(SMALL);
+    memset(small, 0x55, SMALL);
+    bool step = big && small && Disjoint(big, BIG, small, SMALL) && Filled(big, BIG, (char)0xAA) && Filled(small, SMALL, 0x55);
+    std::cout << "1. oversized then small: " << (step ? "intact" : "OVERLAP") << std::endl;
+    ok = ok && step;
+
+    // 2. 已有溢出块时: 小 -> 超大 -> 小
+    char* more = (char*)arena.Alloc(SMALL);
+    memset(more, 0x33, SMALL);
+    char* big2 = (char*)arena.Alloc(BIG);
+    memset(big2, 0xCC, BIG);
+    char* last = (char*)arena.Alloc(SMALL);
+    memset(last, 0x11, SMALL);
+    step = Filled(big, BIG, (char)0xAA) && Filled(small, SMALL, 0x55) && Filled(more, SMALL, 0x33) &&
+        Filled(big2, BIG, (char)0xCC) && Filled(last, SMALL, 0x11) && Disjoint(big2, BIG, last, SMALL);
+    std::cout << "2. small / oversized / small after a spill: " << (step ? "intact" : "OVERLAP") << std::endl;
+    ok = ok && step;
+
+    // 3. Reset 后按高水位合并, 同样的分配序列不再溢出
+    size_t highWater = arena.highWater;
+    arena.Reset();
+    step = arena.capacity >= highWater;
+    char* again = (char*)arena.Alloc(BIG);
+    char* againSmall = (char*)arena.Alloc(SMALL);
+    memset(again, 0xAA, BIG);
+    memset(againSmall, 0x55, SMALL);
+    step = step && Filled(again, BIG, (char)0xAA) && Filled(againSmall, SMALL, 0x55) && arena.growths == 1;
+    std::cout << "3. after Reset: capacity " << arena.capacity << " >= highWater " << highWater
+              << ", growths " << arena.growths << std::endl;
+    ok = ok && step;
+
+    std::cout << std::endl << (ok ? "OK" : "FAILED") << std::endl << "=== Test Complete ===" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+/**
+ * 容器 (作业对象) 测试 - 在有 CPU / 内存上限的作业里, getCpuUsage / getMemoryInfo 改为相对上限的值
+ * 用法: node test-container.js [负载秒数]   (默认 2)
+ * 没有限额时只检查数值仍是整机值; 在 Windows 容器或设置了限额的作业里运行可覆盖切换逻辑
+ */
+
+const os = require('os')
+const sysmon = require('./index.js')
+
+console.log('=== Container Limits Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const seconds = parseInt(process.argv[2]) || 2
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+
+async function main() {
+  // 关闭调度, 每次调用都重新采样
+  sysmon.setSchedule({ enabled: false })
+  sysmon.getContainerInfo()
+  sysmon.getCpuUsage()
+  const end = Date.now() + seconds * 1000
+  while (Date.now() < end) Math.sqrt(Math.random())
+  await sleep(300)
+
+  const c = sysmon.getContainerInfo()
+  const cpu = sysmon.getCpuUsage()
+  const mem = sysmon.getMemoryInfo()
+  console.log(`inJob ${c.inJob}, limited ${c.limited}, ${c.processes} processes, ${c.terminated} terminated by the job`)
+  if (c.cpu) {
+    console.log(`   cpu: limit ${c.cpu.limit.toFixed(2)} CPUs, used ${c.cpu.usedPercent.toFixed(1)}% of it, ` +
+      `throttled ${c.cpu.throttledPeriods} periods / ${c.cpu.throttledTime.toFixed(1)} s, ${c.cpu.throttledSec.toFixed(2)} s/s over 10 s`)
+  }
+  if (c.memory) {
+    console.log(`   memory: ${c.memory.usedFmt} of ${c.memory.limitFmt} (${c.memory.usedPercent.toFixed(1)}%), ` +
+      `peak ${c.memory.peakFmt}, ${c.memory.limitHits} limit hits`)
+  }
+  console.log(`getCpuUsage: ${cpu.load}${cpu.container ? ` of ${cpu.cpuLimit.toFixed(2)} CPUs (host ${cpu.host})` : ''}`)
+  console.log(`getMemoryInfo: ${mem.used} / ${mem.total}${mem.container ? ` (host ${mem.host.used} / ${mem.host.total})` : ''}`)
+
+  let ok = cpu.loadRaw >= 0 && cpu.loadRaw <= 100 && mem.usedRaw <= mem.totalRaw
+  // CPU: 有上限时 load 相对上限, 否则仍是整机值
+  if (c.cpu) {
+    ok = ok && cpu.container && cpu.cpuLimit === c.cpu.limit && c.cpu.limit < os.cpus().length &&
+      cpu.hostRaw >= 0 && cpu.hostRaw <= 100 &&
+      // 节流时间比例: 10 秒窗口内的平均值, 不是上一个采样的 0/1
+      c.cpu.throttledSec >= 0 && c.cpu.throttledSec <= 1 + 1e-9
+  } else {
+    ok = ok && !cpu.container && cpu.host === null
+  }
+  // 内存: 有上限时 total = 上限, host 是物理内存
+  if (c.memory) {
+    ok = ok && mem.container && mem.totalRaw === c.memory.limit && mem.host.totalRaw === os.totalmem()
+  } else {
+    ok = ok && !mem.container && mem.host === null && mem.totalRaw === os.totalmem()
+  }
+  ok = ok && c.limited === !!(c.cpu || c.memory) && (!c.inJob || c.processes >= 1) && (c.inJob || !c.limited)
+  console.log(`\nValues relative to ${c.limited ? 'the job limits' : 'the host'}: ${ok}`)
+
+  if (!ok) process.exitCode = 1
+  console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
+
+main()
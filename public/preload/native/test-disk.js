@@ -39,5 +39,15 @@ setTimeout(() => {
   console.log('  Reads/sec:        ', io.readsPerSecFmt)
   console.log('  Writes/sec:       ', io.writesPerSecFmt)
   
+  // 卷列表 (盘符 / 挂载文件夹 / 网络共享) 与写满预测
+  console.log('\nVolumes:')
+  const d = sysmon.getDiskInfo()
+  d.partitions.forEach(p => {
+    const eta = p.timeToFull == null ? 'not filling' : `full in ${p.timeToFullText}`
+    console.log(`  ${p.mount.padEnd(16)} ${p.kind.padEnd(9)} ${p.type.padEnd(6)} ${p.usedPercent.padStart(6)} ` +
+      `of ${p.size.padEnd(10)} ${(p.growthRate / 1024).toFixed(1)} KB/s, ${eta}`)
+  })
+  d.physical.forEach(p => console.log(`  [${p.interfaceType}] ${p.vendor} ${p.name} ${p.size}`))
+  
   console.log('\n=== Test Complete ===')
 }, 1000)
@@ -0,0 +1,104 @@
+/**
+ * 功耗测试 - 合成能耗计量 / 电池回放数据, 校验功率、计数器回绕与剩余时间估算, 再采样一次实机
+ * 用法: node test-energy.js
+ */
+
+const os = require('os')
+const fs = require('fs')
+const path = require('path')
+const sysmon = require('./index.js')
+
+console.log('=== Energy Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+function writeArchive(file, records) {
+  const parts = [Buffer.from('SYSMONRR'), Buffer.alloc(4)]
+  parts[1].writeUInt32LE(1)
+  records.forEach(r => {
+    const head = Buffer.alloc(2 + r.name.length + 20)
+    let o = head.writeUInt16LE(r.name.length)
+    o += head.write(r.name, o)
+    head.writeBigUInt64LE(BigInt(r.time), o)
+    head.writeBigUInt64LE(0n, o + 8)
+    head.writeUInt32LE(r.bytes.length, o + 16)
+    parts.push(head, r.bytes)
+  })
+  fs.writeFileSync(file, Buffer.concat(parts))
+}
+
+// energyMeters: { name[40], energy (pWh), time (100 ns), range } per channel
+function meters(channels) {
+  const b = Buffer.alloc(channels.length * 64)
+  channels.forEach((c, i) => {
+    b.write(c.name, i * 64)
+    b.writeBigUInt64LE(c.energy, i * 64 + 40)
+    b.writeBigUInt64LE(c.time, i * 64 + 48)
+    b.writeBigUInt64LE(c.range || 0n, i * 64 + 56)
+  })
+  return b
+}
+
+// batteryState: u64 timeMs + SYSTEM_BATTERY_STATE
+function battery(timeMs, remaining, rate) {
+  const b = Buffer.alloc(40)
+  b.writeBigUInt64LE(BigInt(timeMs))
+  b[9] = 1; b[11] = 1                   // BatteryPresent, Discharging
+  b.writeUInt32LE(50000, 16)            // MaxCapacity mWh
+  b.writeUInt32LE(remaining, 20)        // RemainingCapacity mWh
+  b.writeInt32LE(rate, 24)              // Rate mW
+  b.writeUInt32LE(0xFFFFFFFF, 28)       // EstimatedTime unknown
+  return b
+}
+
+const PWH_PER_JOULE = 1e12 / 3600
+const wrap = 0xFFFFFFFFn
+const records = []
+for (let i = 0; i < 5; i++) {
+  const time = BigInt(i) * 10000000n    // 1 s apart
+  records.push({ name: 'energyMeters', time: i * 1000, bytes: meters([
+    { name: 'RAPL_Package0_PKG', energy: BigInt(Math.round(12 * i * PWH_PER_JOULE)), time },
+    { name: 'RAPL_Package0_PP0', energy: BigInt(Math.round(8 * i * PWH_PER_JOULE)), time },
+    // 2 W on a 32-bit counter that wraps between the 2nd and 3rd sample
+    { name: 'RAPL_Package0_DRAM', energy: (wrap - 1000000000n + BigInt(Math.round(2 * i * PWH_PER_JOULE))) & wrap, time, range: wrap }
+  ]) })
+  records.push({ name: 'batteryState', time: i * 1000, bytes: battery(i * 10000, 30000 - i * 40, -15000) })
+}
+
+const file = path.join(os.tmpdir(), 'sysmon-energy-test.rr')
+writeArchive(file, records)
+sysmon.setReplay({ mode: 'play', path: file })
+
+let ok = true
+let p
+for (let i = 0; i < 5; i++) p = sysmon.getPowerInfo({ procs: 5 })
+sysmon.setReplay({ mode: 'off' })
+fs.rmSync(file, { force: true })
+
+const close = (a, b) => a != null && Math.abs(a - b) < 0.01
+console.log('Synthetic meters:')
+p.meters.forEach(m => console.log(`   ${m.name.padEnd(20)} ${m.kind.padEnd(8)} ${m.watts.toFixed(2)} W  ${m.joules.toFixed(1)} J`))
+console.log(`   package ${p.package} W, core ${p.core} W, dram ${p.dram} W, interval ${p.interval} s`)
+ok = ok && p.available && close(p.package, 12) && close(p.core, 8) && close(p.dram, 2) && close(p.interval, 1) &&
+  close(p.meters.find(m => m.kind === 'dram').joules, 8)
+
+const b = p.battery
+console.log(`\nSynthetic battery: ${b.remaining} / ${b.capacity} mWh, rate ${b.rate} W (${b.source}), ` +
+  `time to empty ${b.timeToEmpty && b.timeToEmpty.toFixed(0)} s`)
+ok = ok && close(b.rate, -15) && b.source === 'battery' && Math.abs(b.timeToEmpty - 29840 / 15 * 3.6) < 1
+
+// 实机: 无能耗计量设备或非管理员时 error 非空, 电池可能不存在
+const live = sysmon.getPowerInfo({ procs: 5 })
+console.log(`\nLive: available ${live.available}, ${live.meters.length} meters, battery ${live.battery ? 'yes' : 'no'}, error: ${live.error}`)
+live.meters.forEach(m => console.log(`   ${m.name} (${m.kind})`))
+const info = sysmon.getBatteryInfo()
+if (info.hasBattery) console.log(`   battery ${info.percent}, ${info.timeRemaining}, ${info.dischargeRate}`)
+ok = ok && Array.isArray(live.meters) && Array.isArray(live.processes)
+
+if (!ok) process.exitCode = 1
+console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
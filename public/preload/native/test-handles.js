@@ -0,0 +1,56 @@
+/**
+ * 句柄明细测试 - 按类型/目标分组, 观察句柄泄漏
+ * 用法: node test-handles.js [pid]   (默认观察当前进程)
+ */
+
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const sysmon = require('./index.js')
+
+console.log('=== Process Handles Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const pid = parseInt(process.argv[2]) || process.pid
+const first = sysmon.getProcessHandles(pid, { top: 10 })
+if (!first.found) {
+  console.log(`Process ${pid} not found or not accessible`)
+  process.exit(1)
+}
+console.log(`Watching pid ${pid}: ${first.total} handles, ${first.groupCount} groups` +
+  (first.resolved ? '' : ' (targets not resolvable, no DUP access)') + '\n')
+first.byType.slice().sort((a, b) => b.count - a.count).slice(0, 10).forEach(t => {
+  console.log(`   ${t.type.padEnd(16)} ${String(t.count).padStart(6)}`)
+})
+console.log('')
+
+// 当前进程时故意泄漏一些文件句柄, 便于观察 changes
+const leaked = []
+const tmp = path.join(os.tmpdir(), 'sysmon-handles-test.txt')
+fs.writeFileSync(tmp, 'x')
+const leak = pid === process.pid ? setInterval(() => { for (let i = 0; i < 5; i++) leaked.push(fs.openSync(tmp, 'r')) }, 500) : null
+
+let round = 0
+const timer = setInterval(() => {
+  const t0 = process.hrtime.bigint()
+  const r = sysmon.getProcessHandles(pid, { top: 5 })
+  const ms = Number(process.hrtime.bigint() - t0) / 1e6
+  console.log(`--- window ${r.window.toFixed(2)}s, ${r.total} handles, ${r.pending} pending, ${ms.toFixed(1)}ms ---`)
+  r.changes.forEach(g => {
+    console.log(`   ${g.delta > 0 ? '+' : ''}${g.delta}`.padEnd(8) + ` ${g.type.padEnd(12)} ${g.target || '(unnamed)'} (${g.count})`)
+  })
+  console.log('')
+  if (++round >= 5) {
+    clearInterval(timer)
+    if (leak) clearInterval(leak)
+    leaked.forEach(fd => fs.closeSync(fd))
+    fs.unlinkSync(tmp)
+    console.log('=== Test Complete ===')
+  }
+}, 1000)
@@ -0,0 +1,74 @@
+/**
+ * 历史指标测试 - 窗口分位数查询 (原生 DDSketch 分桶)
+ * 用法: node test-history.js [采样秒数]   (默认 20)
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Metric History Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const seconds = parseInt(process.argv[2]) || 20
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+
+async function main() {
+  // 采样时在 JS 侧保留原始值, 用于和原生分位数对比
+  const raw = []
+  sysmon.setSchedule({ enabled: false })   // every call samples, so the counts match
+  console.log(`Sampling for ${seconds}s ...`)
+  for (let i = 0; i < seconds * 4; i++) {
+    raw.push(sysmon.getCpuUsage().loadRaw)
+    sysmon.getMemoryInfo()
+    sysmon.getNetworkStats()
+    await sleep(250)
+  }
+
+  const names = sysmon.getMetricNames()
+  console.log(`\n${names.length} metrics: ${names.slice(0, 8).join(', ')}${names.length > 8 ? ', ...' : ''}`)
+
+  const q = sysmon.queryMetric('cpu.total', { window: 3600000, percentiles: [50, 95, 99] })
+  raw.sort((a, b) => a - b)
+  const exact = p => raw[Math.floor(p / 100 * (raw.length - 1))]
+  console.log(`\ncpu.total, last hour (${q.buckets} buckets of ${q.bucket / 1000}s, ${q.count} samples):`)
+  console.log(`   min ${q.min.toFixed(2)}  mean ${q.mean.toFixed(2)}  max ${q.max.toFixed(2)}`)
+  let ok = q.found && q.count === raw.length
+  for (const p of [50, 95, 99]) {
+    const est = q.percentiles['p' + p], ref = exact(p)
+    const err = ref > 0.01 ? Math.abs(est - ref) / ref : Math.abs(est - ref)
+    console.log(`   p${p}: ${est.toFixed(2)} (exact ${ref.toFixed(2)}, err ${(err * 100).toFixed(2)}%)`)
+    ok = ok && err <= 0.02
+  }
+  console.log(`   query took ${q.elapsed.toFixed(1)} us`)
+
+  // 查询耗时与窗口长度无关 (按桶合并)
+  const windows = [60000, 3600000, 86400000, 7 * 86400000]
+  for (const w of windows) {
+    let best = Infinity
+    for (let i = 0; i < 100; i++) best = Math.min(best, sysmon.queryMetric('net.rxSec', { window: w }).elapsed)
+    console.log(`   net.rxSec window ${String(w / 60000).padStart(6)} min: ${best.toFixed(1)} us`)
+  }
+
+  // 降采样: 点数受图表宽度约束, 时间有序
+  const to = Date.now(), from = to - 3600000, width = 300
+  const lttb = sysmon.downsample('cpu.total', from, to, width)
+  const minmax = sysmon.downsample('cpu.total', from, to, width, { mode: 'minmax' })
+  const ordered = d => d.times.every((t, i) => i === 0 || t >= d.times[i - 1])
+  console.log(`\ndownsample cpu.total, last hour to ${width} px (source ${lttb.source}, ${lttb.input} points):`)
+  console.log(`   lttb ${lttb.values.length} points in ${lttb.elapsed.toFixed(1)} us, minmax ${minmax.values.length} points in ${minmax.elapsed.toFixed(1)} us`)
+  ok = ok && lttb.found && lttb.values.length <= width && lttb.times.length === lttb.values.length &&
+    minmax.values.length <= 2 * width && ordered(lttb) && ordered(minmax)
+
+  sysmon.setSchedule({ enabled: true })
+  const missing = sysmon.queryMetric('no.such.metric')
+  ok = ok && !missing.found && missing.count === 0
+  if (!ok) process.exitCode = 1
+  console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
+
+main()
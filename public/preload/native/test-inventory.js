@@ -0,0 +1,80 @@
+/**
+ * 硬件信息缓存测试 - 冷启动 / 热启动 (读取磁盘缓存) 的首屏静态信息耗时对比
+ * 用法: node test-inventory.js
+ */
+
+const { execFileSync } = require('child_process')
+const os = require('os')
+const path = require('path')
+const fs = require('fs')
+const sysmon = require('./index.js')
+
+const file = path.join(os.tmpdir(), 'sysmon-inventory-test.bin')
+const calls = ['getSystemInfo', 'getCpuInfo', 'getGpuInfo', 'getMemoryHardware', 'getDiskInfo']
+
+if (process.argv[2] === '--startup') {
+  // 子进程: 模拟面板打开, 依次取静态信息, 然后等待后台刷新写回并通过 onRefresh 送回新值
+  const native = require('./build/Release/sysmon.node')
+  let fresh = {}
+  native.setInventoryCache({ path: file, refreshDelay: 500, onRefresh: values => { fresh = values } })
+  const times = {}, results = {}
+  const t0 = process.hrtime.bigint()
+  for (const name of calls) {
+    const t = process.hrtime.bigint()
+    results[name] = native[name]()
+    times[name] = Number(process.hrtime.bigint() - t) / 1e6
+  }
+  const total = Number(process.hrtime.bigint() - t0) / 1e6
+  setTimeout(() => {
+    const cache = native.getInventoryCache()
+    const saved = fs.readFileSync(file).toString('latin1')
+    console.log(JSON.stringify({ total, times, cache, results, fresh, savedLive: saved.includes('currentSpeed') }))
+  }, 1500)
+  return
+}
+
+console.log('=== Inventory Cache Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const run = () => JSON.parse(execFileSync(process.execPath, [__filename, '--startup']).toString())
+const same = (a, b) => JSON.stringify({ ...a, cached: undefined }) === JSON.stringify({ ...b, cached: undefined })
+
+fs.rmSync(file, { force: true })
+const cold = run()
+const warm = run()
+
+for (const [label, r] of [['cold', cold], ['warm', warm]]) {
+  console.log(`${label}: ${r.total.toFixed(1)} ms  ` +
+    calls.map(c => `${c.replace('get', '')} ${r.times[c].toFixed(1)}`).join(', '))
+}
+console.log(`\ncache file ${warm.cache.path}: ${warm.cache.entries.map(e => `${e.key} ${e.bytes} B`).join(', ')}`)
+console.log(`   fingerprint ${warm.cache.fingerprint}, load ${warm.cache.loadMs.toFixed(2)} ms, hits ${warm.cache.hits}, refreshed ${warm.cache.refreshed}`)
+console.log(`   speedup ${(cold.total / warm.total).toFixed(1)}x`)
+
+// currentSpeed 是实时值: 不写入缓存文件, 热启动时现场采样填入, 所以不参与静态字段比较
+const { currentSpeed, ...warmCpu } = warm.results.getCpuInfo
+const { currentSpeed: coldSpeed, ...coldCpu } = cold.results.getCpuInfo
+const staticSame = ['getSystemInfo', 'getGpuInfo', 'getMemoryHardware']
+  .every(c => same(cold.results[c], warm.results[c])) && same(coldCpu, warmCpu)
+const disksSame = JSON.stringify(cold.results.getDiskInfo.physical) === JSON.stringify(warm.results.getDiskInfo.physical)
+console.log(`   cached results identical: ${staticSame && disksSame}`)
+const live = typeof currentSpeed === 'number' && currentSpeed > 0 && typeof coldSpeed === 'number' && !warm.savedLive
+console.log(`   currentSpeed ${currentSpeed} GHz sampled live, kept out of the file: ${live}`)
+
+// 后台刷新 (WMI 在工作线程) 完成后 onRefresh 收到所有从缓存应答过的接口的新值
+const refreshed = ['getSystemInfo', 'getCpuInfo', 'getGpuInfo', 'getMemoryHardware']
+  .every(c => warm.fresh[c] && !warm.fresh[c].cached)
+const freshSame = refreshed && same(warm.fresh.getMemoryHardware, cold.results.getMemoryHardware)
+console.log(`   onRefresh delivered ${Object.keys(warm.fresh).join(', ') || 'nothing'}: ${freshSame}`)
+
+const ok = cold.cache.valid && warm.cache.valid && warm.cache.hits >= 4 && warm.results.getCpuInfo.cached === true &&
+  staticSame && disksSame && live && freshSame && warm.total < cold.total
+fs.rmSync(file, { force: true })
+if (!ok) process.exitCode = 1
+console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
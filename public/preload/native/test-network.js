@@ -42,6 +42,9 @@ setTimeout(() => {
     console.log('  Upload:       ', iface.txSec)
     console.log('  Total RX:     ', iface.rxBytes, `(${iface.rxPackets.toLocaleString()} packets)`)
     console.log('  Total TX:     ', iface.txBytes, `(${iface.txPackets.toLocaleString()} packets)`)
+    console.log('  Virtual:      ', iface.virtual, `(ifType ${iface.ifType})`)
+    console.log('  Errors:       ', `rx ${iface.rxErrors} tx ${iface.txErrors}`)
+    console.log('  Drops:        ', `rx ${iface.rxDrops} tx ${iface.txDrops}`, `loss ${iface.lossFmt}`)
   })
   
   console.log('\n' + '='.repeat(60))
@@ -0,0 +1,48 @@
+/**
+ * 监听端口索引测试 - 端口归属查询与变化订阅
+ * 用法: node test-ports.js [port]
+ */
+
+const net = require('net')
+const sysmon = require('./index.js')
+
+console.log('=== Listening Port Index Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const port = parseInt(process.argv[2]) || 18080
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+
+async function main() {
+  const base = sysmon.getListeningChanges()
+  console.log(`Index: ${sysmon.getListeningPorts().length} listeners, seq ${base.seq}\n`)
+
+  const server = net.createServer().listen(port, '127.0.0.1')
+  await new Promise(r => server.once('listening', r))
+  await sleep(2500)   // let the index go stale so the lookup refreshes it
+
+  const t0 = process.hrtime.bigint()
+  const owner = sysmon.findPortOwner(port, 'tcp')
+  const us = Number(process.hrtime.bigint() - t0) / 1e3
+  console.log(`findPortOwner(${port}): inUse=${owner.inUse} (${us.toFixed(0)}us)`)
+  owner.owners.forEach(o => console.log(`   ${o.protocol} ${o.address}:${o.port} pid=${o.pid} ${o.process}`))
+  const mine = owner.owners.some(o => o.pid === process.pid)
+  console.log(`   owned by this process: ${mine}`)
+  console.log(`   this process listens on: ${sysmon.getListeningPorts(process.pid).map(o => o.port).join(', ')}\n`)
+
+  server.close()
+  await sleep(2500)
+  const changes = sysmon.getListeningChanges(base.seq)
+  console.log(`Changes since ${base.seq} (truncated=${changes.truncated}):`)
+  changes.changes.filter(c => c.port === port).forEach(c => console.log(`   #${c.seq} ${c.change} ${c.protocol} ${c.address}:${c.port} pid=${c.pid}`))
+  if (!mine) process.exitCode = 1
+
+  console.log('\n=== Test Complete ===')
+}
+
+main()
@@ -0,0 +1,32 @@
+/**
+ * 资源压力测试 - 缺页、换页、运行队列与磁盘队列速率
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Pressure Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+// 第一次调用只初始化速率计数器
+sysmon.getPressure()
+
+let round = 0
+const timer = setInterval(() => {
+  const p = sysmon.getPressure()
+  console.log(`--- window ${p.window.toFixed(2)}s (valid=${p.valid}) ---`)
+  console.log(`   Memory: faults=${p.memory.pageFaultsSec.toFixed(0)}/s hard=${p.memory.hardFaultsSec.toFixed(1)}/s ` +
+    `in=${p.memory.pagesInSec.toFixed(1)}/s out=${p.memory.pagesOutSec.toFixed(1)}/s transition=${p.memory.transitionFaultsSec.toFixed(0)}/s`)
+  console.log(`   CPU: runQueue=${p.cpu.runQueue} (${p.cpu.runQueuePerCpu.toFixed(2)}/cpu) ctxSwitch=${p.cpu.contextSwitchesSec.toFixed(0)}/s`)
+  console.log(`   IO: queue=${p.io.queueLength.toFixed(2)} busy=${p.io.busyPercent.toFixed(1)}%\n`)
+
+  if (++round >= 10) {
+    clearInterval(timer)
+    console.log('=== Test Complete ===')
+  }
+}, 1000)
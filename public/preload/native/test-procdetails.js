@@ -0,0 +1,92 @@
+/**
+ * 进程详情测试 - 区分多个同名 node.exe, 校验路径 / 命令行 / 用户 / 启动时间, 以及稳态刷新不重复获取
+ * 用法: node test-procdetails.js [同名子进程数]   (默认 5)
+ */
+
+const { spawn } = require('child_process')
+const sysmon = require('./index.js')
+
+console.log('=== Process Details Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const count = parseInt(process.argv[2]) || 5
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+const native = require('./build/Release/sysmon.node')
+
+function tick() {
+  const t = process.hrtime.bigint()
+  const r = native.getProcessList()
+  return { ms: Number(process.hrtime.bigint() - t) / 1e6, rows: r.processes }
+}
+
+async function main() {
+  sysmon.setSchedule({ enabled: false })   // every call samples
+  const children = []
+  for (let i = 0; i < count; i++) {
+    children.push(spawn(process.execPath, ['-e', 'setTimeout(() => {}, 60000)', `worker-${i}`]))
+  }
+  await sleep(500)
+
+  const first = tick()
+  const steady = []
+  for (let i = 0; i < 5; i++) steady.push(tick())
+  const last = steady[steady.length - 1]
+  const avg = steady.reduce((s, t) => s + t.ms, 0) / steady.length
+  console.log(`${first.rows.length} processes, first tick ${first.ms.toFixed(1)} ms, steady ${avg.toFixed(1)} ms`)
+
+  const self = last.rows.find(p => p.pid === process.pid)
+  console.log(`\nThis process (${self.name}):`)
+  console.log(`   path    ${self.details.path}`)
+  console.log(`   cmdline ${self.details.cmdline}`)
+  console.log(`   user    ${self.details.user}`)
+  console.log(`   started ${new Date(self.details.startTime).toISOString()}`)
+  let ok = self.details.path.toLowerCase() === process.execPath.toLowerCase() &&
+    self.details.cmdline.includes('test-procdetails') && !!self.details.user &&
+    Math.abs(self.details.startTime - (Date.now() - process.uptime() * 1000)) < 5000
+
+  // 同名子进程靠命令行区分
+  console.log(`\n${count} identical ${self.name} children:`)
+  const seen = new Set()
+  for (const c of children) {
+    const row = last.rows.find(p => p.pid === c.pid)
+    const tag = row && row.details.cmdline && (row.details.cmdline.match(/\bworker-\d+/) || [])[0]
+    console.log(`   pid ${c.pid}: ${tag}`)
+    if (tag) seen.add(tag)
+  }
+  ok = ok && seen.size === count
+
+  // 稳态: 同一进程共享同一个 details 对象 (未重复获取)
+  const before = first.rows.find(p => p.pid === process.pid).details
+  const shared = before === self.details
+  const detail = sysmon.getProcessDetails(process.pid)
+  console.log(`\nDetails object reused across ticks: ${shared}, getProcessDetails cached: ${detail.cached}`)
+  ok = ok && shared && detail.cached && detail.cmdline === self.details.cmdline
+
+  // 进程退出后条目被清理, 再查询需要重新获取
+  const gone = children.pop()
+  await new Promise(r => { gone.on('exit', r); gone.kill() })
+  await sleep(500)
+  tick()
+  const after = sysmon.getProcessDetails(gone.pid)
+  console.log(`Exited child ${gone.pid}: ${after === null ? 'dropped' : 'still listed'}`)
+  ok = ok && after === null
+
+  // 告警规则可按命令行筛选
+  const rule = sysmon.addAlertRule('workers', 'proc[cmdline=*worker-*].count > 0')
+  console.log(`Alert rule on cmdline: ${rule.ok ? 'compiled' : rule.error}`)
+  ok = ok && rule.ok
+  sysmon.removeAlertRule('workers')
+
+  children.forEach(c => c.kill())
+  sysmon.setSchedule({ enabled: true })
+  if (!ok) process.exitCode = 1
+  console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
+
+main()
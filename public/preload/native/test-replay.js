@@ -0,0 +1,135 @@
+/**
+ * 录制/回放测试 - 用合成的大规模连接表对采集器做可重复的性能测试
+ * 用法: node test-replay.js [TCP 连接数]   (默认 200000)
+ */
+
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const sysmon = require('./index.js')
+
+console.log('=== Record / Replay Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const tcpCount = parseInt(process.argv[2]) || 200000
+const udpCount = 5000
+const htons = p => ((p & 0xFF) << 8) | (p >> 8)
+
+// 归档格式见 src/replay.h
+function writeArchive(file, records) {
+  const parts = [Buffer.from('SYSMONRR'), Buffer.alloc(4)]
+  parts[1].writeUInt32LE(1)
+  records.forEach(r => {
+    const head = Buffer.alloc(2 + r.name.length + 20)
+    let o = head.writeUInt16LE(r.name.length)
+    o += head.write(r.name, o)
+    head.writeBigUInt64LE(BigInt(r.time), o)
+    head.writeBigUInt64LE(0n, o + 8)
+    head.writeUInt32LE(r.bytes.length, o + 16)
+    parts.push(head, r.bytes)
+  })
+  fs.writeFileSync(file, Buffer.concat(parts))
+}
+
+// MIB_TCPTABLE_OWNER_PID: dwNumEntries + { state, localAddr, localPort, remoteAddr, remotePort, pid }
+function tcpTable(n, listenOnly = false) {
+  const b = Buffer.alloc(4 + n * 24)
+  b.writeUInt32LE(n)
+  for (let i = 0; i < n; i++) {
+    const o = 4 + i * 24
+    const listen = listenOnly || i % 100 === 0
+    b.writeUInt32LE(listen ? 2 : 5, o)                           // LISTEN / ESTABLISHED
+    b.writeUInt32LE(0x0100007F, o + 4)                           // 127.0.0.1
+    b.writeUInt32LE(htons(listen ? 10000 + Math.floor(i / 100) : 40000 + i % 20000), o + 8)
+    b.writeUInt32LE(listen ? 0 : 0x0A000000 | (i % 50000), o + 12)
+    b.writeUInt32LE(listen ? 0 : htons(443), o + 16)
+    b.writeUInt32LE(1000 + i % 50000, o + 20)                    // 50k distinct pids
+  }
+  return b
+}
+
+// MIB_UDPTABLE_OWNER_PID: dwNumEntries + { localAddr, localPort, pid }
+function udpTable(n) {
+  const b = Buffer.alloc(4 + n * 12)
+  b.writeUInt32LE(n)
+  for (let i = 0; i < n; i++) {
+    b.writeUInt32LE(0, 4 + i * 12)
+    b.writeUInt32LE(htons(20000 + i), 8 + i * 12)
+    b.writeUInt32LE(1000 + i, 12 + i * 12)
+  }
+  return b
+}
+
+function time(label, fn, runs = 5) {
+  const ms = []
+  let r
+  for (let i = 0; i < runs; i++) {
+    const t0 = process.hrtime.bigint()
+    r = fn()
+    ms.push(Number(process.hrtime.bigint() - t0) / 1e6)
+  }
+  ms.sort((a, b) => a - b)
+  console.log(`   ${label.padEnd(28)} median ${ms[runs >> 1].toFixed(2)}ms`)
+  return r
+}
+
+// 回放时不走采样调度, 每次调用都真正执行采集
+sysmon.setSchedule({ enabled: false })
+
+// 1. 合成场景回放
+const synthetic = path.join(os.tmpdir(), 'sysmon-synthetic.rr')
+writeArchive(synthetic, [
+  { name: 'tcpTable', time: 0, bytes: tcpTable(tcpCount) },
+  { name: 'udpTable', time: 0, bytes: udpTable(udpCount) },
+  { name: 'tcpListenTable', time: 0, bytes: tcpTable(Math.ceil(tcpCount / 100), true) }
+])
+let status = sysmon.setReplay({ mode: 'play', path: synthetic, loop: true })
+console.log(`Synthetic archive: ${status.sources.map(s => `${s.name} x${s.records}`).join(', ')}`)
+const conns = time('getNetworkConnections', () => sysmon.getNetworkConnections())
+console.log(`   -> ${conns.totalTcp} tcp, ${conns.totalUdp} udp, ${conns.totalListening} listening, ${conns.byProcess.length} processes`)
+const owner = time('findPortOwner', () => sysmon.findPortOwner(10005), 1000)
+console.log(`   -> port 10005 owned by pid ${owner.owners.map(o => o.pid).join(',')}`)
+let ok = conns.totalTcp === tcpCount && conns.totalUdp === udpCount && owner.inUse
+
+// 2. 录制真实数据后回放, 结果应一致
+const recorded = path.join(os.tmpdir(), 'sysmon-recorded.rr')
+sysmon.setReplay({ mode: 'record', path: recorded })
+const live = sysmon.getNetworkConnections()
+status = sysmon.setReplay({ mode: 'play', path: recorded })
+const replayed = sysmon.getNetworkConnections()
+console.log(`\nRecorded live tables: ${status.sources.map(s => `${s.name} x${s.records}`).join(', ')}`)
+console.log(`   live ${live.totalTcp}/${live.totalUdp}, replayed ${replayed.totalTcp}/${replayed.totalUdp}`)
+ok = ok && live.totalTcp === replayed.totalTcp && live.totalUdp === replayed.totalUdp
+
+// 回放耗尽后采集应失败而不是读真实系统
+const exhausted = sysmon.getNetworkConnections()
+console.log(`   after the archive is used up: ${exhausted.totalTcp} tcp`)
+ok = ok && exhausted.totalTcp === 0
+
+// 3. 行数超出记录长度的表不应被读越界, 而是当作没有数据
+const malformed = path.join(os.tmpdir(), 'sysmon-malformed.rr')
+const lying = tcpTable(10)
+lying.writeUInt32LE(1000000)
+writeArchive(malformed, [
+  { name: 'tcpTable', time: 0, bytes: lying },
+  { name: 'udpTable', time: 0, bytes: udpTable(10).subarray(0, 20) }
+])
+sysmon.setReplay({ mode: 'play', path: malformed })
+const bad = sysmon.getNetworkConnections()
+status = sysmon.setReplay()
+console.log(`\nMalformed tables: ${bad.totalTcp} tcp, ${bad.totalUdp} udp, error: ${status.error}`)
+ok = ok && bad.totalTcp === 0 && bad.totalUdp === 0 && /malformed/.test(status.error || '')
+
+sysmon.setReplay({ mode: 'off' })
+sysmon.setSchedule({ enabled: true })
+fs.unlinkSync(synthetic)
+fs.unlinkSync(recorded)
+fs.unlinkSync(malformed)
+if (!ok) process.exitCode = 1
+console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
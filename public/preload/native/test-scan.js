@@ -0,0 +1,50 @@
+/**
+ * 目录占用扫描测试 - 多线程遍历, 找出占用空间最大的目录和文件
+ * 用法: node test-scan.js [目录] [线程数]   (默认扫描用户目录)
+ */
+
+const os = require('os')
+const sysmon = require('./index.js')
+
+console.log('=== Directory Scan Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const root = process.argv[2] || os.homedir()
+const threads = parseInt(process.argv[3]) || undefined
+
+async function main() {
+  console.log(`Scanning ${root} ...`)
+  const scan = sysmon.scanDirectory(root, {
+    top: 10,
+    threads,
+    onProgress: p => console.log(`   ${p.elapsed.toFixed(1)}s  ${p.files} files, ${p.dirs} dirs`)
+  })
+  const r = await scan.result
+  if (!r.found) {
+    console.log(`Directory ${root} not found`)
+    process.exit(1)
+  }
+  console.log(`\n${r.files} files, ${r.dirs} dirs, ${r.bytesFmt} in ${r.elapsed.toFixed(2)}s ` +
+    `(${r.threads} threads, ${Math.round(r.files / Math.max(r.elapsed, 0.001))} files/s, ${r.errors} unreadable)\n`)
+  console.log('Largest directories:')
+  r.topDirs.forEach(d => console.log(`   ${d.sizeFmt.padStart(10)}  ${d.path}`))
+  console.log('\nLargest files:')
+  r.topFiles.forEach(f => console.log(`   ${f.sizeFmt.padStart(10)}  ${f.path}`))
+
+  // 取消: 马上取消的扫描应带 cancelled 标记返回
+  const cancelled = sysmon.scanDirectory(root)
+  cancelled.cancel()
+  const c = await cancelled.result
+  console.log(`\nCancel: cancelled=${c.cancelled}, ${c.files} files counted before stop`)
+  if (!c.cancelled) process.exitCode = 1
+
+  console.log('\n=== Test Complete ===')
+}
+
+main()
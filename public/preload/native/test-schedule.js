@@ -0,0 +1,44 @@
+/**
+ * 自适应采样测试 - 观察各采集器的有效间隔如何随变化/负载调整
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Adaptive Schedule Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+let round = 0
+const timer = setInterval(() => {
+  // 模拟界面每秒刷新
+  sysmon.getCpuUsage()
+  sysmon.getMemoryInfo()
+  sysmon.getSystemStats()
+  sysmon.getDiskIO()
+  sysmon.getNetworkStats()
+  sysmon.getNetworkConnections()
+  const p = sysmon.getProcessList()
+  sysmon.getDiskInfo()
+
+  round++
+  const s = sysmon.getSchedule()
+  console.log(`--- round ${round} (host cpu ${s.hostCpu.toFixed(1)}%) processList age=${p.sampleAge}ms ---`)
+  s.collectors.forEach(c => {
+    console.log(`   ${c.name.padEnd(22)} interval=${String(c.interval.toFixed(0)).padStart(5)}ms ` +
+      `cost=${c.cost.toFixed(2)}ms samples=${c.samples} served=${c.served} (${c.reason})`)
+  })
+
+  if (round === 20) {
+    console.log('\nDisabling scheduler for the remaining rounds...')
+    sysmon.setSchedule({ enabled: false })
+  }
+  if (round >= 25) {
+    clearInterval(timer)
+    console.log('\n=== Test Complete ===')
+  }
+}, 1000)
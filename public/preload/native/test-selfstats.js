@@ -0,0 +1,54 @@
+/**
+ * 自身开销测试 - 各采集函数的耗时分布与进程 CPU/内存
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Self Stats Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const fmt = t => `p50=${t.p50.toFixed(3)} p99=${t.p99.toFixed(3)} max=${t.max.toFixed(3)}`
+
+// 导出表末尾的函数也要被计时 (采集槽位按导出数量分配, 不设上限)
+sysmon.getCpuTopology()
+sysmon.getContainerInfo()
+
+let round = 0
+const timer = setInterval(() => {
+  sysmon.getCpuUsage()
+  sysmon.getPerCoreUsage()
+  sysmon.getMemoryInfo()
+  sysmon.getDiskIO()
+  sysmon.getNetworkStats()
+  sysmon.getNetworkConnections()
+  sysmon.getProcessList()
+  if (round % 10 === 0) sysmon.getDiskInfo()
+
+  if (++round % 5 === 0) {
+    const s = sysmon.getSelfStats()
+    console.log(`--- after ${round} rounds ---`)
+    s.collectors.forEach(c => {
+      console.log(`   ${c.name} (${c.calls} calls)`)
+      console.log(`      total   ms ${fmt(c.total)}`)
+      console.log(`      query   ms ${fmt(c.query)}`)
+      console.log(`      marshal ms ${fmt(c.marshal)}`)
+      console.log(`      bytes      p50=${c.bytes.p50} max=${c.bytes.max}`)
+    })
+    console.log(`   Process: cpu=${s.process.cpuPercent.toFixed(2)}% rss=${(s.process.rss / 1048576).toFixed(1)} MB`)
+    console.log(`   Native: ${s.nativeTime.toFixed(1)} ms total, ${s.nativePercent.toFixed(2)}% of JS thread\n`)
+  }
+  if (round >= 30) {
+    clearInterval(timer)
+    const names = sysmon.getSelfStats().collectors.map(c => c.name)
+    const ok = ['getCpuTopology', 'getContainerInfo'].every(n => names.includes(n))
+    console.log(`Last exports in the table instrumented: ${ok}`)
+    if (!ok) process.exitCode = 1
+    console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+  }
+}, 1000)
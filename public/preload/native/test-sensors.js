@@ -0,0 +1,36 @@
+/**
+ * 传感器测试 - CPU 实际频率、降频与温度
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Sensors Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+// 频率计数器是速率型，第一次采样用于初始化
+sysmon.getSensors()
+
+let round = 0
+const timer = setInterval(() => {
+  const s = sysmon.getSensors()
+  console.log(`--- sample ${++round} ---`)
+  console.log(`   Frequency: ${s.frequencyFmt} (base ${s.cpu.baseFrequency} MHz, perf ${s.cpu.performance.toFixed(1)}%)`)
+  console.log(`   Performance limit: ${s.cpu.performanceLimit.toFixed(1)}% flags=${s.cpu.limitFlags} throttled=${s.cpu.throttled}`)
+  console.log('   Cores:', s.cpu.cores.map(c => `${c.group},${c.core}=${c.frequency.toFixed(0)}`).join(' '))
+  if (s.thermal.length === 0) console.log('   Thermal: no thermal zones exposed')
+  s.thermal.forEach(z => {
+    console.log(`   Thermal ${z.zone}: ${z.temperature.toFixed(1)} °C passive=${z.passiveLimit}% reasons=${z.throttleReasons}`)
+  })
+  console.log(`   CPU temperature: ${s.temperatureFmt}\n`)
+
+  if (round >= 10) {
+    clearInterval(timer)
+    console.log('=== Test Complete ===')
+  }
+}, 1000)
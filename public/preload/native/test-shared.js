@@ -0,0 +1,88 @@
+/**
+ * 共享快照测试 - 本进程采集并发布, 子进程只读挂载, 对比两边数值与读取耗时
+ * 用法: node test-shared.js [采样秒数]   (默认 5)
+ */
+
+const { execFileSync } = require('child_process')
+const sysmon = require('./index.js')
+
+if (process.argv[2] === '--reader') {
+  // 子进程: 只挂载; getCpuUsage / getProcessList 应直接读共享段, 不运行本地采集
+  const name = process.argv[3]
+  sysmon.setSharedSnapshot({ mode: 'attach', name })
+  const t0 = process.hrtime.bigint()
+  let r
+  for (let i = 0; i < 1000; i++) r = sysmon.getSharedSnapshot({ history: 60 })
+  const us = Number(process.hrtime.bigint() - t0) / 1000 / 1000
+  const cpu = sysmon.getCpuUsage(), list = sysmon.getProcessList()
+  const local = sysmon.getSelfStats().collectors
+    .filter(c => c.name === 'getCpuUsage' || c.name === 'getProcessList')
+    .reduce((n, c) => n + c.calls, 0)
+  console.log(JSON.stringify({
+    found: r.found, role: r.role, ownerPid: r.ownerPid, ownerAlive: r.ownerAlive, age: r.age,
+    cpu: r.cpu && r.cpu.total, mem: r.mem && r.mem.used, procs: r.procs && r.procs.length,
+    history: r.history ? r.history.cpu.length : 0, perRead: us,
+    sharedCpu: cpu.shared === true, sharedProcs: list.shared === true && list.count === r.procs.length,
+    complete: r.procs.length === r.procTotal, paths: list.list.filter(p => p.path).length,
+    localCalls: local
+  }))
+  process.exit(0)
+}
+
+console.log('=== Shared Snapshot Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const seconds = parseInt(process.argv[2]) || 5
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+const name = 'sysmon-test-' + process.pid
+
+async function main() {
+  const status = sysmon.setSharedSnapshot({ mode: 'publish', name })
+  console.log(`Segment ${status.name} v${status.version}, ${(status.size / 1024).toFixed(0)} KB, role ${status.role}`)
+  let ok = status.role === 'publisher'
+
+  console.log(`Publishing for ${seconds}s ...`)
+  let cpu, mem
+  for (let i = 0; i < seconds; i++) {
+    cpu = sysmon.getCpuUsage()
+    mem = sysmon.getMemoryInfo()
+    sysmon.getProcessList()
+    sysmon.getNetworkStats()
+    await sleep(1000)
+  }
+
+  const out = execFileSync(process.execPath, [__filename, '--reader', name]).toString()
+  const r = JSON.parse(out)
+  console.log(`\nReader (pid != ${process.pid}): found ${r.found}, role ${r.role}, owner ${r.ownerPid} alive ${r.ownerAlive}, age ${r.age.toFixed(0)} ms`)
+  console.log(`   cpu ${r.cpu} (publisher ${cpu.loadRaw})`)
+  console.log(`   mem ${r.mem} (publisher ${mem.usedRaw})`)
+  console.log(`   ${r.procs} processes, ${r.history} history samples`)
+  console.log(`   ${r.perRead.toFixed(1)} us per read`)
+  console.log(`   getCpuUsage shared ${r.sharedCpu}, getProcessList shared ${r.sharedProcs}, local collector calls ${r.localCalls}`)
+  console.log(`   complete list ${r.complete}, ${r.paths} rows with a path`)
+
+  ok = ok && r.found && r.role === 'reader' && r.ownerPid === process.pid && r.ownerAlive &&
+    Math.abs(r.cpu - cpu.loadRaw) < 0.01 && r.procs > 0 && r.history > 0 &&
+    r.sharedCpu && r.sharedProcs && r.localCalls === 0 && r.complete && r.paths > 0
+
+  // 第二个发布者应被拒绝
+  const again = execFileSync(process.execPath, ['-e',
+    `const s = require(${JSON.stringify(require.resolve('./index.js'))});` +
+    `console.log(JSON.stringify(s.setSharedSnapshot({ mode: 'publish', name: ${JSON.stringify(name)} })))`
+  ]).toString()
+  const second = JSON.parse(again)
+  console.log(`\nSecond publisher: role ${second.role}, error: ${second.error}`)
+  ok = ok && second.role === 'off' && !!second.error
+
+  sysmon.setSharedSnapshot({ mode: 'off' })
+  if (!ok) process.exitCode = 1
+  console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
+
+main()
@@ -0,0 +1,46 @@
+/**
+ * 连接质量测试 - 按远端主机汇总 RTT / 重传 / 吞吐
+ * 用法: node test-tcpstats.js [pid ...]   (默认观察当前进程, 并发起几个 HTTPS 请求)
+ * RTT 与重传需要以管理员身份运行
+ */
+
+const https = require('https')
+const sysmon = require('./index.js')
+
+console.log('=== Connection Quality Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const pids = process.argv.slice(2).map(Number).filter(Boolean)
+if (!pids.length) pids.push(process.pid)
+
+// 当前进程时保持几个长连接, 便于观察
+const agent = new https.Agent({ keepAlive: true })
+const traffic = pids.includes(process.pid) ? setInterval(() => {
+  ['www.microsoft.com', 'www.bing.com'].forEach(host => https.get({ host, agent }, res => res.resume()).on('error', () => {}))
+}, 1000) : null
+
+sysmon.getConnectionQuality(pids)
+let round = 0
+const timer = setInterval(() => {
+  const r = sysmon.getConnectionQuality(pids)
+  console.log(`--- window ${r.window.toFixed(2)}s, ${r.connections} connections` +
+    (r.enabled ? '' : ' (EStats unavailable, run as admin)') + ' ---')
+  r.hosts.slice(0, 10).forEach(h => {
+    console.log(`   ${h.host.padEnd(16)} x${h.connections} rtt=${h.rttFmt.padStart(7)} ` +
+      `min=${h.rttMin ?? '-'} max=${h.rttMax ?? '-'} retrans=${h.retransmits} ` +
+      `in=${h.bytesInSecFmt} out=${h.bytesOutSecFmt} cwnd=${h.cwnd.toFixed(0)}`)
+  })
+  console.log('')
+  if (++round >= 6) {
+    clearInterval(timer)
+    if (traffic) clearInterval(traffic)
+    agent.destroy()
+    console.log('=== Test Complete ===')
+  }
+}, 1000)
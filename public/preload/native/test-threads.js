@@ -0,0 +1,42 @@
+/**
+ * 线程 CPU 测试 - 找出占用 CPU 的线程
+ * 用法: node test-threads.js [pid]   (默认观察当前进程)
+ */
+
+const sysmon = require('./index.js')
+
+console.log('=== Process Threads Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const pid = parseInt(process.argv[2]) || process.pid
+const first = sysmon.getProcessThreads(pid)
+if (!first.found) {
+  console.log(`Process ${pid} not found`)
+  process.exit(1)
+}
+console.log(`Watching pid ${pid} (${first.count} threads)\n`)
+
+// 当前进程时制造一点负载, 便于观察
+const busy = pid === process.pid ? setInterval(() => { const end = Date.now() + 200; while (Date.now() < end); }, 500) : null
+
+let round = 0
+const timer = setInterval(() => {
+  const r = sysmon.getProcessThreads(pid)
+  console.log(`--- window ${r.window.toFixed(2)}s, ${r.count} threads ---`)
+  r.threads.slice(0, 8).forEach(t => {
+    console.log(`   ${String(t.tid).padStart(6)} ${(t.name || '-').padEnd(20)} cpu=${t.cpuFmt.padStart(6)} ` +
+      `(k ${t.kernel.toFixed(1)} / u ${t.user.toFixed(1)}) ${t.state}${t.waitReason ? ':' + t.waitReason : ''} prio=${t.priority}`)
+  })
+  console.log('')
+  if (++round >= 8) {
+    clearInterval(timer)
+    if (busy) clearInterval(busy)
+    console.log('=== Test Complete ===')
+  }
+}, 1000)
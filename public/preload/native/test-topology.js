@@ -0,0 +1,65 @@
+/**
+ * CPU 拓扑测试 - 插槽 / NUMA 节点 / L3 / SMT 映射的一致性, 按拓扑聚合负载, 节点内存
+ * 用法: node test-topology.js [负载秒数]   (默认 2)
+ */
+
+const os = require('os')
+const sysmon = require('./index.js')
+
+console.log('=== CPU Topology Test (C++ Native) ===\n')
+
+if (!sysmon.isLoaded()) {
+  console.log('ERROR: Native module not loaded!')
+  console.log('Error:', sysmon.getError())
+  console.log('\nPlease build first: npm run build')
+  process.exit(1)
+}
+
+const seconds = parseInt(process.argv[2]) || 2
+const sleep = ms => new Promise(r => setTimeout(r, ms))
+const avg = list => list.length ? list.reduce((s, x) => s + x, 0) / list.length : 0
+
+async function main() {
+  sysmon.getCpuTopology()
+  // 在本线程上制造一点负载, 让某个插槽比其它的忙
+  const end = Date.now() + seconds * 1000
+  while (Date.now() < end) Math.sqrt(Math.random())
+  await sleep(100)
+  const t = sysmon.getCpuTopology()
+  const info = sysmon.getCpuInfo()
+
+  console.log(`${t.logical} logical, ${t.cores.length} cores, ${t.caches.length} L3, ${t.nodes.length} nodes, ${t.sockets.length} sockets` +
+    `, smt ${t.smt}, hybrid ${t.hybrid}`)
+  t.sockets.forEach(s => console.log(`   socket ${s.id}: ${s.cores} cores / ${s.logical} logical, load ${s.loadFmt}`))
+  t.nodes.forEach(n => console.log(`   node ${n.id} (socket ${n.socket}): load ${n.loadFmt}, ` +
+    (n.memory ? `${(n.memory.available / 1073741824).toFixed(1)} GB free` +
+      (n.memory.total ? ` of ${(n.memory.total / 1073741824).toFixed(1)} GB` : '') : 'no memory info')))
+  t.caches.forEach(c => console.log(`   L3 ${c.id}: ${(c.size / 1048576).toFixed(0)} MB, ${c.logical} logical, load ${c.loadFmt}`))
+  console.log(`   imbalance: socket ${t.imbalance.socket.toFixed(1)}, node ${t.imbalance.node.toFixed(1)}, l3 ${t.imbalance.l3.toFixed(1)} points`)
+
+  // 每个逻辑处理器恰好属于一个核心, SMT 兄弟编号从 0 连续
+  let ok = t.logical === os.cpus().length && t.processors.length === t.logical && info.cores === t.logical &&
+    info.physicalCores === t.cores.length && info.sockets === t.sockets.length
+  const covered = t.cores.reduce((n, c) => n + c.logical.length, 0)
+  const siblingsOk = t.cores.every(c => c.logical.every((idx, rank) => t.processors[idx].sibling === rank &&
+    t.processors[idx].core === c.id))
+  ok = ok && covered === t.logical && siblingsOk && (t.smt || t.cores.length === t.logical)
+  console.log(`\nEvery processor in one core: ${covered === t.logical}, sibling ranks consistent: ${siblingsOk}`)
+
+  // 聚合负载 = 成员处理器负载的平均
+  const socketOk = t.sockets.every(s =>
+    Math.abs(s.load - avg(t.processors.filter(p => p.socket === s.id).map(p => p.load))) < 0.01)
+  const perCore = sysmon.getPerCoreUsage()
+  console.log(`Socket load = mean of its processors: ${socketOk}, getPerCoreUsage has ${perCore.length} entries`)
+  ok = ok && socketOk && perCore.length === t.logical
+
+  // 节点可用内存合计不超过物理内存
+  const free = t.nodes.reduce((n, x) => n + (x.memory ? x.memory.available : 0), 0)
+  console.log(`Node free memory ${(free / 1073741824).toFixed(1)} GB (os.freemem ${(os.freemem() / 1073741824).toFixed(1)} GB)`)
+  ok = ok && free > 0 && free <= os.totalmem()
+
+  if (!ok) process.exitCode = 1
+  console.log(`\n${ok ? 'OK' : 'FAILED'}\n=== Test Complete ===`)
+}
+
+main()
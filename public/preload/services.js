@@ -14,6 +14,9 @@ try {
 
 window.__nativeApiLoaded = native !== null
 
+// 多个窗口共用一份采样: 第一个实例发布, 其余实例直接读取共享段
+if (native) native.setSharedSnapshot({ mode: 'auto' })
+
 // 格式化工具
 function formatBytes(bytes, decimals = 2) {
   if (!bytes || bytes === 0) return '0 B'
@@ -32,8 +35,18 @@ const cache = {
   externalIPTime: 0
 }
 
+// 静态信息首屏来自磁盘缓存; 后台刷新 (WMI 在工作线程) 完成后替换缓存并通知页面
+if (native) {
+  native.setInventoryCache({ onRefresh: fresh => {
+    if (fresh.getSystemInfo) cache.systemInfo = fresh.getSystemInfo
+    if (fresh.getGpuInfo) cache.gpuInfo = fresh.getGpuInfo
+    if (fresh.getMemoryHardware) cache.memoryHardware = fresh.getMemoryHardware
+    window.dispatchEvent(new CustomEvent('sysmon-inventory', { detail: fresh }))
+  } })
+}
+
 window.services = {
-  // CPU 负载 (同步, <0.1ms)
+  // CPU 负载 (同步, 耗时见 getSelfStats)
   getCpuLoad() {
     if (native) return native.getCpuUsage()
     const cpus = os.cpus()
@@ -46,7 +59,7 @@ window.services = {
     return []
   },
 
-  // 内存信息 (同步, <0.01ms)
+  // 内存信息 (同步, 耗时见 getSelfStats)
   getMemoryInfo() {
     if (native) return native.getMemoryInfo()
     const total = os.totalmem(), free = os.freemem(), used = total - free
@@ -62,7 +75,7 @@ window.services = {
     return cache.memoryHardware || { modules: [], usedSlots: 0, totalSlots: 0 }
   },
 
-  // 运行时间 (同步, <0.001ms)
+  // 运行时间 (同步, 耗时见 getSelfStats)
   getUptime() {
     if (native) return native.getUptime()
     const s = os.uptime()
@@ -113,8 +126,11 @@ window.services = {
   // 网络信息
   async getNetworkInfo() {
     if (native) {
-      const stats = native.getNetworkStats()
-      return { interfaces: stats, virtualInterfaces: [], allInterfaces: stats, stats, gateway: '' }
+      const all = native.getNetworkStats()
+      // 物理网卡在前；Hyper-V / WSL / Docker / VPN / 回环归为虚拟
+      const stats = all.filter(i => !i.virtual)
+      const virtualInterfaces = all.filter(i => i.virtual)
+      return { interfaces: stats, virtualInterfaces, allInterfaces: all, stats, gateway: '' }
     }
     const nets = os.networkInterfaces()
     const interfaces = []
@@ -219,6 +235,183 @@ window.services = {
     }
   },
 
+  // 进程线程 CPU 明细 (首次调用只建立基线, 之后返回两次调用间的速率)
+  getProcessThreads(pid) {
+    if (native) return native.getProcessThreads(pid)
+    return { pid, found: false, threads: [] }
+  },
+
+  // 进程句柄明细 (按类型/目标分组, 附带与上次调用相比的变化, 用于排查句柄泄漏)
+  getProcessHandles(pid, opts) {
+    if (native) return native.getProcessHandles(pid, opts)
+    return { pid, found: false, byType: [], groups: [], changes: [] }
+  },
+
+  // 目录占用扫描 (多线程遍历, 返回最大的目录和文件; cancel() 可中途停止)
+  scanDirectory(root, opts) {
+    if (native) return native.scanDirectory(root, opts)
+    return { id: 0, result: Promise.resolve({ root, found: false, topDirs: [], topFiles: [] }), cancel() {} }
+  },
+
+  // 连接质量 (按远端主机汇总 RTT / 重传 / 吞吐; 只对传入的进程开启统计, 需要管理员权限)
+  getConnectionQuality(pids) {
+    if (native) return native.getConnectionQuality(pids)
+    return { watched: [], enabled: false, window: 0, connections: 0, untracked: 0, hosts: [] }
+  },
+
+  // 端口占用查询 (原生监听索引, 不遍历整张连接表)
+  findPortOwner(port, protocol) {
+    if (native) return native.findPortOwner(port, protocol)
+    return { port, inUse: false, owners: [], indexAge: 0 }
+  },
+
+  // 监听端口变化 (传入上次返回的 seq, 只取之后的新增/关闭)
+  getListeningChanges(since) {
+    if (native) return native.getListeningChanges(since)
+    return { seq: 0, truncated: false, changes: [] }
+  },
+
+  // 进程异常事件 (内存增长 / 句柄泄漏 / CPU 突增)
+  getAnomalyEvents() {
+    if (native) return native.getAnomalyEvents()
+    return { events: [], tracked: 0, dropped: 0 }
+  },
+
+  // 告警规则 (原生编译与求值)
+  addAlertRule(id, expr) {
+    if (native) return native.addAlertRule(id, expr)
+    return { ok: false, error: '原生模块未加载' }
+  },
+
+  removeAlertRule(id) {
+    if (native) return native.removeAlertRule(id)
+    return false
+  },
+
+  getAlertRules() {
+    if (native) return native.getAlertRules()
+    return []
+  },
+
+  onAlert(callback) {
+    if (native) return native.setAlertCallback(callback)
+    return false
+  },
+
+  setAlertLog(path) {
+    if (native) return native.setAlertLog(path)
+    return false
+  },
+
+  // 监控自身开销 (各采集函数耗时 p50/p99/max, 进程 CPU/内存)
+  getSelfStats(reset = false) {
+    if (native) return native.getSelfStats(reset)
+    return null
+  },
+
+  // 传感器：CPU 实际频率 / 降频 / 温度
+  getSensors() {
+    if (native) return native.getSensors()
+    return null
+  },
+
+  // 资源压力：缺页 / 换页 / 运行队列 / 磁盘队列 (采样窗口内的速率)
+  getPressure() {
+    if (native) return native.getPressure()
+    return null
+  },
+
+  // 自适应采样间隔 (数据平稳或负载高时原生层自动降频)
+  getSchedule() {
+    if (native) return native.getSchedule()
+    return null
+  },
+
+  setSchedule(opts) {
+    if (native) return native.setSchedule(opts)
+    return null
+  },
+
+  // 录制/回放原始系统表 (用于可重复的大规模场景测试)
+  setReplay(opts) {
+    if (native) return native.setReplay(opts)
+    return null
+  },
+
+  // 多机监控: 本机推送指标流 / 汇聚端接收
+  setStream(opts) {
+    if (native) return native.setStream(opts)
+    return null
+  },
+
+  setAggregator(opts) {
+    if (native) return native.setAggregator(opts)
+    return null
+  },
+
+  getAggregatedHosts(opts) {
+    if (native) return native.getAggregatedHosts(opts || {})
+    return []
+  },
+
+  // 历史指标窗口查询 (分位数/最值/均值)
+  queryMetric(metric, opts) {
+    if (native) return native.queryMetric(metric, opts || {})
+    return null
+  },
+
+  // 历史曲线降采样 (LTTB / 每像素最值), 点数与图表宽度一致
+  downsample(metric, from, to, width, opts) {
+    if (native) return native.downsample(metric, from, to, width, opts || {})
+    return null
+  },
+
+  getMetricNames() {
+    if (native) return native.getMetricNames()
+    return []
+  },
+
+  // 多窗口共享采样: 一个实例采集并发布到共享内存, 其余实例只读
+  setSharedSnapshot(opts) {
+    if (native) return native.setSharedSnapshot(opts)
+    return null
+  },
+
+  getSharedSnapshot(opts) {
+    if (native) return native.getSharedSnapshot(opts || {})
+    return { found: false, role: 'off' }
+  },
+
+  // 静态硬件信息磁盘缓存 (启动时直接读取, 后台刷新)
+  getInventoryCache() {
+    if (native) return native.getInventoryCache()
+    return null
+  },
+
+  // 功耗: 能耗计量 (RAPL) / 电池放电速率 / 进程能耗估算
+  getPowerInfo(opts) {
+    if (native) return native.getPowerInfo(opts)
+    return { available: false, meters: [], package: null, core: null, dram: null, gpu: null, battery: null, processes: [], interval: 0, error: null }
+  },
+
+  // 进程详情: 完整路径 / 命令行 / 用户 / 启动时间
+  getProcessDetails(pid) {
+    if (native) return native.getProcessDetails(pid)
+    return null
+  },
+
+  // CPU 拓扑: 插槽 / NUMA 节点 / L3 / 核心负载与节点内存
+  getCpuTopology() {
+    if (native) return native.getCpuTopology()
+    return null
+  },
+
+  // 容器 (作业对象) 限额: CPU 上限 / 内存上限 / 节流与超限次数
+  getContainerInfo() {
+    if (native) return native.getContainerInfo()
+    return { inJob: false, limited: false, cpu: null, memory: null, processes: 0, terminated: 0, terminatedSec: 0, interval: 0 }
+  },
+
   // 网络连接监控
   getNetworkConnections() {
     if (native) return native.getNetworkConnections()
@@ -289,3 +289,77 @@ export function drawMultiLineChart(canvas, lines) {
   ctx.lineTo(padding.left + chartWidth, padding.top + chartHeight)
   ctx.stroke()
 }
+
+// 趋势图时间范围: 实时为最近 maxDataPoints 个样本, 其余从原生历史降采样
+export const chartRanges = [
+  { label: '实时', ms: 0 },
+  { label: '1小时', ms: 3600 * 1000 },
+  { label: '24小时', ms: 24 * 3600 * 1000 }
+]
+
+// 取最近 rangeMs 的历史曲线, 每像素列保留最小/最大值, 尖峰不会被平均掉
+export function loadSeries(canvas, metric, rangeMs) {
+  if (!canvas || typeof window.services?.downsample !== 'function') return null
+  const { chartWidth } = getChartConfig(canvas)
+  const to = Date.now()
+  return window.services.downsample(metric, to - rangeMs, to, Math.max(1, Math.round(chartWidth)), { mode: 'minmax' })
+}
+
+// 绘制历史曲线（按时间定位, series 为 downsample() 的结果）
+// 点数由原生层按图表宽度降采样, 绘制开销与时间窗口长短无关
+export function drawSeriesChart(canvas, series, color, yMax = 0) {
+  if (!canvas) return
+  const ctx = canvas.getContext('2d')
+  const config = getChartConfig(canvas, !yMax)
+  const { padding, width, height, chartWidth, chartHeight } = config
+
+  if (width === 0 || height === 0) return
+  ctx.clearRect(0, 0, width, height)
+  if (!series || series.values.length < 1) return
+
+  // 未指定上限时按数据动态缩放
+  const { times, values, from, to } = series
+  let max = yMax
+  if (!max) {
+    for (let i = 0; i < values.length; i++) if (values[i] > max) max = values[i]
+    max = max > 0 ? max * 1.2 : 1
+  }
+
+  // Y轴网格线和标签
+  ctx.strokeStyle = '#e0e0e0'
+  ctx.lineWidth = 1
+  ctx.fillStyle = '#999'
+  ctx.font = '10px sans-serif'
+  ctx.textAlign = 'right'
+
+  for (let i = 0; i <= 4; i++) {
+    const y = padding.top + (chartHeight / 4) * i
+    ctx.beginPath()
+    ctx.moveTo(padding.left, y)
+    ctx.lineTo(padding.left + chartWidth, y)
+    ctx.stroke()
+    const label = max - (max / 4) * i
+    ctx.fillText(yMax ? Math.round(label) + '%' : formatIOValue(label), padding.left - 5, y + 4)
+  }
+
+  // 绘制折线
+  const span = to - from || 1
+  ctx.strokeStyle = color
+  ctx.lineWidth = 2
+  ctx.beginPath()
+  for (let i = 0; i < values.length; i++) {
+    const x = padding.left + ((times[i] - from) / span) * chartWidth
+    const y = padding.top + chartHeight - (values[i] / max) * chartHeight
+    i === 0 ? ctx.moveTo(x, y) : ctx.lineTo(x, y)
+  }
+  ctx.stroke()
+
+  // 坐标轴
+  ctx.strokeStyle = '#666'
+  ctx.lineWidth = 2
+  ctx.beginPath()
+  ctx.moveTo(padding.left, padding.top)
+  ctx.lineTo(padding.left, padding.top + chartHeight)
+  ctx.lineTo(padding.left + chartWidth, padding.top + chartHeight)
+  ctx.stroke()
+}